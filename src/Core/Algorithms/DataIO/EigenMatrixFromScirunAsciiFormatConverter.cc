@@ -36,6 +36,9 @@
 #include <iostream>
 #include <fstream>
 #include <streambuf>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
 
 #include <Core/Algorithms/DataIO/EigenMatrixFromScirunAsciiFormatConverter.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
@@ -45,11 +48,94 @@
 #include <Core/Algorithms/Base/AlgorithmBase.h>
 #include <Core/Utils/FileUtil.h>
 #include <Core/Utils/StringUtil.h>
+#include <Core/Utils/Legacy/MappedFile.h>
+#include <Core/Utils/Legacy/TextTable.h>
 
 
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Utility;
 using namespace SCIRun::Core::Algorithms::DataIO::internal;
+using SCIRun::MappedFile;
+using SCIRun::TextTable;
+
+namespace
+{
+  // The whole file, mapped when possible
+  class FileContents
+  {
+  public:
+    explicit FileContents(const std::string& filename) : mapped_(filename)
+    {
+      if (!mapped_.is_open())
+      {
+        std::ifstream file(filename.c_str(), std::ios::binary);
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      }
+    }
+    const char* begin() const { return mapped_.is_open() ? mapped_.data() : buffer_.data(); }
+    const char* end() const { return begin() + (mapped_.is_open() ? mapped_.size() : buffer_.size()); }
+  private:
+    MappedFile mapped_;
+    std::string buffer_;
+  };
+
+  void invalidFormat()
+  {
+    BOOST_THROW_EXCEPTION(SCIRun::Core::Algorithms::AlgorithmInputException() << SCIRun::Core::ErrorMessage("Invalid SCIRun matrix file contents"));
+  }
+
+  // Same rule as getMatrixContentsLine: the first line starting with a digit
+  const char* contentsLine(const char* begin, const char* end, const char*& lineEnd)
+  {
+    const char* p = begin;
+    while (p < end)
+    {
+      const char* e = static_cast<const char*>(memchr(p, '\n', end - p));
+      if (!e) e = end;
+      if (e - p > 2 && isdigit(static_cast<unsigned char>(*p)))
+      {
+        lineEnd = e;
+        return p;
+      }
+      p = e + 1;
+    }
+    invalidFormat();
+    return 0;
+  }
+
+  int readSize(const char*& p, const char* end)
+  {
+    while (p < end && *p == ' ') ++p;
+    double value;
+    const char* q = TextTable::parse_double(p, end, value);
+    if (q == p || value < 0)
+      invalidFormat();
+    p = q;
+    return static_cast<int>(value);
+  }
+
+  // Numbers from p up to the next closing brace, skipping the opening brace
+  // and the type tag that the sparse index arrays carry
+  const char* readBraces(const char* p, const char* end, bool tagged, std::vector<double>& values)
+  {
+    p = std::find(p, end, '{');
+    if (p == end)
+      invalidFormat();
+    ++p;
+    if (tagged)
+      readSize(p, end);
+    const char* close = std::find(p, end, '}');
+    if (close == end)
+      invalidFormat();
+    TextTable::parse_numbers(p, close, values);
+    return close + 1;
+  }
+
+  bool headerContains(const char* begin, const char* end, const char* name)
+  {
+    return std::search(begin, end, name, name + strlen(name)) != end;
+  }
+}
 
 EigenMatrixFromScirunAsciiFormatConverter::EigenMatrixFromScirunAsciiFormatConverter(const ProgressReporter* reporter) : reporter_(reporter)
 {
@@ -59,12 +145,17 @@ MatrixHandle EigenMatrixFromScirunAsciiFormatConverter::make(const std::string&
 {
   if (reporter_)
     reporter_->update_progress(0.01);
-  if (fileContainsString(matFile, "DenseMatrix"))
-    return makeDense(matFile);
-  if (fileContainsString(matFile, "SparseRowMatrix"))
-    return makeSparse(matFile);
-  if (fileContainsString(matFile, "ColumnMatrix"))
-    return makeColumn(matFile);
+
+  // The type names are in the header, which ends at the contents line
+  FileContents file(matFile);
+  const char* lineEnd;
+  const char* header = contentsLine(file.begin(), file.end(), lineEnd);
+  if (headerContains(file.begin(), header, "DenseMatrix"))
+    return makeDense(file.begin(), file.end());
+  if (headerContains(file.begin(), header, "SparseRowMatrix"))
+    return makeSparse(file.begin(), file.end());
+  if (headerContains(file.begin(), header, "ColumnMatrix"))
+    return makeColumn(file.begin(), file.end());
 
   /// @todo: no access to error(), need alternative for logging this exception
   BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Unknown SCIRun matrix format"));
@@ -72,7 +163,35 @@ MatrixHandle EigenMatrixFromScirunAsciiFormatConverter::make(const std::string&
 
 SparseRowMatrixHandle EigenMatrixFromScirunAsciiFormatConverter::makeSparse(const std::string& matFile)
 {
-  SparseData data = convertRaw(parseSparseMatrixString(getMatrixContentsLine(readFile(matFile)).get()).get());
+  FileContents file(matFile);
+  return makeSparse(file.begin(), file.end());
+}
+
+SparseRowMatrixHandle EigenMatrixFromScirunAsciiFormatConverter::makeSparse(const char* begin, const char* end)
+{
+  if (reporter_)
+    reporter_->update_progress(0.1);
+  const char* lineEnd;
+  const char* p = contentsLine(begin, end, lineEnd);
+  end = lineEnd;
+  const int rows = readSize(p, end);
+  const int cols = readSize(p, end);
+  const int nnz = readSize(p, end);
+
+  std::vector<double> rowData, colData, values;
+  p = readBraces(p, end, true, rowData);
+  p = readBraces(p, end, true, colData);
+  readBraces(p, end, false, values);
+  if (rowData.size() != static_cast<size_t>(rows) + 1 || colData.size() != static_cast<size_t>(nnz) ||
+      values.size() != static_cast<size_t>(nnz))
+    invalidFormat();
+
+  if (reporter_)
+    reporter_->update_progress(0.5);
+  SparseData data = boost::make_tuple(rows, cols, nnz,
+    Indices(rowData.begin(), rowData.end()), Indices(colData.begin(), colData.end()), Data());
+  data.get<5>().swap(values);
+
   if (reporter_)
     reporter_->update_progress(0.7);
   SparseRowMatrixHandle mat(boost::make_shared<SparseRowMatrix>(data.get<0>(), data.get<1>()));
@@ -133,10 +252,26 @@ std::string EigenMatrixFromScirunAsciiFormatConverter::readFile(const std::strin
 
 DenseMatrixHandle EigenMatrixFromScirunAsciiFormatConverter::makeDense(const std::string& matFile)
 {
-  DenseData data = convertRaw(parseDenseMatrixString(getMatrixContentsLine(readFile(matFile)).get()).get());
-  DenseMatrixHandle mat(boost::make_shared<DenseMatrix>(data.get<0>(), data.get<1>()));
+  FileContents file(matFile);
+  return makeDense(file.begin(), file.end());
+}
+
+DenseMatrixHandle EigenMatrixFromScirunAsciiFormatConverter::makeDense(const char* begin, const char* end)
+{
+  const char* lineEnd;
+  const char* p = contentsLine(begin, end, lineEnd);
+  end = lineEnd;
+  const int rows = readSize(p, end);
+  const int cols = readSize(p, end);
 
-  auto values = data.get<2>().begin();
+  // The values are tagged with a 0 after the brace
+  std::vector<double> data;
+  readBraces(p, end, true, data);
+  if (data.size() != static_cast<size_t>(rows)*cols)
+    invalidFormat();
+
+  DenseMatrixHandle mat(boost::make_shared<DenseMatrix>(rows, cols));
+  auto values = data.begin();
   for (int i = 0; i < mat->rows(); ++i)
     for (int j = 0; j < mat->cols(); ++j)
       (*mat)(i,j) = *values++;
@@ -146,10 +281,27 @@ DenseMatrixHandle EigenMatrixFromScirunAsciiFormatConverter::makeDense(const std
 
 DenseColumnMatrixHandle EigenMatrixFromScirunAsciiFormatConverter::makeColumn(const std::string& matFile)
 {
-  DenseData data = convertRaw(parseColumnMatrixString(getMatrixContentsLine(readFile(matFile)).get()).get());
-  DenseColumnMatrixHandle mat(boost::make_shared<DenseColumnMatrix>(data.get<0>()));
+  FileContents file(matFile);
+  return makeColumn(file.begin(), file.end());
+}
+
+DenseColumnMatrixHandle EigenMatrixFromScirunAsciiFormatConverter::makeColumn(const char* begin, const char* end)
+{
+  const char* lineEnd;
+  const char* p = contentsLine(begin, end, lineEnd);
+  end = lineEnd;
+  const int rows = readSize(p, end);
+
+  const char* close = std::find(p, end, '}');
+  if (close == end)
+    invalidFormat();
+  std::vector<double> data;
+  TextTable::parse_numbers(p, close, data);
+  if (data.size() != static_cast<size_t>(rows))
+    invalidFormat();
 
-  auto values = data.get<2>().begin();
+  DenseColumnMatrixHandle mat(boost::make_shared<DenseColumnMatrix>(rows));
+  auto values = data.begin();
   for (int i = 0; i < mat->rows(); ++i)
       (*mat)(i) = *values++;
 
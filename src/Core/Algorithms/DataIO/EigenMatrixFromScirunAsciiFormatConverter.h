@@ -72,6 +72,12 @@ namespace internal
     boost::optional<RawSparseData> parseSparseMatrixString(const std::string& matString);
     SparseData convertRaw(const RawSparseData& data);
   private:
+    /// Build the matrices from the contents of a file that is read once:
+    /// the numbers between the braces are parsed in place on all cores.
+    Core::Datatypes::SparseRowMatrixHandle makeSparse(const char* begin, const char* end);
+    Core::Datatypes::DenseMatrixHandle makeDense(const char* begin, const char* end);
+    Core::Datatypes::DenseColumnMatrixHandle makeColumn(const char* begin, const char* end);
+
     const Utility::ProgressReporter* reporter_;
   };
 
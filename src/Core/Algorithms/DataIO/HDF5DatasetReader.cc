@@ -0,0 +1,196 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+///
+///@file  HDF5DatasetReader.cc
+///
+///@brief Hyperslab and streaming reads of a single HDF5 dataset.
+///
+
+#include <Core/Algorithms/DataIO/HDF5DatasetReader.h>
+
+#ifdef HAVE_HDF5
+
+#include <algorithm>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::DataIO;
+
+HDF5Hyperslab
+HDF5Hyperslab::all(const std::vector<hsize_t>& dims)
+{
+  HDF5Hyperslab slab;
+  slab.start.assign(dims.size(), 0);
+  slab.stride.assign(dims.size(), 1);
+  slab.count = dims;
+  return slab;
+}
+
+hsize_t
+HDF5Hyperslab::size() const
+{
+  hsize_t n = 1;
+  for (size_t d = 0; d < count.size(); d++) n *= count[d];
+  return n;
+}
+
+bool
+HDF5Hyperslab::fits(const std::vector<hsize_t>& dims) const
+{
+  if (start.size() != dims.size() || stride.size() != dims.size() ||
+      count.size() != dims.size()) return false;
+
+  for (size_t d = 0; d < dims.size(); d++)
+  {
+    if (stride[d] == 0 || count[d] == 0) return false;
+    if (start[d] + (count[d]-1)*stride[d] >= dims[d]) return false;
+  }
+  return true;
+}
+
+HDF5DatasetReader::HDF5DatasetReader(hid_t dataset) :
+  dataset_(dataset), valid_(false), chunked_(false)
+{
+  hid_t space = H5Dget_space(dataset_);
+  if (space < 0) return;
+
+  int ndims = H5Sget_simple_extent_ndims(space);
+  if (ndims >= 0)
+  {
+    dims_.resize(ndims);
+    chunk_dims_.assign(ndims, 1);
+    if (ndims == 0 || H5Sget_simple_extent_dims(space, &dims_[0], NULL) == ndims)
+      valid_ = true;
+  }
+  H5Sclose(space);
+
+  hid_t plist = H5Dget_create_plist(dataset_);
+  if (plist >= 0)
+  {
+    if (ndims > 0 && H5Pget_layout(plist) == H5D_CHUNKED)
+      chunked_ = (H5Pget_chunk(plist, ndims, &chunk_dims_[0]) == ndims);
+    H5Pclose(plist);
+  }
+  if (!chunked_) chunk_dims_.assign(dims_.size(), 1);
+}
+
+bool
+HDF5DatasetReader::read(const HDF5Hyperslab& slab, hid_t mem_type, void* dest) const
+{
+  if (!valid_) return false;
+
+  // Scalar dataspace
+  if (dims_.empty())
+    return (H5Dread(dataset_, mem_type, H5S_ALL, H5S_ALL, H5P_DEFAULT, dest) >= 0);
+
+  if (!slab.fits(dims_)) return false;
+
+  hid_t file_space = H5Dget_space(dataset_);
+  if (file_space < 0) return false;
+
+  // The memory space is the dense extent of the selection, HDF5 converts
+  // from the file type while it copies the chunks into dest.
+  hid_t mem_space = -1;
+  bool ok = (H5Sselect_hyperslab(file_space, H5S_SELECT_SET, &slab.start[0],
+    &slab.stride[0], &slab.count[0], NULL) >= 0);
+
+  if (ok) ok = ((mem_space = H5Screate_simple(static_cast<int>(slab.rank()),
+    &slab.count[0], NULL)) >= 0);
+  if (ok) ok = (H5Dread(dataset_, mem_type, mem_space, file_space,
+    H5P_DEFAULT, dest) >= 0);
+
+  if (mem_space >= 0) H5Sclose(mem_space);
+  H5Sclose(file_space);
+  return ok;
+}
+
+DenseMatrixHandle
+HDF5DatasetReader::read_matrix(const HDF5Hyperslab& slab) const
+{
+  if (!valid_) return DenseMatrixHandle();
+
+  // Both HDF5 and DenseMatrix are row major, the selection is read into
+  // the storage of the matrix without an intermediate buffer.
+  hsize_t rows = 1, cols = 1;
+  if (!dims_.empty())
+  {
+    rows = slab.count.empty() ? 1 : slab.count[0];
+    for (size_t d = 1; d < slab.count.size(); d++) cols *= slab.count[d];
+  }
+
+  DenseMatrixHandle matrix(new DenseMatrix(rows, cols));
+  if (!read(slab, H5T_NATIVE_DOUBLE, matrix->data())) return DenseMatrixHandle();
+  return matrix;
+}
+
+bool
+HDF5DatasetReader::for_each_slab(const HDF5Hyperslab& slab, size_t dim,
+  hid_t mem_type, SlabVisitor visitor, size_t max_bytes) const
+{
+  if (!valid_ || dim >= dims_.size() || !slab.fits(dims_)) return false;
+
+  const size_t type_size = H5Tget_size(mem_type);
+  if (type_size == 0) return false;
+
+  // Bytes per entry along the streamed dimension
+  const hsize_t layer = (slab.size()/slab.count[dim])*type_size;
+
+  // Thickness of a slab in file coordinates: a whole number of chunk
+  // layers, as many as fit in max_bytes.
+  const hsize_t chunk = chunk_dims_[dim];
+  const hsize_t stride = slab.stride[dim];
+  hsize_t layers = max_bytes/std::max<hsize_t>(layer*((chunk + stride - 1)/stride), 1);
+  const hsize_t thickness = chunk*std::max<hsize_t>(layers, 1);
+
+  HDF5Hyperslab part = slab;
+  std::vector<char> buffer;
+
+  hsize_t first = 0;
+  while (first < slab.count[dim])
+  {
+    const hsize_t pos = slab.start[dim] + first*stride;
+    const hsize_t end = (pos/thickness + 1)*thickness;
+    const hsize_t n = std::min((end - pos + stride - 1)/stride, slab.count[dim] - first);
+
+    part.start[dim] = pos;
+    part.count[dim] = n;
+
+    const size_t bytes = static_cast<size_t>(n*layer);
+    if (buffer.size() < bytes) buffer.resize(bytes);
+    if (!read(part, mem_type, &buffer[0])) return false;
+    if (!visitor(part, first, &buffer[0])) break;
+
+    first += n;
+  }
+  return true;
+}
+
+#endif  // HAVE_HDF5
@@ -0,0 +1,121 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+///
+///@file  HDF5DatasetReader.h
+///
+///@brief Hyperslab and streaming reads of a single HDF5 dataset.
+///
+
+#ifndef ALGORITHMS_DATAIO_HDF5DATASETREADER_H
+#define ALGORITHMS_DATAIO_HDF5DATASETREADER_H
+
+#include <vector>
+#include <boost/function.hpp>
+
+#ifdef HAVE_HDF5
+
+#include "hdf5.h"
+
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Algorithms/DataIO/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace DataIO {
+
+/// A regular selection of a dataset, one start, stride and count per
+/// dimension, in the dimension order of the file.
+class SCISHARE HDF5Hyperslab {
+public:
+  /// The complete extent of a dataset
+  static HDF5Hyperslab all(const std::vector<hsize_t>& dims);
+
+  size_t rank() const { return count.size(); }
+  /// Number of elements selected
+  hsize_t size() const;
+  /// Whether the selection lies within a dataset of the given extent
+  bool fits(const std::vector<hsize_t>& dims) const;
+
+  std::vector<hsize_t> start;
+  std::vector<hsize_t> stride;
+  std::vector<hsize_t> count;
+};
+
+/// Reads selections of a dataset straight into caller provided memory. The
+/// reader does not own the dataset, it only has to stay open while the
+/// reader is in use.
+///
+/// Streaming visits a selection in slabs along one dimension. The slab
+/// boundaries are aligned with the chunks of the dataset, so every chunk is
+/// read from disk and decompressed once, and only one slab is held in memory.
+class SCISHARE HDF5DatasetReader {
+public:
+  /// Called with the part of the selection that was read, the index of its
+  /// first entry along the streamed dimension within the full selection and
+  /// the data. Return false to stop streaming.
+  typedef boost::function<bool (const HDF5Hyperslab&, hsize_t, const void*)> SlabVisitor;
+
+  explicit HDF5DatasetReader(hid_t dataset);
+
+  bool valid() const { return valid_; }
+
+  const std::vector<hsize_t>& dims() const { return dims_; }
+  /// Chunk dimensions, all ones for contiguous datasets
+  const std::vector<hsize_t>& chunk_dims() const { return chunk_dims_; }
+  bool chunked() const { return chunked_; }
+
+  /// Read the selection into dest, which has to hold slab.size() elements
+  /// of mem_type. The selection is stored densely in row major order.
+  bool read(const HDF5Hyperslab& slab, hid_t mem_type, void* dest) const;
+
+  /// Read the selection converted to doubles into a matrix. The first
+  /// dimension becomes the rows, the remaining ones the columns.
+  Datatypes::DenseMatrixHandle read_matrix(const HDF5Hyperslab& slab) const;
+
+  /// Stream the selection along dimension dim. Slabs hold about
+  /// max_bytes of data, but at least one layer of chunks.
+  bool for_each_slab(const HDF5Hyperslab& slab, size_t dim, hid_t mem_type,
+                     SlabVisitor visitor, size_t max_bytes = 64*1024*1024) const;
+
+private:
+  hid_t dataset_;
+  bool valid_;
+  bool chunked_;
+  std::vector<hsize_t> dims_;
+  std::vector<hsize_t> chunk_dims_;
+};
+
+}}}}
+
+#endif  // HAVE_HDF5
+
+#endif
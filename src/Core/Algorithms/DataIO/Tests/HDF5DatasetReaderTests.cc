@@ -0,0 +1,247 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/DataIO/HDF5DatasetReader.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+
+#include <boost/filesystem.hpp>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::DataIO;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // A chunked 3D dataset of doubles in a temporary file, every value
+  // encodes its position.
+  class TestFile
+  {
+  public:
+    TestFile(hsize_t ni, hsize_t nj, hsize_t nk, hsize_t ci, hsize_t cj, hsize_t ck)
+    {
+      name_ = (boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("hdf5reader-%%%%%%%%.h5")).string();
+      file_ = H5Fcreate(name_.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+
+      hsize_t dims[3] = { ni, nj, nk };
+      hsize_t chunks[3] = { ci, cj, ck };
+      hid_t space = H5Screate_simple(3, dims, NULL);
+      hid_t plist = H5Pcreate(H5P_DATASET_CREATE);
+      H5Pset_chunk(plist, 3, chunks);
+      dataset_ = H5Dcreate2(file_, "data", H5T_IEEE_F64LE, space, H5P_DEFAULT, plist, H5P_DEFAULT);
+      H5Pclose(plist);
+      H5Sclose(space);
+
+      // Written one layer at a time so that large files can be generated
+      std::vector<double> layer(nj*nk);
+      for (hsize_t i = 0; i < ni; i++)
+      {
+        for (hsize_t j = 0; j < nj; j++)
+          for (hsize_t k = 0; k < nk; k++) layer[j*nk+k] = value(i, j, k);
+
+        hsize_t start[3] = { i, 0, 0 };
+        hsize_t count[3] = { 1, nj, nk };
+        hid_t file_space = H5Dget_space(dataset_);
+        H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+        hid_t mem_space = H5Screate_simple(3, count, NULL);
+        H5Dwrite(dataset_, H5T_NATIVE_DOUBLE, mem_space, file_space, H5P_DEFAULT, &layer[0]);
+        H5Sclose(mem_space);
+        H5Sclose(file_space);
+      }
+    }
+
+    ~TestFile()
+    {
+      H5Dclose(dataset_);
+      H5Fclose(file_);
+      boost::filesystem::remove(name_);
+    }
+
+    static double value(hsize_t i, hsize_t j, hsize_t k)
+    {
+      return i*1e6 + j*1e3 + k;
+    }
+
+    hid_t dataset() const { return dataset_; }
+
+  private:
+    std::string name_;
+    hid_t file_;
+    hid_t dataset_;
+  };
+
+  HDF5Hyperslab slab(hsize_t i0, hsize_t si, hsize_t ni,
+                     hsize_t j0, hsize_t sj, hsize_t nj,
+                     hsize_t k0, hsize_t sk, hsize_t nk)
+  {
+    HDF5Hyperslab s;
+    s.start  = { i0, j0, k0 };
+    s.stride = { si, sj, sk };
+    s.count  = { ni, nj, nk };
+    return s;
+  }
+
+  struct Collector
+  {
+    std::vector<double>* values;
+    std::vector<hsize_t>* firsts;
+    size_t layer;
+
+    bool operator()(const HDF5Hyperslab& part, hsize_t first, const void* data)
+    {
+      const double* d = static_cast<const double*>(data);
+      firsts->push_back(first);
+      values->insert(values->end(), d, d + part.count[0]*layer);
+      return true;
+    }
+  };
+}
+
+TEST(HDF5DatasetReaderTests, ReportsChunkLayout)
+{
+  TestFile file(10, 6, 4, 3, 6, 4);
+  HDF5DatasetReader reader(file.dataset());
+
+  ASSERT_TRUE(reader.valid());
+  EXPECT_TRUE(reader.chunked());
+  EXPECT_EQ(std::vector<hsize_t>({ 10, 6, 4 }), reader.dims());
+  EXPECT_EQ(std::vector<hsize_t>({ 3, 6, 4 }), reader.chunk_dims());
+}
+
+TEST(HDF5DatasetReaderTests, ReadsStridedHyperslab)
+{
+  TestFile file(10, 6, 4, 3, 6, 4);
+  HDF5DatasetReader reader(file.dataset());
+
+  HDF5Hyperslab s = slab(1, 3, 3, 0, 2, 3, 1, 1, 2);
+  std::vector<double> data(s.size());
+  ASSERT_TRUE(reader.read(s, H5T_NATIVE_DOUBLE, &data[0]));
+
+  size_t n = 0;
+  for (hsize_t i = 0; i < 3; i++)
+    for (hsize_t j = 0; j < 3; j++)
+      for (hsize_t k = 0; k < 2; k++)
+        EXPECT_EQ(TestFile::value(1+3*i, 2*j, 1+k), data[n++]);
+}
+
+TEST(HDF5DatasetReaderTests, RejectsSelectionOutsideDataset)
+{
+  TestFile file(10, 6, 4, 3, 6, 4);
+  HDF5DatasetReader reader(file.dataset());
+
+  std::vector<double> data(100);
+  EXPECT_FALSE(reader.read(slab(1, 3, 4, 0, 1, 1, 0, 1, 1), H5T_NATIVE_DOUBLE, &data[0]));
+  EXPECT_FALSE(reader.read(slab(0, 1, 1, 0, 0, 1, 0, 1, 1), H5T_NATIVE_DOUBLE, &data[0]));
+}
+
+TEST(HDF5DatasetReaderTests, ReadsSelectionIntoMatrix)
+{
+  TestFile file(10, 6, 4, 3, 6, 4);
+  HDF5DatasetReader reader(file.dataset());
+
+  DenseMatrixHandle m = reader.read_matrix(slab(2, 1, 4, 1, 1, 2, 0, 1, 4));
+  ASSERT_TRUE(m != nullptr);
+  ASSERT_EQ(4, m->nrows());
+  ASSERT_EQ(8, m->ncols());
+  for (hsize_t i = 0; i < 4; i++)
+    for (hsize_t j = 0; j < 2; j++)
+      for (hsize_t k = 0; k < 4; k++)
+        EXPECT_EQ(TestFile::value(2+i, 1+j, k), (*m)(i, j*4+k));
+}
+
+TEST(HDF5DatasetReaderTests, StreamsChunkAlignedSlabs)
+{
+  TestFile file(20, 6, 4, 3, 6, 4);
+  HDF5DatasetReader reader(file.dataset());
+
+  HDF5Hyperslab s = slab(1, 2, 9, 0, 1, 6, 0, 1, 4);
+  std::vector<double> expected(s.size());
+  ASSERT_TRUE(reader.read(s, H5T_NATIVE_DOUBLE, &expected[0]));
+
+  // Room for a single chunk layer per slab
+  std::vector<double> streamed;
+  std::vector<hsize_t> firsts;
+  Collector c = { &streamed, &firsts, 24 };
+  ASSERT_TRUE(reader.for_each_slab(s, 0, H5T_NATIVE_DOUBLE, c, 1));
+
+  EXPECT_EQ(expected, streamed);
+  // Rows 1,3,5,...,17 split at the chunk boundaries 3,6,9,...
+  EXPECT_EQ(std::vector<hsize_t>({ 0, 1, 3, 4, 6, 7 }), firsts);
+}
+
+TEST(HDF5DatasetReaderTests, StreamingStopsWhenVisitorDeclines)
+{
+  TestFile file(20, 6, 4, 3, 6, 4);
+  HDF5DatasetReader reader(file.dataset());
+
+  int calls = 0;
+  auto visitor = [&calls](const HDF5Hyperslab&, hsize_t, const void*) { return ++calls < 2; };
+  EXPECT_TRUE(reader.for_each_slab(HDF5Hyperslab::all(reader.dims()), 0, H5T_NATIVE_DOUBLE, visitor, 1));
+  EXPECT_EQ(2, calls);
+}
+
+// Generates a dataset of about 4 GB, a time series of 256^2 slices, and
+// compares reading everything against a single hyperslab and streaming.
+TEST(HDF5DatasetReaderTests, DISABLED_LargeFileBenchmark)
+{
+  const hsize_t steps = 8192, n = 256;
+  std::unique_ptr<TestFile> file;
+  {
+    ScopedTimer t("generating file");
+    file.reset(new TestFile(steps, n, n, 16, n, n));
+  }
+  HDF5DatasetReader reader(file->dataset());
+
+  {
+    ScopedTimer t("one time step as a matrix");
+    DenseMatrixHandle m = reader.read_matrix(slab(steps/2, 1, 1, 0, 1, n, 0, 1, n));
+    EXPECT_EQ(TestFile::value(steps/2, 1, 1), (*m)(0, n+1));
+  }
+  {
+    ScopedTimer t("every 64th time step, strided hyperslab");
+    DenseMatrixHandle m = reader.read_matrix(slab(0, 64, steps/64, 0, 1, n, 0, 1, n));
+    EXPECT_EQ(TestFile::value(64, 0, 0), (*m)(1, 0));
+  }
+  {
+    ScopedTimer t("streaming the whole dataset in 64 MB slabs");
+    double sum = 0;
+    auto visitor = [&sum](const HDF5Hyperslab& part, hsize_t, const void* data)
+    {
+      const double* d = static_cast<const double*>(data);
+      for (hsize_t i = 0; i < part.size(); i++) sum += d[i];
+      return true;
+    };
+    EXPECT_TRUE(reader.for_each_slab(HDF5Hyperslab::all(reader.dims()), 0, H5T_NATIVE_DOUBLE, visitor));
+    EXPECT_GT(sum, 0);
+  }
+}
@@ -33,6 +33,9 @@
 #include <Core/Datatypes/MatrixComparison.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Algorithms/DataIO/ReadMatrix.h>
+#include <Core/Algorithms/DataIO/EigenMatrixFromScirunAsciiFormatConverter.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Utils/StringUtil.h>
 #include <boost/filesystem.hpp>
@@ -180,6 +183,48 @@ TEST(ReadMatrixAlgorithmTest, DISABLED_TestLargeSparseFromRealASCIIMatFile)
     FAIL() << "file " << AFile.string() << " does not exist, skipping test." << std::endl;
 }
 
+namespace
+{
+  boost::filesystem::path writeAsciiFile(const std::string& name, const std::string& contents)
+  {
+    auto filename = TestResources::rootDir() / "TransientOutput" / name;
+    std::ofstream out(filename.string().c_str());
+    out << "SCI\nASC\n2\n" << contents;
+    return filename;
+  }
+}
+
+TEST(ReadMatrixAlgorithmTest, AsciiConverterReadsAllMatrixTypes)
+{
+  using Core::Algorithms::DataIO::internal::EigenMatrixFromScirunAsciiFormatConverter;
+  EigenMatrixFromScirunAsciiFormatConverter converter;
+
+  auto sparse = converter.make(writeAsciiFile("sparseAscii.mat",
+    "{@1 SparseRowMatrix 3 {Matrix 3 {PropertyManager 2 0 }\n}\n2 3 4 {8 0 2 4 }{8 0 2 0 1 }{1 3.5 -1 2 }}\n").string());
+  ASSERT_TRUE(matrixIs::sparse(sparse));
+  DenseMatrix a(2, 3);
+  a << 1, 0, 3.5,
+    -1, 2, 0;
+  EXPECT_EQ(a, *convertMatrix::toDense(sparse));
+
+  auto dense = converter.make(writeAsciiFile("denseAscii.mat",
+    "{@1 DenseMatrix 3 {Matrix 3 {PropertyManager 2 0 }\n}\n2 3 {0 1 0 3.5 -1 2 0 }}\n").string());
+  ASSERT_TRUE(matrixIs::dense(dense));
+  EXPECT_EQ(a, *castMatrix::toDense(dense));
+
+  auto column = converter.make(writeAsciiFile("columnAscii.mat",
+    "{@1 ColumnMatrix 3 {Matrix 3 {PropertyManager 2 0 }\n}\n3 1e-3 2,-4.25 }\n").string());
+  ASSERT_TRUE(matrixIs::column(column));
+  auto col = castMatrix::toColumn(column);
+  ASSERT_EQ(3, col->rows());
+  EXPECT_DOUBLE_EQ(1e-3, (*col)[0]);
+  EXPECT_DOUBLE_EQ(-4.25, (*col)[2]);
+
+  EXPECT_THROW(converter.make(writeAsciiFile("badAscii.mat",
+    "{@1 DenseMatrix 3 {Matrix 3 {PropertyManager 2 0 }\n}\n2 3 {0 1 2 }}\n").string()),
+    Core::Algorithms::AlgorithmInputException);
+}
+
 TEST(ReadMatrixAlgorithmTest, UnknownFileFormatThrows)
 {
   ReadMatrixAlgorithm algo;
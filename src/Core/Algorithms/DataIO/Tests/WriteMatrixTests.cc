@@ -36,6 +36,9 @@
 #include <Core/Algorithms/DataIO/WriteMatrix.h>
 #include <Core/Algorithms/DataIO/ReadMatrix.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Utils/Legacy/MappedFile.h>
+#include <Core/Persistent/Pstreams.h>
+#include <Core/Persistent/PersistentSTL.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 
 using namespace SCIRun::TestUtils;
@@ -220,3 +223,164 @@ TEST(WriteMatrixAlgorithmTest, RoundTripRealBinaryFileDense)
   ASSERT_TRUE(dense5.get() != nullptr);
   EXPECT_EQ(*dense4, *dense5);
 }
+
+namespace
+{
+  class ScopedMapping
+  {
+  public:
+    explicit ScopedMapping(bool enable) : previous_(SCIRun::MappedFile::enabled())
+    {
+      SCIRun::MappedFile::set_enabled(enable);
+    }
+    ~ScopedMapping() { SCIRun::MappedFile::set_enabled(previous_); }
+  private:
+    bool previous_;
+  };
+}
+
+TEST(WriteMatrixAlgorithmTest, RoundTripLargeBinaryFileWithAndWithoutMapping)
+{
+  DenseMatrixHandle m(new DenseMatrix(DenseMatrix::Random(300, 200)));
+  auto file = TestResources::rootDir() / "TransientOutput" / "dense_mapped.mat";
+  writeMatrixToFile(m, file);
+
+  DenseMatrixHandle mapped, buffered;
+  {
+    ScopedMapping mapping(true);
+    mapped = readDenseMatrixFile(file);
+  }
+  {
+    ScopedMapping mapping(false);
+    buffered = readDenseMatrixFile(file);
+  }
+
+  ASSERT_TRUE(mapped.get() != nullptr);
+  ASSERT_TRUE(buffered.get() != nullptr);
+  EXPECT_EQ(*m, *mapped);
+  EXPECT_EQ(*m, *buffered);
+}
+
+namespace
+{
+  void writeMatrixToFile(const MatrixHandle& matrix, const boost::filesystem::path& filename, const std::string& type)
+  {
+    SCIRun::PiostreamPtr stream = SCIRun::auto_ostream(filename.string(), type);
+    ASSERT_FALSE(stream->error());
+    MatrixHandle m(matrix);
+    Pio(*stream, m);
+    EXPECT_FALSE(stream->error());
+  }
+}
+
+TEST(WriteMatrixAlgorithmTest, RoundTripCompressedFile)
+{
+  DenseMatrixHandle dense(new DenseMatrix(DenseMatrix::Random(500, 400)));
+  auto denseFile = TestResources::rootDir() / "TransientOutput" / "dense_compressed.mat";
+  writeMatrixToFile(dense, denseFile, "Compressed");
+  auto dense2 = readDenseMatrixFile(denseFile);
+  ASSERT_TRUE(dense2.get() != nullptr);
+  EXPECT_EQ(*dense, *dense2);
+
+  auto sparse = readSparseMatrixFile(TestResources::rootDir() / "Matrices" / "sparse_v4.mat");
+  ASSERT_TRUE(sparse.get() != nullptr);
+  auto sparseFile = TestResources::rootDir() / "TransientOutput" / "sparse_compressed.mat";
+  writeMatrixToFile(sparse, sparseFile, "Compressed");
+  auto sparse2 = readSparseMatrixFile(sparseFile);
+  ASSERT_TRUE(sparse2.get() != nullptr);
+  EXPECT_EQ(*sparse, *sparse2);
+}
+
+TEST(WriteMatrixAlgorithmTest, DISABLED_CompressedFileBenchmark)
+{
+  DenseMatrixHandle m(new DenseMatrix(4000, 4000));
+  for (int i = 0; i < m->rows(); ++i)
+    for (int j = 0; j < m->cols(); ++j)
+      (*m)(i, j) = std::sin(0.001 * i) * std::cos(0.002 * j);
+
+  const std::string types[] = { "Binary", "Compressed" };
+  for (const auto& type : types)
+  {
+    auto file = TestResources::rootDir() / "TransientOutput" / ("benchmark_" + type + ".mat");
+    {
+      ScopedTimer t("write " + type);
+      writeMatrixToFile(m, file, type);
+    }
+    {
+      ScopedTimer t("read " + type);
+      readDenseMatrixFile(file);
+    }
+    std::cout << type << " file size: " << boost::filesystem::file_size(file) << std::endl;
+  }
+}
+
+namespace
+{
+  // Writes the file a machine of the other byte order would write: the
+  // header says BIG and every element of two or more bytes is reversed.
+  class ForeignEndianPiostream : public SCIRun::BinaryPiostream
+  {
+  public:
+    explicit ForeignEndianPiostream(const std::string& filename)
+      : BinaryPiostream(Write, filename, SCIRun::Core::Logging::LoggerHandle())
+    {
+      fp_ = fopen(filename.c_str(), "wb");
+      char hdr[17];
+      sprintf(hdr, "SCI\nBIN\n%03d\nBIG\n", version());
+      if (!fp_ || fwrite(hdr, 1, 16, fp_) != 16) err = true;
+    }
+  protected:
+    size_t write_data(const void* data, size_t size, size_t nmemb) override
+    {
+      const char* p = static_cast<const char*>(data);
+      std::vector<char> swapped(size*nmemb);
+      for (size_t i = 0; i < nmemb; ++i)
+        std::reverse_copy(p + i*size, p + (i+1)*size, swapped.begin() + i*size);
+      return fwrite(swapped.data(), size, nmemb, fp_);
+    }
+  };
+}
+
+TEST(WriteMatrixAlgorithmTest, ReadForeignEndianBlocks)
+{
+  // Larger than the 64 KB swap chunks, and not a multiple of them
+  std::vector<double> values(100003);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i] = 1000.0 * std::sin(0.01 * i);
+  std::vector<SCIRun::index_type> indices(70001);
+  for (size_t i = 0; i < indices.size(); ++i)
+    indices[i] = static_cast<SCIRun::index_type>(i) * 65537 + ((i % 7) ? 0 : 5000000000LL);
+  DenseMatrixHandle dense(new DenseMatrix(DenseMatrix::Random(300, 200)));
+
+  auto file = TestResources::rootDir() / "TransientOutput" / "foreign_endian.pio";
+  {
+    ForeignEndianPiostream stream(file.string());
+    ASSERT_FALSE(stream.error());
+    SCIRun::Pio(stream, values);
+    SCIRun::Pio_index(stream, indices);
+    MatrixHandle m(dense);
+    Pio(stream, m);
+    ASSERT_FALSE(stream.error());
+  }
+
+  for (bool mapped : { true, false })
+  {
+    ScopedMapping mapping(mapped);
+    SCIRun::PiostreamPtr stream = SCIRun::auto_istream(file.string());
+    ASSERT_TRUE(stream && !stream->error());
+    EXPECT_TRUE(dynamic_cast<SCIRun::BinarySwapPiostream*>(stream.get()) != nullptr);
+
+    std::vector<double> readValues;
+    std::vector<SCIRun::index_type> readIndices;
+    MatrixHandle readMatrix;
+    SCIRun::Pio(*stream, readValues);
+    SCIRun::Pio_index(*stream, readIndices);
+    Pio(*stream, readMatrix);
+    EXPECT_FALSE(stream->error());
+
+    EXPECT_EQ(values, readValues);
+    EXPECT_EQ(indices, readIndices);
+    ASSERT_TRUE(readMatrix.get() != nullptr);
+    EXPECT_EQ(*dense, *castMatrix::toDense(readMatrix));
+  }
+}
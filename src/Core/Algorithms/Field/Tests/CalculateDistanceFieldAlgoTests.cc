@@ -0,0 +1,190 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateSignedDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/RegularGridDistance.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // The surface of [0,1]x[0,1]x[-1,0]
+  FieldHandle cube()
+  {
+    return CubeTriSurfLinearBasis(DOUBLE_E);
+  }
+
+  // Offset so that no grid plane contains a face of the cube, points in
+  // those planes have no well defined sign.
+  FieldHandle grid(size_type n, data_info_type type = DOUBLE_E)
+  {
+    return CreateEmptyLatVol(n, n, n, type, Point(-0.53, -0.47, -1.52), Point(1.47, 1.53, 0.48));
+  }
+
+  FieldHandle distance(FieldHandle input, const std::string& method, bool truncate = false, double max = 1.0)
+  {
+    CalculateDistanceFieldAlgo algo;
+    algo.setOption(Parameters::DistanceMethod, method);
+    algo.set(Parameters::Truncate, truncate);
+    algo.set(Parameters::TruncateDistance, max);
+    FieldHandle output;
+    EXPECT_TRUE(algo.runImpl(input, cube(), output));
+    return output;
+  }
+
+  FieldHandle signedDistance(FieldHandle input, const std::string& method)
+  {
+    CalculateSignedDistanceFieldAlgo algo;
+    algo.setOption(Parameters::DistanceMethod, method);
+    FieldHandle output;
+    EXPECT_TRUE(algo.run(input, cube(), output));
+    return output;
+  }
+}
+
+TEST(CalculateDistanceFieldAlgoTests, FastSweepingMatchesClosestElementSearchOnLatVol)
+{
+  const size_type n = 21;
+  const double h = 2.0/(n-1);
+  auto exact = FieldValues(distance(grid(n), "brute force"));
+  auto fast = FieldValues(distance(grid(n), "fast sweeping"));
+
+  ASSERT_EQ(exact.size(), fast.size());
+  double maxError = 0;
+  for (size_t i = 0; i < exact.size(); ++i)
+    maxError = std::max(maxError, std::fabs(exact[i] - fast[i]));
+  EXPECT_LT(maxError, 0.25*h);
+}
+
+TEST(CalculateDistanceFieldAlgoTests, FastSweepingOnCellCenters)
+{
+  const size_type n = 16;
+  FieldHandle input = grid(n);
+  FieldInformation fi(input);
+  fi.make_constantdata();
+  input = CreateField(fi, input->mesh());
+
+  auto exact = FieldValues(distance(input, "brute force"));
+  auto fast = FieldValues(distance(input, "fast sweeping"));
+
+  ASSERT_EQ((n-1)*(n-1)*(n-1), fast.size());
+  for (size_t i = 0; i < exact.size(); ++i)
+    EXPECT_NEAR(exact[i], fast[i], 0.25*2.0/(n-1));
+}
+
+TEST(CalculateDistanceFieldAlgoTests, FastSweepingHonorsTruncation)
+{
+  auto fast = FieldValues(distance(grid(17), "fast sweeping", true, 0.3));
+  auto exact = FieldValues(distance(grid(17), "brute force", true, 0.3));
+  for (size_t i = 0; i < fast.size(); ++i)
+  {
+    EXPECT_LE(fast[i], 0.3);
+    if (exact[i] < 0.3)
+    {
+      EXPECT_NEAR(exact[i], fast[i], 0.05);
+    }
+  }
+}
+
+// The sweeps leave grid points beyond the truncation distance alone
+TEST(CalculateDistanceFieldAlgoTests, FastSweepingStopsAtTruncationDistance)
+{
+  FieldHandle input = grid(33);
+  FieldHandle object = cube();
+  object->vmesh()->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+
+  RegularGridDistance sweeping(input->vmesh(), 1);
+  ASSERT_TRUE(sweeping.is_valid());
+  sweeping.compute(object->vmesh(), nullptr, 2.0, 0.2);
+  auto exact = FieldValues(distance(input, "brute force"));
+
+  size_t unreached = 0;
+  for (VMesh::index_type idx = 0; idx < sweeping.size(); ++idx)
+  {
+    if (sweeping.source(idx) < 0)
+    {
+      ++unreached;
+      EXPECT_EQ(DBL_MAX, sweeping.distance(idx));
+      EXPECT_GT(exact[idx], 0.2);
+    }
+  }
+  EXPECT_GT(unreached, sweeping.size()/2);
+}
+
+TEST(CalculateDistanceFieldAlgoTests, UnstructuredDestinationUsesClosestElementSearch)
+{
+  auto exact = FieldValues(distance(CreateTetVolGrid(4, false, 1), "brute force"));
+  auto fast = FieldValues(distance(CreateTetVolGrid(4, false, 1), "fast sweeping"));
+  EXPECT_EQ(exact, fast);
+}
+
+TEST(CalculateDistanceFieldAlgoTests, SignedFastSweepingMatchesClosestElementSearch)
+{
+  const size_type n = 21;
+  const double h = 2.0/(n-1);
+  auto exact = FieldValues(signedDistance(grid(n), "brute force"));
+  auto fast = FieldValues(signedDistance(grid(n), "fast sweeping"));
+
+  ASSERT_EQ(exact.size(), fast.size());
+  for (size_t i = 0; i < exact.size(); ++i)
+  {
+    EXPECT_NEAR(std::fabs(exact[i]), std::fabs(fast[i]), 0.25*h);
+    if (std::fabs(exact[i]) > h)
+    {
+      EXPECT_EQ(exact[i] < 0, fast[i] < 0) << " at " << i;
+    }
+  }
+}
+
+TEST(CalculateDistanceFieldAlgoTests, DISABLED_FastSweepingBenchmark)
+{
+  const size_type n = 128;
+  {
+    ScopedTimer t("closest element search");
+    distance(grid(n), "brute force");
+  }
+  {
+    ScopedTimer t("fast sweeping");
+    distance(grid(n), "fast sweeping");
+  }
+}
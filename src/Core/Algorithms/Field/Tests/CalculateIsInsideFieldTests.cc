@@ -0,0 +1,195 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateIsInsideField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateInsideWhichField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/SurfaceWindingNumber.h>
+#include <Core/Algorithms/Legacy/Fields/MeshDerivatives/GetFieldBoundaryAlgo.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Unit cube as a volume and as its boundary surface
+  FieldHandle cubeVolume(size_type n)
+  {
+    return CreateTetVolGrid(n, false, 1);
+  }
+
+  FieldHandle cubeSurface(size_type n)
+  {
+    GetFieldBoundaryAlgo algo;
+    FieldHandle boundary;
+    EXPECT_TRUE(algo.run(cubeVolume(n), boundary));
+    return boundary;
+  }
+
+  // Offset so that no samples fall on the faces of the cube
+  FieldHandle grid(size_type n)
+  {
+    return CreateEmptyLatVol(n, n, n, DOUBLE_E, Point(-0.27, -0.23, -0.31), Point(1.33, 1.29, 1.21));
+  }
+
+  FieldHandle isInside(FieldHandle input, FieldHandle object, const std::string& test, const std::string& method)
+  {
+    CalculateIsInsideFieldAlgo algo;
+    algo.setOption(Parameters::InsideTest, test);
+    algo.setOption(Parameters::CalcInsideMethod, method);
+    FieldHandle output;
+    EXPECT_TRUE(algo.runImpl(input, object, output));
+    return output;
+  }
+}
+
+TEST(SurfaceWindingNumberTests, ClosedSurface)
+{
+  SurfaceWindingNumber winding(CubeTriSurfLinearBasis(DOUBLE_E)->vmesh());
+  ASSERT_TRUE(winding.is_valid());
+
+  EXPECT_NEAR(1.0, std::fabs(winding.winding_number(Point(0.5, 0.5, -0.5))), 1e-6);
+  EXPECT_NEAR(1.0, std::fabs(winding.winding_number(Point(0.9, 0.1, -0.05))), 1e-6);
+  EXPECT_NEAR(0.0, winding.winding_number(Point(1.5, 0.5, -0.5)), 1e-6);
+  EXPECT_NEAR(0.0, winding.winding_number(Point(10, -20, 30)), 1e-3);
+  EXPECT_TRUE(winding.is_inside(Point(0.25, 0.75, -0.5)));
+  EXPECT_FALSE(winding.is_inside(Point(0.25, 0.75, 0.5)));
+}
+
+TEST(SurfaceWindingNumberTests, SurfaceWithHole)
+{
+  FieldHandle cube = cubeSurface(8);
+  VMesh* mesh = cube->vmesh();
+
+  // Drop one face triangle
+  FieldInformation fi("TriSurfMesh", 1, "double");
+  FieldHandle open = CreateField(fi);
+  VMesh* omesh = open->vmesh();
+  for (VMesh::Node::index_type n = 0; n < mesh->num_nodes(); n++)
+  {
+    Point p;
+    mesh->get_center(p, n);
+    omesh->add_point(p);
+  }
+  VMesh::Node::array_type nodes;
+  for (VMesh::Elem::index_type e = 1; e < mesh->num_elems(); e++)
+  {
+    mesh->get_nodes(nodes, e);
+    omesh->add_elem(nodes);
+  }
+
+  SurfaceWindingNumber winding(omesh);
+  EXPECT_TRUE(winding.is_inside(Point(0.5, 0.5, 0.5)));
+  EXPECT_TRUE(winding.is_inside(Point(0.3, 0.6, 0.2)));
+  EXPECT_FALSE(winding.is_inside(Point(1.5, 0.5, 0.5)));
+  EXPECT_FALSE(winding.is_inside(Point(-0.2, -0.1, 0.5)));
+}
+
+TEST(SurfaceWindingNumberTests, RejectsVolumeMesh)
+{
+  SurfaceWindingNumber winding(cubeVolume(2)->vmesh());
+  EXPECT_FALSE(winding.is_valid());
+}
+
+TEST(CalculateIsInsideFieldAlgoTests, WindingNumberMatchesLocate)
+{
+  FieldHandle volume = cubeVolume(6);
+  FieldHandle surface = cubeSurface(6);
+
+  for (const std::string method : { "one", "most", "all" })
+  {
+    auto locate = FieldValues(isInside(grid(12), volume, "locate", method));
+    auto winding = FieldValues(isInside(grid(12), surface, "winding number", method));
+    EXPECT_EQ(locate, winding) << method;
+    EXPECT_GT(std::count(winding.begin(), winding.end(), 1.0), 0);
+  }
+}
+
+TEST(CalculateIsInsideFieldAlgoTests, WindingNumberOnVolumeObjectFallsBackToLocate)
+{
+  FieldHandle volume = cubeVolume(4);
+  auto locate = FieldValues(isInside(grid(8), volume, "locate", "most"));
+  auto winding = FieldValues(isInside(grid(8), volume, "winding number", "most"));
+  EXPECT_EQ(locate, winding);
+}
+
+TEST(CalculateInsideWhichFieldAlgoTests, LabelsNestedObjects)
+{
+  // Second object is the half of the cube with z < 0.5
+  FieldHandle outer = cubeSurface(4);
+  FieldHandle inner = cubeSurface(4);
+  Transform scale;
+  scale.pre_scale(Vector(1, 1, 0.5));
+  inner->vmesh()->transform(scale);
+
+  FieldList objects { outer, inner };
+
+  CalculateInsideWhichFieldAlgo algo;
+  algo.setOption(Parameters::InsideTest, "winding number");
+  algo.setOption(Parameters::DataLocation, "node");
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(grid(9), objects, output));
+
+  VMesh* omesh = output->vmesh();
+  for (VMesh::Node::index_type n = 0; n < omesh->num_nodes(); n++)
+  {
+    Point p;
+    omesh->get_center(p, n);
+    double value;
+    output->vfield()->get_value(value, n);
+
+    const bool in_outer = p.x() > 0 && p.x() < 1 && p.y() > 0 && p.y() < 1 && p.z() > 0 && p.z() < 1;
+    const bool in_inner = in_outer && p.z() < 0.5;
+    EXPECT_EQ(in_inner ? 2.0 : (in_outer ? 1.0 : 0.0), value) << p;
+  }
+}
+
+TEST(CalculateIsInsideFieldAlgoTests, DISABLED_WindingNumberBenchmark)
+{
+  FieldHandle volume = cubeVolume(24);
+  FieldHandle surface = cubeSurface(24);
+  {
+    ScopedTimer t("locate");
+    isInside(grid(64), volume, "locate", "most");
+  }
+  {
+    ScopedTimer t("winding number");
+    isInside(grid(64), surface, "winding number", "most");
+  }
+}
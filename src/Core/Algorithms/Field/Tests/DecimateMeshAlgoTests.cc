@@ -0,0 +1,214 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Legacy/Fields/DecimateMesh/DecimateMesh.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // A gently curved height field of n x n cells, quads or two triangles per
+  // cell. Node data are set to x, element data to the element index.
+  FieldHandle CreateHeightField(int n, bool quads, bool nodeData)
+  {
+    FieldInformation fi(quads ? QUADSURFMESH_E : TRISURFMESH_E,
+      nodeData ? LINEARDATA_E : CONSTANTDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    auto mesh = field->vmesh();
+
+    for (int j = 0; j <= n; j++)
+      for (int i = 0; i <= n; i++)
+      {
+        const double x = double(i)/n, y = double(j)/n;
+        mesh->add_point(Point(x, y, 0.2*std::sin(3.0*x)*std::cos(2.0*y)));
+      }
+
+    VMesh::Node::array_type nodes;
+    for (int j = 0; j < n; j++)
+      for (int i = 0; i < n; i++)
+      {
+        const VMesh::index_type a = j*(n+1) + i, b = a + 1, c = a + n + 2, d = a + n + 1;
+        if (quads)
+        {
+          nodes.resize(4);
+          nodes[0] = a; nodes[1] = b; nodes[2] = c; nodes[3] = d;
+          mesh->add_elem(nodes);
+        }
+        else
+        {
+          nodes.resize(3);
+          nodes[0] = a; nodes[1] = b; nodes[2] = c;
+          mesh->add_elem(nodes);
+          nodes[1] = c; nodes[2] = d;
+          mesh->add_elem(nodes);
+        }
+      }
+
+    auto vfield = field->vfield();
+    vfield->resize_values();
+    if (nodeData)
+    {
+      Point p;
+      for (VMesh::Node::index_type idx = 0; idx < mesh->num_nodes(); idx++)
+      {
+        mesh->get_center(p, idx);
+        vfield->set_value(p.x(), idx);
+      }
+    }
+    else
+    {
+      for (VMesh::Elem::index_type idx = 0; idx < mesh->num_elems(); idx++)
+        vfield->set_value(static_cast<double>(idx), idx);
+    }
+    return field;
+  }
+}
+
+TEST(DecimateMeshAlgoTests, ReducesToTargetAndInterpolatesNodeData)
+{
+  auto input = CreateHeightField(40, false, true);
+
+  DecimateMeshAlgo algo;
+  algo.set(Parameters::TargetElementCount, 400);
+  FieldHandle output;
+  MatrixHandle mapping;
+  ASSERT_TRUE(algo.runImpl(input, output, mapping));
+
+  auto omesh = output->vmesh();
+  EXPECT_LE(omesh->num_elems(), 400);
+  EXPECT_GT(omesh->num_elems(), 200);
+  EXPECT_LT(omesh->num_nodes(), input->vmesh()->num_nodes());
+
+  // The corners of the boundary stay in place
+  BBox ibox = input->vmesh()->get_bounding_box();
+  BBox obox = omesh->get_bounding_box();
+  EXPECT_NEAR(ibox.get_min().x(), obox.get_min().x(), 1e-12);
+  EXPECT_NEAR(ibox.get_max().y(), obox.get_max().y(), 1e-12);
+
+  // new = Mapping * old
+  auto sparse = castMatrix::toSparse(mapping);
+  ASSERT_TRUE(sparse != nullptr);
+  ASSERT_EQ(omesh->num_nodes(), sparse->nrows());
+  ASSERT_EQ(input->vmesh()->num_nodes(), sparse->ncols());
+
+  DenseColumnMatrix in(input->vmesh()->num_nodes()), out(omesh->num_nodes());
+  for (VMesh::Node::index_type idx = 0; idx < input->vmesh()->num_nodes(); idx++)
+    input->vfield()->get_value(in[idx], idx);
+  for (VMesh::Node::index_type idx = 0; idx < omesh->num_nodes(); idx++)
+    output->vfield()->get_value(out[idx], idx);
+  DenseColumnMatrix mapped = *sparse * in;
+  EXPECT_TRUE(mapped.isApprox(out));
+
+  // Interpolated node data stay close to x of the node
+  Point p;
+  for (VMesh::Node::index_type idx = 0; idx < omesh->num_nodes(); idx++)
+  {
+    omesh->get_center(p, idx);
+    EXPECT_NEAR(p.x(), out[idx], 0.1);
+  }
+}
+
+TEST(DecimateMeshAlgoTests, QuadSurfBecomesTriSurfWithElementData)
+{
+  auto input = CreateHeightField(30, true, false);
+
+  DecimateMeshAlgo algo;
+  algo.set(Parameters::TargetElementCount, 300);
+  auto result = algo.run(withInputData((Variables::InputField, input)));
+  auto output = result.get<Field>(Variables::OutputField);
+  ASSERT_TRUE(output != nullptr);
+
+  FieldInformation fi(output);
+  EXPECT_TRUE(fi.is_trisurfmesh());
+  EXPECT_TRUE(fi.is_constantdata());
+  EXPECT_LE(output->vmesh()->num_elems(), 300);
+
+  // Every triangle carries the index of the quad it was cut from
+  auto mapping = castMatrix::toSparse(result.get<Matrix>(DecimateMeshAlgo::Mapping));
+  ASSERT_TRUE(mapping != nullptr);
+  ASSERT_EQ(output->vmesh()->num_elems(), mapping->nrows());
+  for (VMesh::Elem::index_type idx = 0; idx < output->vmesh()->num_elems(); idx++)
+  {
+    double value;
+    output->vfield()->get_value(value, idx);
+    EXPECT_GE(value, 0.0);
+    EXPECT_LT(value, 900.0);
+    EXPECT_EQ(1, mapping->row(idx).nonZeros());
+  }
+}
+
+TEST(DecimateMeshAlgoTests, MaximumErrorLimitsDecimation)
+{
+  auto input = CreateHeightField(20, false, true);
+
+  DecimateMeshAlgo algo;
+  algo.set(Parameters::TargetElementCount, 0);
+  algo.set(Parameters::MaximumDecimationError, 1e-9);
+  FieldHandle loose, tight;
+  ASSERT_TRUE(algo.runImpl(input, tight));
+  algo.set(Parameters::MaximumDecimationError, 1e-2);
+  ASSERT_TRUE(algo.runImpl(input, loose));
+
+  EXPECT_LT(loose->vmesh()->num_elems(), tight->vmesh()->num_elems());
+}
+
+TEST(DecimateMeshAlgoTests, LevelsShrinkByAboutFour)
+{
+  auto input = CreateHeightField(64, false, true);
+
+  DecimateMeshAlgo algo;
+  std::vector<FieldHandle> levels;
+  ASSERT_TRUE(algo.runLevels(input, 4, levels));
+  ASSERT_EQ(4, levels.size());
+  EXPECT_EQ(input, levels[0]);
+  for (size_t k = 1; k < levels.size(); k++)
+  {
+    EXPECT_LE(4 * levels[k]->vmesh()->num_elems(), levels[k-1]->vmesh()->num_elems() + 4);
+    EXPECT_GT(8 * levels[k]->vmesh()->num_elems(), levels[k-1]->vmesh()->num_elems());
+  }
+}
+
+TEST(DecimateMeshAlgoTests, RejectsVolumeMesh)
+{
+  DecimateMeshAlgo algo;
+  FieldHandle output;
+  EXPECT_FALSE(algo.runImpl(CreateTetVolGrid(3, false, 0), output));
+}
@@ -36,6 +36,7 @@ last change: 04/21/2015
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Algorithms/Legacy/Fields/MeshDerivatives/ExtractSimpleIsosurfaceAlgo.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
@@ -101,3 +102,17 @@ TEST(ExtractSimpleIsoSurfaceAlgoTest, ExtractSimpleIsoSurf_LatVol_DataOnNodes)
   EXPECT_EQ(output->vmesh()->num_elems(),3);
   EXPECT_EQ(output->vfield()->num_values(),5);
 }
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, CoarseSampleStrideLimitsLargestDimension)
+{
+  EXPECT_EQ(1, ExtractSimpleIsosurfaceAlgo::coarseSampleStride(CreateEmptyLatVol(65, 10, 10), 64));
+  EXPECT_EQ(2, ExtractSimpleIsosurfaceAlgo::coarseSampleStride(CreateEmptyLatVol(10, 66, 10), 64));
+  EXPECT_EQ(3, ExtractSimpleIsosurfaceAlgo::coarseSampleStride(CreateEmptyLatVol(10, 10, 130), 64));
+  EXPECT_EQ(1, ExtractSimpleIsosurfaceAlgo::coarseSampleStride(LoadInTetrahedrals(), 2));
+}
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, CoarsePreviewIsOffByDefault)
+{
+  ExtractSimpleIsosurfaceAlgo algo;
+  EXPECT_FALSE(algo.get(Parameters::IsosurfaceCoarseToFine).toBool());
+}
@@ -0,0 +1,230 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/MarchingCubes.h>
+#include <Core/Thread/Parallel.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+
+#include <set>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  const Point center(0.1, -0.05, 0.02);
+
+  // Distance to a point, sampled on the nodes
+  FieldHandle sphere(FieldHandle field)
+  {
+    VMesh* mesh = field->vmesh();
+    VField* vfield = field->vfield();
+    for (VMesh::Node::index_type n = 0; n < mesh->num_nodes(); n++)
+    {
+      Point p;
+      mesh->get_center(p, n);
+      vfield->set_value((p - center).length(), n);
+    }
+    return field;
+  }
+
+  FieldHandle latVolSphere(size_type n)
+  {
+    return sphere(CreateEmptyLatVol(n, n, n, DOUBLE_E, Point(-1, -1, -1), Point(1, 1, 1)));
+  }
+
+  FieldHandle isosurface(FieldHandle input, const std::vector<double>& isovalues, int threads)
+  {
+    MarchingCubesAlgo algo;
+    algo.set(MarchingCubesAlgo::build_field, true);
+    algo.set(MarchingCubesAlgo::num_threads, threads);
+    FieldHandle output;
+    EXPECT_TRUE(algo.run(input, isovalues, output));
+    return output;
+  }
+
+  size_t uniquePoints(FieldHandle field)
+  {
+    std::set<std::tuple<double, double, double>> points;
+    VMesh* mesh = field->vmesh();
+    for (VMesh::Node::index_type n = 0; n < mesh->num_nodes(); n++)
+    {
+      Point p;
+      mesh->get_center(p, n);
+      points.insert(std::make_tuple(p.x(), p.y(), p.z()));
+    }
+    return points.size();
+  }
+}
+
+TEST(MarchingCubesAlgoTests, LatVolIsosurfaceLiesOnSphere)
+{
+  const size_type n = 24;
+  const double h = 2.0/(n-1);
+  FieldHandle output = isosurface(latVolSphere(n), { 0.6 }, 1);
+
+  VMesh* mesh = output->vmesh();
+  ASSERT_GT(mesh->num_elems(), 0);
+  for (VMesh::Node::index_type i = 0; i < mesh->num_nodes(); i++)
+  {
+    Point p;
+    mesh->get_center(p, i);
+    EXPECT_NEAR(0.6, (p - center).length(), h*h);
+  }
+}
+
+TEST(MarchingCubesAlgoTests, ThreadsWeldSharedVertices)
+{
+  FieldHandle input = latVolSphere(33);
+  FieldHandle serial = isosurface(input, { 0.45 }, 1);
+
+  for (int threads : { 2, 3, 8 })
+  {
+    FieldHandle parallel = isosurface(input, { 0.45 }, threads);
+    EXPECT_EQ(serial->vmesh()->num_nodes(), parallel->vmesh()->num_nodes()) << threads;
+    EXPECT_EQ(serial->vmesh()->num_elems(), parallel->vmesh()->num_elems()) << threads;
+    EXPECT_EQ(static_cast<size_t>(parallel->vmesh()->num_nodes()), uniquePoints(parallel)) << threads;
+  }
+}
+
+TEST(MarchingCubesAlgoTests, ThreadsWeldSharedVerticesOnTetVol)
+{
+  FieldHandle input = sphere(CreateTetVolGrid(10, true, 1));
+  FieldHandle serial = isosurface(input, { 0.5 }, 1);
+  FieldHandle parallel = isosurface(input, { 0.5 }, 4);
+
+  ASSERT_GT(serial->vmesh()->num_elems(), 0);
+  EXPECT_EQ(serial->vmesh()->num_nodes(), parallel->vmesh()->num_nodes());
+  EXPECT_EQ(serial->vmesh()->num_elems(), parallel->vmesh()->num_elems());
+}
+
+TEST(MarchingCubesAlgoTests, MoreThreadsThanTheUserAllowsKeepsAllTriangles)
+{
+  FieldHandle input = latVolSphere(33);
+  FieldHandle serial = isosurface(input, { 0.45 }, 1);
+
+  Core::Thread::Parallel::SetMaximumCores(2);
+  FieldHandle capped = isosurface(input, { 0.45 }, 8);
+  Core::Thread::Parallel::SetMaximumCores(0);
+
+  EXPECT_EQ(serial->vmesh()->num_nodes(), capped->vmesh()->num_nodes());
+  EXPECT_EQ(serial->vmesh()->num_elems(), capped->vmesh()->num_elems());
+}
+
+TEST(MarchingCubesAlgoTests, MultipleIsovaluesAreKeptApart)
+{
+  FieldHandle input = latVolSphere(20);
+  FieldHandle inner = isosurface(input, { 0.3 }, 4);
+  FieldHandle outer = isosurface(input, { 0.7 }, 4);
+  FieldHandle both = isosurface(input, { 0.3, 0.7 }, 4);
+
+  EXPECT_EQ(inner->vmesh()->num_nodes() + outer->vmesh()->num_nodes(), both->vmesh()->num_nodes());
+  EXPECT_EQ(inner->vmesh()->num_elems() + outer->vmesh()->num_elems(), both->vmesh()->num_elems());
+}
+
+TEST(MarchingCubesAlgoTests, IsovalueOutsideRangeGivesEmptySurface)
+{
+  FieldHandle output = isosurface(latVolSphere(10), { 5.0 }, 4);
+  EXPECT_EQ(0, output->vmesh()->num_elems());
+}
+
+TEST(MarchingCubesAlgoTests, SubsampledLatVolGivesCoarseSurfaceOnSphere)
+{
+  const size_type n = 49;
+  const int stride = 4;
+  FieldHandle input = latVolSphere(n);
+  FieldHandle fine = isosurface(input, { 0.6 }, 4);
+
+  MarchingCubesAlgo algo;
+  algo.set(MarchingCubesAlgo::build_field, true);
+  algo.set(MarchingCubesAlgo::sample_stride, stride);
+  FieldHandle coarse;
+  ASSERT_TRUE(algo.run(input, { 0.6 }, coarse));
+
+  VMesh* mesh = coarse->vmesh();
+  ASSERT_GT(mesh->num_elems(), 0);
+  EXPECT_LT(4*mesh->num_elems(), fine->vmesh()->num_elems());
+
+  const double h = stride*2.0/(n-1);
+  for (VMesh::Node::index_type i = 0; i < mesh->num_nodes(); i++)
+  {
+    Point p;
+    mesh->get_center(p, i);
+    EXPECT_NEAR(0.6, (p - center).length(), h*h);
+  }
+}
+
+TEST(MarchingCubesAlgoTests, SampleStrideIsIgnoredForTetVol)
+{
+  FieldHandle input = sphere(CreateTetVolGrid(10, true, 1));
+  FieldHandle full = isosurface(input, { 0.5 }, 1);
+
+  MarchingCubesAlgo algo;
+  algo.set(MarchingCubesAlgo::build_field, true);
+  algo.set(MarchingCubesAlgo::sample_stride, 4);
+  FieldHandle output;
+  ASSERT_TRUE(algo.run(input, { 0.5 }, output));
+  EXPECT_EQ(full->vmesh()->num_elems(), output->vmesh()->num_elems());
+}
+
+TEST(MarchingCubesAlgoTests, DISABLED_ManyIsovaluesBenchmark)
+{
+  FieldHandle input = latVolSphere(256);
+  std::vector<double> isovalues;
+  for (int i = 1; i <= 24; i++) isovalues.push_back(0.05*i);
+
+  ScopedTimer t("24 isovalues on 256^3");
+  isosurface(input, isovalues, -1);
+}
+
+// The preview that ExtractSimpleIsosurface sends while an isovalue is
+// dragged, 512^3 subsampled to 65^3.
+TEST(MarchingCubesAlgoTests, DISABLED_CoarsePreviewBenchmark)
+{
+  FieldHandle input = latVolSphere(512);
+  MarchingCubesAlgo algo;
+  algo.set(MarchingCubesAlgo::build_field, true);
+  algo.set(MarchingCubesAlgo::sample_stride, 8);
+
+  for (double iso : { 0.3, 0.5, 0.7 })
+  {
+    FieldHandle output;
+    ScopedTimer t("isosurface of 512^3 subsampled by 8");
+    algo.run(input, { iso }, output);
+  }
+}
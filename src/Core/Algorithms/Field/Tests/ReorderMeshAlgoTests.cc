@@ -0,0 +1,175 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Legacy/Fields/ReorderMesh/ReorderMeshAlgo.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Average distance in memory between nodes that share an element
+  double averageNodeSpread(FieldHandle field)
+  {
+    auto mesh = field->vmesh();
+    VMesh::Node::array_type nodes;
+    double sum = 0;
+    size_type count = 0;
+    for (VMesh::Elem::index_type idx = 0; idx < mesh->num_elems(); idx++)
+    {
+      mesh->get_nodes(nodes, idx);
+      for (size_t j = 1; j < nodes.size(); j++)
+      {
+        sum += std::abs(static_cast<double>(nodes[j] - nodes[0]));
+        count++;
+      }
+    }
+    return sum / count;
+  }
+
+  void setNodeDataToX(FieldHandle field)
+  {
+    auto mesh = field->vmesh();
+    auto vfield = field->vfield();
+    Point p;
+    for (VMesh::Node::index_type idx = 0; idx < mesh->num_nodes(); idx++)
+    {
+      mesh->get_center(p, idx);
+      vfield->set_value(p.x(), idx);
+    }
+  }
+}
+
+class ReorderMeshAlgoTests : public ::testing::TestWithParam<std::string>
+{
+};
+
+TEST_P(ReorderMeshAlgoTests, DataAndGeometryTravelWithNodes)
+{
+  auto input = CreateTetVolGrid(6, true, 1);
+  setNodeDataToX(input);
+
+  ReorderMeshAlgo algo;
+  algo.setOption(Parameters::NodeOrdering, GetParam());
+  FieldHandle output;
+  MatrixHandle nodeMapping, elemMapping;
+  ASSERT_TRUE(algo.runImpl(input, output, nodeMapping, elemMapping));
+
+  auto omesh = output->vmesh();
+  ASSERT_EQ(input->vmesh()->num_nodes(), omesh->num_nodes());
+  ASSERT_EQ(input->vmesh()->num_elems(), omesh->num_elems());
+
+  Point p;
+  double value;
+  for (VMesh::Node::index_type idx = 0; idx < omesh->num_nodes(); idx++)
+  {
+    omesh->get_center(p, idx);
+    output->vfield()->get_value(value, idx);
+    EXPECT_DOUBLE_EQ(p.x(), value);
+  }
+
+  // new = Mapping * old
+  auto mapping = castMatrix::toSparse(nodeMapping);
+  ASSERT_TRUE(mapping != nullptr);
+  DenseColumnMatrix in(omesh->num_nodes()), out(omesh->num_nodes());
+  for (VMesh::Node::index_type idx = 0; idx < omesh->num_nodes(); idx++)
+  {
+    input->vfield()->get_value(in[idx], idx);
+    output->vfield()->get_value(out[idx], idx);
+  }
+  DenseColumnMatrix mapped = *mapping * in;
+  EXPECT_TRUE(mapped.isApprox(out));
+}
+
+TEST_P(ReorderMeshAlgoTests, ElementsKeepTheirNodes)
+{
+  auto input = CreateTetVolGrid(4, true, 0);
+  auto imesh = input->vmesh();
+  for (VMesh::Elem::index_type idx = 0; idx < imesh->num_elems(); idx++)
+    input->vfield()->set_value(static_cast<double>(idx), idx);
+
+  ReorderMeshAlgo algo;
+  algo.setOption(Parameters::NodeOrdering, GetParam());
+  FieldHandle output;
+  std::vector<index_type> nodeOrder, elemOrder;
+  ASSERT_TRUE(algo.runImpl(input, output, nodeOrder, elemOrder));
+
+  auto omesh = output->vmesh();
+  VMesh::Node::array_type inodes, onodes;
+  for (VMesh::Elem::index_type idx = 0; idx < omesh->num_elems(); idx++)
+  {
+    double value;
+    output->vfield()->get_value(value, idx);
+    EXPECT_EQ(elemOrder[idx], static_cast<index_type>(value));
+
+    imesh->get_nodes(inodes, VMesh::Elem::index_type(elemOrder[idx]));
+    omesh->get_nodes(onodes, idx);
+    ASSERT_EQ(inodes.size(), onodes.size());
+    for (size_t j = 0; j < onodes.size(); j++)
+      EXPECT_EQ(inodes[j], nodeOrder[onodes[j]]);
+  }
+}
+
+TEST_P(ReorderMeshAlgoTests, ImprovesLocalityOfShuffledMesh)
+{
+  auto input = CreateTetVolGrid(10, true, 0);
+
+  ReorderMeshAlgo algo;
+  algo.setOption(Parameters::NodeOrdering, GetParam());
+  auto output = algo.run(withInputData((Variables::InputField, input))).get<Field>(Variables::OutputField);
+  ASSERT_TRUE(output != nullptr);
+
+  EXPECT_LT(4 * averageNodeSpread(output), averageNodeSpread(input));
+}
+
+INSTANTIATE_TEST_CASE_P(
+  ReorderMeshAlgoTestsParameterized,
+  ReorderMeshAlgoTests,
+  ::testing::Values("Morton", "Hilbert", "ReverseCuthillMcKee")
+  );
+
+TEST(ReorderMeshAlgoStructuredTests, RejectsStructuredMesh)
+{
+  auto latvol = CreateEmptyLatVol();
+  ReorderMeshAlgo algo;
+  FieldHandle output;
+  std::vector<index_type> nodeOrder, elemOrder;
+  EXPECT_FALSE(algo.runImpl(latvol, output, nodeOrder, elemOrder));
+}
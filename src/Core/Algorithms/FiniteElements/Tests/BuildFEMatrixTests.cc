@@ -33,9 +33,11 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Legacy/FiniteElements/BuildMatrix/BuildFEMatrix.h>
+#include <Core/Algorithms/Legacy/Fields/ReorderMesh/ReorderMeshAlgo.h>
 #include <Core/Algorithms/DataIO/ReadMatrix.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -214,3 +216,79 @@ TEST(BuildFEMatrixAlgorithmTests, DISABLED_TestMeshSize1e6)
 
   EXPECT_TRUE(compare_with_tolerance(*expectedOutput("1e6.mat"), *output));
 }
+
+namespace
+{
+  FieldHandle unitConductivityGrid(size_type cellsPerSide)
+  {
+    auto mesh = CreateTetVolGrid(cellsPerSide, true, 0);
+    mesh->vfield()->set_all_values(1.0);
+    return mesh;
+  }
+
+  SparseRowMatrixHandle buildStiffness(FieldHandle mesh, bool reorder)
+  {
+    BuildFEMatrixAlgo algo;
+    algo.set(BuildFEMatrixAlgo::ReorderForLocality, reorder);
+    auto out = algo.run(withInputData((Variables::InputField, mesh)));
+    return out.get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  }
+}
+
+TEST(BuildFEMatrixAlgorithmTests, ReorderingKeepsInputNodeNumbering)
+{
+  auto mesh = unitConductivityGrid(5);
+
+  auto plain = buildStiffness(mesh, false);
+  auto reordered = buildStiffness(mesh, true);
+
+  ASSERT_THAT(plain, NotNull());
+  ASSERT_THAT(reordered, NotNull());
+  EXPECT_EQ(plain->nrows(), reordered->nrows());
+  EXPECT_EQ(plain->nonZeros(), reordered->nonZeros());
+  EXPECT_TRUE(plain->isApprox(*reordered));
+}
+
+// Benchmark: assembly and SpMV on a randomly numbered mesh versus the same
+// mesh renumbered along a Hilbert curve.
+TEST(BuildFEMatrixAlgorithmTests, DISABLED_ReorderingBenchmark)
+{
+  auto mesh = unitConductivityGrid(60);
+  std::cout << "elements: " << mesh->vmesh()->num_elems() << std::endl;
+
+  Fields::ReorderMeshAlgo reorder;
+  FieldHandle sorted;
+  std::vector<index_type> nodeOrder, elemOrder;
+  {
+    ScopedTimer t("reordering mesh");
+    ASSERT_TRUE(reorder.runImpl(mesh, sorted, nodeOrder, elemOrder));
+  }
+
+  SparseRowMatrixHandle shuffledK, sortedK;
+  {
+    ScopedTimer t("assembly, shuffled mesh");
+    shuffledK = buildStiffness(mesh, false);
+  }
+  {
+    ScopedTimer t("assembly, shuffled mesh with ReorderForLocality");
+    buildStiffness(mesh, true);
+  }
+  {
+    ScopedTimer t("assembly, reordered mesh");
+    sortedK = buildStiffness(sorted, false);
+  }
+
+  const int iterations = 100;
+  DenseColumnMatrix x = DenseColumnMatrix::Ones(shuffledK->ncols());
+  DenseColumnMatrix y(shuffledK->nrows());
+  {
+    ScopedTimer t("SpMV, shuffled mesh");
+    for (int i = 0; i < iterations; ++i)
+      y = *shuffledK * x;
+  }
+  {
+    ScopedTimer t("SpMV, reordered mesh");
+    for (int i = 0; i < iterations; ++i)
+      y = *sortedK * x;
+  }
+}
@@ -0,0 +1,282 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Legacy/Forward/BuildBEMatrixAlgo.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Thread/Parallel.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+
+#include <array>
+#include <map>
+#include <string>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Forward;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Icosahedron refined by splitting every triangle into four, with all
+  // nodes projected on the sphere. The triangles face outwards.
+  FieldHandle sphere(double radius, int refinements)
+  {
+    const double t = (1.0 + sqrt(5.0)) / 2.0;
+    std::vector<Vector> points = {
+      { -1, t, 0 }, { 1, t, 0 }, { -1, -t, 0 }, { 1, -t, 0 },
+      { 0, -1, t }, { 0, 1, t }, { 0, -1, -t }, { 0, 1, -t },
+      { t, 0, -1 }, { t, 0, 1 }, { -t, 0, -1 }, { -t, 0, 1 } };
+    std::vector<std::array<int, 3>> tris = {
+      {{ 0, 11, 5 }}, {{ 0, 5, 1 }}, {{ 0, 1, 7 }}, {{ 0, 7, 10 }}, {{ 0, 10, 11 }},
+      {{ 1, 5, 9 }}, {{ 5, 11, 4 }}, {{ 11, 10, 2 }}, {{ 10, 7, 6 }}, {{ 7, 1, 8 }},
+      {{ 3, 9, 4 }}, {{ 3, 4, 2 }}, {{ 3, 2, 6 }}, {{ 3, 6, 8 }}, {{ 3, 8, 9 }},
+      {{ 4, 9, 5 }}, {{ 2, 4, 11 }}, {{ 6, 2, 10 }}, {{ 8, 6, 7 }}, {{ 9, 8, 1 }} };
+
+    for (int r = 0; r < refinements; r++)
+    {
+      std::map<std::pair<int, int>, int> midpoints;
+      auto midpoint = [&](int a, int b)
+      {
+        auto key = std::make_pair(std::min(a, b), std::max(a, b));
+        auto it = midpoints.find(key);
+        if (it != midpoints.end()) return it->second;
+        points.push_back((points[a] + points[b]) * 0.5);
+        return midpoints[key] = static_cast<int>(points.size()) - 1;
+      };
+
+      std::vector<std::array<int, 3>> refined;
+      for (const auto& f : tris)
+      {
+        int ab = midpoint(f[0], f[1]), bc = midpoint(f[1], f[2]), ca = midpoint(f[2], f[0]);
+        refined.push_back({{ f[0], ab, ca }});
+        refined.push_back({{ f[1], bc, ab }});
+        refined.push_back({{ f[2], ca, bc }});
+        refined.push_back({{ ab, bc, ca }});
+      }
+      tris.swap(refined);
+    }
+
+    FieldInformation fi(TRISURFMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+    for (const auto& p : points)
+    {
+      Vector n = p;
+      n.normalize();
+      mesh->add_point(Point(n * radius));
+    }
+    VMesh::Node::array_type nodes(3);
+    for (const auto& f : tris)
+    {
+      for (int k = 0; k < 3; k++) nodes[k] = f[k];
+      mesh->add_elem(nodes);
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  FieldHandle pointCloud(const std::vector<Point>& points)
+  {
+    FieldInformation fi(POINTCLOUDMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    for (const auto& p : points)
+      field->vmesh()->add_point(p);
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  std::vector<double> areas(FieldHandle surface)
+  {
+    std::vector<double> a;
+    BuildBEMatrixBase::pre_calc_tri_areas(surface->vmesh(), a);
+    return a;
+  }
+}
+
+// The single layer potential of a unit density on a sphere is the radius
+// everywhere on (and inside) the sphere.
+TEST(BuildBEMatrixTests, SingleLayerOfSphereIsItsRadius)
+{
+  const double radius = 2.0;
+  FieldHandle surface = sphere(radius, 3);
+
+  DenseMatrixHandle G;
+  BuildBEMatrixBase::make_auto_G(surface->vmesh(), G, 1.0, 0.0, 1.0, areas(surface));
+  for (int i = 0; i < G->rows(); i++)
+    EXPECT_NEAR(-radius, G->row(i).sum(), 0.03*radius);
+
+  FieldHandle inside = pointCloud({ Point(0, 0, 0), Point(0.5, -0.3, 0.8) });
+  DenseMatrixHandle Gc;
+  BuildBEMatrixBase::make_cross_G(inside->vmesh(), surface->vmesh(), Gc, 1.0, 0.0, 1.0, areas(surface));
+  ASSERT_EQ(2, Gc->rows());
+  for (int i = 0; i < Gc->rows(); i++)
+    EXPECT_NEAR(-radius, Gc->row(i).sum(), 0.03*radius);
+}
+
+// A closed surface covers the full solid angle from inside and none from
+// outside.
+TEST(BuildBEMatrixTests, SolidAngleOfClosedSurface)
+{
+  FieldHandle surface = sphere(1.0, 2);
+  FieldHandle points = pointCloud({ Point(0, 0, 0), Point(0.3, 0.2, -0.5), Point(3, 1, 0) });
+
+  DenseMatrixHandle P;
+  BuildBEMatrixBase::make_cross_P(points->vmesh(), surface->vmesh(), P, 1.0, 0.0, 1.0);
+  EXPECT_NEAR(1.0, std::fabs(P->row(0).sum()), 1e-8);
+  EXPECT_NEAR(1.0, std::fabs(P->row(1).sum()), 1e-8);
+  EXPECT_NEAR(0.0, P->row(2).sum(), 1e-8);
+}
+
+TEST(BuildBEMatrixTests, ThreadCountDoesNotChangeMatrices)
+{
+  FieldHandle surface = sphere(1.5, 2);
+  FieldHandle points = pointCloud({ Point(0, 0, 0), Point(0.2, 0.1, 0), Point(4, 0, 0) });
+  const std::vector<double> a = areas(surface);
+
+  DenseMatrixHandle G1, G4, P1, P4, Gc1, Gc4;
+  BuildBEMatrixBase::make_auto_G(surface->vmesh(), G1, 1.0, 0.0, 1.0, a, 1);
+  BuildBEMatrixBase::make_auto_G(surface->vmesh(), G4, 1.0, 0.0, 1.0, a, 4);
+  BuildBEMatrixBase::make_auto_P(surface->vmesh(), P1, 1.0, 0.0, 1.0, 1);
+  BuildBEMatrixBase::make_auto_P(surface->vmesh(), P4, 1.0, 0.0, 1.0, 4);
+  BuildBEMatrixBase::make_cross_G(points->vmesh(), surface->vmesh(), Gc1, 1.0, 0.0, 1.0, a, 1);
+  BuildBEMatrixBase::make_cross_G(points->vmesh(), surface->vmesh(), Gc4, 1.0, 0.0, 1.0, a, 4);
+
+  EXPECT_EQ(0.0, (*G1 - *G4).cwiseAbs().maxCoeff());
+  EXPECT_EQ(0.0, (*P1 - *P4).cwiseAbs().maxCoeff());
+  EXPECT_EQ(0.0, (*Gc1 - *Gc4).cwiseAbs().maxCoeff());
+}
+
+TEST(BuildBEMatrixTests, MoreThreadsThanTheUserAllowsFillsAllRows)
+{
+  FieldHandle surface = sphere(1.5, 2);
+
+  DenseMatrixHandle P1, P4;
+  BuildBEMatrixBase::make_auto_P(surface->vmesh(), P1, 1.0, 0.0, 1.0, 1);
+  Core::Thread::Parallel::SetMaximumCores(2);
+  BuildBEMatrixBase::make_auto_P(surface->vmesh(), P4, 1.0, 0.0, 1.0, 4);
+  Core::Thread::Parallel::SetMaximumCores(0);
+
+  EXPECT_EQ(0.0, (*P1 - *P4).cwiseAbs().maxCoeff());
+}
+
+// Four nested spheres of about 2500 nodes each, like a torso model with
+// lungs, heart and blood volume, assembled with a growing number of threads.
+TEST(BuildBEMatrixTests, DISABLED_AssemblyScalingBenchmark)
+{
+  std::vector<FieldHandle> surfaces;
+  for (double radius : { 4.0, 3.0, 2.0, 1.0 })
+    surfaces.push_back(sphere(radius, 4));
+
+  const int cores = static_cast<int>(Core::Thread::Parallel::NumCores());
+  for (int threads = 1; threads <= cores; threads *= 2)
+  {
+    ScopedTimer t("auto and cross blocks of 4 surfaces, " + std::to_string(threads) + " threads");
+    for (size_t i = 0; i < surfaces.size(); i++)
+    {
+      const std::vector<double> a = areas(surfaces[i]);
+      for (size_t j = 0; j < surfaces.size(); j++)
+      {
+        DenseMatrixHandle G, P;
+        if (i == j)
+        {
+          BuildBEMatrixBase::make_auto_G(surfaces[i]->vmesh(), G, 1.0, 0.0, 1.0, a, threads);
+          BuildBEMatrixBase::make_auto_P(surfaces[i]->vmesh(), P, 1.0, 0.0, 1.0, threads);
+        }
+        else
+        {
+          BuildBEMatrixBase::make_cross_G(surfaces[j]->vmesh(), surfaces[i]->vmesh(), G, 1.0, 0.0, 1.0, a, threads);
+          BuildBEMatrixBase::make_cross_P(surfaces[j]->vmesh(), surfaces[i]->vmesh(), P, 1.0, 0.0, 1.0, threads);
+        }
+      }
+    }
+  }
+}
+
+namespace
+{
+  double relativeDifference(const DenseMatrix& a, const DenseMatrix& b)
+  {
+    return (a - b).norm()/b.norm();
+  }
+
+  MatrixHandle transferMatrix(const bemfield_vector& fields, bool compress)
+  {
+    HierarchicalMatrixOptions options;
+    options.tolerance = 1e-7;
+    auto algo = BEMAlgoImplFactory::create(fields, compress, options);
+    return algo ? algo->compute(fields) : nullptr;
+  }
+}
+
+TEST(BuildBEMatrixTests, CompressedSurfaceAndPointsMatchesDense)
+{
+  bemfield surface(sphere(1.0, 3));
+  surface.surface = true;
+  bemfield points(pointCloud({ Point(0, 0, 0), Point(0.3, -0.2, 0.1), Point(0, 0.6, -0.5) }));
+  const bemfield_vector fields = { surface, points };
+
+  MatrixHandle dense = transferMatrix(fields, false);
+  MatrixHandle compressed = transferMatrix(fields, true);
+  ASSERT_TRUE(dense != nullptr);
+  ASSERT_TRUE(compressed != nullptr);
+  ASSERT_EQ(dense->nrows(), compressed->nrows());
+  ASSERT_EQ(dense->ncols(), compressed->ncols());
+  EXPECT_LT(relativeDifference(*castMatrix::toDense(compressed), *castMatrix::toDense(dense)), 1e-3);
+}
+
+// Heart surface with the source potentials inside a torso surface
+TEST(BuildBEMatrixTests, CompressedSurfaceToSurfaceMatchesDense)
+{
+  bemfield torso(sphere(3.0, 2));
+  torso.surface = true;
+  torso.insideconductivity = 1.0;
+  torso.outsideconductivity = 0.0;
+  torso.set_measurement_neumann();
+  bemfield heart(sphere(1.0, 3));
+  heart.surface = true;
+  heart.insideconductivity = 0.0;
+  heart.outsideconductivity = 1.0;
+  heart.set_source_dirichlet();
+  const bemfield_vector fields = { torso, heart };
+
+  MatrixHandle dense = transferMatrix(fields, false);
+  MatrixHandle compressed = transferMatrix(fields, true);
+  ASSERT_TRUE(dense != nullptr);
+  ASSERT_TRUE(compressed != nullptr);
+  ASSERT_EQ(dense->nrows(), compressed->nrows());
+  ASSERT_EQ(dense->ncols(), compressed->ncols());
+  EXPECT_LT(relativeDifference(*castMatrix::toDense(compressed), *castMatrix::toDense(dense)), 1e-3);
+}
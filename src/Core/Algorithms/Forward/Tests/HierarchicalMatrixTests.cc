@@ -0,0 +1,215 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Legacy/Forward/HierarchicalMatrix.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+
+#include <cmath>
+#include <set>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Forward;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Points spread evenly over a sphere along a spiral
+  std::vector<Vector> spherePoints(size_t n, double radius, const Vector& center = Vector(0, 0, 0))
+  {
+    std::vector<Vector> points(n);
+    const double golden = M_PI*(3 - sqrt(5.0));
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double z = 1 - (2*i + 1.0)/n;
+      const double r = sqrt(1 - z*z);
+      points[i] = center + Vector(r*cos(golden*i), r*sin(golden*i), z)*radius;
+    }
+    return points;
+  }
+
+  // Smoothed 1/r kernel, with a dominant diagonal on a single set of points
+  HierarchicalMatrix::BlockFunction kernel(const std::vector<Vector>& x, const std::vector<Vector>& y, double diagonal)
+  {
+    return [&x, &y, diagonal](const std::vector<index_type>& rows, const std::vector<index_type>& cols, DenseMatrix& block)
+    {
+      for (size_t i = 0; i < rows.size(); ++i)
+        for (size_t j = 0; j < cols.size(); ++j)
+          block(i, j) = (&x == &y && rows[i] == cols[j]) ? diagonal : 1/((x[rows[i]] - y[cols[j]]).length() + 0.01);
+    };
+  }
+
+  DenseMatrix dense(const std::vector<Vector>& x, const std::vector<Vector>& y, double diagonal)
+  {
+    std::vector<index_type> rows(x.size()), cols(y.size());
+    for (size_t i = 0; i < rows.size(); ++i) rows[i] = i;
+    for (size_t j = 0; j < cols.size(); ++j) cols[j] = j;
+    DenseMatrix A(x.size(), y.size());
+    kernel(x, y, diagonal)(rows, cols, A);
+    return A;
+  }
+}
+
+TEST(ClusterTreeTests, LeavesPartitionThePoints)
+{
+  const std::vector<Vector> points = spherePoints(1000, 1.0);
+  ClusterTree tree(points, 20);
+
+  std::set<index_type> all;
+  for (size_t p = 0; p < tree.size(); ++p) all.insert(tree.index(p));
+  EXPECT_EQ(points.size(), all.size());
+
+  std::vector<int> open(1, 0);
+  while (!open.empty())
+  {
+    const ClusterTree::Cluster c = tree.cluster(open.back());
+    open.pop_back();
+    for (size_t p = c.begin; p < c.end; ++p)
+    {
+      const Vector& x = points[tree.index(p)];
+      for (int k = 0; k < 3; ++k)
+      {
+        EXPECT_LE(c.min[k], x[k]);
+        EXPECT_GE(c.max[k], x[k]);
+      }
+    }
+    if (c.is_leaf())
+    {
+      EXPECT_LE(c.size(), 20u);
+    }
+    else
+    {
+      EXPECT_EQ(c.begin, tree.cluster(c.left).begin);
+      EXPECT_EQ(tree.cluster(c.left).end, tree.cluster(c.right).begin);
+      EXPECT_EQ(c.end, tree.cluster(c.right).end);
+      open.push_back(c.left);
+      open.push_back(c.right);
+    }
+  }
+}
+
+TEST(HierarchicalMatrixTests, ApproximatesKernelWithinTolerance)
+{
+  const std::vector<Vector> x = spherePoints(3000, 1.0);
+  HierarchicalMatrixOptions options;
+  options.tolerance = 1e-6;
+  HierarchicalMatrix H(x, kernel(x, x, 10.0), options);
+
+  const DenseMatrix A = dense(x, x, 10.0);
+  const double error = (H.to_dense() - A).norm()/A.norm();
+  EXPECT_LT(error, 1e-5);
+  EXPECT_GT(H.num_low_rank_blocks(), 0u);
+  EXPECT_LT(H.stored_entries(), A.size()/2);
+}
+
+TEST(HierarchicalMatrixTests, ProductsMatchDenseMatrix)
+{
+  const std::vector<Vector> x = spherePoints(1500, 2.0);
+  const std::vector<Vector> y = spherePoints(700, 1.0, Vector(0.1, 0, 0.2));
+  HierarchicalMatrix H(x, y, kernel(x, y, 0.0));
+  const DenseMatrix A = dense(x, y, 0.0);
+
+  DenseColumnMatrix u(y.size()), v(x.size());
+  for (size_t j = 0; j < y.size(); ++j) u(j) = cos(0.1*j);
+  for (size_t i = 0; i < x.size(); ++i) v(i) = sin(0.3*i);
+
+  const DenseColumnMatrix Au = A*u;
+  const DenseColumnMatrix Atv = A.transpose()*v;
+  EXPECT_LT((H*u - Au).norm(), 1e-4*Au.norm());
+  EXPECT_LT((H.transpose_multiply(v) - Atv).norm(), 1e-4*Atv.norm());
+}
+
+TEST(HierarchicalMatrixTests, GMRESSolvesWithBlockJacobiPreconditioner)
+{
+  const std::vector<Vector> x = spherePoints(1500, 1.0);
+  HierarchicalMatrixOptions options;
+  options.tolerance = 1e-8;
+  HierarchicalMatrix H(x, kernel(x, x, 100.0), options);
+  const DenseMatrix A = dense(x, x, 100.0);
+
+  DenseColumnMatrix b(x.size());
+  for (size_t i = 0; i < x.size(); ++i) b(i) = x[i].x() - 0.5*x[i].z();
+
+  for (bool transposed : { false, true })
+  {
+    LinearOperator op = [&](const DenseColumnMatrix& in, DenseColumnMatrix& out)
+    {
+      out = transposed ? H.transpose_multiply(in) : H*in;
+    };
+    LinearOperator preconditioner = [&](const DenseColumnMatrix& in, DenseColumnMatrix& out)
+    {
+      out.resize(in.size());
+      H.solve_diagonal_blocks(in.data(), out.data(), transposed);
+    };
+
+    DenseColumnMatrix solution;
+    ASSERT_TRUE(SolveGMRES(op, preconditioner, b, solution, 1e-8, 200));
+    const DenseColumnMatrix r = (transposed ? DenseMatrix(A.transpose()) : A)*solution - b;
+    EXPECT_LT(r.norm(), 1e-6*b.norm());
+  }
+}
+
+TEST(HierarchicalMatrixTests, DiagonalCanBeReplaced)
+{
+  const std::vector<Vector> x = spherePoints(500, 1.0);
+  HierarchicalMatrix H(x, kernel(x, x, 10.0));
+
+  DenseColumnMatrix d(H.diagonal());
+  for (size_t i = 0; i < x.size(); ++i) EXPECT_EQ(10.0, d(i));
+
+  d.setConstant(3.0);
+  H.set_diagonal(d);
+  const DenseMatrix A = H.to_dense();
+  for (size_t i = 0; i < x.size(); ++i) EXPECT_EQ(3.0, A(i, i));
+}
+
+// Storage and product time for growing numbers of points, near linear
+// for the compressed matrix against quadratic for the dense one.
+TEST(HierarchicalMatrixTests, DISABLED_CompressionScalingBenchmark)
+{
+  for (size_t n : { 2000, 8000, 32000 })
+  {
+    const std::vector<Vector> x = spherePoints(n, 1.0);
+    HierarchicalMatrixOptions options;
+    options.tolerance = 1e-5;
+    std::unique_ptr<HierarchicalMatrix> H;
+    {
+      ScopedTimer t("build " + std::to_string(n) + " points");
+      H.reset(new HierarchicalMatrix(x, kernel(x, x, 10.0), options));
+    }
+    std::cout << "stored entries: " << H->stored_entries() << " of " << n*n
+      << ", " << H->num_low_rank_blocks() << " low rank and " << H->num_dense_blocks() << " dense blocks" << std::endl;
+
+    DenseColumnMatrix u(DenseColumnMatrix::Ones(n));
+    ScopedTimer t("100 products");
+    for (int i = 0; i < 100; ++i) u = (*H*u)/n;
+  }
+}
@@ -0,0 +1,747 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Legacy/Fields/DecimateMesh/DecimateMesh.h>
+
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+ALGORITHM_PARAMETER_DEF(Fields, TargetElementCount);
+ALGORITHM_PARAMETER_DEF(Fields, MaximumDecimationError);
+
+namespace {
+
+/// Sum of squared distances to a set of planes, the symmetric 4x4 matrix is
+/// stored as xx xy xz xd yy yz yd zz zd dd.
+class Quadric
+{
+public:
+  Quadric() { std::fill(a_, a_+10, 0.0); }
+
+  void add_plane(const Vector& n, double d, double w)
+  {
+    a_[0] += w*n.x()*n.x(); a_[1] += w*n.x()*n.y(); a_[2] += w*n.x()*n.z(); a_[3] += w*n.x()*d;
+    a_[4] += w*n.y()*n.y(); a_[5] += w*n.y()*n.z(); a_[6] += w*n.y()*d;
+    a_[7] += w*n.z()*n.z(); a_[8] += w*n.z()*d;
+    a_[9] += w*d*d;
+  }
+
+  Quadric& operator+=(const Quadric& q)
+  {
+    for (int k = 0; k < 10; k++) a_[k] += q.a_[k];
+    return (*this);
+  }
+
+  double evaluate(const Point& p) const
+  {
+    const double x = p.x(), y = p.y(), z = p.z();
+    return (a_[0]*x*x + 2.0*a_[1]*x*y + 2.0*a_[2]*x*z + 2.0*a_[3]*x +
+            a_[4]*y*y + 2.0*a_[5]*y*z + 2.0*a_[6]*y +
+            a_[7]*z*z + 2.0*a_[8]*z + a_[9]);
+  }
+
+  /// Point of minimal error, fails when the planes do not fix a point
+  bool minimum(Point& p) const
+  {
+    const double c00 = a_[4]*a_[7] - a_[5]*a_[5];
+    const double c01 = a_[2]*a_[5] - a_[1]*a_[7];
+    const double c02 = a_[1]*a_[5] - a_[2]*a_[4];
+    const double det = a_[0]*c00 + a_[1]*c01 + a_[2]*c02;
+    const double scale = std::max(a_[0], std::max(a_[4], a_[7]));
+    if (scale <= 0.0 || std::fabs(det) <= 1e-10*scale*scale*scale) return (false);
+
+    const double c11 = a_[0]*a_[7] - a_[2]*a_[2];
+    const double c12 = a_[1]*a_[2] - a_[0]*a_[5];
+    const double c22 = a_[0]*a_[4] - a_[1]*a_[1];
+    const double bx = -a_[3], by = -a_[6], bz = -a_[8];
+    p = Point((c00*bx + c01*by + c02*bz)/det,
+              (c01*bx + c11*by + c12*bz)/det,
+              (c02*bx + c12*by + c22*bz)/det);
+    return (true);
+  }
+
+private:
+  double a_[10];
+};
+
+struct Edge
+{
+  index_type v, w;
+  /// Number of triangles sharing the edge
+  int shared;
+  double cost;
+  Point target;
+};
+
+/// Boundary edges are held in place by a plane through the edge that is
+/// perpendicular to the triangle, with this weight relative to the planes
+/// of the triangles.
+const double BoundaryWeight = 100.0;
+
+class QuadricDecimation
+{
+public:
+  QuadricDecimation(VMesh* mesh, int num_tasks);
+
+  size_t num_triangles() const { return (num_alive_); }
+
+  /// Collapse edges until at most target triangles are left or the cheapest
+  /// collapse costs more than max_cost. Returns false when nothing could be
+  /// collapsed.
+  bool decimate(size_t target, double max_cost);
+
+  void build_field(FieldHandle input, FieldHandle& output, MatrixHandle* mapping);
+
+private:
+  void compact();
+  void build_adjacency();
+  void find_edges(std::vector<Edge>& edges);
+  bool evaluate(Edge& e) const;
+  index_type find(index_type v);
+
+  int num_tasks_;
+  size_t num_alive_;
+
+  std::vector<Point> original_;
+  std::vector<Point> points_;
+  std::vector<Quadric> quadrics_;
+  /// The node a node was merged into, itself for nodes that remain
+  std::vector<index_type> parent_;
+
+  /// Three nodes per triangle and the element it came from
+  std::vector<index_type> tris_;
+  std::vector<index_type> elems_;
+  std::vector<char> removed_;
+
+  /// Triangles around each node
+  std::vector<size_t> node_offsets_;
+  std::vector<index_type> node_tris_;
+  std::vector<char> boundary_;
+};
+
+QuadricDecimation::QuadricDecimation(VMesh* mesh, int num_tasks) :
+  num_tasks_(num_tasks), num_alive_(0)
+{
+  VMesh::Node::size_type num_nodes;
+  VMesh::Elem::size_type num_elems;
+  mesh->size(num_nodes);
+  mesh->size(num_elems);
+
+  original_.resize(num_nodes);
+  for (VMesh::Node::index_type i = 0; i < num_nodes; i++) mesh->get_center(original_[i], i);
+  points_ = original_;
+  parent_.resize(num_nodes);
+  for (index_type i = 0; i < num_nodes; i++) parent_[i] = i;
+
+  // Quads are split into two triangles
+  VMesh::Node::array_type nodes;
+  tris_.reserve(3*num_elems);
+  elems_.reserve(num_elems);
+  for (VMesh::Elem::index_type e = 0; e < num_elems; e++)
+  {
+    mesh->get_nodes(nodes, e);
+    for (size_t k = 2; k < nodes.size(); k++)
+    {
+      tris_.push_back(nodes[0]);
+      tris_.push_back(nodes[k-1]);
+      tris_.push_back(nodes[k]);
+      elems_.push_back(e);
+    }
+  }
+  removed_.assign(elems_.size(), 0);
+  num_alive_ = elems_.size();
+
+  build_adjacency();
+
+  // Planes of the triangles around every node
+  quadrics_.resize(num_nodes);
+  const size_t nodes_per_task = (num_nodes + num_tasks_ - 1) / num_tasks_;
+  auto node_quadrics = [&](int t)
+  {
+    const size_t end = std::min<size_t>(num_nodes, (t+1)*nodes_per_task);
+    for (size_t v = t*nodes_per_task; v < end; v++)
+    {
+      for (size_t j = node_offsets_[v]; j < node_offsets_[v+1]; j++)
+      {
+        const index_type* tri = &tris_[3*node_tris_[j]];
+        Vector n = Cross(points_[tri[1]] - points_[tri[0]], points_[tri[2]] - points_[tri[0]]);
+        if (n.safe_normalize() == 0.0) continue;
+        quadrics_[v].add_plane(n, -Dot(n, points_[tri[0]]), 1.0);
+      }
+    }
+  };
+  Parallel::RunTasks(node_quadrics, num_tasks_);
+
+  std::vector<Edge> edges;
+  find_edges(edges);
+  for (size_t k = 0; k < edges.size(); k++)
+  {
+    const Edge& e = edges[k];
+    if (e.shared != 1) continue;
+
+    // The triangle of a boundary edge is the one both nodes have in common
+    for (size_t j = node_offsets_[e.v]; j < node_offsets_[e.v+1]; j++)
+    {
+      const index_type* tri = &tris_[3*node_tris_[j]];
+      if (tri[0] != e.w && tri[1] != e.w && tri[2] != e.w) continue;
+
+      const Vector edge = points_[e.w] - points_[e.v];
+      Vector normal = Cross(points_[tri[1]] - points_[tri[0]], points_[tri[2]] - points_[tri[0]]);
+      Vector n = Cross(edge, normal);
+      if (n.safe_normalize() == 0.0) break;
+      const double d = -Dot(n, points_[e.v]);
+      quadrics_[e.v].add_plane(n, d, BoundaryWeight);
+      quadrics_[e.w].add_plane(n, d, BoundaryWeight);
+      break;
+    }
+  }
+}
+
+index_type
+QuadricDecimation::find(index_type v)
+{
+  index_type r = v;
+  while (parent_[r] != r) r = parent_[r];
+  while (parent_[v] != r)
+  {
+    index_type next = parent_[v];
+    parent_[v] = r;
+    v = next;
+  }
+  return (r);
+}
+
+void
+QuadricDecimation::compact()
+{
+  size_t n = 0;
+  for (size_t t = 0; t < elems_.size(); t++)
+  {
+    if (removed_[t]) continue;
+    std::copy(&tris_[3*t], &tris_[3*t]+3, &tris_[3*n]);
+    elems_[n++] = elems_[t];
+  }
+  tris_.resize(3*n);
+  elems_.resize(n);
+  removed_.assign(n, 0);
+  num_alive_ = n;
+}
+
+void
+QuadricDecimation::build_adjacency()
+{
+  const size_t num_nodes = points_.size();
+  node_offsets_.assign(num_nodes+1, 0);
+  for (size_t k = 0; k < tris_.size(); k++) node_offsets_[tris_[k]+1]++;
+  for (size_t v = 0; v < num_nodes; v++) node_offsets_[v+1] += node_offsets_[v];
+
+  node_tris_.resize(tris_.size());
+  std::vector<size_t> pos(node_offsets_.begin(), node_offsets_.end()-1);
+  for (size_t k = 0; k < tris_.size(); k++) node_tris_[pos[tris_[k]]++] = static_cast<index_type>(k/3);
+}
+
+void
+QuadricDecimation::find_edges(std::vector<Edge>& edges)
+{
+  const size_t num_nodes = points_.size();
+  boundary_.assign(num_nodes, 0);
+
+  // Every node collects its neighbors and how many triangles it shares with
+  // them. Edges are reported by their first node, the boundary flag is
+  // written by each node itself.
+  std::vector<std::vector<Edge> > found(num_tasks_);
+  const size_t nodes_per_task = (num_nodes + num_tasks_ - 1) / num_tasks_;
+  auto node_edges = [&](int t)
+  {
+    std::vector<std::pair<index_type, int> > ring;
+    const size_t end = std::min<size_t>(num_nodes, (t+1)*nodes_per_task);
+    for (size_t v = t*nodes_per_task; v < end; v++)
+    {
+      ring.clear();
+      for (size_t j = node_offsets_[v]; j < node_offsets_[v+1]; j++)
+      {
+        const index_type* tri = &tris_[3*node_tris_[j]];
+        for (int k = 0; k < 3; k++)
+        {
+          if (tri[k] == static_cast<index_type>(v)) continue;
+          size_t r = 0;
+          while (r < ring.size() && ring[r].first != tri[k]) r++;
+          if (r == ring.size()) ring.push_back(std::make_pair(tri[k], 1));
+          else ring[r].second++;
+        }
+      }
+
+      for (size_t r = 0; r < ring.size(); r++)
+      {
+        if (ring[r].second == 1) boundary_[v] = 1;
+        if (ring[r].first > static_cast<index_type>(v))
+        {
+          Edge e;
+          e.v = static_cast<index_type>(v);
+          e.w = ring[r].first;
+          e.shared = ring[r].second;
+          e.cost = 0.0;
+          found[t].push_back(e);
+        }
+      }
+    }
+  };
+  Parallel::RunTasks(node_edges, num_tasks_);
+
+  edges.clear();
+  for (int t = 0; t < num_tasks_; t++)
+  {
+    edges.insert(edges.end(), found[t].begin(), found[t].end());
+    std::vector<Edge>().swap(found[t]);
+  }
+}
+
+bool
+QuadricDecimation::evaluate(Edge& e) const
+{
+  // Non manifold edges stay, as do interior edges between two boundary
+  // nodes, collapsing those would pinch the surface.
+  if (e.shared > 2) return (false);
+  if (e.shared == 2 && boundary_[e.v] && boundary_[e.w]) return (false);
+
+  Quadric q = quadrics_[e.v];
+  q += quadrics_[e.w];
+
+  if (!q.minimum(e.target))
+  {
+    const Point mid = points_[e.v] + 0.5*(points_[e.w] - points_[e.v]);
+    e.target = points_[e.v];
+    double best = q.evaluate(e.target);
+    const double cw = q.evaluate(points_[e.w]);
+    if (cw < best) { best = cw; e.target = points_[e.w]; }
+    if (q.evaluate(mid) < best) e.target = mid;
+  }
+  e.cost = std::max(0.0, q.evaluate(e.target));
+
+  // Link condition: the nodes both ends share are exactly the ones of the
+  // triangles on the edge, otherwise the collapse folds the surface.
+  size_t common = 0;
+  for (size_t j = node_offsets_[e.v]; j < node_offsets_[e.v+1]; j++)
+  {
+    const index_type* tri = &tris_[3*node_tris_[j]];
+    for (int k = 0; k < 3; k++)
+    {
+      const index_type u = tri[k];
+      if (u == e.v || u == e.w) continue;
+      bool seen = false;
+      for (size_t i = node_offsets_[e.v]; i < j && !seen; i++)
+      {
+        const index_type* prev = &tris_[3*node_tris_[i]];
+        seen = (prev[0] == u || prev[1] == u || prev[2] == u);
+      }
+      for (int i = 0; i < k && !seen; i++) seen = (tri[i] == u);
+      if (seen) continue;
+
+      for (size_t i = node_offsets_[e.w]; i < node_offsets_[e.w+1]; i++)
+      {
+        const index_type* other = &tris_[3*node_tris_[i]];
+        if (other[0] == u || other[1] == u || other[2] == u) { common++; break; }
+      }
+    }
+  }
+  if (common != static_cast<size_t>(e.shared)) return (false);
+
+  // Triangles that move with the collapse must not flip or degenerate
+  const index_type ends[2] = { e.v, e.w };
+  for (int s = 0; s < 2; s++)
+  {
+    const index_type v = ends[s];
+    for (size_t j = node_offsets_[v]; j < node_offsets_[v+1]; j++)
+    {
+      const index_type* tri = &tris_[3*node_tris_[j]];
+      const index_type other = ends[1-s];
+      if (tri[0] == other || tri[1] == other || tri[2] == other) continue;
+
+      Point p[3];
+      for (int k = 0; k < 3; k++) p[k] = points_[tri[k]];
+      const Vector before = Cross(p[1] - p[0], p[2] - p[0]);
+      for (int k = 0; k < 3; k++) if (tri[k] == v) p[k] = e.target;
+      const Vector after = Cross(p[1] - p[0], p[2] - p[0]);
+
+      const double b = before.length(), a = after.length();
+      if (a <= 1e-12*b || Dot(before, after) <= 0.2*a*b) return (false);
+    }
+  }
+  return (true);
+}
+
+bool
+QuadricDecimation::decimate(size_t target, double max_cost)
+{
+  bool collapsed = false;
+  std::vector<Edge> edges;
+  std::vector<size_t> order;
+  std::vector<char> locked;
+  std::vector<size_t> selected;
+
+  while (num_alive_ > target)
+  {
+    compact();
+    build_adjacency();
+    find_edges(edges);
+
+    std::vector<char> valid(edges.size(), 0);
+    const size_t edges_per_task = (edges.size() + num_tasks_ - 1) / num_tasks_;
+    auto edge_costs = [&](int t)
+    {
+      const size_t end = std::min(edges.size(), (t+1)*edges_per_task);
+      for (size_t k = t*edges_per_task; k < end; k++)
+        valid[k] = (evaluate(edges[k]) && edges[k].cost <= max_cost);
+    };
+    Parallel::RunTasks(edge_costs, num_tasks_);
+
+    order.clear();
+    for (size_t k = 0; k < edges.size(); k++) if (valid[k]) order.push_back(k);
+    if (order.empty()) break;
+
+    std::sort(order.begin(), order.end(), [&edges](size_t a, size_t b)
+      { return (edges[a].cost < edges[b].cost); });
+
+    // Greedily take the cheapest edges whose triangles are not touched by
+    // another collapse of this round. Only the cheaper part of the edges is
+    // considered, so the order of the collapses stays close to the serial
+    // algorithm.
+    const size_t considered = std::max<size_t>(1, order.size()/4);
+    locked.assign(points_.size(), 0);
+    selected.clear();
+    size_t removing = 0;
+    for (size_t i = 0; i < considered && num_alive_ - removing > target; i++)
+    {
+      const Edge& e = edges[order[i]];
+      if (locked[e.v] || locked[e.w]) continue;
+
+      const index_type ends[2] = { e.v, e.w };
+      for (int s = 0; s < 2; s++)
+      {
+        for (size_t j = node_offsets_[ends[s]]; j < node_offsets_[ends[s]+1]; j++)
+        {
+          const index_type* tri = &tris_[3*node_tris_[j]];
+          locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+        }
+      }
+      selected.push_back(order[i]);
+      removing += e.shared;
+    }
+    if (selected.empty()) break;
+
+    // The neighborhoods are disjoint, the collapses are independent
+    const size_t per_task = (selected.size() + num_tasks_ - 1) / num_tasks_;
+    auto collapse = [&](int t)
+    {
+      const size_t end = std::min(selected.size(), (t+1)*per_task);
+      for (size_t i = t*per_task; i < end; i++)
+      {
+        const Edge& e = edges[selected[i]];
+        parent_[e.w] = e.v;
+        points_[e.v] = e.target;
+        quadrics_[e.v] += quadrics_[e.w];
+
+        for (size_t j = node_offsets_[e.w]; j < node_offsets_[e.w+1]; j++)
+        {
+          const index_type tri = node_tris_[j];
+          index_type* nodes = &tris_[3*tri];
+          if (nodes[0] == e.v || nodes[1] == e.v || nodes[2] == e.v)
+          {
+            removed_[tri] = 1;
+            continue;
+          }
+          for (int k = 0; k < 3; k++) if (nodes[k] == e.w) nodes[k] = e.v;
+        }
+      }
+    };
+    Parallel::RunTasks(collapse, num_tasks_);
+
+    num_alive_ -= removing;
+    collapsed = true;
+  }
+
+  return (collapsed);
+}
+
+void
+QuadricDecimation::build_field(FieldHandle input, FieldHandle& output, MatrixHandle* mapping)
+{
+  compact();
+
+  const index_type num_nodes = static_cast<index_type>(points_.size());
+  std::vector<index_type> renumber(num_nodes, -1);
+  index_type num_onodes = 0;
+  for (size_t k = 0; k < tris_.size(); k++)
+    if (renumber[tris_[k]] < 0) renumber[tris_[k]] = 0;
+  for (index_type v = 0; v < num_nodes; v++)
+    if (renumber[v] == 0) renumber[v] = num_onodes++;
+
+  FieldInformation fo(input);
+  fo.make_trisurfmesh();
+  output = CreateField(fo);
+
+  VMesh* omesh = output->vmesh();
+  VField* ofield = output->vfield();
+  VField* ifield = input->vfield();
+
+  omesh->node_reserve(num_onodes);
+  for (index_type v = 0; v < num_nodes; v++)
+    if (renumber[v] >= 0) omesh->add_point(points_[v]);
+
+  const size_t num_oelems = elems_.size();
+  omesh->elem_reserve(num_oelems);
+  VMesh::Node::array_type nodes(3);
+  for (size_t t = 0; t < num_oelems; t++)
+  {
+    for (int k = 0; k < 3; k++) nodes[k] = renumber[tris_[3*t+k]];
+    omesh->add_elem(nodes);
+  }
+  ofield->resize_values();
+
+  typedef SparseRowMatrix::Triplet T;
+  std::vector<T> triplets;
+
+  if (ifield->basis_order() == 0)
+  {
+    for (size_t t = 0; t < num_oelems; t++)
+    {
+      ofield->copy_value(ifield, VMesh::Elem::index_type(elems_[t]), VMesh::Elem::index_type(t));
+      if (mapping) triplets.push_back(T(static_cast<int>(t), static_cast<int>(elems_[t]), 1.0));
+    }
+    if (mapping)
+    {
+      SparseRowMatrixHandle mat(new SparseRowMatrix(num_oelems, ifield->num_values()));
+      mat->setFromTriplets(triplets.begin(), triplets.end());
+      *mapping = mat;
+    }
+  }
+  else if (ifield->basis_order() == 1)
+  {
+    // Every remaining node interpolates the nodes merged into it, weighted
+    // by their inverse distance to its final position.
+    std::vector<index_type> cluster_offsets(num_onodes+1, 0);
+    std::vector<index_type> owner(num_nodes, -1);
+    for (index_type v = 0; v < num_nodes; v++)
+    {
+      const index_type r = find(v);
+      if (renumber[r] < 0) continue;
+      owner[v] = renumber[r];
+      cluster_offsets[owner[v]+1]++;
+    }
+    for (index_type o = 0; o < num_onodes; o++) cluster_offsets[o+1] += cluster_offsets[o];
+    std::vector<index_type> members(cluster_offsets[num_onodes]);
+    std::vector<index_type> pos(cluster_offsets.begin(), cluster_offsets.end()-1);
+    for (index_type v = 0; v < num_nodes; v++)
+      if (owner[v] >= 0) members[pos[owner[v]]++] = v;
+
+    std::vector<index_type> location(num_onodes);
+    for (index_type v = 0; v < num_nodes; v++)
+      if (renumber[v] >= 0) location[renumber[v]] = v;
+
+    std::vector<VMesh::weight_type> weights(members.size());
+    const size_t per_task = (num_onodes + num_tasks_ - 1) / num_tasks_;
+    auto interpolate = [&](int t)
+    {
+      const size_t end = std::min<size_t>(num_onodes, (t+1)*per_task);
+      for (size_t o = t*per_task; o < end; o++)
+      {
+        const Point& p = points_[location[o]];
+        const index_type first = cluster_offsets[o];
+        const index_type count = cluster_offsets[o+1] - first;
+        // A node that did not move keeps its own value
+        index_type exact = -1;
+        double sum = 0.0;
+        for (index_type i = first; i < first + count; i++)
+        {
+          const double d = (original_[members[i]] - p).length();
+          if (d == 0.0) exact = i;
+          weights[i] = (d > 0.0) ? 1.0/d : 0.0;
+          sum += weights[i];
+        }
+        for (index_type i = first; i < first + count; i++)
+        {
+          if (exact >= 0) weights[i] = (i == exact) ? 1.0 : 0.0;
+          else weights[i] /= sum;
+        }
+        ofield->copy_weighted_value(ifield, &members[first], &weights[first], count, VMesh::Node::index_type(o));
+      }
+    };
+    Parallel::RunTasks(interpolate, num_tasks_);
+
+    if (mapping)
+    {
+      triplets.reserve(members.size());
+      for (index_type o = 0; o < num_onodes; o++)
+        for (index_type i = cluster_offsets[o]; i < cluster_offsets[o+1]; i++)
+          if (weights[i] != 0.0) triplets.push_back(T(static_cast<int>(o), static_cast<int>(members[i]), weights[i]));
+
+      SparseRowMatrixHandle mat(new SparseRowMatrix(num_onodes, num_nodes));
+      mat->setFromTriplets(triplets.begin(), triplets.end());
+      *mapping = mat;
+    }
+  }
+  else if (mapping)
+  {
+    // provide an empty matrix
+    mapping->reset(new DenseMatrix(0, 0));
+  }
+}
+
+}
+
+DecimateMeshAlgo::DecimateMeshAlgo()
+{
+  addParameter(Parameters::TargetElementCount, 10000);
+  addParameter(Parameters::MaximumDecimationError, 0.0);
+}
+
+bool
+DecimateMeshAlgo::runImpl(FieldHandle input, FieldHandle& output) const
+{
+  return (decimate(input, output, nullptr));
+}
+
+bool
+DecimateMeshAlgo::runImpl(FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const
+{
+  return (decimate(input, output, &mapping));
+}
+
+bool
+DecimateMeshAlgo::check_input(FieldHandle input) const
+{
+  if (!input)
+  {
+    error("No input field");
+    return (false);
+  }
+
+  FieldInformation fi(input);
+  if (!(fi.is_trisurfmesh() || fi.is_quadsurfmesh()))
+  {
+    error("This algorithm only works on a TriSurfMesh or a QuadSurfMesh");
+    return (false);
+  }
+
+  if (fi.is_nonlinear())
+  {
+    error("This algorithm has not yet been defined for non-linear elements yet");
+    return (false);
+  }
+  return (true);
+}
+
+bool
+DecimateMeshAlgo::decimate(FieldHandle input, FieldHandle& output, MatrixHandle* mapping) const
+{
+  ScopedAlgorithmStatusReporter asr(this, "DecimateMesh");
+  if (!check_input(input)) return (false);
+
+  const int target = get(Parameters::TargetElementCount).toInt();
+  const double max_error = get(Parameters::MaximumDecimationError).toDouble();
+  if (target <= 0 && max_error <= 0.0)
+  {
+    error("Set a target element count or a maximum error");
+    return (false);
+  }
+
+  QuadricDecimation decimation(input->vmesh(), std::max(1, static_cast<int>(Parallel::NumCores())));
+  decimation.decimate(static_cast<size_t>(std::max(target, 0)),
+    (max_error > 0.0) ? max_error*max_error : std::numeric_limits<double>::max());
+  decimation.build_field(input, output, mapping);
+
+  if (!output)
+  {
+    error("Could not allocate output field");
+    return (false);
+  }
+  return (true);
+}
+
+bool
+DecimateMeshAlgo::runLevels(FieldHandle input, size_t numLevels, std::vector<FieldHandle>& levels) const
+{
+  ScopedAlgorithmStatusReporter asr(this, "DecimateMesh");
+  levels.clear();
+  if (!check_input(input)) return (false);
+  levels.push_back(input);
+
+  // Each level continues from the previous one
+  QuadricDecimation decimation(input->vmesh(), std::max(1, static_cast<int>(Parallel::NumCores())));
+  size_t target = decimation.num_triangles();
+  for (size_t level = 1; level < numLevels; level++)
+  {
+    target /= 4;
+    if (target == 0 || !decimation.decimate(target, std::numeric_limits<double>::max())) break;
+
+    FieldHandle output;
+    decimation.build_field(input, output, nullptr);
+    if (!output) break;
+    levels.push_back(output);
+  }
+  return (true);
+}
+
+const AlgorithmOutputName DecimateMeshAlgo::Mapping("Mapping");
+
+AlgorithmOutput
+DecimateMeshAlgo::run(const AlgorithmInput& input) const
+{
+  auto inputField = input.get<Field>(Variables::InputField);
+
+  FieldHandle outputField;
+  MatrixHandle mapping;
+
+  if (!runImpl(inputField, outputField, mapping))
+    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.");
+
+  AlgorithmOutput output;
+  output[Variables::OutputField] = outputField;
+  output[Mapping] = mapping;
+  return output;
+}
@@ -0,0 +1,82 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_FIELDS_DECIMATEMESH_DECIMATEMESH_H
+#define CORE_ALGORITHMS_FIELDS_DECIMATEMESH_DECIMATEMESH_H 1
+
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+        ALGORITHM_PARAMETER_DECL(TargetElementCount);
+        ALGORITHM_PARAMETER_DECL(MaximumDecimationError);
+
+        /// @class DecimateMeshAlgo
+        /// @brief Simplifies a TriSurf or QuadSurf mesh by quadric error edge
+        /// collapses.
+        ///
+        /// Edges are collapsed until the mesh has TargetElementCount triangles
+        /// or the next collapse would move the surface further than
+        /// MaximumDecimationError, a zero disables either limit. Every round
+        /// evaluates all edges on all cores and collapses a set of cheap edges
+        /// whose neighborhoods do not overlap. Quads are split into triangles,
+        /// the output is a TriSurf. Node data are interpolated from the nodes that
+        /// were merged, element data are taken from the original element, the
+        /// mapping matrix describes this interpolation.
+        class SCISHARE DecimateMeshAlgo : public AlgorithmBase
+        {
+        public:
+          DecimateMeshAlgo();
+
+          bool runImpl(FieldHandle input, FieldHandle& output) const;
+          bool runImpl(FieldHandle input, FieldHandle& output,
+                       Datatypes::MatrixHandle& mapping) const;
+
+          /// Levels of detail: levels[0] is the input, every further level
+          /// has about a quarter of the elements of the previous one. Stops
+          /// early when the mesh cannot be decimated any further.
+          bool runLevels(FieldHandle input, size_t numLevels,
+                         std::vector<FieldHandle>& levels) const;
+
+          static const AlgorithmOutputName Mapping;
+
+          virtual AlgorithmOutput run(const AlgorithmInput& input) const override;
+
+        private:
+          bool check_input(FieldHandle input) const;
+          bool decimate(FieldHandle input, FieldHandle& output,
+                        Datatypes::MatrixHandle* mapping) const;
+        };
+
+      }}}}
+
+#endif
@@ -27,6 +27,7 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/RegularGridDistance.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
@@ -48,6 +49,7 @@ ALGORITHM_PARAMETER_DEF(Fields, Truncate);
 ALGORITHM_PARAMETER_DEF(Fields, TruncateDistance);
 ALGORITHM_PARAMETER_DEF(Fields, OutputFieldDatatype);
 ALGORITHM_PARAMETER_DEF(Fields, OutputValueField);
+ALGORITHM_PARAMETER_DEF(Fields, DistanceMethod);
 
 CalculateDistanceFieldAlgo::CalculateDistanceFieldAlgo()
 {
@@ -57,6 +59,9 @@ CalculateDistanceFieldAlgo::CalculateDistanceFieldAlgo()
   addParameter(OutputValueField, false);
   addOption(BasisType, "same as input","same as input|constant|linear");
   addOption(OutputFieldDatatype, "double","char|unsigned char|short|unsigned short|int|unsigned int|float|double");
+  // fast sweeping only applies to regular destination grids, other meshes
+  // always use a closest element search per value
+  addOption(DistanceMethod, "brute force", "brute force|fast sweeping");
 }
 
 namespace detail
@@ -338,6 +343,7 @@ class CalculateDistanceFieldP : public Interruptible
     VField*  vfield;
     const AlgorithmBase* algo_;
 };
+
 }
 
 //TODO refactor duplication
@@ -404,6 +410,23 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (false);
   }
 
+  if (checkOption(Parameters::DistanceMethod, "fast sweeping"))
+  {
+    RegularGridDistance grid(imesh, ofield->basis_order());
+    if (grid.is_valid())
+    {
+      double max = DBL_MAX;
+      if (get(Parameters::Truncate).toBool())
+        max = get(Parameters::TruncateDistance).toDouble();
+
+      grid.compute(objmesh, this, 2.0, max);
+      for (VMesh::index_type idx = 0; idx < grid.size(); idx++)
+        ofield->set_value(std::min(grid.distance(idx), max), idx);
+      return (true);
+    }
+    remark("Fast sweeping requires a regular grid with orthogonal axes, using a closest element search instead.");
+  }
+
   detail::CalculateDistanceFieldP palgo(imesh,objmesh,ofield,this);
   auto task_i = [&palgo,this](int i) { palgo.parallel(i, Parallel::NumCores()); };
   Parallel::RunTasks(task_i, Parallel::NumCores());
@@ -489,6 +512,24 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (false);
   }
 
+  if (checkOption(Parameters::DistanceMethod, "fast sweeping") &&
+      dfield->basis_order() == vfield->basis_order())
+  {
+    RegularGridDistance grid(imesh, dfield->basis_order());
+    if (grid.is_valid())
+    {
+      if (get(Parameters::Truncate).toBool())
+        warning("Closest value has been requested, disabling truncated distance map.");
+
+      grid.compute(objmesh, this);
+      for (VMesh::index_type idx = 0; idx < grid.size(); idx++)
+        dfield->set_value(grid.distance(idx), idx);
+      grid.copy_closest_values(objfield, vfield);
+      return (true);
+    }
+    remark("Fast sweeping requires a regular grid with orthogonal axes, using a closest element search instead.");
+  }
+
   detail::CalculateDistanceFieldP palgo(imesh,objmesh,objfield,dfield,vfield,this);
   auto task_i = [&palgo,this](int i) { palgo.parallel2(i, Parallel::NumCores()); };
   Parallel::RunTasks(task_i, Parallel::NumCores());
@@ -26,218 +26,266 @@
    DEALINGS IN THE SOFTWARE.
 */
 
-#include <Core/Algorithms/Fields/DistanceField/CalculateInsideWhichField.h>
 
-#include <Core/Datatypes/FieldInformation.h>
-
-namespace SCIRunAlgo {
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateInsideWhichField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/SurfaceWindingNumber.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Thread;
+
+ALGORITHM_PARAMETER_DEF(Fields, StartValue);
+ALGORITHM_PARAMETER_DEF(Fields, ChangeOutsideValues);
+ALGORITHM_PARAMETER_DEF(Fields, DataLocation);
+
+CalculateInsideWhichFieldAlgo::CalculateInsideWhichFieldAlgo()
+{
+  // How many samples inside the elements to test for being inside the
+  // object field
+  addOption(Parameters::SamplingScheme, "regular2", "regular1|regular2|regular3|regular4|regular5");
+  // Value for outside elements
+  addParameter(Parameters::OutsideFieldValue, 0.0);
+  // Output type of the algorithm
+  addOption(Parameters::FieldOutputType, "same as input", "same as input|char|unsigned char|short|unsigned short|int|unsigned int|float|double");
+  // How many samples need to be inside to call it inside
+  addOption(Parameters::CalcInsideMethod, "one", "one|most|all");
+  // Which value the first field is
+  addParameter(Parameters::StartValue, 1.0);
+  // Do not alter the outside values
+  addParameter(Parameters::ChangeOutsideValues, true);
+  // For nodes or for elements
+  addOption(Parameters::DataLocation, "elem", "elem|node");
+  // Point in volume element search, or winding number of surface objects
+  addOption(Parameters::InsideTest, "locate", "locate|winding number");
+}
 
-bool 
-CalculateInsideWhichFieldAlgo::
-run(FieldHandle input, std::vector<FieldHandle> objfield, FieldHandle& output)
+bool
+CalculateInsideWhichFieldAlgo::runImpl(FieldHandle input, const FieldList& objfield, FieldHandle& output) const
 {
-  algo_start("Calculate IsInsideField");
-  
-  if (input.get_rep() == 0)
+  ScopedAlgorithmStatusReporter asr(this, "Calculate InsideWhichField");
+
+  if (!input)
   {
     error("No input field");
-    algo_end(); return (false);
+    return (false);
   }
 
   for (size_t p=0;p<objfield.size();p++)
   {
-    if (objfield[p].get_rep() == 0)
+    if (!objfield[p])
     {
       error("No object field");
-      algo_end(); return (false);
+      return (false);
     }
   }
-  
-  // no precompiled version available, so compile one
 
   FieldInformation fi(input);
   FieldInformation fo(input);
-    
+
   if (fi.is_nonlinear())
   {
     error("This function has not yet been defined for non-linear elements");
-    algo_end(); return (false);
+    return (false);
   }
-    
-  std::string output_type = get_option("output_type");  
-    
+
+  std::string output_type = getOption(Parameters::FieldOutputType);
+
   if (output_type != "same as input")
-  {  
+  {
     fo.set_data_type(output_type);
   }
- 
-  
- 
+
   if (fo.is_vector()) fo.make_double();
   if (fo.is_tensor()) fo.make_double();
-  
+
   fo.make_constantdata();
-  if (check_option("data_location","node")) fo.make_lineardata();
-    
+  if (checkOption(Parameters::DataLocation, "node")) fo.make_lineardata();
+
   output = CreateField(fo,input->mesh());
-  
-  if (output.get_rep() == 0)
+
+  if (!output)
   {
     error("Could not create output field");
-    algo_end(); return(false);  
+    return(false);
   }
 
   // For the moment we calculate everything in doubles
 
   VField* ifield  = input->vfield();
-  
+
   VMesh*  omesh   = output->vmesh();
   VField* ofield  = output->vfield();
 
-  double outside_value = get_scalar("outside_value");
-  double start_value   = get_scalar("start_value");
+  double outside_value = get(Parameters::OutsideFieldValue).toDouble();
+  double start_value   = get(Parameters::StartValue).toDouble();
 
-  bool change_outside_values = get_bool("change_outside_values");
+  bool change_outside_values = get(Parameters::ChangeOutsideValues).toBool();
   if (change_outside_values)
     ofield->set_all_values(outside_value);
   else
     ofield->copy_values(ifield);
-    
-  std::vector<VMesh*> objmesh(objfield.size(),0); 
-  
-  if (ofield->basis_order() == 0)
+
+  const size_t num_objects = objfield.size();
+  std::vector<VMesh*> objmesh(num_objects,0);
+  for (size_t p=0;p<num_objects;p++) objmesh[p] = objfield[p]->vmesh();
+
+  // The winding number is only used if every object is a surface, as the
+  // classification then runs in parallel
+  std::vector<boost::shared_ptr<SurfaceWindingNumber> > winding;
+  if (checkOption(Parameters::InsideTest, "winding number"))
   {
-    for (size_t p=0;p<objfield.size();p++)
+    bool surfaces = true;
+    for (size_t p=0;p<num_objects;p++) if (!objmesh[p]->is_surface()) surfaces = false;
+
+    if (surfaces)
     {
-      objmesh[p] = objfield[p]->vmesh();  
-      objmesh[p]->synchronize(Mesh::ELEM_LOCATE_E);
+      winding.resize(num_objects);
+      auto build = [&](int proc)
+      {
+        for (size_t p=proc; p<num_objects; p+=Parallel::NumCores())
+          winding[p].reset(new SurfaceWindingNumber(objmesh[p]));
+      };
+      Parallel::RunTasks(build, Parallel::NumCores());
     }
-    
+    else
+    {
+      remark("Winding number test requires surface objects, using locate instead");
+    }
+  }
+
+  if (winding.empty())
+  {
+    for (size_t p=0;p<num_objects;p++)
+      objmesh[p]->synchronize(Mesh::ELEM_LOCATE_E);
+  }
+
+  const int nproc = winding.empty() ? 1 : Parallel::NumCores();
+
+  if (ofield->basis_order() == 0)
+  {
     VMesh::size_type num_elems = omesh->num_elems();
-    
-    VMesh::Node::array_type nodes;
-    VMesh::Elem::index_type cidx;
 
-    std::vector<Point> points;
-    std::vector<Point> points2;
-    
     std::vector<VMesh::coords_type> coords;
     std::vector<double> weights;
-    
-    std::string sampling_scheme = get_option("sampling_scheme");
+
+    std::string sampling_scheme = getOption(Parameters::SamplingScheme);
     if (sampling_scheme == "regular1") omesh->get_regular_scheme(coords,weights,1);
     else if (sampling_scheme == "regular2") omesh->get_regular_scheme(coords,weights,2);
     else if (sampling_scheme == "regular3") omesh->get_regular_scheme(coords,weights,3);
     else if (sampling_scheme == "regular4") omesh->get_regular_scheme(coords,weights,4);
     else if (sampling_scheme == "regular5") omesh->get_regular_scheme(coords,weights,5);
 
-    std::string method = get_option("method");
-    
-    int cnt = 0;
-    
-    if (method == "one")
+    std::string method = getOption(Parameters::CalcInsideMethod);
+
+    auto task = [&](int proc)
     {
-      for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
+      const VMesh::index_type start = (num_elems*proc)/nproc;
+      const VMesh::index_type end = (num_elems*(proc+1))/nproc;
+
+      VMesh::Elem::index_type cidx;
+      std::vector<Point> points2;
+
+      auto inside = [&](size_t p, const Point& point)
+      {
+        if (!winding.empty()) return (winding[p]->is_inside(point));
+        return (objmesh[p]->locate(cidx,point));
+      };
+
+      int cnt = 0;
+      for (VMesh::Elem::index_type idx=start; idx<end; idx++)
       {
         omesh->minterpolate(points2,coords,idx);
 
-        for (size_t p=0; p<objmesh.size(); p++)
+        for (size_t p=0; p<num_objects; p++)
         {
           bool is_inside = false;
-          for (size_t r=0; r< points2.size(); r++)
+
+          if (method == "one")
           {
-            if (objmesh[p]->locate(cidx,points2[r]))
-            {
-              is_inside = true; break;
-            }
+            for (size_t r=0; r< points2.size() && !is_inside; r++)
+              if (inside(p,points2[r])) is_inside = true;
           }
-
-          if (is_inside) ofield->set_value(start_value+p,idx);
-        }
-        // Progress Reporting
-        cnt++; if (cnt == 100) { update_progress(idx,num_elems); cnt = 0; }
-      }
-    }
-    else if (method == "all")
-    {
-      for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
-      {
-        omesh->minterpolate(points2,coords,idx);
-
-        for (size_t p=0; p<objmesh.size(); p++)
-        {
-          bool is_inside = true;      
-          for (size_t r=0; r< points2.size(); r++)
+          else if (method == "all")
           {
-            if (!(objmesh[p]->locate(cidx,points2[r])))
+            is_inside = true;
+            for (size_t r=0; r< points2.size() && is_inside; r++)
+              if (!inside(p,points2[r])) is_inside = false;
+          }
+          else
+          {
+            int outside = 0;
+            int inside_cnt = 0;
+            for (size_t r=0; r< points2.size(); r++)
             {
-              is_inside = false; break;
+              if (inside(p,points2[r])) inside_cnt++; else outside++;
             }
+            is_inside = (inside_cnt >= outside);
           }
-        
+
           if (is_inside) ofield->set_value(start_value+p,idx);
         }
         // Progress Reporting
-        cnt++; if (cnt == 100) { update_progress(idx,num_elems); cnt = 0; }
+        if (proc == 0) { cnt++; if (cnt == 100) { update_progress_max(idx-start,end-start); cnt = 0; } }
       }
-    }  
-    else
-    {
-      for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
-      {
-        omesh->minterpolate(points2,coords,idx);
-
-        for (size_t p=0; p<objmesh.size(); p++)
-        {
-          int outside = 0;
-          int inside = 0;
-          for (size_t r=0; r< points2.size(); r++)
-          {
-            if (objmesh[p]->locate(cidx,points2[r])) inside++; else outside++;
-          }
+    };
 
-          if (inside >= outside) ofield->set_value(start_value+p,idx);
-        }
-        // Progress Reporting
-        cnt++; if (cnt == 100) { update_progress(idx,num_elems); cnt = 0; }
-      }
-    }
+    Parallel::RunTasks(task, nproc);
   }
   else
   {
-    for (size_t p=0;p<objfield.size();p++)
-    {
-      objmesh[p] = objfield[p]->vmesh();  
-      objmesh[p]->synchronize(Mesh::ELEM_LOCATE_E);
-    }
-    
     VMesh::size_type num_nodes = omesh->num_nodes();
-    
-    int cnt = 0;
-    
-    for(VMesh::Node::index_type idx=0; idx<num_nodes;idx++)
+
+    auto task = [&](int proc)
     {
-      Point point;
-      VMesh::Elem::index_type cidx;
-      omesh->get_center(point,idx);
+      const VMesh::index_type start = (num_nodes*proc)/nproc;
+      const VMesh::index_type end = (num_nodes*(proc+1))/nproc;
 
-      for (size_t p=0; p<objmesh.size(); p++)
+      int cnt = 0;
+      for (VMesh::Node::index_type idx=start; idx<end; idx++)
       {
-        bool is_inside = false;
-        if (objmesh[p]->locate(cidx,point))
+        Point point;
+        VMesh::Elem::index_type cidx;
+        omesh->get_center(point,idx);
+
+        for (size_t p=0; p<num_objects; p++)
         {
-          ofield->set_value(start_value+p,idx);
+          bool is_inside = winding.empty() ? objmesh[p]->locate(cidx,point) :
+            winding[p]->is_inside(point);
+          if (is_inside) ofield->set_value(start_value+p,idx);
         }
+
+        // Progress Reporting
+        if (proc == 0) { cnt++; if (cnt == 100) { update_progress_max(idx-start,end-start); cnt = 0; } }
       }
-        
-      // Progress Reporting
-      cnt++; if (cnt == 100) { update_progress(idx,num_nodes); cnt = 0; }
-    }
+    };
+
+    Parallel::RunTasks(task, nproc);
   }
-  
-  algo_end(); return (true);  
+
+  return (true);
 }
 
-} // End namespace SCIRunAlgo
+AlgorithmOutput CalculateInsideWhichFieldAlgo::run(const AlgorithmInput& input) const
+{
+  auto inputField = input.get<Field>(Variables::InputField);
+  auto objectFields = input.getList<Field>(Variables::ObjectField);
+
+  FieldHandle outputField;
+
+  if (!runImpl(inputField, objectFields, outputField))
+    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.");
+
+  AlgorithmOutput output;
+  output[Variables::OutputField] = outputField;
+  return output;
+}
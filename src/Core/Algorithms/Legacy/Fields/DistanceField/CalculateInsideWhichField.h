@@ -26,52 +26,39 @@
    DEALINGS IN THE SOFTWARE.
 */
 
+
 #ifndef CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_CALCULATEINSIDEWHICHFIELD_H
 #define CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_CALCULATEINSIDEWHICHFIELD_H 1
 
-// Datatypes that the algorithm uses
-#include <Core/Datatypes/Mesh.h>
-#include <Core/Datatypes/Field.h>
-
-// Base class for algorithm
-#include <Core/Algorithms/Util/AlgoBase.h>
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateIsInsideField.h>
+#include <Core/Algorithms/Legacy/Fields/share.h>
 
-// STL class needed
-#include <vector>
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
 
-// for Windows support
-#include <Core/Algorithms/Fields/share.h>
+        ALGORITHM_PARAMETER_DECL(StartValue);
+        ALGORITHM_PARAMETER_DECL(ChangeOutsideValues);
+        ALGORITHM_PARAMETER_DECL(DataLocation);
 
-namespace SCIRunAlgo {
+/// @class CalculateInsideWhichFieldAlgo
+/// @brief Labels the elements or nodes of a field with the index of the
+/// object they are inside, counting from StartValue. Objects later in the
+/// list take precedence. The inside test is the same as the one of
+/// CalculateIsInsideFieldAlgo; with the winding number test the objects
+/// need to be surfaces and the field is classified in parallel.
 
-using namespace SCIRun;
-
-class SCISHARE CalculateInsideWhichFieldAlgo : public AlgoBase 
+class SCISHARE CalculateInsideWhichFieldAlgo : public AlgorithmBase
 {
   public:
-    CalculateInsideWhichFieldAlgo() 
-    {
-      /// How many samples inside the elements to test for being inside the
-      /// object field
-      add_option("sampling_scheme","regular2","regular1|regular2|regular3|regular4|regular5");
-      /// Value for inside elements
-      add_scalar("outside_value",0.0);
-      /// Output type of the algorithm
-      add_option("output_type","same as input","same as input|char|unsigned char|short|unsigned short|int|unsigned int|float|double");
-      /// How many nodes need to be inside to call it inside
-      add_option("method","one","one|most|all");
-      /// Which value the first field is
-      add_scalar("start_value",1.0);
-      /// Do not alter the outside values
-      add_bool("change_outside_values",true);
-      /// For nodes or for elements
-      add_option("data_location","elem","elem|node");
-    }
-    
-    /// run the algorithm
-    bool run(FieldHandle input, std::vector<FieldHandle> object, FieldHandle& output);
+    CalculateInsideWhichFieldAlgo();
+    bool runImpl(FieldHandle input, const FieldList& objects, FieldHandle& output) const;
+
+    virtual AlgorithmOutput run(const AlgorithmInput& input) const override;
 };
 
-} // end namespace SCIRunAlgo
+}}}}
 
 #endif
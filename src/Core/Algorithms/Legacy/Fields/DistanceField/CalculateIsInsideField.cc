@@ -33,18 +33,22 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/SurfaceWindingNumber.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Thread;
 
 ALGORITHM_PARAMETER_DEF(Fields, SamplingScheme);
 ALGORITHM_PARAMETER_DEF(Fields, InsideFieldValue);
 ALGORITHM_PARAMETER_DEF(Fields, OutsideFieldValue);
 ALGORITHM_PARAMETER_DEF(Fields, FieldOutputType);
 ALGORITHM_PARAMETER_DEF(Fields, CalcInsideMethod);
+ALGORITHM_PARAMETER_DEF(Fields, InsideTest);
 
 CalculateIsInsideFieldAlgo::CalculateIsInsideFieldAlgo()
 {
@@ -59,6 +63,8 @@ CalculateIsInsideFieldAlgo::CalculateIsInsideFieldAlgo()
   addOption(Parameters::FieldOutputType, "same as input", "same as input|char|unsigned char|short|unsigned short|int|unsigned int|float|double");
   // How many nodes need to be inside to call it inside
   addOption(Parameters::CalcInsideMethod, "all", "one|most|all");
+  // Point in volume element search, or winding number of a surface object
+  addOption(Parameters::InsideTest, "locate", "locate|winding number");
 }
 
 bool
@@ -126,14 +132,7 @@ CalculateIsInsideFieldAlgo::runImpl(FieldHandle input, FieldHandle objfield, Fie
 
   ofield->set_all_values(outside_value);
 
-  objmesh->synchronize(Mesh::ELEM_LOCATE_E);
-
   VMesh::size_type num_elems = omesh->num_elems();
-  VMesh::Node::array_type nodes;
-  VMesh::Elem::index_type cidx;
-
-  std::vector<Point> points;
-  std::vector<Point> points2;
 
   std::vector<VMesh::coords_type> coords;
   std::vector<double> weights;
@@ -147,93 +146,87 @@ CalculateIsInsideFieldAlgo::runImpl(FieldHandle input, FieldHandle objfield, Fie
 
   std::string method = getOption(Parameters::CalcInsideMethod);
 
-  if (method == "one")
+  boost::shared_ptr<SurfaceWindingNumber> winding;
+  if (checkOption(Parameters::InsideTest, "winding number"))
   {
-    for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
+    if (objmesh->is_surface())
     {
-      omesh->get_nodes(nodes,idx);
-      omesh->get_centers(points,nodes);
-      omesh->minterpolate(points2,coords,idx);
+      winding.reset(new SurfaceWindingNumber(objmesh));
+    }
+    else
+    {
+      remark("Winding number test requires a surface object, using locate instead");
+    }
+  }
 
-      bool is_inside = false;
+  if (!winding) objmesh->synchronize(Mesh::ELEM_LOCATE_E);
 
-      for (size_t r=0; r< points2.size(); r++)
-      {
-        if (objmesh->locate(cidx,points2[r]))
-        {
-          is_inside = true; break;
-        }
-      }
-
-      if (!is_inside)
-      {
-        for (size_t r=0; r< points.size(); r++)
-        {
-          if (objmesh->locate(cidx,points[r]))
-          {
-            is_inside = true; break;
-          }
-        }
-      }
+  // The winding number is thread safe, the locate test runs serially
+  const int nproc = winding ? Parallel::NumCores() : 1;
 
-      if (is_inside) ofield->set_value(inside_value,idx);
-    }
-  }
-  else if (method == "all")
+  auto task = [&](int proc)
   {
-    for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
+    const VMesh::index_type start = (num_elems*proc)/nproc;
+    const VMesh::index_type end = (num_elems*(proc+1))/nproc;
+
+    VMesh::Node::array_type nodes;
+    VMesh::Elem::index_type cidx;
+    std::vector<Point> points;
+    std::vector<Point> points2;
+
+    auto inside = [&](const Point& p)
+    {
+      if (winding) return (winding->is_inside(p));
+      return (objmesh->locate(cidx,p));
+    };
+
+    int cnt = 0;
+    for (VMesh::Elem::index_type idx=start; idx<end; idx++)
     {
       omesh->get_nodes(nodes,idx);
       omesh->get_centers(points,nodes);
       omesh->minterpolate(points2,coords,idx);
 
-      bool is_inside = true;
+      bool is_inside = false;
 
-      for (size_t r=0; r< points2.size(); r++)
+      if (method == "one")
+      {
+        for (size_t r=0; r< points2.size() && !is_inside; r++)
+          if (inside(points2[r])) is_inside = true;
+        for (size_t r=0; r< points.size() && !is_inside; r++)
+          if (inside(points[r])) is_inside = true;
+      }
+      else if (method == "all")
+      {
+        is_inside = true;
+        for (size_t r=0; r< points2.size() && is_inside; r++)
+          if (!inside(points2[r])) is_inside = false;
+        for (size_t r=0; r< points.size() && is_inside; r++)
+          if (!inside(points[r])) is_inside = false;
+      }
+      else
       {
-        if (!(objmesh->locate(cidx,points2[r])))
+        int outside = 0;
+        int inside_cnt = 0;
+        for (size_t r=0; r< points2.size(); r++)
         {
-          is_inside = false; break;
+          if (inside(points2[r])) inside_cnt++; else outside++;
         }
-      }
 
-      if (is_inside)
-      {
         for (size_t r=0; r< points.size(); r++)
         {
-          if (!(objmesh->locate(cidx,points[r])))
-          {
-            is_inside = false; break;
-          }
+          if (inside(points[r])) inside_cnt++; else outside++;
         }
+        is_inside = (inside_cnt >= outside);
       }
 
       if (is_inside) ofield->set_value(inside_value,idx);
-    }
-  }
-  else
-  {
-    for(VMesh::Elem::index_type idx=0; idx<num_elems;idx++)
-    {
-      omesh->get_nodes(nodes,idx);
-      omesh->get_centers(points,nodes);
-      omesh->minterpolate(points2,coords,idx);
-
-      int outside = 0;
-      int inside = 0;
-      for (size_t r=0; r< points2.size(); r++)
-      {
-        if (objmesh->locate(cidx,points2[r])) inside++; else outside++;
-      }
-
-      for (size_t r=0; r< points.size(); r++)
-      {
-        if (objmesh->locate(cidx,points[r])) inside++; else outside++;
-      }
 
-      if (inside >= outside) ofield->set_value(inside_value,idx);
+      if (proc == 0) { cnt++; if (cnt == 100) { update_progress_max(idx-start,end-start); cnt = 0; } }
     }
-  }
+  };
+
+  Parallel::RunTasks(task, nproc);
 
   return (true);
 }
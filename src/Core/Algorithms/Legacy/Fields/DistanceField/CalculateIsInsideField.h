@@ -42,6 +42,14 @@ namespace SCIRun {
         ALGORITHM_PARAMETER_DECL(OutsideFieldValue);
         ALGORITHM_PARAMETER_DECL(FieldOutputType);
         ALGORITHM_PARAMETER_DECL(CalcInsideMethod);
+        ALGORITHM_PARAMETER_DECL(InsideTest);
+
+/// @class CalculateIsInsideFieldAlgo
+/// @brief Marks the elements of a field that are inside an object. With the
+/// "locate" test the object is a volume mesh and a sample is inside if it
+/// lies in one of its elements. With the "winding number" test the object
+/// is a closed or nearly closed surface, the samples are classified by the
+/// generalized winding number of the surface in parallel.
 
 class SCISHARE CalculateIsInsideFieldAlgo : public AlgorithmBase
 {
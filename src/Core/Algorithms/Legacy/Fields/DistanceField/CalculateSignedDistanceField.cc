@@ -27,6 +27,8 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateSignedDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/RegularGridDistance.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
@@ -42,6 +44,90 @@ using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 
+namespace
+{
+  /// Side of the surface a point lies on, given its closest point on
+  /// element fidx. Points right above an edge use the neighboring element
+  /// across the closest edge to break the tie.
+  bool isInside(VMesh* objmesh, const Point& p, double dist, const Point& closest,
+                VMesh::Elem::index_type fidx, double epsilon)
+  {
+    VMesh::Node::array_type nodes;
+    Point n0, n1, n2;
+
+    objmesh->get_nodes(nodes,fidx);
+    objmesh->get_center(n0,nodes[0]);
+    objmesh->get_center(n1,nodes[1]);
+    objmesh->get_center(n2,nodes[2]);
+
+    Vector n = Cross(Vector(n1-n0),Vector(n2-n1));
+    Vector k = Vector(p-closest); k.normalize();
+
+    double angle = Dot(n,k);
+    if (angle < -epsilon) return (true);
+    if (angle > epsilon || dist == 0.0) return (false);
+
+    VMesh::DElem::array_type delems;
+    objmesh->get_delems(delems,fidx);
+    double mindist = DBL_MAX;
+    size_t edgeidx = 0;
+    for (size_t r=0; r<delems.size();r++)
+    {
+      Point p1, p2;
+      objmesh->get_nodes(nodes,delems[r]);
+      objmesh->get_center(p1,nodes[0]);
+      objmesh->get_center(p2,nodes[1]);
+
+      double d;
+      if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
+      {
+        d = (p-p2).length2();
+      }
+      else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
+      {
+        d = (p-p1).length2();
+      }
+      else
+      {
+        Vector v1 = Vector(p1-p2);
+        Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
+        d = Dot(v,v);
+      }
+      if (d < mindist) { mindist = d; edgeidx = r; }
+    }
+
+    VMesh::Elem::index_type fidx_n;
+    if (!objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx])) fidx_n = fidx;
+    objmesh->get_nodes(nodes,fidx_n);
+    objmesh->get_center(n0,nodes[0]);
+    objmesh->get_center(n1,nodes[1]);
+    objmesh->get_center(n2,nodes[2]);
+    n = Cross(Vector(n1-n0),Vector(n2-n1));
+    return (Dot(n,k) < 0.0);
+  }
+
+  /// Signed distances on a regular grid by fast sweeping, the sign of every
+  /// band entry is determined once and travels with its closest point. The
+  /// sweeps therefore have to reach every grid point, max only clamps the
+  /// magnitude afterwards.
+  void signedGridDistance(const RegularGridDistance& grid, VMesh* objmesh,
+                          VField* ofield, double max)
+  {
+    const double epsilon = objmesh->get_epsilon();
+    std::vector<char> inside(grid.band_size());
+    for (VMesh::index_type b = 0; b < grid.band_size(); b++)
+      inside[b] = isInside(objmesh, grid.band_location(b), grid.band_distance(b),
+                           grid.band_closest(b), grid.band_elem(b), epsilon);
+
+    for (VMesh::index_type idx = 0; idx < grid.size(); idx++)
+    {
+      const double val = std::min(grid.distance(idx), max);
+      ofield->set_value(inside[grid.source(idx)] ? -val : val, idx);
+    }
+  }
+
+}
+
 class CalculateSignedDistanceFieldP : public Interruptible
 {
   public:
@@ -661,6 +747,9 @@ class CalculateSignedDistanceFieldP : public Interruptible
 CalculateSignedDistanceFieldAlgo::CalculateSignedDistanceFieldAlgo()
 {
   addParameter(OutputValueField, false);
+  addParameter(Parameters::Truncate, false);
+  addParameter(Parameters::TruncateDistance, 1.0);
+  addOption(Parameters::DistanceMethod, "brute force", "brute force|fast sweeping");
 }
 
 bool
@@ -719,11 +808,38 @@ CalculateSignedDistanceFieldAlgo::run(FieldHandle input, FieldHandle object, Fie
   }
 
   objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::EDGES_E);
+
+  double max = DBL_MAX;
+  if (get(Parameters::Truncate).toBool())
+    max = get(Parameters::TruncateDistance).toDouble();
+
+  if (checkOption(Parameters::DistanceMethod, "fast sweeping"))
+  {
+    RegularGridDistance grid(imesh, ofield->basis_order());
+    if (grid.is_valid())
+    {
+      grid.compute(objmesh, this);
+      signedGridDistance(grid, objmesh, ofield, max);
+      return (true);
+    }
+    remark("Fast sweeping requires a regular grid with orthogonal axes, using a closest element search instead.");
+  }
+
   CalculateSignedDistanceFieldP palgo(imesh, objmesh, ofield, this);
   const int numThreads = Parallel::NumCores();
   auto task_i = [&palgo,numThreads,this](int i) { palgo.parallel(i, numThreads); };
   Parallel::RunTasks(task_i, numThreads);
 
+  if (max < DBL_MAX)
+  {
+    double val;
+    for (VMesh::index_type idx = 0; idx < ofield->num_values(); idx++)
+    {
+      ofield->get_value(val, idx);
+      if (std::fabs(val) > max) ofield->set_value(val < 0.0 ? -max : max, idx);
+    }
+  }
+
   return (true);
 }
 
@@ -808,6 +924,19 @@ CalculateSignedDistanceFieldAlgo::run(FieldHandle input, FieldHandle object, Fie
     return (false);
   }
 
+  if (checkOption(Parameters::DistanceMethod, "fast sweeping"))
+  {
+    RegularGridDistance grid(imesh, dfield->basis_order());
+    if (grid.is_valid())
+    {
+      grid.compute(objmesh, this);
+      signedGridDistance(grid, objmesh, dfield, DBL_MAX);
+      grid.copy_closest_values(objfield, vfield);
+      return (true);
+    }
+    remark("Fast sweeping requires a regular grid with orthogonal axes, using a closest element search instead.");
+  }
+
   CalculateSignedDistanceFieldP palgo(imesh, objmesh, objfield, dfield, vfield, this);
 
   auto task_i = [&palgo,this](int i) { palgo.parallel2(i, Parallel::NumCores()); };
@@ -0,0 +1,319 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Algorithms/Legacy/Fields/DistanceField/RegularGridDistance.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/GeometryPrimitives/Tensor.h>
+
+#include <algorithm>
+
+#include <cmath>
+#include <cfloat>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+RegularGridDistance::RegularGridDistance(VMesh* imesh, int basis_order) :
+  valid_(false), size_(0)
+{
+  if (!imesh->is_regularmesh() || basis_order < 0 || basis_order > 1) return;
+
+  VMesh::dimension_type dims;
+  imesh->get_dimensions(dims);
+  if (dims.empty() || dims.size() > 3) return;
+
+  for (size_t d = 0; d < 3; d++)
+  {
+    dims_[d] = 1;
+    if (d < dims.size()) dims_[d] = (basis_order == 0) ? dims[d] - 1 : dims[d];
+    if (dims_[d] < 1) return;
+  }
+
+  stride_[0] = 1;
+  stride_[1] = dims_[0];
+  stride_[2] = dims_[0]*dims_[1];
+  size_ = dims_[0]*dims_[1]*dims_[2];
+
+  const VMesh::size_type num = (basis_order == 0) ? imesh->num_elems() : imesh->num_nodes();
+  if (num != size_) return;
+
+  // Grid geometry from the locations of the first point along every axis
+  auto center = [imesh, basis_order](VMesh::index_type idx)
+  {
+    Point p;
+    if (basis_order == 0) imesh->get_center(p, VMesh::Elem::index_type(idx));
+    else imesh->get_center(p, VMesh::Node::index_type(idx));
+    return (p);
+  };
+
+  origin_ = center(0);
+  for (size_t d = 0; d < 3; d++)
+  {
+    axis_[d] = Vector(0.0, 0.0, 0.0);
+    if (dims_[d] > 1) axis_[d] = center(stride_[d]) - origin_;
+  }
+
+  for (size_t d = 0; d < 3; d++)
+  {
+    if (dims_[d] > 1 && axis_[d].length2() == 0.0) return;
+    for (size_t e = d+1; e < 3; e++)
+    {
+      const double tol = 1e-8*axis_[d].length()*axis_[e].length();
+      if (std::fabs(Dot(axis_[d], axis_[e])) > tol) return;
+    }
+  }
+
+  valid_ = true;
+}
+
+Point
+RegularGridDistance::location(VMesh::index_type idx) const
+{
+  const VMesh::index_type i = idx % dims_[0];
+  const VMesh::index_type j = (idx / dims_[0]) % dims_[1];
+  const VMesh::index_type k = idx / stride_[2];
+  return (origin_ + static_cast<double>(i)*axis_[0]
+    + static_cast<double>(j)*axis_[1] + static_cast<double>(k)*axis_[2]);
+}
+
+void
+RegularGridDistance::compute(VMesh* objmesh, const AlgorithmBase* algo, double bandwidth,
+                             double max_distance)
+{
+  if (!valid_) return;
+
+  // Mark the grid points within the band around every element
+  double hmax = 0.0;
+  for (size_t d = 0; d < 3; d++) hmax = std::max(hmax, axis_[d].length());
+  const double width = bandwidth*hmax;
+
+  std::vector<char> inband(size_, 0);
+  VMesh::Node::array_type nodes;
+  VMesh::size_type num_elems = objmesh->num_elems();
+
+  for (VMesh::Elem::index_type e = 0; e < num_elems; e++)
+  {
+    checkForInterruption();
+    objmesh->get_nodes(nodes, e);
+
+    double lo[3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+    double hi[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+    for (size_t r = 0; r < nodes.size(); r++)
+    {
+      Point p;
+      objmesh->get_center(p, nodes[r]);
+      const Vector v = p - origin_;
+      for (size_t d = 0; d < 3; d++)
+      {
+        if (dims_[d] == 1) { lo[d] = hi[d] = 0.0; continue; }
+        const double t = Dot(v, axis_[d])/axis_[d].length2();
+        lo[d] = std::min(lo[d], t);
+        hi[d] = std::max(hi[d], t);
+      }
+    }
+
+    VMesh::index_type start[3], end[3];
+    bool outside = false;
+    for (size_t d = 0; d < 3; d++)
+    {
+      const double w = (dims_[d] > 1) ? width/axis_[d].length() : 0.0;
+      const double a = std::floor(lo[d] - w);
+      const double b = std::ceil(hi[d] + w);
+      if (b < 0.0 || a > static_cast<double>(dims_[d]-1)) { outside = true; break; }
+      start[d] = static_cast<VMesh::index_type>(std::max(a, 0.0));
+      end[d] = static_cast<VMesh::index_type>(std::min(b, static_cast<double>(dims_[d]-1)));
+    }
+    if (outside) continue;
+
+    for (VMesh::index_type k = start[2]; k <= end[2]; k++)
+      for (VMesh::index_type j = start[1]; j <= end[1]; j++)
+        for (VMesh::index_type i = start[0]; i <= end[0]; i++)
+          inband[i + stride_[1]*j + stride_[2]*k] = 1;
+  }
+
+  band_.clear();
+  for (VMesh::index_type idx = 0; idx < size_; idx++)
+    if (inband[idx]) band_.push_back(idx);
+
+  // The object does not come near the grid: seed from the grid boundary
+  if (band_.empty())
+  {
+    for (VMesh::index_type idx = 0; idx < size_; idx++)
+    {
+      const VMesh::index_type i = idx % dims_[0];
+      const VMesh::index_type j = (idx / dims_[0]) % dims_[1];
+      const VMesh::index_type k = idx / stride_[2];
+      if (i == 0 || j == 0 || k == 0 || i == dims_[0]-1 ||
+          j == dims_[1]-1 || k == dims_[2]-1) band_.push_back(idx);
+    }
+  }
+
+  // Exact closest points within the band
+  const VMesh::size_type num_band = band_.size();
+  closest_.resize(num_band);
+  elem_.resize(num_band);
+  coords_.resize(num_band);
+  distance_.assign(size_, DBL_MAX);
+  source_.assign(size_, -1);
+
+  auto band_task = [&](int proc)
+  {
+    const int nproc = Parallel::NumCores();
+    const VMesh::index_type start = (num_band*proc)/nproc;
+    const VMesh::index_type end = (num_band*(proc+1))/nproc;
+    int cnt = 0;
+    for (VMesh::index_type b = start; b < end; b++)
+    {
+      checkForInterruption();
+      double dist;
+      const VMesh::index_type idx = band_[b];
+      objmesh->find_closest_elem(dist, closest_[b], coords_[b], elem_[b], location(idx));
+      distance_[idx] = dist;
+      source_[idx] = b;
+      if (proc == 0 && algo) { cnt++; if (cnt == 100) { algo->update_progress_max(b-start, 2*(end-start)); cnt = 0; } }
+    }
+  };
+  Parallel::RunTasks(band_task, Parallel::NumCores());
+
+  // Only grid points within max_distance of the band need sweeping
+  for (size_t d = 0; d < 3; d++)
+  {
+    lo_[d] = 0;
+    hi_[d] = dims_[d]-1;
+  }
+  if (max_distance < DBL_MAX)
+  {
+    VMesh::index_type blo[3] = { dims_[0]-1, dims_[1]-1, dims_[2]-1 };
+    VMesh::index_type bhi[3] = { 0, 0, 0 };
+    for (VMesh::index_type b = 0; b < num_band; b++)
+    {
+      const VMesh::index_type idx = band_[b];
+      const VMesh::index_type ijk[3] = { idx % dims_[0], (idx / dims_[0]) % dims_[1], idx / stride_[2] };
+      for (size_t d = 0; d < 3; d++)
+      {
+        blo[d] = std::min(blo[d], ijk[d]);
+        bhi[d] = std::max(bhi[d], ijk[d]);
+      }
+    }
+    for (size_t d = 0; d < 3; d++)
+    {
+      if (dims_[d] == 1) continue;
+      const double cells = std::ceil(max_distance/axis_[d].length());
+      const VMesh::index_type reach = (cells < static_cast<double>(dims_[d])) ?
+        static_cast<VMesh::index_type>(cells) : dims_[d];
+      lo_[d] = std::max<VMesh::index_type>(0, blo[d] - reach);
+      hi_[d] = std::min<VMesh::index_type>(dims_[d]-1, bhi[d] + reach);
+    }
+  }
+
+  // Propagate the closest points outward
+  for (int pass = 0; pass < 4; pass++)
+  {
+    bool changed = false;
+    for (int s = 0; s < 8; s++)
+    {
+      checkForInterruption();
+      sweep((s & 1) ? -1 : 1, (s & 2) ? -1 : 1, (s & 4) ? -1 : 1, max_distance, changed);
+    }
+    if (algo) algo->update_progress_max(pass+5, 8);
+    if (!changed) break;
+  }
+}
+
+void
+RegularGridDistance::sweep(int si, int sj, int sk, double max_distance, bool& changed)
+{
+  const VMesh::index_type ni = dims_[0], nj = dims_[1], nk = dims_[2];
+
+  for (VMesh::index_type kk = lo_[2]; kk <= hi_[2]; kk++)
+  {
+    const VMesh::index_type k = (sk > 0) ? kk : lo_[2]+hi_[2]-kk;
+    for (VMesh::index_type jj = lo_[1]; jj <= hi_[1]; jj++)
+    {
+      const VMesh::index_type j = (sj > 0) ? jj : lo_[1]+hi_[1]-jj;
+      const Point row = origin_ + static_cast<double>(j)*axis_[1] + static_cast<double>(k)*axis_[2];
+      for (VMesh::index_type ii = lo_[0]; ii <= hi_[0]; ii++)
+      {
+        const VMesh::index_type i = (si > 0) ? ii : lo_[0]+hi_[0]-ii;
+        const VMesh::index_type idx = i + stride_[1]*j + stride_[2]*k;
+
+        VMesh::index_type src = source_[idx];
+        // Band points hold exact values
+        if (src >= 0 && band_[src] == idx) continue;
+
+        VMesh::index_type nbrs[3] = { -1, -1, -1 };
+        if (i-si >= 0 && i-si < ni) nbrs[0] = idx - si*stride_[0];
+        if (j-sj >= 0 && j-sj < nj) nbrs[1] = idx - sj*stride_[1];
+        if (k-sk >= 0 && k-sk < nk) nbrs[2] = idx - sk*stride_[2];
+
+        const Point p = row + static_cast<double>(i)*axis_[0];
+        double dist = distance_[idx];
+        for (int n = 0; n < 3; n++)
+        {
+          if (nbrs[n] < 0) continue;
+          const VMesh::index_type cand = source_[nbrs[n]];
+          if (cand < 0 || cand == src) continue;
+          const double d = (p - closest_[cand]).length();
+          if (d < dist && d <= max_distance) { dist = d; src = cand; }
+        }
+
+        if (src != source_[idx])
+        {
+          distance_[idx] = dist;
+          source_[idx] = src;
+          changed = true;
+        }
+      }
+    }
+  }
+}
+
+template <class T>
+void
+RegularGridDistance::copy_closest_values(VField* objfield, VField* vfield) const
+{
+  std::vector<T> values(band_.size());
+  for (VMesh::index_type b = 0; b < band_size(); b++)
+    objfield->interpolate(values[b], coords_[b], elem_[b]);
+
+  for (VMesh::index_type idx = 0; idx < size_; idx++)
+    if (source_[idx] >= 0) vfield->set_value(values[source_[idx]], idx);
+}
+
+void
+RegularGridDistance::copy_closest_values(VField* objfield, VField* vfield) const
+{
+  if (objfield->is_scalar()) copy_closest_values<double>(objfield, vfield);
+  else if (objfield->is_vector()) copy_closest_values<Vector>(objfield, vfield);
+  else if (objfield->is_tensor()) copy_closest_values<Tensor>(objfield, vfield);
+}
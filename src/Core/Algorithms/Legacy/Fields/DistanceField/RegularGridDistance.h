@@ -0,0 +1,122 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_REGULARGRIDDISTANCE_H
+#define CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_REGULARGRIDDISTANCE_H 1
+
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Thread/Interruptible.h>
+#include <cfloat>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+/// @class RegularGridDistance
+/// @brief Closest point transform of an object mesh on the nodes or cells of
+/// a regular grid with orthogonal axes.
+///
+/// Grid points within a narrow band around the object get their exact
+/// closest point from VMesh::find_closest_elem. The closest points are then
+/// propagated to the rest of the grid by fast sweeping: eight Gauss-Seidel
+/// passes, one per octant direction, in which each point adopts the closest
+/// point of an upwind neighbor if that one is nearer. The cost is linear in
+/// the grid size plus the band queries, instead of one closest element search
+/// for every grid point. Away from the band the result is approximate, the
+/// error is bounded by the grid spacing and is usually far smaller.
+
+class SCISHARE RegularGridDistance : public Core::Thread::Interruptible
+{
+  public:
+    /// basis_order selects the grid: 1 for the nodes, 0 for the cell centers.
+    RegularGridDistance(VMesh* imesh, int basis_order);
+
+    /// False if the destination is not a regular grid with orthogonal axes,
+    /// callers should fall back to a search per grid point.
+    bool is_valid() const { return (valid_); }
+
+    /// Compute the closest points. bandwidth is the band width in grid cells.
+    /// The sweeps stop at max_distance: they only visit the grid points
+    /// within that distance of the band and do not propagate farther.
+    void compute(VMesh* objmesh, const AlgorithmBase* algo, double bandwidth = 2.0,
+                 double max_distance = DBL_MAX);
+
+    VMesh::size_type size() const { return (size_); }
+    /// DBL_MAX for grid points beyond max_distance.
+    double distance(VMesh::index_type idx) const { return (distance_[idx]); }
+
+    /// The band entry holding the closest point of a grid point, -1 for grid
+    /// points beyond max_distance.
+    VMesh::index_type source(VMesh::index_type idx) const { return (source_[idx]); }
+
+    /// Interpolate objfield at the closest point of every grid point into
+    /// vfield, grid points beyond max_distance are left untouched.
+    void copy_closest_values(VField* objfield, VField* vfield) const;
+
+    /// Band entries: the grid point that seeded the entry and its exact
+    /// closest point on the object.
+    VMesh::size_type band_size() const { return (band_.size()); }
+    Core::Geometry::Point band_location(VMesh::index_type b) const { return (location(band_[b])); }
+    const Core::Geometry::Point& band_closest(VMesh::index_type b) const { return (closest_[b]); }
+    VMesh::Elem::index_type band_elem(VMesh::index_type b) const { return (elem_[b]); }
+    const VMesh::coords_type& band_coords(VMesh::index_type b) const { return (coords_[b]); }
+    double band_distance(VMesh::index_type b) const { return (distance_[band_[b]]); }
+
+  private:
+    Core::Geometry::Point location(VMesh::index_type idx) const;
+    template <class T>
+    void copy_closest_values(VField* objfield, VField* vfield) const;
+    void sweep(int si, int sj, int sk, double max_distance, bool& changed);
+
+    bool valid_;
+    VMesh::size_type size_;
+    VMesh::size_type dims_[3];
+    VMesh::size_type stride_[3];
+    /// Grid points visited by the sweeps, [lo_,hi_] along every axis
+    VMesh::index_type lo_[3];
+    VMesh::index_type hi_[3];
+    Core::Geometry::Point origin_;
+    Core::Geometry::Vector axis_[3];
+
+    std::vector<double> distance_;
+    std::vector<VMesh::index_type> source_;
+
+    std::vector<VMesh::index_type> band_;
+    std::vector<Core::Geometry::Point> closest_;
+    std::vector<VMesh::Elem::index_type> elem_;
+    std::vector<VMesh::coords_type> coords_;
+};
+
+}}}}
+
+#endif
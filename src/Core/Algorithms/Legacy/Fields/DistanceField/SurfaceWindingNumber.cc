@@ -0,0 +1,200 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Legacy/Fields/DistanceField/SurfaceWindingNumber.h>
+#include <Core/Math/MiscMath.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+namespace
+{
+  const int leafSize = 8;
+}
+
+SurfaceWindingNumber::SurfaceWindingNumber(VMesh* surface, double accuracy) :
+  valid_(false), accuracy2_(accuracy*accuracy)
+{
+  if (!surface || !surface->is_surface()) return;
+
+  // Split the elements into triangles, quadrilaterals along their first
+  // diagonal
+  VMesh::Node::array_type nodes;
+  VMesh::size_type num_elems = surface->num_elems();
+  vertices_.reserve(3*num_elems);
+
+  for (VMesh::Elem::index_type idx = 0; idx < num_elems; idx++)
+  {
+    surface->get_nodes(nodes, idx);
+    if (nodes.size() < 3) continue;
+
+    Point p[4];
+    for (size_t r = 0; r < nodes.size() && r < 4; r++) surface->get_center(p[r], nodes[r]);
+
+    vertices_.push_back(p[0]); vertices_.push_back(p[1]); vertices_.push_back(p[2]);
+    if (nodes.size() == 4)
+    {
+      vertices_.push_back(p[0]); vertices_.push_back(p[2]); vertices_.push_back(p[3]);
+    }
+  }
+
+  const int num_triangles = static_cast<int>(vertices_.size()/3);
+  centroids_.resize(num_triangles);
+  for (int t = 0; t < num_triangles; t++)
+    centroids_[t] = Point((Vector(vertices_[3*t]) + Vector(vertices_[3*t+1]) + Vector(vertices_[3*t+2]))/3.0);
+
+  if (num_triangles > 0)
+  {
+    clusters_.reserve(2*(num_triangles/leafSize+1));
+    build(0, num_triangles);
+  }
+  valid_ = true;
+}
+
+int
+SurfaceWindingNumber::build(int first, int count)
+{
+  const int index = static_cast<int>(clusters_.size());
+  clusters_.push_back(Cluster());
+
+  // Dipole: area weighted normal at the area weighted center
+  Vector normal(0.0, 0.0, 0.0);
+  Vector center(0.0, 0.0, 0.0);
+  double area = 0.0;
+  Point lo(DBL_MAX, DBL_MAX, DBL_MAX), hi(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+
+  for (int t = first; t < first+count; t++)
+  {
+    const Point& a = vertices_[3*t];
+    const Vector n = 0.5*Cross(vertices_[3*t+1] - a, vertices_[3*t+2] - a);
+    const double w = n.length();
+    normal += n;
+    center += w*Vector(centroids_[t]);
+    area += w;
+    lo = Min(lo, centroids_[t]);
+    hi = Max(hi, centroids_[t]);
+  }
+
+  Cluster cluster;
+  cluster.center = (area > 0.0) ? Point(center/area) : Point(0.5*(Vector(lo) + Vector(hi)));
+  cluster.normal = normal;
+  cluster.radius = 0.0;
+  for (int v = 3*first; v < 3*(first+count); v++)
+    cluster.radius = std::max(cluster.radius, (vertices_[v] - cluster.center).length());
+  cluster.left = cluster.right = -1;
+  cluster.first = first;
+  cluster.count = count;
+
+  if (count > leafSize)
+  {
+    // Split at the median along the longest axis of the centroids
+    const Vector ext = hi - lo;
+    const int axis = (ext.x() >= ext.y() && ext.x() >= ext.z()) ? 0 : ((ext.y() >= ext.z()) ? 1 : 2);
+    const int half = count/2;
+
+    std::vector<int> order(count);
+    for (int k = 0; k < count; k++) order[k] = first + k;
+    std::nth_element(order.begin(), order.begin() + half, order.end(),
+      [this, axis](int a, int b) { return (centroids_[a][axis] < centroids_[b][axis]); });
+
+    std::vector<Point> vertices(3*count);
+    std::vector<Point> centroids(count);
+    for (int k = 0; k < count; k++)
+    {
+      for (int r = 0; r < 3; r++) vertices[3*k+r] = vertices_[3*order[k]+r];
+      centroids[k] = centroids_[order[k]];
+    }
+    std::copy(vertices.begin(), vertices.end(), vertices_.begin() + 3*first);
+    std::copy(centroids.begin(), centroids.end(), centroids_.begin() + first);
+
+    cluster.left = build(first, half);
+    cluster.right = build(first + half, count - half);
+  }
+
+  clusters_[index] = cluster;
+  return (index);
+}
+
+double
+SurfaceWindingNumber::triangle_solid_angle(int t, const Point& p) const
+{
+  // Van Oosterom and Strackee
+  const Vector a = vertices_[3*t] - p;
+  const Vector b = vertices_[3*t+1] - p;
+  const Vector c = vertices_[3*t+2] - p;
+  const double la = a.length(), lb = b.length(), lc = c.length();
+  const double det = Dot(a, Cross(b, c));
+  const double den = la*lb*lc + Dot(a, b)*lc + Dot(b, c)*la + Dot(c, a)*lb;
+  return (2.0*std::atan2(det, den));
+}
+
+double
+SurfaceWindingNumber::winding_number(const Point& p) const
+{
+  if (clusters_.empty()) return (0.0);
+
+  double omega = 0.0;
+  int stack[128];
+  int top = 0;
+  stack[top++] = 0;
+
+  while (top > 0)
+  {
+    const Cluster& cluster = clusters_[stack[--top]];
+    const Vector d = cluster.center - p;
+    const double dist2 = d.length2();
+
+    if (dist2 > accuracy2_*cluster.radius*cluster.radius)
+    {
+      omega += Dot(d, cluster.normal)/(dist2*std::sqrt(dist2));
+    }
+    else if (cluster.left < 0)
+    {
+      for (int t = cluster.first; t < cluster.first + cluster.count; t++)
+        omega += triangle_solid_angle(t, p);
+    }
+    else
+    {
+      stack[top++] = cluster.left;
+      stack[top++] = cluster.right;
+    }
+  }
+
+  return (omega/(4.0*M_PI));
+}
+
+bool
+SurfaceWindingNumber::is_inside(const Point& p) const
+{
+  return (std::fabs(winding_number(p)) >= 0.5);
+}
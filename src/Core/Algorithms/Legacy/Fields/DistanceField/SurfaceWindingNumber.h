@@ -0,0 +1,92 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_SURFACEWINDINGNUMBER_H
+#define CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_SURFACEWINDINGNUMBER_H 1
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+/// @class SurfaceWindingNumber
+/// @brief Generalized winding number of a triangle or quadrilateral surface.
+///
+/// The winding number is the signed solid angle of the surface seen from a
+/// point divided by 4 pi: 1 inside a closed outward oriented surface, 0
+/// outside, and a smooth value in between near holes, which makes the
+/// inside test robust for surfaces that are not quite closed. The elements
+/// are stored in a bounding volume hierarchy; clusters that are far away
+/// compared to their size are evaluated as a single dipole (the area
+/// weighted normal at the cluster center), so a query costs O(log n)
+/// instead of O(n). The class is read only after construction and can be
+/// queried from several threads.
+
+class SCISHARE SurfaceWindingNumber
+{
+  public:
+    /// accuracy is the distance, in cluster radii, beyond which a cluster
+    /// is replaced by its dipole. Larger values are more accurate.
+    explicit SurfaceWindingNumber(VMesh* surface, double accuracy = 2.0);
+
+    /// False if the mesh is not a surface mesh.
+    bool is_valid() const { return (valid_); }
+
+    double winding_number(const Core::Geometry::Point& p) const;
+
+    /// Inside if the absolute winding number is at least one half, the
+    /// absolute value makes the test independent of the orientation.
+    bool is_inside(const Core::Geometry::Point& p) const;
+
+  private:
+    struct Cluster
+    {
+      Core::Geometry::Point  center;
+      Core::Geometry::Vector normal;
+      double radius;
+      // Children for inner clusters, a triangle range for leaves
+      int left, right;
+      int first, count;
+    };
+
+    int build(int first, int count);
+    double triangle_solid_angle(int t, const Core::Geometry::Point& p) const;
+
+    bool valid_;
+    double accuracy2_;
+    std::vector<Core::Geometry::Point> vertices_;
+    std::vector<Core::Geometry::Point> centroids_;
+    std::vector<Cluster> clusters_;
+};
+
+}}}}
+
+#endif
@@ -122,3 +122,28 @@ MatrixHandle BaseMC::get_parent_cells()
     return MatrixHandle();
 }
 
+
+void BaseMC::get_node_keys(std::vector<edgepair_t>& keys, SCIRun::size_type num_nodes) const
+{
+  edgepair_t none;
+  none.first = -1;
+  none.second = -1;
+  none.dfirst = 0.0;
+  keys.assign(num_nodes, none);
+
+  if (basis_order_ == 0)
+  {
+    for (size_t n = 0; n < node_map_.size(); n++)
+    {
+      const SCIRun::index_type i = node_map_[n];
+      if (i >= 0 && i < num_nodes) keys[i].first = static_cast<SCIRun::index_type>(n);
+    }
+  }
+  else
+  {
+    for (edge_hash_type::const_iterator it = edge_map_.begin(); it != edge_map_.end(); ++it)
+    {
+      if ((*it).second >= 0 && (*it).second < num_nodes) keys[(*it).second] = (*it).first;
+    }
+  }
+}
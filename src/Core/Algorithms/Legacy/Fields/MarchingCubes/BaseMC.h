@@ -87,7 +87,14 @@ namespace SCIRun {
       SCIRun::index_type second;
       double dfirst;
     };
-  protected:
+
+    /// Key of every node of the extracted field: the cut edge for node
+    /// data, the source node (second = -1) for cell data. Nodes without a
+    /// key get first = second = -1. Tesselators that run on separate parts
+    /// of the same mesh produce equal keys for shared nodes, this is used
+    /// to weld their results.
+    void get_node_keys(std::vector<edgepair_t>& keys, SCIRun::size_type num_nodes) const;
+
     struct edgepairhash
     {
       size_t operator()(const edgepair_t &a) const
@@ -99,6 +106,8 @@ namespace SCIRun {
 
     typedef boost::unordered_map<edgepair_t, SCIRun::index_type, edgepairhash> edge_hash_type;
 
+  protected:
+
     std::vector<SCIRun::index_type> cell_map_;  // Unique cells when surfacing node data.
     std::vector<SCIRun::index_type> node_map_;  // Unique nodes when surfacing cell data.
 
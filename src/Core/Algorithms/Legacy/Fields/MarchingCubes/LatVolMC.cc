@@ -0,0 +1,212 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/LatVolMC.h>
+
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/mcube2.h>
+
+#include <Core/Math/MiscMath.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  // Corner offsets in the order of VMesh::get_nodes for a LatVol cell
+  const int corner[8][3] = { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0},
+                             {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1} };
+}
+
+LatVolMC::LatVolMC( FieldHandle field ) :
+  field_handle_(field),
+  field_(field->vfield()),
+  mesh_(field->vmesh()),
+  trisurf_(0),
+  ni_(0), nj_(0), nk_(0),
+  node_(8)
+{
+  VMesh::dimension_type dims;
+  mesh_->get_dimensions(dims);
+  if (dims.size() == 3)
+  {
+    ni_ = dims[0]; nj_ = dims[1]; nk_ = dims[2];
+  }
+
+  // The lattice is affine: node (i,j,k) = origin + i*axis0 + j*axis1 + k*axis2
+  mesh_->get_center(origin_, VMesh::Node::index_type(0));
+  const index_type stride[3] = { 1, ni_, ni_*nj_ };
+  const index_type size[3] = { ni_, nj_, nk_ };
+  for (int d = 0; d < 3; d++)
+  {
+    axis_[d] = Vector(0.0, 0.0, 0.0);
+    if (size[d] > 1)
+    {
+      Point p;
+      mesh_->get_center(p, VMesh::Node::index_type(stride[d]));
+      axis_[d] = p - origin_;
+    }
+  }
+}
+
+void LatVolMC::reset( int /*n*/, bool build_field, bool build_geom, bool /*transparency*/ )
+{
+  build_field_ = build_field;
+  build_geom_  = build_geom;
+  basis_order_ = field_->basis_order();
+
+  edge_map_.clear();
+  nnodes_ = ni_*nj_*nk_;
+
+  cell_map_.clear();
+  ncells_ = (ni_-1)*(nj_-1)*(nk_-1);
+
+  trisurf_ = 0;
+  if (build_field_)
+  {
+    FieldInformation fi("TriSurfMesh",basis_order_,"double");
+    trisurf_handle_ = CreateField(fi);
+    trisurf_ = trisurf_handle_->vmesh();
+  }
+}
+
+void LatVolMC::extract( VMesh::Elem::index_type cell, double iso )
+{
+  const index_type i = cell % (ni_-1);
+  const index_type jk = cell / (ni_-1);
+  const index_type j = jk % (nj_-1);
+  const index_type k = jk / (nj_-1);
+
+  const index_type nij = ni_*nj_;
+  const index_type a = i + ni_*j + nij*k;
+  node_[0] = a;
+  node_[1] = a+1;
+  node_[2] = a+1+ni_;
+  node_[3] = a+ni_;
+  node_[4] = a+nij;
+  node_[5] = a+1+nij;
+  node_[6] = a+1+ni_+nij;
+  node_[7] = a+ni_+nij;
+
+  double value[8];
+  field_->get_values(value,node_);
+
+  int code = 0;
+  for (int n=7; n>=0; n--)
+  {
+    // skip anything with a NaN
+    if (IsNan(value[n])) return;
+    code = code*2+(value[n] < iso );
+  }
+
+  if ( code == 0 || code == 255 )
+    return;
+
+  TRIANGLE_CASES *tcase= &triCases[code];
+  int *vertex = tcase->edges;
+
+  const Point base = origin_ + static_cast<double>(i)*axis_[0] +
+    static_cast<double>(j)*axis_[1] + static_cast<double>(k)*axis_[2];
+
+  VMesh::Node::index_type surf_node[12];
+
+  // interpolate the cut edges
+  index_type v = 0;
+  bool visited[12];
+  for (int e=0;e<12;e++) visited[e] = false;
+
+  while (vertex[v] != -1)
+  {
+    index_type e = vertex[v++];
+    if (visited[e]) continue;
+    visited[e]=true;
+    index_type v1 = edge_tab[e][0];
+    index_type v2 = edge_tab[e][1];
+    const double d = (value[v1]-iso) / double(value[v1]-value[v2]);
+    if (build_field_)
+    {
+      const Point p1 = base + static_cast<double>(corner[v1][0])*axis_[0] +
+        static_cast<double>(corner[v1][1])*axis_[1] + static_cast<double>(corner[v1][2])*axis_[2];
+      const Point p2 = base + static_cast<double>(corner[v2][0])*axis_[0] +
+        static_cast<double>(corner[v2][1])*axis_[1] + static_cast<double>(corner[v2][2])*axis_[2];
+      surf_node[e] = find_or_add_edgepoint(node_[v1], node_[v2], d, Interpolate(p1, p2, d));
+    }
+  }
+
+  if (!build_field_) return;
+
+  v = 0;
+  VMesh::Node::array_type nodes(3);
+  while(vertex[v] != -1)
+  {
+    index_type v0 = vertex[v++];
+    index_type v1 = vertex[v++];
+    index_type v2 = vertex[v++];
+
+    if (surf_node[v0] != surf_node[v1] &&
+        surf_node[v1] != surf_node[v2] &&
+        surf_node[v2] != surf_node[v0])
+    {
+      nodes[0] = surf_node[v0];
+      nodes[1] = surf_node[v1];
+      nodes[2] = surf_node[v2];
+      trisurf_->add_elem(nodes);
+      cell_map_.push_back( cell );
+    }
+  }
+}
+
+FieldHandle LatVolMC::get_field(double value)
+{
+  trisurf_handle_->vfield()->resize_values();
+  trisurf_handle_->vfield()->set_all_values(value);
+  return (trisurf_handle_);
+}
+
+VMesh::Node::index_type LatVolMC::find_or_add_edgepoint(index_type u0, index_type u1, double d0, const Point &p)
+{
+  if (d0 < 0.0) { u1 = -1; }
+  if (d0 > 1.0) { u0 = -1; }
+  edgepair_t np;
+
+  if (u0 < u1)  { np.first = u0; np.second = u1; np.dfirst = d0; }
+  else { np.first = u1; np.second = u0; np.dfirst = 1.0 - d0; }
+  const edge_hash_type::iterator loc = edge_map_.find(np);
+
+  if (loc == edge_map_.end())
+  {
+    const VMesh::Node::index_type nodeindex = trisurf_->add_point(p);
+    edge_map_[np] = nodeindex;
+    return (nodeindex);
+  }
+  else
+  {
+    return ((*loc).second);
+  }
+}
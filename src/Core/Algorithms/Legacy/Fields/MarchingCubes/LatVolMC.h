@@ -0,0 +1,78 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_LEGACY_FIELDS_MARCHINGCUBES_LATVOLMC_H
+#define CORE_ALGORITHMS_LEGACY_FIELDS_MARCHINGCUBES_LATVOLMC_H 1
+
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/BaseMC.h>
+
+namespace SCIRun {
+
+/// Marching cubes for node data on a LatVol. The same tesselation as
+/// HexMC, but node indices are computed from the cell index and points
+/// from the lattice axes, so a cell costs one virtual call for the values
+/// instead of a mesh lookup of every corner. Cell data is left to HexMC.
+class LatVolMC : public BaseMC
+{
+  public:
+
+    explicit LatVolMC( FieldHandle field );
+    virtual ~LatVolMC() {}
+
+    void extract( VMesh::Elem::index_type, double);
+
+    virtual void reset( int, bool build_field, bool build_geom, bool transparency );
+    virtual FieldHandle get_field(double val);
+
+  private:
+
+    VMesh::Node::index_type find_or_add_edgepoint(index_type n0, index_type n1, double d0, const Core::Geometry::Point &p);
+
+    FieldHandle field_handle_;
+    VField*     field_;
+    VMesh*      mesh_;
+
+    VMesh*      trisurf_;
+    FieldHandle trisurf_handle_;
+
+    index_type  ni_, nj_, nk_;
+    Core::Geometry::Point  origin_;
+    Core::Geometry::Vector axis_[3];
+
+    VMesh::Node::array_type node_;
+};
+
+} // namespace SCIRun
+#endif
@@ -32,14 +32,21 @@
 
 #include <Core/Thread/Parallel.h>
 #include <Core/Thread/Mutex.h>
+#include <Core/Thread/Interruptible.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/MarchingCubes.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Algorithms/Math/AppendMatrix.h>
 #include <Core/Algorithms/Legacy/Fields/MergeFields/AppendFieldsAlgo.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Math/MiscMath.h>
+
+#include <algorithm>
+#include <cfloat>
 
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/HexMC.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/LatVolMC.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/UHexMC.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/PrismMC.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/TetMC.h>
@@ -60,6 +67,7 @@ using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Algorithm::Fields;
 using namespace SCIRun::Core::Algorithm::Fields::Math;
+using namespace SCIRun::Core::Geometry;
 
 MarchingCubesAlgo::MarchingCubesAlgo()
 {
@@ -69,6 +77,7 @@ MarchingCubesAlgo::MarchingCubesAlgo()
   addParameter(build_node_interpolant,false);
   addParameter(build_elem_interpolant,false);
   addParameter(num_threads,-1);
+  addParameter(sample_stride,1);
 }
 
 AlgorithmParameterName MarchingCubesAlgo::transparency("transparency");
@@ -77,6 +86,7 @@ AlgorithmParameterName MarchingCubesAlgo::build_field("build_field");
 AlgorithmParameterName MarchingCubesAlgo::build_node_interpolant("build_node_interpolant");
 AlgorithmParameterName MarchingCubesAlgo::build_elem_interpolant("build_elem_interpolant");
 AlgorithmParameterName MarchingCubesAlgo::num_threads("num_threads");
+AlgorithmParameterName MarchingCubesAlgo::sample_stride("sample_stride");
 
 AlgorithmOutput MarchingCubesAlgo::run(const AlgorithmInput& input) const
 {
@@ -86,6 +96,252 @@ AlgorithmOutput MarchingCubesAlgo::run(const AlgorithmInput& input) const
 }
 
 
+namespace {
+
+/// Groups the elements into blocks and keeps the range of the node values
+/// of every block, so that blocks that cannot contain an isovalue are
+/// skipped without visiting their elements. The ranges are computed once
+/// and shared by all isovalues. A LatVol is split into bricks of cells,
+/// other meshes into runs of consecutive elements, which works best when
+/// the elements are ordered spatially (see ReorderMesh).
+class ElementBlocks
+{
+  public:
+    explicit ElementBlocks(VMesh* mesh);
+
+    size_type num_blocks() const { return (num_blocks_); }
+    void get_elems(index_type block, std::vector<VMesh::Elem::index_type>& elems) const;
+
+    /// Only meaningful for node data; without ranges every block is active.
+    void compute_ranges(VMesh* mesh, VField* field, int nproc);
+
+    bool active(index_type block, double iso) const
+    {
+      if (min_.empty()) return (true);
+      // A cell produces output if some value is below iso and some is not
+      return (min_[block] < iso && iso <= max_[block]);
+    }
+
+  private:
+    static const size_type brick_size = 8;
+    static const size_type run_size = 512;
+
+    bool bricks_;
+    size_type num_elems_;
+    size_type num_blocks_;
+    // Cells per axis and bricks per axis for a LatVol
+    size_type ci_, cj_, ck_;
+    size_type bi_, bj_, bk_;
+
+    std::vector<double> min_;
+    std::vector<double> max_;
+};
+
+ElementBlocks::ElementBlocks(VMesh* mesh) :
+  bricks_(false), num_elems_(mesh->num_elems()), num_blocks_(0),
+  ci_(0), cj_(0), ck_(0), bi_(0), bj_(0), bk_(0)
+{
+  VMesh::dimension_type dims;
+  if (mesh->is_latvolmesh())
+  {
+    mesh->get_dimensions(dims);
+    if (dims.size() == 3 && dims[0] > 1 && dims[1] > 1 && dims[2] > 1)
+    {
+      bricks_ = true;
+      ci_ = dims[0]-1; cj_ = dims[1]-1; ck_ = dims[2]-1;
+      bi_ = (ci_+brick_size-1)/brick_size;
+      bj_ = (cj_+brick_size-1)/brick_size;
+      bk_ = (ck_+brick_size-1)/brick_size;
+      num_blocks_ = bi_*bj_*bk_;
+    }
+  }
+
+  if (!bricks_) num_blocks_ = (num_elems_+run_size-1)/run_size;
+}
+
+void
+ElementBlocks::get_elems(index_type block, std::vector<VMesh::Elem::index_type>& elems) const
+{
+  elems.clear();
+  if (bricks_)
+  {
+    const index_type i0 = (block % bi_)*brick_size;
+    const index_type j0 = ((block / bi_) % bj_)*brick_size;
+    const index_type k0 = (block / (bi_*bj_))*brick_size;
+    const index_type i1 = std::min(i0+brick_size, ci_);
+    const index_type j1 = std::min(j0+brick_size, cj_);
+    const index_type k1 = std::min(k0+brick_size, ck_);
+
+    for (index_type k = k0; k < k1; k++)
+      for (index_type j = j0; j < j1; j++)
+        for (index_type i = i0; i < i1; i++)
+          elems.push_back(VMesh::Elem::index_type(i + ci_*(j + cj_*k)));
+  }
+  else
+  {
+    const index_type start = block*run_size;
+    const index_type end = std::min(start+run_size, num_elems_);
+    for (index_type idx = start; idx < end; idx++)
+      elems.push_back(VMesh::Elem::index_type(idx));
+  }
+}
+
+void
+ElementBlocks::compute_ranges(VMesh* mesh, VField* field, int nproc)
+{
+  min_.assign(num_blocks_, DBL_MAX);
+  max_.assign(num_blocks_, -DBL_MAX);
+
+  auto task = [&](int proc)
+  {
+    const index_type start = (num_blocks_*proc)/nproc;
+    const index_type end = (num_blocks_*(proc+1))/nproc;
+
+    std::vector<VMesh::Elem::index_type> elems;
+    VMesh::Node::array_type nodes;
+    std::vector<double> values;
+
+    for (index_type b = start; b < end; b++)
+    {
+      nodes.clear();
+      if (bricks_)
+      {
+        // The nodes of a brick, shared nodes are read once
+        const index_type ni = ci_+1, nj = cj_+1;
+        const index_type i0 = (b % bi_)*brick_size;
+        const index_type j0 = ((b / bi_) % bj_)*brick_size;
+        const index_type k0 = (b / (bi_*bj_))*brick_size;
+        const index_type i1 = std::min(i0+brick_size, ci_);
+        const index_type j1 = std::min(j0+brick_size, cj_);
+        const index_type k1 = std::min(k0+brick_size, ck_);
+
+        for (index_type k = k0; k <= k1; k++)
+          for (index_type j = j0; j <= j1; j++)
+            for (index_type i = i0; i <= i1; i++)
+              nodes.push_back(VMesh::Node::index_type(i + ni*(j + nj*k)));
+      }
+      else
+      {
+        VMesh::Node::array_type elem_nodes;
+        get_elems(b, elems);
+        for (size_t e = 0; e < elems.size(); e++)
+        {
+          mesh->get_nodes(elem_nodes, elems[e]);
+          nodes.insert(nodes.end(), elem_nodes.begin(), elem_nodes.end());
+        }
+      }
+
+      field->get_values(values, nodes);
+
+      // Cells with a NaN are skipped by the tesselators, so NaNs do not
+      // count; a block of NaNs is never active
+      double lo = DBL_MAX, hi = -DBL_MAX;
+      for (size_t r = 0; r < values.size(); r++)
+      {
+        if (IsNan(values[r])) continue;
+        if (values[r] < lo) lo = values[r];
+        if (values[r] > hi) hi = values[r];
+      }
+      min_[b] = lo;
+      max_[b] = hi;
+    }
+  };
+
+  Parallel::RunTasks(task, nproc);
+}
+
+/// Resample node data of a LatVol on a coarser lattice spanning the same
+/// box, stride fine cells per coarse cell. The coarse nodes are spread
+/// evenly, so the values are interpolated trilinearly between fine nodes.
+FieldHandle subsample_latvol(FieldHandle input, size_type stride)
+{
+  VMesh* imesh = input->vmesh();
+  VField* ifield = input->vfield();
+
+  VMesh::dimension_type dims;
+  imesh->get_dimensions(dims);
+  if (dims.size() != 3) return (input);
+
+  VMesh::dimension_type cdims(3);
+  Vector scale;
+  bool coarser = false;
+  for (size_t d = 0; d < 3; d++)
+  {
+    cdims[d] = (dims[d] > 1) ? (dims[d]-2)/stride + 2 : 1;
+    if (cdims[d] < dims[d]) coarser = true;
+    scale[d] = (cdims[d] > 1) ? double(dims[d]-1)/double(cdims[d]-1) : 1.0;
+  }
+  if (!coarser) return (input);
+
+  FieldInformation fi(input);
+  fi.make_double();
+  MeshHandle mesh = CreateMesh(fi, cdims[0], cdims[1], cdims[2]);
+  Transform transform = imesh->get_transform();
+  transform.post_scale(scale);
+  mesh->vmesh()->set_transform(transform);
+
+  FieldHandle output = CreateField(fi, mesh);
+  VField* ofield = output->vfield();
+  ofield->resize_values();
+
+  const size_type ni = dims[0], nj = dims[1];
+  const size_type num_slices = cdims[2];
+  const int nproc = Parallel::NumCores();
+
+  auto task = [&](int proc)
+  {
+    const index_type start = (num_slices*proc)/nproc;
+    const index_type end = (num_slices*(proc+1))/nproc;
+
+    double x[3], w[3], v[8];
+    index_type f[3];
+    for (index_type k = start; k < end; k++)
+    {
+      Interruptible::checkForInterruption();
+      for (index_type j = 0; j < cdims[1]; j++)
+      {
+        for (index_type i = 0; i < cdims[0]; i++)
+        {
+          const index_type c[3] = { i, j, k };
+          for (int d = 0; d < 3; d++)
+          {
+            x[d] = c[d]*scale[d];
+            f[d] = std::min(static_cast<index_type>(x[d]), std::max<index_type>(dims[d]-2, 0));
+            w[d] = (dims[d] > 1) ? x[d] - f[d] : 0.0;
+          }
+
+          const index_type di = (dims[0] > 1) ? 1 : 0;
+          const index_type dj = (dims[1] > 1) ? ni : 0;
+          const index_type dk = (dims[2] > 1) ? ni*nj : 0;
+          const index_type base = f[0] + ni*(f[1] + nj*f[2]);
+          ifield->get_value(v[0], VMesh::Node::index_type(base));
+          ifield->get_value(v[1], VMesh::Node::index_type(base+di));
+          ifield->get_value(v[2], VMesh::Node::index_type(base+dj));
+          ifield->get_value(v[3], VMesh::Node::index_type(base+di+dj));
+          ifield->get_value(v[4], VMesh::Node::index_type(base+dk));
+          ifield->get_value(v[5], VMesh::Node::index_type(base+di+dk));
+          ifield->get_value(v[6], VMesh::Node::index_type(base+dj+dk));
+          ifield->get_value(v[7], VMesh::Node::index_type(base+di+dj+dk));
+
+          const double a = v[0] + w[0]*(v[1]-v[0]);
+          const double b = v[2] + w[0]*(v[3]-v[2]);
+          const double e = v[4] + w[0]*(v[5]-v[4]);
+          const double g = v[6] + w[0]*(v[7]-v[6]);
+          const double lo = a + w[1]*(b-a);
+          const double hi = e + w[1]*(g-e);
+          ofield->set_value(lo + w[2]*(hi-lo),
+            VMesh::Node::index_type(i + cdims[0]*(j + cdims[1]*k)));
+        }
+      }
+    }
+  };
+  Parallel::RunTasks(task, nproc);
+
+  return (output);
+}
+
+}
+
 template <class TESSELATOR>
 class MarchingCubesAlgoP {
 
@@ -97,9 +353,7 @@ class MarchingCubesAlgoP {
 
     ~MarchingCubesAlgoP()
     {
-      #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-       delete_all_items(tesselator_);
-      #endif
+      for (size_t j=0; j<tesselator_.size(); j++) delete tesselator_[j];
     }
 
     FieldHandle    input_;
@@ -121,11 +375,18 @@ class MarchingCubesAlgoP {
     const std::vector<double>& iso_values_;
     const AlgorithmBase* algo_;
 
+    boost::shared_ptr<ElementBlocks> blocks_;
+    std::vector<index_type> active_blocks_;
+
     bool run(const AlgorithmBase* algo, FieldHandle& output,
              MatrixHandle& node_interpolant,MatrixHandle& elem_interpolant );
 
     void parallel(int proc, int nproc, size_t iso);
 
+    /// Merge the output of the threads, nodes on the partition seams are
+    /// matched by the mesh edge they were cut from.
+    FieldHandle weld(int nproc, size_t iso);
+
   private:
     AppendFieldsAlgorithm append_fields_;
     AppendMatrixAlgorithm append_matrices_;
@@ -166,16 +427,20 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
   */
   /// @todo: FIX MULTI THREADING OF MARCHING CUBES FIELDS ARE NOT PROPORLY LINKED
  #endif
-  int np = Parallel::NumCores();
+  int np = algo->get(MarchingCubesAlgo::num_threads).toInt();
+  /// By default (-1) choose number of processors
+  if (np < 1) np = Parallel::NumCores();
+  /// RunTasks starts no more threads than the user allows, the blocks and
+  /// the tesselators are split into that many parts too
+  np = std::max(1, static_cast<int>(Parallel::capByUserCoreCount(np)));
 
-  np = 1;
   size_t num_values = iso_values_.size();
 
   tesselator_.resize(np);
   for (size_t j=0; j<tesselator_.size(); j++)
     tesselator_[j] = new TESSELATOR(input_);
 
-  output_field_.resize(np*num_values);
+  output_field_.resize(num_values);
   output_interpolant_matrix_.resize(np*num_values);
   output_parent_cell_matrix_.resize(np*num_values);
   //output_geometry_.resize(np*num_values);
@@ -192,18 +457,24 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
   append_matrices_.setOption("method","append_rows");
  #endif
 
+  VMesh* imesh = input_->vmesh();
+  blocks_.reset(new ElementBlocks(imesh));
+  if (input_->vfield()->basis_order() == 1)
+    blocks_->compute_ranges(imesh,input_->vfield(),np);
+
   for (size_t j=0; j<iso_values_.size(); j++)
   {
-    if (np == 1)
-    {
-      parallel(0,1,j);
-    }
-    else
-    {
-      #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-       Thread::parallel(this,&MarchingCubesAlgoP<TESSELATOR>::parallel,np,np,j);
-      #endif
-    }
+    // Resetting may synchronize the shared input mesh, do it serially
+    for (int p=0; p<np; p++)
+      tesselator_[p]->reset(0, build_field_, build_geometry_, transparency_);
+
+    active_blocks_.clear();
+    for (index_type b=0; b<blocks_->num_blocks(); b++)
+      if (blocks_->active(b,iso_values_[j])) active_blocks_.push_back(b);
+
+    Parallel::RunTasks([this,np,j](int proc) { parallel(proc,np,j); }, np);
+
+    if (build_field_) output_field_[j] = weld(np,j);
   }
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   if (output_geometry_.size() == 0)
@@ -252,12 +523,19 @@ bool MarchingCubesAlgo::run(FieldHandle input, const std::vector<double>& isoval
   if (!input)
   {
      error("MarchingCube algorithm error: Input field is Null pointer.");
+     return (false);
   }
 
   bool success = false;
 
   FieldInformation fi(input);
 
+  const int stride = get(sample_stride).toInt();
+  if (stride > 1 && fi.is_latvolmesh() && fi.is_lineardata() && fi.is_scalar())
+  {
+    input = subsample_latvol(input, stride);
+  }
+
   if (fi.is_pnt_element())
   {
     error("Field needs to have elements in order to extract isosurfaces");
@@ -289,7 +567,12 @@ bool MarchingCubesAlgo::run(FieldHandle input, const std::vector<double>& isoval
   }
   else if (fi.is_hex_element())
   {
-    if (fi.is_structuredmesh())
+    if (fi.is_latvolmesh() && fi.is_lineardata())
+    {
+      MarchingCubesAlgoP<LatVolMC> algo(input,isovalues);
+      success = algo.run(this,field,node_interpolant,elem_interpolant);
+    }
+    else if (fi.is_structuredmesh())
     {
       MarchingCubesAlgoP<HexMC> algo(input,isovalues);
       success = algo.run(this,field,node_interpolant,elem_interpolant);
@@ -301,42 +584,33 @@ bool MarchingCubesAlgo::run(FieldHandle input, const std::vector<double>& isoval
     }
   }
 
-  return true;
+  return (success);
 }
 
 
 template<class TESSELATOR>
 void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
 {
-  tesselator_[proc]->reset(0, build_field_, build_geometry_, transparency_);
-
-  VMesh*  imesh  = input_->vmesh();
-
-  VMesh::size_type num_elems = imesh->num_elems();
+  const size_type num_active = active_blocks_.size();
+  const index_type start = (num_active*proc)/nproc;
+  const index_type end = (num_active*(proc+1))/nproc;
 
-  index_type start = (proc)*(num_elems/nproc);
-  index_type end = (proc < nproc-1) ? (proc+1)*(num_elems/nproc) : num_elems;
-
-  index_type cnt = 0;
-  size_type total = (num_elems*iso_values_.size()/nproc);
-  index_type offset = (num_elems*iso/nproc);
+  const size_type num_values = iso_values_.size();
   double isoval = iso_values_[iso];
 
-  for(VMesh::Elem::index_type idx= start ; idx<end; idx++)
+  std::vector<VMesh::Elem::index_type> elems;
+
+  for (index_type b = start; b < end; b++)
   {
-    tesselator_[proc]->extract(idx, isoval);
+    Interruptible::checkForInterruption();
+    blocks_->get_elems(active_blocks_[b],elems);
+    for (size_t e = 0; e < elems.size(); e++)
+      tesselator_[proc]->extract(elems[e], isoval);
+
     if (proc == 0)
-    {
-      cnt++;
-      if (cnt == 300)
-      {
-        cnt = 0;
-        algo_->update_progress(idx+offset/total);
-      }
-    }
+      algo_->update_progress_max(iso*(end-start)+(b-start), num_values*(end-start));
   }
 
-  output_field_[iso*nproc+proc] = 0;
   output_interpolant_matrix_[iso*nproc+proc] = 0;
   output_parent_cell_matrix_[iso*nproc+proc] = 0;
 
@@ -344,10 +618,6 @@ void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
    output_geometry_[iso*nproc+proc] = 0;
   #endif
 
-  if (build_field_)
-  {
-    output_field_[iso*nproc+proc] = tesselator_[proc]->get_field(isoval);
-  }
   if (build_node_interpolant_)
   {
     output_interpolant_matrix_[iso*nproc+proc] = tesselator_[proc]->get_interpolant();
@@ -385,3 +655,61 @@ void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
   #endif
 
 }
+
+
+template<class TESSELATOR>
+FieldHandle MarchingCubesAlgoP<TESSELATOR>::weld(int nproc, size_t iso)
+{
+  double isoval = iso_values_[iso];
+  if (nproc == 1) return (tesselator_[0]->get_field(isoval));
+
+  std::vector<FieldHandle> parts(nproc);
+  for (int p=0; p<nproc; p++) parts[p] = tesselator_[p]->get_field(isoval);
+
+  FieldInformation fi(parts[0]);
+  FieldHandle output = CreateField(fi);
+  VMesh* omesh = output->vmesh();
+
+  BaseMC::edge_hash_type welded;
+  std::vector<BaseMC::edgepair_t> keys;
+  std::vector<VMesh::Node::index_type> remap;
+  VMesh::Node::array_type nodes;
+
+  for (int p=0; p<nproc; p++)
+  {
+    VMesh* pmesh = parts[p]->vmesh();
+    const VMesh::size_type num_nodes = pmesh->num_nodes();
+    const VMesh::size_type num_elems = pmesh->num_elems();
+
+    tesselator_[p]->get_node_keys(keys,num_nodes);
+    remap.resize(num_nodes);
+
+    for (VMesh::Node::index_type n=0; n<num_nodes; n++)
+    {
+      const BaseMC::edgepair_t& key = keys[n];
+      const bool has_key = (key.first != -1 || key.second != -1);
+      if (has_key)
+      {
+        BaseMC::edge_hash_type::const_iterator it = welded.find(key);
+        if (it != welded.end()) { remap[n] = (*it).second; continue; }
+      }
+
+      Point point;
+      pmesh->get_center(point,n);
+      remap[n] = omesh->add_point(point);
+      if (has_key) welded[key] = remap[n];
+    }
+
+    omesh->elem_reserve(omesh->num_elems()+num_elems);
+    for (VMesh::Elem::index_type e=0; e<num_elems; e++)
+    {
+      pmesh->get_nodes(nodes,e);
+      for (size_t r=0; r<nodes.size(); r++) nodes[r] = remap[nodes[r]];
+      omesh->add_elem(nodes);
+    }
+  }
+
+  output->vfield()->resize_values();
+  output->vfield()->set_all_values(isoval);
+  return (output);
+}
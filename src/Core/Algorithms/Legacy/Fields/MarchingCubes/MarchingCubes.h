@@ -62,6 +62,10 @@ namespace SCIRun {
     static AlgorithmParameterName build_node_interpolant;
     static AlgorithmParameterName build_elem_interpolant;
     static AlgorithmParameterName num_threads;
+    /// Node data on a LatVol is first resampled on a grid that keeps every
+    /// n-th node along each axis, for a quick preview of the surface. Other
+    /// inputs are always extracted at full resolution.
+    static AlgorithmParameterName sample_stride;
 
    #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
    {
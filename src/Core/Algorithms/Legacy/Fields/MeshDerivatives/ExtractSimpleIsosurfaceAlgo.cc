@@ -52,6 +52,9 @@ ALGORITHM_PARAMETER_DEF(Fields, IsovalueChoice);
 ALGORITHM_PARAMETER_DEF(Fields, ListOfIsovalues);
 ALGORITHM_PARAMETER_DEF(Fields, QuantityOfIsovalues);
 ALGORITHM_PARAMETER_DEF(Fields, IsovalueListString);
+ALGORITHM_PARAMETER_DEF(Fields, IsosurfaceSampleStride);
+ALGORITHM_PARAMETER_DEF(Fields, IsosurfaceCoarseToFine);
+ALGORITHM_PARAMETER_DEF(Fields, IsosurfaceCoarseResolution);
 
 ExtractSimpleIsosurfaceAlgo::ExtractSimpleIsosurfaceAlgo()
 {
@@ -60,6 +63,11 @@ ExtractSimpleIsosurfaceAlgo::ExtractSimpleIsosurfaceAlgo()
   addParameter(Parameters::ListOfIsovalues, std::string());
   addParameter(Parameters::QuantityOfIsovalues, 1);
   addOption(Parameters::IsovalueChoice, "Single", "Single|List|Quantity");
+  addParameter(Parameters::IsosurfaceSampleStride, 1);
+  // Off by default, the preview re-executes the module when the full
+  // surface is done, which only pays off while the isovalue is dragged.
+  addParameter(Parameters::IsosurfaceCoarseToFine, false);
+  addParameter(Parameters::IsosurfaceCoarseResolution, 64);
 }
 
 bool ExtractSimpleIsosurfaceAlgo::run(FieldHandle input, const std::vector<double>& isovalues, FieldHandle& output) const
@@ -71,6 +79,7 @@ bool ExtractSimpleIsosurfaceAlgo::run(FieldHandle input, const std::vector<doubl
 
   MarchingCubesAlgo marching_;
   marching_.set(MarchingCubesAlgo::build_field, true);
+  marching_.set(MarchingCubesAlgo::sample_stride, get(Parameters::IsosurfaceSampleStride).toInt());
 
   marching_.run(input, isovalues, output);
 
@@ -93,3 +102,19 @@ AlgorithmOutput ExtractSimpleIsosurfaceAlgo::run(const AlgorithmInput& input) co
 
   return output;
 }
+
+int ExtractSimpleIsosurfaceAlgo::coarseSampleStride(FieldHandle input, int resolution)
+{
+  if (!input || resolution < 1) return (1);
+
+  FieldInformation fi(input);
+  if (!fi.is_latvolmesh() || !fi.is_lineardata()) return (1);
+
+  VMesh::dimension_type dims;
+  input->vmesh()->get_dimensions(dims);
+  size_type largest = 0;
+  for (size_t d = 0; d < dims.size(); d++) largest = std::max(largest, dims[d]);
+
+  if (largest < 2) return (1);
+  return (static_cast<int>((largest - 2)/resolution + 1));
+}
@@ -45,6 +45,9 @@ namespace Fields {
   ALGORITHM_PARAMETER_DECL(Isovalues);
   ALGORITHM_PARAMETER_DECL(IsovalueChoice);
   ALGORITHM_PARAMETER_DECL(IsovalueListString);
+  ALGORITHM_PARAMETER_DECL(IsosurfaceSampleStride);
+  ALGORITHM_PARAMETER_DECL(IsosurfaceCoarseToFine);
+  ALGORITHM_PARAMETER_DECL(IsosurfaceCoarseResolution);
 
 class SCISHARE ExtractSimpleIsosurfaceAlgo : public AlgorithmBase
 {
@@ -54,6 +57,12 @@ public:
   bool run(FieldHandle input, const std::vector<double>& isovalues, FieldHandle& output) const;
 
   AlgorithmOutput run(const AlgorithmInput& input) const;
+
+  /// Sample stride that brings the largest dimension of a LatVol with node
+  /// data down to at most resolution cells, used for a quick preview before
+  /// the surface is extracted at full resolution. Returns 1 for fields that
+  /// cannot be subsampled or are already small enough.
+  static int coarseSampleStride(FieldHandle input, int resolution);
 };
 
 }}}}
@@ -33,6 +33,7 @@
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/MeshBoundaryFaces.h>
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/PropertyManagerExtensions.h>
@@ -59,6 +60,37 @@ struct IndexHash
     { return (static_cast<size_t>(idx)); }
 };
 
+/// Unstructured volume meshes use the boundary faces of the mesh, which are
+/// found without building the face topology of the mesh.
+template <class MAP>
+static void
+addBoundaryFaces(const MeshBoundaryFaces& faces, VMesh* imesh, VMesh* omesh,
+                 MAP& node_map, MAP& elem_map)
+{
+  VMesh::Node::array_type onodes(faces.nodes_per_face);
+  Point point;
+
+  for (size_t f = 0; f < faces.size(); f++)
+  {
+    for (size_t q = 0; q < faces.nodes_per_face; q++)
+    {
+      index_type a = faces.nodes[f*faces.nodes_per_face + q];
+      auto it = node_map.find(a);
+      if (it == node_map.end())
+      {
+        imesh->get_center(point, VMesh::Node::index_type(a));
+        onodes[q] = omesh->add_node(point);
+        node_map[a] = onodes[q];
+      }
+      else
+      {
+        onodes[q] = it->second;
+      }
+    }
+    elem_map[omesh->add_elem(onodes)] = faces.elems[f];
+  }
+}
+
 bool 
 GetFieldBoundaryAlgo::run(FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const
 {
@@ -123,61 +155,73 @@ GetFieldBoundaryAlgo::run(FieldHandle input, FieldHandle& output, MatrixHandle&
   auto ifield = input->vfield();
   auto ofield = output->vfield();
 
-  imesh->synchronize(Mesh::DELEMS_E | Mesh::ELEM_NEIGHBORS_E);
-
-  /// These are all virtual iterators, virtual index_types and array_types
-  VMesh::Elem::iterator be, ee;
-  VMesh::Elem::index_type nci, ci;
-  VMesh::DElem::array_type delems; 
-  VMesh::Node::array_type inodes; 
-  VMesh::Node::array_type onodes; 
-  VMesh::Node::index_type a;
+  MeshBoundaryFacesHandle faces;
+  if (imesh->is_volume() && imesh->is_unstructuredmesh())
+    faces = imesh->get_boundary_faces();
 
-  inodes.clear();
-  onodes.clear();  
-  Point point;
-
-  /// This algorithm was copy from the original dynamic compiled version
-  /// and was slightly adapted to work here:
-  
-  imesh->begin(be); 
-  imesh->end(ee);
-
-  while (be != ee)
+  if (faces)
   {
     checkForInterruption();
-    ci = *be;
-    imesh->get_delems(delems, ci);
-    for (size_t p = 0; p < delems.size(); p++)
-    {
-      auto includeface = false;
-
-      if (!(imesh->get_neighbor(nci, ci, delems[p]))) includeface = true;
+    addBoundaryFaces(*faces, imesh, omesh, node_map, elem_map);
+  }
+  else
+  {
+    imesh->synchronize(Mesh::DELEMS_E | Mesh::ELEM_NEIGHBORS_E);
+
+    /// These are all virtual iterators, virtual index_types and array_types
+    VMesh::Elem::iterator be, ee;
+    VMesh::Elem::index_type nci, ci;
+    VMesh::DElem::array_type delems; 
+    VMesh::Node::array_type inodes; 
+    VMesh::Node::array_type onodes; 
+    VMesh::Node::index_type a;
+
+    inodes.clear();
+    onodes.clear();  
+    Point point;
+
+    /// This algorithm was copy from the original dynamic compiled version
+    /// and was slightly adapted to work here:
+  
+    imesh->begin(be); 
+    imesh->end(ee);
 
-      if (includeface)
+    while (be != ee)
+    {
+      checkForInterruption();
+      ci = *be;
+      imesh->get_delems(delems, ci);
+      for (size_t p = 0; p < delems.size(); p++)
       {
-        imesh->get_nodes(inodes, delems[p]);
-        onodes.resize(inodes.size());
+        auto includeface = false;
 
-        for (size_t q = 0; q < inodes.size(); q++)
+        if (!(imesh->get_neighbor(nci, ci, delems[p]))) includeface = true;
+
+        if (includeface)
         {
-          a = inodes[q];
-          auto it = node_map.find(a);
-          if (it == node_map.end())
-          {
-            imesh->get_center(point, a);
-            onodes[q] = omesh->add_node(point);
-            node_map[a] = onodes[q];
-          }
-          else
+          imesh->get_nodes(inodes, delems[p]);
+          onodes.resize(inodes.size());
+
+          for (size_t q = 0; q < inodes.size(); q++)
           {
-            onodes[q] = node_map[a];
+            a = inodes[q];
+            auto it = node_map.find(a);
+            if (it == node_map.end())
+            {
+              imesh->get_center(point, a);
+              onodes[q] = omesh->add_node(point);
+              node_map[a] = onodes[q];
+            }
+            else
+            {
+              onodes[q] = node_map[a];
+            }
           }
+          elem_map[omesh->add_elem(onodes)] = ci;
         }
-        elem_map[omesh->add_elem(onodes)] = ci;
       }
+      ++be;
     }
-    ++be;
   }
 
   mapping.reset();
@@ -366,60 +410,72 @@ GetFieldBoundaryAlgo::run(FieldHandle input, FieldHandle& output) const
   auto ifield = input->vfield();
   auto ofield = output->vfield();
   
-  imesh->synchronize(Mesh::DELEMS_E|Mesh::ELEM_NEIGHBORS_E);
-  
-  /// These are all virtual iterators, virtual index_types and array_types
-  VMesh::Elem::iterator be, ee;
-  VMesh::Elem::index_type nci, ci;
-  VMesh::DElem::array_type delems; 
-  VMesh::Node::array_type inodes; 
-  VMesh::Node::array_type onodes; 
-  VMesh::Node::index_type a;
-
-  inodes.clear();
-  onodes.clear();  
-  Point point;
-
-  /// This algorithm was copy from the original dynamic compiled version
-  /// and was slightly adapted to work here:
-  
-  imesh->begin(be); 
-  imesh->end(ee);
+  MeshBoundaryFacesHandle faces;
+  if (imesh->is_volume() && imesh->is_unstructuredmesh())
+    faces = imesh->get_boundary_faces();
 
-  while (be != ee)
+  if (faces)
   {
     checkForInterruption();
-    ci = *be;
-    imesh->get_delems(delems, ci);
-    for (size_t p = 0; p < delems.size(); p++)
+    addBoundaryFaces(*faces, imesh, omesh, node_map, elem_map);
+  }
+  else
+  {
+    imesh->synchronize(Mesh::DELEMS_E|Mesh::ELEM_NEIGHBORS_E);
+  
+    /// These are all virtual iterators, virtual index_types and array_types
+    VMesh::Elem::iterator be, ee;
+    VMesh::Elem::index_type nci, ci;
+    VMesh::DElem::array_type delems; 
+    VMesh::Node::array_type inodes; 
+    VMesh::Node::array_type onodes; 
+    VMesh::Node::index_type a;
+
+    inodes.clear();
+    onodes.clear();  
+    Point point;
+
+    /// This algorithm was copy from the original dynamic compiled version
+    /// and was slightly adapted to work here:
+  
+    imesh->begin(be); 
+    imesh->end(ee);
+
+    while (be != ee)
     {
-      auto includeface = false;
+      checkForInterruption();
+      ci = *be;
+      imesh->get_delems(delems, ci);
+      for (size_t p = 0; p < delems.size(); p++)
+      {
+        auto includeface = false;
 
-      if (!(imesh->get_neighbor(nci, ci, delems[p]))) includeface = true;
+        if (!(imesh->get_neighbor(nci, ci, delems[p]))) includeface = true;
 
-      if (includeface)
-      {
-        imesh->get_nodes(inodes, delems[p]);
-        if (onodes.size() == 0) onodes.resize(inodes.size());
-        for (size_t q = 0; q < onodes.size(); q++)
+        if (includeface)
         {
-          a = inodes[q];
-          auto it = node_map.find(a);
-          if (it == node_map.end())
-          {
-            imesh->get_center(point, a);
-            onodes[q] = omesh->add_node(point);
-            node_map[a] = onodes[q];
-          }
-          else
+          imesh->get_nodes(inodes, delems[p]);
+          if (onodes.size() == 0) onodes.resize(inodes.size());
+          for (size_t q = 0; q < onodes.size(); q++)
           {
-            onodes[q] = node_map[a];
+            a = inodes[q];
+            auto it = node_map.find(a);
+            if (it == node_map.end())
+            {
+              imesh->get_center(point, a);
+              onodes[q] = omesh->add_node(point);
+              node_map[a] = onodes[q];
+            }
+            else
+            {
+              onodes[q] = node_map[a];
+            }
           }
+          elem_map[omesh->add_elem(onodes)] = ci;
         }
-        elem_map[omesh->add_elem(onodes)] = ci;
       }
+      ++be;
     }
-    ++be;
   }
   
   ofield->resize_fdata();
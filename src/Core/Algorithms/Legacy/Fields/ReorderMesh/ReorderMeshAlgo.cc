@@ -0,0 +1,384 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Algorithms/Legacy/Fields/ReorderMesh/ReorderMeshAlgo.h>
+
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/PropertyManagerExtensions.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <numeric>
+#include <boost/cstdint.hpp>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+ALGORITHM_PARAMETER_DEF(Fields, NodeOrdering);
+ALGORITHM_PARAMETER_DEF(Fields, ElemOrdering);
+
+const AlgorithmOutputName ReorderMeshAlgo::NodeMapping("NodeMapping");
+const AlgorithmOutputName ReorderMeshAlgo::ElemMapping("ElemMapping");
+
+ReorderMeshAlgo::ReorderMeshAlgo()
+{
+  addOption(Parameters::NodeOrdering, "Hilbert", "None|Morton|Hilbert|ReverseCuthillMcKee");
+  addOption(Parameters::ElemOrdering, "Hilbert", "None|Morton|Hilbert");
+}
+
+namespace
+{
+  // 21 bits per axis gives a 63 bit key for a 3D curve.
+  const int curveBits = 21;
+  const boost::uint32_t curveMax = (1u << curveBits) - 1;
+
+  // Insert two zero bits between each of the lower 21 bits of v.
+  inline boost::uint64_t spreadBits(boost::uint64_t v)
+  {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8)  & 0x100f00f00f00f00fULL;
+    v = (v | v << 4)  & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2)  & 0x1249249249249249ULL;
+    return v;
+  }
+
+  inline boost::uint64_t mortonKey(boost::uint32_t x, boost::uint32_t y, boost::uint32_t z)
+  {
+    return (spreadBits(x) << 2) | (spreadBits(y) << 1) | spreadBits(z);
+  }
+
+  // J. Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707 (2004).
+  // Converts the coordinates into the transposed Hilbert index, which is then
+  // interleaved the same way as a Morton key.
+  inline boost::uint64_t hilbertKey(boost::uint32_t x, boost::uint32_t y, boost::uint32_t z)
+  {
+    boost::uint32_t X[3] = { x, y, z };
+    const boost::uint32_t M = 1u << (curveBits - 1);
+
+    for (boost::uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+      const boost::uint32_t P = Q - 1;
+      for (int i = 0; i < 3; i++)
+      {
+        if (X[i] & Q)
+        {
+          X[0] ^= P;
+        }
+        else
+        {
+          const boost::uint32_t t = (X[0] ^ X[i]) & P;
+          X[0] ^= t;
+          X[i] ^= t;
+        }
+      }
+    }
+
+    X[1] ^= X[0];
+    X[2] ^= X[1];
+    boost::uint32_t t = 0;
+    for (boost::uint32_t Q = M; Q > 1; Q >>= 1)
+      if (X[2] & Q) t ^= Q - 1;
+    for (int i = 0; i < 3; i++) X[i] ^= t;
+
+    return mortonKey(X[0], X[1], X[2]);
+  }
+
+  // Sort the points along a Morton or Hilbert curve through their bounding box.
+  void curveOrder(const std::vector<Point>& points, bool hilbert, std::vector<index_type>& order)
+  {
+    const size_type num = static_cast<size_type>(points.size());
+    order.resize(num);
+    std::iota(order.begin(), order.end(), 0);
+    if (num < 2) return;
+
+    BBox bbox;
+    for (const auto& p : points) bbox.extend(p);
+
+    // Use one scale for all axes so the curve cells stay cubic.
+    const Vector diag = bbox.diagonal();
+    const double extent = std::max(diag.x(), std::max(diag.y(), diag.z()));
+    const double scale = extent > 0.0 ? curveMax / extent : 0.0;
+    const Point pmin = bbox.get_min();
+
+    std::vector<boost::uint64_t> keys(num);
+    const int numProcs = Parallel::NumCores();
+    Parallel::RunTasks([&](int proc)
+    {
+      const size_type start = (num * proc) / numProcs;
+      const size_type end = (num * (proc + 1)) / numProcs;
+      for (size_type idx = start; idx < end; idx++)
+      {
+        const Vector d = points[idx] - pmin;
+        auto x = static_cast<boost::uint32_t>(std::min<double>(d.x() * scale, curveMax));
+        auto y = static_cast<boost::uint32_t>(std::min<double>(d.y() * scale, curveMax));
+        auto z = static_cast<boost::uint32_t>(std::min<double>(d.z() * scale, curveMax));
+        keys[idx] = hilbert ? hilbertKey(x, y, z) : mortonKey(x, y, z);
+      }
+    }, numProcs);
+
+    std::stable_sort(order.begin(), order.end(),
+      [&keys](index_type a, index_type b) { return keys[a] < keys[b]; });
+  }
+
+  // Reverse Cuthill-McKee on the node graph of the mesh. Each connected
+  // component is started from its lowest degree node.
+  void reverseCuthillMcKee(VMesh* mesh, std::vector<index_type>& order)
+  {
+    const VMesh::size_type num_nodes = mesh->num_nodes();
+    mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+
+    VMesh::Node::array_type neighbors;
+    std::vector<size_type> degree(num_nodes);
+    for (VMesh::Node::index_type idx = 0; idx < num_nodes; idx++)
+    {
+      mesh->get_neighbors(neighbors, idx);
+      degree[idx] = static_cast<size_type>(neighbors.size());
+    }
+    auto byDegree = [&degree](index_type a, index_type b) { return degree[a] < degree[b]; };
+
+    std::vector<index_type> seeds(num_nodes);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    std::stable_sort(seeds.begin(), seeds.end(), byDegree);
+
+    std::vector<char> visited(num_nodes, 0);
+    order.clear();
+    order.reserve(num_nodes);
+
+    for (auto seed : seeds)
+    {
+      if (visited[seed]) continue;
+      visited[seed] = 1;
+      size_t head = order.size();
+      order.push_back(seed);
+
+      while (head < order.size())
+      {
+        VMesh::Node::index_type idx(order[head++]);
+        mesh->get_neighbors(neighbors, idx);
+        const size_t first = order.size();
+        for (size_t j = 0; j < neighbors.size(); j++)
+        {
+          if (!visited[neighbors[j]])
+          {
+            visited[neighbors[j]] = 1;
+            order.push_back(neighbors[j]);
+          }
+        }
+        std::stable_sort(order.begin() + first, order.end(), byDegree);
+      }
+    }
+
+    std::reverse(order.begin(), order.end());
+  }
+}
+
+SparseRowMatrixHandle ReorderMeshAlgo::permutationMatrix(const std::vector<index_type>& order)
+{
+  const size_type n = static_cast<size_type>(order.size());
+  std::vector<index_type> rows(n + 1);
+  std::iota(rows.begin(), rows.end(), 0);
+  std::vector<double> values(n, 1.0);
+  return boost::make_shared<SparseRowMatrix>(n, n, &rows[0], n > 0 ? &order[0] : nullptr, n > 0 ? &values[0] : nullptr, n);
+}
+
+bool
+ReorderMeshAlgo::runImpl(FieldHandle input, FieldHandle& output,
+                         MatrixHandle& nodeMapping, MatrixHandle& elemMapping) const
+{
+  std::vector<index_type> nodeOrder, elemOrder;
+  if (!runImpl(input, output, nodeOrder, elemOrder))
+    return (false);
+
+  nodeMapping = permutationMatrix(nodeOrder);
+  elemMapping = permutationMatrix(elemOrder);
+  return (true);
+}
+
+bool
+ReorderMeshAlgo::runImpl(FieldHandle input, FieldHandle& output,
+                         std::vector<index_type>& nodeOrder,
+                         std::vector<index_type>& elemOrder) const
+{
+  ScopedAlgorithmStatusReporter asr(this, "ReorderMesh");
+
+  if (!input)
+  {
+    error("No input field.");
+    return (false);
+  }
+
+  FieldInformation fi(input);
+  if (fi.is_nonlinear())
+  {
+    error("This algorithm has not yet been defined for non-linear elements yet.");
+    return (false);
+  }
+
+  if (!fi.is_unstructuredmesh())
+  {
+    error("This algorithm only works on an unstructured mesh; structured meshes have an implicit ordering.");
+    return (false);
+  }
+
+  VMesh*  imesh  = input->vmesh();
+  VField* ifield = input->vfield();
+
+  const VMesh::size_type num_nodes = imesh->num_nodes();
+  const VMesh::size_type num_elems = imesh->num_elems();
+
+  const std::string nodeMethod = getOption(Parameters::NodeOrdering);
+  const std::string elemMethod = getOption(Parameters::ElemOrdering);
+
+  // Step 1: node permutation
+  if (nodeMethod == "ReverseCuthillMcKee")
+  {
+    reverseCuthillMcKee(imesh, nodeOrder);
+  }
+  else if (nodeMethod == "Morton" || nodeMethod == "Hilbert")
+  {
+    std::vector<Point> points(num_nodes);
+    for (VMesh::Node::index_type idx = 0; idx < num_nodes; idx++)
+      imesh->get_center(points[idx], idx);
+    curveOrder(points, nodeMethod == "Hilbert", nodeOrder);
+  }
+  else
+  {
+    nodeOrder.resize(num_nodes);
+    std::iota(nodeOrder.begin(), nodeOrder.end(), 0);
+  }
+  update_progress_max(1, 4);
+
+  // Step 2: element permutation. For point clouds elements and nodes are the
+  // same entities, so they have to share one ordering.
+  if (imesh->is_pointcloudmesh())
+  {
+    elemOrder = nodeOrder;
+  }
+  else if (elemMethod == "Morton" || elemMethod == "Hilbert")
+  {
+    std::vector<Point> centers(num_elems);
+    for (VMesh::Elem::index_type idx = 0; idx < num_elems; idx++)
+      imesh->get_center(centers[idx], idx);
+    curveOrder(centers, elemMethod == "Hilbert", elemOrder);
+  }
+  else
+  {
+    elemOrder.resize(num_elems);
+    std::iota(elemOrder.begin(), elemOrder.end(), 0);
+  }
+  update_progress_max(2, 4);
+
+  // Step 3: rebuild the mesh in the new order
+  FieldInformation fo(input);
+  output = CreateField(fo);
+  if (!output)
+  {
+    error("Could not allocate output field.");
+    return (false);
+  }
+
+  VMesh*  omesh  = output->vmesh();
+  VField* ofield = output->vfield();
+
+  std::vector<index_type> newNodeIndex(num_nodes);
+  for (index_type idx = 0; idx < num_nodes; idx++)
+    newNodeIndex[nodeOrder[idx]] = idx;
+
+  omesh->node_reserve(num_nodes);
+  omesh->elem_reserve(num_elems);
+
+  Point p;
+  for (index_type idx = 0; idx < num_nodes; idx++)
+  {
+    imesh->get_center(p, VMesh::Node::index_type(nodeOrder[idx]));
+    omesh->add_node(p);
+  }
+  update_progress_max(3, 4);
+
+  if (!imesh->is_pointcloudmesh())
+  {
+    VMesh::Node::array_type nodes;
+    for (index_type idx = 0; idx < num_elems; idx++)
+    {
+      imesh->get_nodes(nodes, VMesh::Elem::index_type(elemOrder[idx]));
+      for (size_t j = 0; j < nodes.size(); j++)
+        nodes[j] = newNodeIndex[nodes[j]];
+      omesh->add_elem(nodes);
+    }
+  }
+
+  // Step 4: permute the data along with its entities
+  ofield->resize_values();
+  if (ofield->basis_order() == 0)
+  {
+    for (index_type idx = 0; idx < num_elems; idx++)
+      ofield->copy_value(ifield, elemOrder[idx], idx);
+  }
+  else if (ofield->basis_order() == 1)
+  {
+    for (index_type idx = 0; idx < num_nodes; idx++)
+      ofield->copy_value(ifield, nodeOrder[idx], idx);
+  }
+
+  CopyProperties(*input, *output);
+
+  return (true);
+}
+
+AlgorithmOutput ReorderMeshAlgo::run(const AlgorithmInput& input) const
+{
+  auto inputField = input.get<Field>(Variables::InputField);
+
+  FieldHandle outputField;
+  MatrixHandle nodeMapping, elemMapping;
+
+  if (!runImpl(inputField, outputField, nodeMapping, elemMapping))
+    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.");
+
+  AlgorithmOutput output;
+  output[Variables::OutputField] = outputField;
+  output[NodeMapping] = nodeMapping;
+  output[ElemMapping] = elemMapping;
+  return output;
+}
@@ -0,0 +1,77 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_REORDERMESH_REORDERMESHALGO_H
+#define CORE_ALGORITHMS_FIELDS_REORDERMESH_REORDERMESHALGO_H 1
+
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Datatypes/MatrixFwd.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+        ALGORITHM_PARAMETER_DECL(NodeOrdering);
+        ALGORITHM_PARAMETER_DECL(ElemOrdering);
+
+/// @class ReorderMeshAlgo
+/// @brief Renumbers the nodes and elements of an unstructured mesh along a
+/// space-filling curve (or by reverse Cuthill-McKee for the nodes) so that
+/// entities close in space are close in memory. Field data is permuted with
+/// the mesh, and the permutations are returned as mapping matrices
+/// (new = Mapping * old).
+
+class SCISHARE ReorderMeshAlgo : public AlgorithmBase
+{
+public:
+  ReorderMeshAlgo();
+
+  /// nodeOrder[i] / elemOrder[i] give the input index of output node/elem i.
+  bool runImpl(FieldHandle input, FieldHandle& output,
+               std::vector<index_type>& nodeOrder,
+               std::vector<index_type>& elemOrder) const;
+  bool runImpl(FieldHandle input, FieldHandle& output,
+               Datatypes::MatrixHandle& nodeMapping,
+               Datatypes::MatrixHandle& elemMapping) const;
+
+  /// Sparse permutation matrix P with P(i, order[i]) = 1.
+  static Datatypes::SparseRowMatrixHandle permutationMatrix(const std::vector<index_type>& order);
+
+  static const AlgorithmOutputName NodeMapping;
+  static const AlgorithmOutputName ElemMapping;
+
+  virtual AlgorithmOutput run(const AlgorithmInput& input) const override;
+};
+
+      }}}}
+
+#endif
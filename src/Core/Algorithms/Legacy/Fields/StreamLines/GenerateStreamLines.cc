@@ -59,6 +59,10 @@ ALGORITHM_PARAMETER_DEF(Fields, StreamlineMethod);
 ALGORITHM_PARAMETER_DEF(Fields, AutoParameters);
 ALGORITHM_PARAMETER_DEF(Fields, NumStreamlines);
 ALGORITHM_PARAMETER_DEF(Fields, UseMultithreading);
+ALGORITHM_PARAMETER_DEF(Fields, StreamlineSeedStride);
+ALGORITHM_PARAMETER_DEF(Fields, StreamlineStepScale);
+ALGORITHM_PARAMETER_DEF(Fields, StreamlineCoarseToFine);
+ALGORITHM_PARAMETER_DEF(Fields, StreamlineCoarseSeeds);
 
 GenerateStreamLinesAlgo::GenerateStreamLinesAlgo()
 {
@@ -76,6 +80,16 @@ GenerateStreamLinesAlgo::GenerateStreamLinesAlgo()
   addParameter(Parameters::NumStreamlines, 0);
 
   addParameter(Parameters::UseMultithreading, true);
+
+  // Quick preview: only every n-th seed is traced, and with steps (and
+  // tolerance) that are larger by the scale. The number of steps is reduced
+  // by the same factor so that the lines keep their length.
+  addParameter(Parameters::StreamlineSeedStride, 1);
+  addParameter(Parameters::StreamlineStepScale, 1.0);
+  // Used by the module: send a preview with about this many seeds first.
+  // Off by default, like the isosurface preview.
+  addParameter(Parameters::StreamlineCoarseToFine, false);
+  addParameter(Parameters::StreamlineCoarseSeeds, 256);
 }
 
 namespace detail
@@ -167,7 +181,7 @@ class GenerateStreamLinesAlgoP : public Core::Thread::Interruptible
   public:
      GenerateStreamLinesAlgoP(const AlgorithmBase* algo) :
       algo_(algo), numprocessors_(Parallel::NumCores()), barrier_("FEMVolRHSBuilder Barrier", numprocessors_),
-      tolerance_(0), step_size_(0), max_steps_(0), direction_(0), value_(SeedIndex), remove_colinear_pts_(false),
+      tolerance_(0), step_size_(0), max_steps_(0), seed_stride_(1), direction_(0), value_(SeedIndex), remove_colinear_pts_(false),
       method_(AdamsBashforth), seed_field_(0), seed_mesh_(0), field_(0), mesh_(0), ofield_(0), omesh_(0)
     {}
 
@@ -183,6 +197,7 @@ class GenerateStreamLinesAlgoP : public Core::Thread::Interruptible
     double tolerance_;
     double step_size_;
     int    max_steps_;
+    int    seed_stride_;
     int    direction_;
     StreamlineValue    value_;
     bool   remove_colinear_pts_;
@@ -235,6 +250,8 @@ FieldHandle GenerateStreamLinesAlgoP::StreamLinesForCertainSeeds(VMesh::Node::in
     for (VMesh::Node::index_type idx=from; idx<to; ++idx)
     {
       checkForInterruption();
+      if (idx % seed_stride_ != 0)
+        continue;
       seed_mesh_->get_point(BI.seed_, idx);
 
        // Is the seed point inside the field?
@@ -405,6 +422,14 @@ bool GenerateStreamLinesAlgoP::run(FieldHandle input,
   tolerance_ = algo_->get(Parameters::StreamlineTolerance).toDouble();
   step_size_ = algo_->get(Parameters::StreamlineStepSize).toDouble();
   max_steps_ = algo_->get(Parameters::StreamlineMaxSteps).toInt();
+  seed_stride_ = std::max(1, algo_->get(Parameters::StreamlineSeedStride).toInt());
+  const double scale = algo_->get(Parameters::StreamlineStepScale).toDouble();
+  if (scale > 0.0)
+  {
+    tolerance_ *= scale;
+    step_size_ *= scale;
+    max_steps_ = std::max(1, static_cast<int>(max_steps_/scale));
+  }
   direction_ = convertDirectionOption(algo_->getOption(Parameters::StreamlineDirection));
   value_ = convertValue(algo_->getOption(Parameters::StreamlineValue));
   remove_colinear_pts_ = algo_->get(Parameters::RemoveColinearPoints).toBool();
@@ -441,7 +466,7 @@ class GenerateStreamLinesAccAlgo {
   public:
     GenerateStreamLinesAccAlgo() :
       numprocessors_(Parallel::NumCores()), barrier_("FEMVolRHSBuilder Barrier", numprocessors_),
-      max_steps_(0), direction_(0), value_(SeedIndex), remove_colinear_pts_(false),
+      max_steps_(0), seed_stride_(1), direction_(0), value_(SeedIndex), remove_colinear_pts_(false),
       seed_field_(0), seed_mesh_(0)
       {}
 
@@ -452,6 +477,7 @@ class GenerateStreamLinesAccAlgo {
     int numprocessors_;
     Barrier barrier_;
     int    max_steps_;
+    int    seed_stride_;
     int    direction_;
     StreamlineValue    value_;
     bool   remove_colinear_pts_;
@@ -506,6 +532,9 @@ FieldHandle GenerateStreamLinesAccAlgo::StreamLinesForCertainSeeds(VMesh::Node::
     // Try to find the streamline for each seed point.
     for(VMesh::Node::index_type idx=from; idx<to; ++idx)
     {
+      Core::Thread::Interruptible::checkForInterruption();
+      if (idx % seed_stride_ != 0)
+        continue;
       seed_mesh_->get_center(seed, idx);
 
       // Is the seed point inside the field?
@@ -657,6 +686,8 @@ bool GenerateStreamLinesAccAlgo::run(const AlgorithmBase* algo, FieldHandle inpu
   mesh_ = input->vmesh();
   algo_=algo;
   max_steps_ = algo_->get(Parameters::StreamlineMaxSteps).toInt();
+  // Cell walk steps from face to face, only the seeds are thinned out
+  seed_stride_ = std::max(1, algo_->get(Parameters::StreamlineSeedStride).toInt());
   direction_ = convertDirectionOption(algo_->getOption(Parameters::StreamlineDirection));
   value_ = convertValue(algo_->getOption(Parameters::StreamlineValue));
   remove_colinear_pts_ = algo_->get(Parameters::RemoveColinearPoints).toBool();
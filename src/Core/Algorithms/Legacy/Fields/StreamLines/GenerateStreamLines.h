@@ -47,6 +47,10 @@ namespace SCIRun {
         ALGORITHM_PARAMETER_DECL(AutoParameters);
         ALGORITHM_PARAMETER_DECL(NumStreamlines);
         ALGORITHM_PARAMETER_DECL(UseMultithreading);
+        ALGORITHM_PARAMETER_DECL(StreamlineSeedStride);
+        ALGORITHM_PARAMETER_DECL(StreamlineStepScale);
+        ALGORITHM_PARAMETER_DECL(StreamlineCoarseToFine);
+        ALGORITHM_PARAMETER_DECL(StreamlineCoarseSeeds);
 
 class SCISHARE GenerateStreamLinesAlgo : public AlgorithmBase
 {
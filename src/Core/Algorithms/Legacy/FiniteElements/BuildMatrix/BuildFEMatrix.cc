@@ -41,6 +41,7 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/GeometryPrimitives/Tensor.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Legacy/Fields/ReorderMesh/ReorderMeshAlgo.h>
 #include <Core/Logging/Log.h>
 
 #include <string>
@@ -1057,6 +1058,7 @@ FEMBuilder<T>::parallel(int proc_num)
 
 const AlgorithmParameterName BuildFEMatrixAlgo::ForceSymmetry("ForceSymmetry");
 const AlgorithmParameterName BuildFEMatrixAlgo::GenerateBasis("GenerateBasis");
+const AlgorithmParameterName BuildFEMatrixAlgo::ReorderForLocality("ReorderForLocality");
 
 template <typename T>
 bool
@@ -1096,6 +1098,26 @@ BuildFEMatrixAlgoImpl<T>::run(FieldHandle input, DenseMatrixHandle ctable, matri
     }
   }
 
+  // The basis cache is keyed on the mesh generation, so reordering (which
+  // creates a new mesh on every call) is only done for direct assembly.
+  std::vector<index_type> nodeOrder;
+  if (algo_->get(BuildFEMatrixAlgo::ReorderForLocality).toBool() &&
+      !algo_->get(BuildFEMatrixAlgo::GenerateBasis).toBool())
+  {
+    Fields::ReorderMeshAlgo reorder;
+    FieldHandle reordered;
+    std::vector<index_type> elemOrder;
+    if (reorder.runImpl(input, reordered, nodeOrder, elemOrder))
+    {
+      input = reordered;
+    }
+    else
+    {
+      algo_->warning("Could not reorder mesh, assembling with the input ordering");
+      nodeOrder.clear();
+    }
+  }
+
   FEMBuilder<T> builder(algo_);
 
   if (algo_->get(BuildFEMatrixAlgo::GenerateBasis).toBool())
@@ -1210,6 +1232,17 @@ BuildFEMatrixAlgoImpl<T>::run(FieldHandle input, DenseMatrixHandle ctable, matri
     return false;
   }
 
+  // Map rows and columns back to the input node numbering: P K P^-1 with
+  // P taking reordered node i to input node nodeOrder[i].
+  if (!nodeOrder.empty())
+  {
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, index_type> perm(nodeOrder.size());
+    std::copy(nodeOrder.begin(), nodeOrder.end(), perm.indices().data());
+    typename matrix_type<T>::EigenBase permuted;
+    permuted = output->twistedBy(perm);
+    output.reset(new matrix_type<T>(permuted));
+  }
+
   return true;
 }
 
@@ -44,6 +44,7 @@ class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
   public:
     static const AlgorithmParameterName ForceSymmetry;
     static const AlgorithmParameterName GenerateBasis;
+    static const AlgorithmParameterName ReorderForLocality;
 
     static const AlgorithmInputName Conductivity_Table;
     static const AlgorithmOutputName Stiffness_Matrix;
@@ -59,6 +60,10 @@ class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
       // for instance conductivity search
       // This option only works for an indexed conductivity table
       addParameter(GenerateBasis, false);
+
+      // Assemble on a copy of the mesh renumbered along a space-filling curve
+      // for better cache behavior. The output keeps the input node numbering.
+      addParameter(ReorderForLocality, false);
     }
 
     virtual AlgorithmOutput run(const AlgorithmInput &) const override;
@@ -44,6 +44,7 @@ DEALINGS IN THE SOFTWARE.
 #include <string>
 #include <fstream>
 #include <numeric>
+#include <atomic>
 #include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm/copy.hpp>
 
@@ -55,17 +56,25 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Thread/Interruptible.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms::Forward;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core;
+using namespace SCIRun::Core::Algorithms;
 
 ALGORITHM_PARAMETER_DEF(Forward, FieldNameList);
 ALGORITHM_PARAMETER_DEF(Forward, FieldTypeList);
 ALGORITHM_PARAMETER_DEF(Forward, BoundaryConditionList);
 ALGORITHM_PARAMETER_DEF(Forward, InsideConductivityList);
 ALGORITHM_PARAMETER_DEF(Forward, OutsideConductivityList);
+ALGORITHM_PARAMETER_DEF(Forward, UseHierarchicalMatrices);
+ALGORITHM_PARAMETER_DEF(Forward, HierarchicalMatrixTolerance);
 
 void BuildBEMatrixBase::getOmega(
   const Vector& y1,
@@ -495,17 +504,114 @@ double BuildBEMatrixBase::do_radon_g(
   return g2 * aV.length();
 }
 
+namespace
+{
+  /// The 7 point Radon rule on a triangle, the points lie on the lines from
+  /// the centroid to the vertices.
+  struct RadonRule
+  {
+    RadonRule()
+    {
+      const double sqrt15 = sqrt(15.0);
+      w[0] = 9.0/40.0;
+      w[1] = w[2] = w[3] = (155 + sqrt15) / 1200;
+      w[4] = w[5] = w[6] = (155 - sqrt15) / 1200;
+      s = (1 - sqrt15) / 7;
+      r = (1 + sqrt15) / 7;
+    }
+
+    double w[7];
+    double s;
+    double r;
+  };
+
+  std::vector<Vector> node_points(VMesh* mesh)
+  {
+    VMesh::Node::size_type num_nodes;
+    mesh->size(num_nodes);
+    std::vector<Vector> points(num_nodes);
+    for (VMesh::Node::index_type n = 0; n < num_nodes; ++n)
+      points[n] = Vector(mesh->get_point(n));
+    return points;
+  }
+
+  /// Nodes and triangles of a surface in flat arrays, read once from the
+  /// mesh instead of through the VMesh iterators for every node.
+  struct SurfaceGeometry
+  {
+    explicit SurfaceGeometry(VMesh* mesh) : points(node_points(mesh))
+    {
+      VMesh::Face::size_type num_faces;
+      mesh->size(num_faces);
+
+      VMesh::Node::array_type face_nodes;
+      nodes.resize(3*num_faces);
+      for (VMesh::Face::index_type f = 0; f < num_faces; ++f)
+      {
+        mesh->get_nodes(face_nodes, f);
+        for (int k = 0; k < 3; ++k) nodes[3*f+k] = face_nodes[k];
+      }
+    }
+
+    size_t num_triangles() const { return nodes.size()/3; }
+
+    /// Corners of the triangles around every node, as 3*triangle + vertex,
+    /// the corners of node n are corners[first[n]] up to corners[first[n+1]].
+    void find_corners()
+    {
+      first.assign(points.size() + 1, 0);
+      for (size_t c = 0; c < nodes.size(); ++c) first[nodes[c]+1]++;
+      std::partial_sum(first.begin(), first.end(), first.begin());
+
+      std::vector<size_t> next(first.begin(), first.end() - 1);
+      corners.resize(nodes.size());
+      for (size_t c = 0; c < nodes.size(); ++c) corners[next[nodes[c]]++] = c;
+    }
+
+    std::vector<Vector> points;
+    std::vector<index_type> nodes;
+    std::vector<size_t> first;
+    std::vector<size_t> corners;
+  };
+
+  // RunTasks starts no more threads than the user allows, so the work has to
+  // be split into that many blocks too.
+  int num_tasks(int num_threads, size_t rows)
+  {
+    const size_t tasks = (num_threads > 0) ? Parallel::capByUserCoreCount(num_threads) : Parallel::NumCores();
+    return static_cast<int>(std::max<size_t>(1, std::min<size_t>(tasks, rows)));
+  }
+
+  /// Rows are split into contiguous blocks, one per task, so that every
+  /// entry is written by a single thread and its triangle contributions are
+  /// added in the same order as in a serial loop.
+  template <class RowFunction>
+  void for_each_row(size_t rows, int num_threads, RowFunction row)
+  {
+    const int tasks = num_tasks(num_threads, rows);
+    Parallel::RunTasks([&](int t)
+    {
+      const size_t end = (rows*(t+1))/tasks;
+      for (size_t i = (rows*t)/tasks; i < end; ++i)
+      {
+        Interruptible::checkForInterruption();
+        row(static_cast<index_type>(i));
+      }
+    }, tasks);
+  }
+}
+
 class BuildBEMatrixBaseCompute : public BuildBEMatrixBase
 {
 public:
   template <class MatrixType>
-  static void make_auto_P_compute(VMesh* hsurf, MatrixType& auto_P, double in_cond, double out_cond, double op_cond);
+  static void make_auto_P_compute(VMesh* hsurf, MatrixType& auto_P, double in_cond, double out_cond, double op_cond, int num_threads = -1);
 
   template <class MatrixType>
-  static void make_cross_P_compute(VMesh* hsurf1, VMesh* hsurf2, MatrixType& cross_P, double in_cond, double out_cond, double op_cond);
+  static void make_cross_P_compute(VMesh* hsurf1, VMesh* hsurf2, MatrixType& cross_P, double in_cond, double out_cond, double op_cond, int num_threads = -1);
 
   template <class MatrixType>
-  static void make_auto_G_compute(VMesh* hsurf, MatrixType& auto_G, double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn);
+  static void make_auto_G_compute(VMesh* hsurf, MatrixType& auto_G, double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn, int num_threads = -1);
 
   template <class MatrixType>
   static void make_cross_G_compute( VMesh*,
@@ -514,164 +620,327 @@ public:
   double,
   double,
   double,
-  const std::vector<double>& );
+  const std::vector<double>&,
+  int num_threads = -1);
+
+  /// Entry by entry versions of assemble_G and assemble_P, an entry sums
+  /// the contributions of the triangles around the node of its column.
+  static HierarchicalMatrixHandle compressed_G(const std::vector<Vector>& observers, SurfaceGeometry& surface,
+    bool same, double mult, const std::vector<double>& areas, const HierarchicalMatrixOptions& options);
+
+  static HierarchicalMatrixHandle compressed_P(const std::vector<Vector>& observers, SurfaceGeometry& surface,
+    bool same, double mult, const HierarchicalMatrixOptions& options);
+
+private:
+  /// Quadrature of the 1/r integrals over the triangles of a surface. The
+  /// Radon points and their weights, already multiplied with the Cruse
+  /// weights of the vertices and the area, are computed once per triangle.
+  class GQuadrature
+  {
+  public:
+    GQuadrature(const SurfaceGeometry& surface, const std::vector<double>& areas, bool singular, int num_threads);
+
+    /// Contributions of triangle t to its three vertices, seen from op
+    void values(size_t t, const Vector& op, double g[3]) const
+    {
+      const Vector* q = &points_[7*t];
+      const double* w = &weights_[21*t];
+      double inv[7];
+      for (int k = 0; k < 7; ++k) inv[k] = 1 / (q[k] - op).length();
+      for (int v = 0; v < 3; ++v)
+      {
+        double sum = 0;
+        for (int k = 0; k < 7; ++k) sum += w[7*v+k]*inv[k];
+        g[v] = sum;
+      }
+    }
+
+    /// Contributions of triangle t when op is its vertex k
+    const double* singular(size_t t, int k) const { return &singular_[9*t+3*k]; }
+
+  private:
+    std::vector<Vector> points_;
+    std::vector<double> weights_;
+    std::vector<double> singular_;
+  };
+
+  template <class MatrixType>
+  static void assemble_G(const std::vector<Vector>& observers, const SurfaceGeometry& surface, bool same,
+    MatrixType& G, double mult, const std::vector<double>& areas, int num_threads);
+
+  template <class MatrixType>
+  static void assemble_P(const std::vector<Vector>& observers, const SurfaceGeometry& surface, bool same,
+    MatrixType& P, double mult, int num_threads);
 };
 
-void BuildBEMatrixBase::make_auto_G_allocate(VMesh* hsurf, DenseMatrixHandle &h_GG_)
+BuildBEMatrixBaseCompute::GQuadrature::GQuadrature(const SurfaceGeometry& surface,
+  const std::vector<double>& areas, bool singular, int num_threads)
 {
-  auto nnodes = numNodes(hsurf);
-  h_GG_.reset(new DenseMatrix(nnodes, nnodes, 0.0));
-}
+  const RadonRule rule;
+  const size_t num_tris = surface.num_triangles();
+  points_.resize(7*num_tris);
+  weights_.resize(21*num_tris);
+  if (singular) singular_.resize(9*num_tris);
 
-void BuildBEMatrixBase::make_auto_G(VMesh* hsurf, DenseMatrixHandle &h_GG_,
-double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn)
-{
-  make_auto_G_allocate(hsurf, h_GG_);
-  BuildBEMatrixBaseCompute::make_auto_G_compute(hsurf, *h_GG_, in_cond, out_cond, op_cond, avInn);
+  auto prepare = [&](int task, int tasks)
+  {
+    DenseMatrix cruse_weights(3, 7);
+    DenseMatrix g_values(3, 1);
+    DenseMatrix R_W(1, 7);
+    for (int k = 0; k < 7; ++k) R_W(0,k) = rule.w[k];
+
+    const size_t end = (num_tris*(task+1))/tasks;
+    for (size_t t = (num_tris*task)/tasks; t < end; ++t)
+    {
+      const Vector& p1 = surface.points[surface.nodes[3*t]];
+      const Vector& p2 = surface.points[surface.nodes[3*t+1]];
+      const Vector& p3 = surface.points[surface.nodes[3*t+2]];
+      const Vector centroid = (p1 + p2 + p3) / 3.0;
+
+      Vector* q = &points_[7*t];
+      q[0] = centroid;
+      q[1] = centroid * (1-rule.s) + p1 * rule.s;
+      q[2] = centroid * (1-rule.s) + p2 * rule.s;
+      q[3] = centroid * (1-rule.s) + p3 * rule.s;
+      q[4] = centroid * (1-rule.r) + p1 * rule.r;
+      q[5] = centroid * (1-rule.r) + p2 * rule.r;
+      q[6] = centroid * (1-rule.r) + p3 * rule.r;
+
+      get_cruse_weights(p1, p2, p3, rule.s, rule.r, areas[t], cruse_weights);
+      double* w = &weights_[21*t];
+      for (int v = 0; v < 3; ++v)
+        for (int k = 0; k < 7; ++k) w[7*v+k] = areas[t]*cruse_weights(v,k)*rule.w[k];
+
+      if (singular)
+      {
+        for (int k = 0; k < 3; ++k)
+        {
+          bem_sing(p1, p2, p3, k, g_values, rule.s, rule.r, R_W);
+          for (int v = 0; v < 3; ++v) singular_[9*t+3*k+v] = g_values(v,0);
+        }
+      }
+    }
+  };
+
+  const int tasks = num_tasks(num_threads, num_tris);
+  Parallel::RunTasks([&](int t) { prepare(t, tasks); }, tasks);
 }
 
 template <class MatrixType>
-void BuildBEMatrixBaseCompute::make_auto_G_compute(VMesh* hsurf, MatrixType& auto_G,
-  double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn)
+void BuildBEMatrixBaseCompute::assemble_G(const std::vector<Vector>& observers, const SurfaceGeometry& surface,
+  bool same, MatrixType& G, double mult, const std::vector<double>& areas, int num_threads)
 {
-  //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
-  const double mult = 1/(4*M_PI)*(out_cond - in_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
+  const GQuadrature quadrature(surface, areas, same, num_threads);
+  const size_t num_tris = surface.num_triangles();
+  const index_type* nodes = surface.nodes.empty() ? 0 : &surface.nodes[0];
 
-  VMesh::Node::array_type nodes;
+  for_each_row(observers.size(), num_threads, [&](index_type ppi)
+  {
+    const Vector& op = observers[ppi];
+    double g[3];
+    for (size_t t = 0; t < num_tris; ++t)
+    {
+      const index_type* n = &nodes[3*t];
+      const double* values = g;
+      if (same && ppi == n[0]) values = quadrature.singular(t, 0);
+      else if (same && ppi == n[1]) values = quadrature.singular(t, 1);
+      else if (same && ppi == n[2]) values = quadrature.singular(t, 2);
+      else quadrature.values(t, op, g);
+
+      for (int i = 0; i < 3; ++i)
+        G(ppi, n[i]) += values[i]*mult;
+    }
+  });
+}
 
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
+template <class MatrixType>
+void BuildBEMatrixBaseCompute::assemble_P(const std::vector<Vector>& observers, const SurfaceGeometry& surface,
+  bool same, MatrixType& P, double mult, int num_threads)
+{
+  const size_t num_tris = surface.num_triangles();
+  const index_type* nodes = surface.nodes.empty() ? 0 : &surface.nodes[0];
+  const Vector* points = surface.points.empty() ? 0 : &surface.points[0];
 
-  double area;
+  for_each_row(observers.size(), num_threads, [&](index_type ppi)
+  {
+    DenseMatrix coef(1, 3);
+    const Vector& pp = observers[ppi];
+    for (size_t t = 0; t < num_tris; ++t)
+    {
+      const index_type* n = &nodes[3*t];
+      if (same && (ppi == n[0] || ppi == n[1] || ppi == n[2]))
+        continue;
 
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
+      getOmega(points[n[0]] - pp, points[n[1]] - pp, points[n[2]] - pp, coef);
 
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
+      for (int i = 0; i < 3; ++i)
+        P(ppi, n[i]) -= coef(0,i)*mult;
+    }
+  });
+}
 
+HierarchicalMatrixHandle BuildBEMatrixBaseCompute::compressed_G(const std::vector<Vector>& observers,
+  SurfaceGeometry& surface, bool same, double mult, const std::vector<double>& areas,
+  const HierarchicalMatrixOptions& options)
+{
+  const GQuadrature quadrature(surface, areas, same, options.num_threads);
+  surface.find_corners();
 
-  hsurf->begin(fi); hsurf->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf->get_nodes(nodes, *fi);
-    Vector p1(hsurf->get_point(nodes[0]));
-    Vector p2(hsurf->get_point(nodes[1]));
-    Vector p3(hsurf->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-    hsurf->begin(ni); hsurf->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf->get_point(ppi));
-
-      if (ppi == nodes[0])       bem_sing(p1, p2, p3, 0, g_values, s, r, R_W);
-      else if (ppi == nodes[1])       bem_sing(p1, p2, p3, 1, g_values, s, r, R_W);
-      else if (ppi == nodes[2])       bem_sing(p1, p2, p3, 2, g_values, s, r, R_W);
-      else
+  auto entries = [&](const std::vector<index_type>& rows, const std::vector<index_type>& cols, DenseMatrix& block)
+  {
+    double g[3];
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+      const index_type ppi = rows[i];
+      const Vector& op = observers[ppi];
+      for (size_t j = 0; j < cols.size(); ++j)
       {
-        get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
+        double sum = 0;
+        for (size_t c = surface.first[cols[j]]; c < surface.first[cols[j]+1]; ++c)
+        {
+          const size_t t = surface.corners[c]/3;
+          const int k = static_cast<int>(surface.corners[c]%3);
+          const index_type* n = &surface.nodes[3*t];
+          if (same && ppi == n[0]) sum += quadrature.singular(t, 0)[k];
+          else if (same && ppi == n[1]) sum += quadrature.singular(t, 1)[k];
+          else if (same && ppi == n[2]) sum += quadrature.singular(t, 2)[k];
+          else
+          {
+            quadrature.values(t, op, g);
+            sum += g[k];
+          }
+        }
+        block(i, j) = sum*mult;
+      }
+    }
+  };
 
-        for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
+  if (same)
+    return boost::make_shared<HierarchicalMatrix>(surface.points, entries, options);
+  return boost::make_shared<HierarchicalMatrix>(observers, surface.points, entries, options);
+}
 
-        g_values = area * (cruse_weights * temp.transpose());
-      } // else
+HierarchicalMatrixHandle BuildBEMatrixBaseCompute::compressed_P(const std::vector<Vector>& observers,
+  SurfaceGeometry& surface, bool same, double mult, const HierarchicalMatrixOptions& options)
+{
+  surface.find_corners();
+
+  auto entries = [&](const std::vector<index_type>& rows, const std::vector<index_type>& cols, DenseMatrix& block)
+  {
+    DenseMatrix coef(1, 3);
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+      const index_type ppi = rows[i];
+      const Vector& pp = observers[ppi];
+      for (size_t j = 0; j < cols.size(); ++j)
+      {
+        double sum = 0;
+        for (size_t c = surface.first[cols[j]]; c < surface.first[cols[j]+1]; ++c)
+        {
+          const size_t t = surface.corners[c]/3;
+          const index_type* n = &surface.nodes[3*t];
+          if (same && (ppi == n[0] || ppi == n[1] || ppi == n[2]))
+            continue;
 
-      for (int i=0; i<3; ++i)
-        auto_G(ppi, nodes[i])+=g_values(i,0)*mult;
+          getOmega(surface.points[n[0]] - pp, surface.points[n[1]] - pp, surface.points[n[2]] - pp, coef);
+          sum -= coef(0, surface.corners[c]%3);
+        }
+        block(i, j) = sum*mult;
+      }
     }
-  }
+  };
+
+  if (same)
+    return boost::make_shared<HierarchicalMatrix>(surface.points, entries, options);
+  return boost::make_shared<HierarchicalMatrix>(observers, surface.points, entries, options);
 }
 
-void BuildBEMatrixBase::make_cross_G_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_GG_)
+HierarchicalMatrixHandle BuildBEMatrixBase::make_auto_G_compressed(VMesh* hsurf,
+  double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn,
+  const HierarchicalMatrixOptions& options)
 {
-  h_GG_.reset(new DenseMatrix(numNodes(hsurf1), numNodes(hsurf2), 0.0));
+  const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+  SurfaceGeometry surface(hsurf);
+  return BuildBEMatrixBaseCompute::compressed_G(surface.points, surface, true, mult, avInn, options);
 }
 
-void BuildBEMatrixBase::make_cross_G(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_GG_,
-  double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn)
+HierarchicalMatrixHandle BuildBEMatrixBase::make_cross_G_compressed(VMesh* hsurf1, VMesh* hsurf2,
+  double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn,
+  const HierarchicalMatrixOptions& options)
 {
-  make_cross_G_allocate(hsurf1, hsurf2, h_GG_);
-  BuildBEMatrixBaseCompute::make_cross_G_compute(hsurf1, hsurf2, *h_GG_, in_cond, out_cond, op_cond, avInn);
+  const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+  SurfaceGeometry surface(hsurf2);
+  return BuildBEMatrixBaseCompute::compressed_G(node_points(hsurf1), surface, false, mult, avInn, options);
 }
 
-template <class MatrixType>
-void BuildBEMatrixBaseCompute::make_cross_G_compute(VMesh* hsurf1, VMesh* hsurf2, MatrixType& cross_G,
-  double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn)
+HierarchicalMatrixHandle BuildBEMatrixBase::make_auto_P_compressed(VMesh* hsurf,
+  double in_cond, double out_cond, double op_cond, const HierarchicalMatrixOptions& options)
 {
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
-  //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
+  SurfaceGeometry surface(hsurf);
+  HierarchicalMatrixHandle P = BuildBEMatrixBaseCompute::compressed_P(surface.points, surface, true, mult, options);
 
-  VMesh::Node::array_type nodes;
+  //! accounting for autosolid angle, the diagonal is still zero
+  const DenseColumnMatrix sumOfRows = *P * DenseColumnMatrix(DenseColumnMatrix::Ones(P->cols()));
+  P->set_diagonal(DenseColumnMatrix((out_cond - sumOfRows.array()).matrix()));
+  return P;
+}
 
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
+HierarchicalMatrixHandle BuildBEMatrixBase::make_cross_P_compressed(VMesh* hsurf1, VMesh* hsurf2,
+  double in_cond, double out_cond, double op_cond, const HierarchicalMatrixOptions& options)
+{
+  const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+  SurfaceGeometry surface(hsurf2);
+  return BuildBEMatrixBaseCompute::compressed_P(node_points(hsurf1), surface, false, mult, options);
+}
 
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
-
-  double area;
-
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-  hsurf2->begin(fi); hsurf2->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf2->get_nodes(nodes, *fi);
-    Vector p1(hsurf2->get_point(nodes[0]));
-    Vector p2(hsurf2->get_point(nodes[1]));
-    Vector p3(hsurf2->get_point(nodes[2]));
+void BuildBEMatrixBase::make_auto_G_allocate(VMesh* hsurf, DenseMatrixHandle &h_GG_)
+{
+  auto nnodes = numNodes(hsurf);
+  h_GG_.reset(new DenseMatrix(nnodes, nnodes, 0.0));
+}
 
-    area = avInn[*fi];
+void BuildBEMatrixBase::make_auto_G(VMesh* hsurf, DenseMatrixHandle &h_GG_,
+double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn, int num_threads)
+{
+  make_auto_G_allocate(hsurf, h_GG_);
+  BuildBEMatrixBaseCompute::make_auto_G_compute(hsurf, *h_GG_, in_cond, out_cond, op_cond, avInn, num_threads);
+}
 
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
+template <class MatrixType>
+void BuildBEMatrixBaseCompute::make_auto_G_compute(VMesh* hsurf, MatrixType& auto_G,
+  double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn, int num_threads)
+{
+  //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
+  const double mult = 1/(4*M_PI)*(out_cond - in_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
 
-    hsurf1->begin(ni); hsurf1->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf1->get_point(ppi));
-      get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
+  //! contributions of every triangle to every node, the triangles that
+  //! share the node are integrated with Jeroen's singular weights
+  const SurfaceGeometry surface(hsurf);
+  assemble_G(surface.points, surface, true, auto_G, mult, avInn, num_threads);
+}
 
-      for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
+void BuildBEMatrixBase::make_cross_G_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_GG_)
+{
+  h_GG_.reset(new DenseMatrix(numNodes(hsurf1), numNodes(hsurf2), 0.0));
+}
 
-      g_values = area * (cruse_weights * temp.transpose());
+void BuildBEMatrixBase::make_cross_G(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_GG_,
+  double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn, int num_threads)
+{
+  make_cross_G_allocate(hsurf1, hsurf2, h_GG_);
+  BuildBEMatrixBaseCompute::make_cross_G_compute(hsurf1, hsurf2, *h_GG_, in_cond, out_cond, op_cond, avInn, num_threads);
+}
 
-      for (int i=0; i<3; ++i)
-        cross_G(ppi, nodes[i])+=g_values(i,0)*mult;
-    }
-  }
+template <class MatrixType>
+void BuildBEMatrixBaseCompute::make_cross_G_compute(VMesh* hsurf1, VMesh* hsurf2, MatrixType& cross_G,
+  double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn, int num_threads)
+{
+  const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+  //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
+
+  const SurfaceGeometry surface(hsurf2);
+  assemble_G(node_points(hsurf1), surface, false, cross_G, mult, avInn, num_threads);
 }
 
 void BuildBEMatrixBase::make_cross_P_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_PP_)
@@ -680,43 +949,20 @@ void BuildBEMatrixBase::make_cross_P_allocate(VMesh* hsurf1, VMesh* hsurf2, Dens
 }
 
 void BuildBEMatrixBase::make_cross_P(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_PP_,
-  double in_cond, double out_cond, double op_cond)
+  double in_cond, double out_cond, double op_cond, int num_threads)
 {
   make_cross_P_allocate(hsurf1, hsurf2, h_PP_);
-  BuildBEMatrixBaseCompute::make_cross_P_compute(hsurf1, hsurf2, *h_PP_, in_cond, out_cond, op_cond);
+  BuildBEMatrixBaseCompute::make_cross_P_compute(hsurf1, hsurf2, *h_PP_, in_cond, out_cond, op_cond, num_threads);
 }
 
 template <class MatrixType>
-void BuildBEMatrixBaseCompute::make_cross_P_compute(VMesh* hsurf1, VMesh* hsurf2, MatrixType& cross_P, double in_cond, double out_cond, double op_cond)
+void BuildBEMatrixBaseCompute::make_cross_P_compute(VMesh* hsurf1, VMesh* hsurf2, MatrixType& cross_P, double in_cond, double out_cond, double op_cond, int num_threads)
 {
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-  int i;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
-
-  hsurf1->begin(ni); hsurf1->end(nie);
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf1->get_point(ppi);
-
-    hsurf2->begin(fi); hsurf2->end(fie);
-    for (; fi != fie; ++fi){ //! find contributions from every triangle
 
-      hsurf2->get_nodes(nodes, *fi);
-      Vector v1 = hsurf2->get_point(nodes[0]) - pp;
-      Vector v2 = hsurf2->get_point(nodes[1]) - pp;
-      Vector v3 = hsurf2->get_point(nodes[2]) - pp;
-
-      getOmega(v1, v2, v3, coef);
-
-      for (i=0; i<3; ++i)
-        cross_P(ppi, nodes[i])-=coef(0,i)*mult;
-    }
-  }
+  const SurfaceGeometry surface(hsurf2);
+  assemble_P(node_points(hsurf1), surface, false, cross_P, mult, num_threads);
 }
 
 void BuildBEMatrixBase::make_auto_P_allocate(VMesh* hsurf, DenseMatrixHandle &h_PP_)
@@ -738,60 +984,30 @@ int BuildBEMatrixBase::numNodes(VMesh* hsurf)
 }
 
 template <class MatrixType>
-void BuildBEMatrixBaseCompute::make_auto_P_compute(VMesh* hsurf, MatrixType& auto_P, double in_cond, double out_cond, double op_cond)
+void BuildBEMatrixBaseCompute::make_auto_P_compute(VMesh* hsurf, MatrixType& auto_P, double in_cond, double out_cond, double op_cond, int num_threads)
 {
   auto nnodes = auto_P.rows();
-  
-  
 
   //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
 
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-
-  unsigned int i;
-
-  hsurf->begin(ni); hsurf->end(nie);
-
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf->get_point(ppi);
-
-    hsurf->begin(fi); hsurf->end(fie);
-    
-    for (; fi != fie; ++fi) { //! find contributions from every triangle
-
-      hsurf->get_nodes(nodes, *fi);
-      if (ppi!=nodes[0] && ppi!=nodes[1] && ppi!=nodes[2]){
-        Vector v1 = hsurf->get_point(nodes[0]) - pp;
-        Vector v2 = hsurf->get_point(nodes[1]) - pp;
-        Vector v3 = hsurf->get_point(nodes[2]) - pp;
-        
-        getOmega(v1, v2, v3, coef);
-
-        for (i=0; i<3; ++i)
-          auto_P(ppi, nodes[i])-=coef(0,i)*mult;
-      }
-    }
-  }
+  //! contributions of every triangle that does not contain the node
+  const SurfaceGeometry surface(hsurf);
+  assemble_P(surface.points, surface, true, auto_P, mult, num_threads);
 
   //! accounting for autosolid angle
   auto sumOfRows = auto_P.rowwise().sum().eval();
-  for (i=0; i<nnodes; ++i)
+  for (unsigned int i=0; i<nnodes; ++i)
   {
     auto_P(i,i) = out_cond - sumOfRows(i);
   }
 }
 
 void BuildBEMatrixBase::make_auto_P(VMesh* hsurf, DenseMatrixHandle &h_PP_,
-  double in_cond, double out_cond, double op_cond)
+  double in_cond, double out_cond, double op_cond, int num_threads)
 {
   make_auto_P_allocate(hsurf, h_PP_);
-  BuildBEMatrixBaseCompute::make_auto_P_compute(hsurf, *h_PP_, in_cond, out_cond, op_cond);
+  BuildBEMatrixBaseCompute::make_auto_P_compute(hsurf, *h_PP_, in_cond, out_cond, op_cond, num_threads);
 }
 
 // precalculate triangles area
@@ -940,19 +1156,109 @@ bool BuildBEMatrixBase::compute_nesting(std::vector<int> &nesting, const std::ve
   return true;
 }
 
+namespace
+{
+  /// Square operator of a set of surfaces, with a compressed block for
+  /// every pair of surfaces.
+  class CompressedBlocks
+  {
+  public:
+    explicit CompressedBlocks(const std::vector<int>& sizes) :
+      offsets_(sizes.size() + 1, 0), blocks_(sizes.size()*sizes.size())
+    {
+      std::partial_sum(sizes.begin(), sizes.end(), offsets_.begin() + 1);
+    }
+
+    HierarchicalMatrixHandle& block(size_t i, size_t j) { return blocks_[i*num_blocks() + j]; }
+    size_t num_blocks() const { return offsets_.size() - 1; }
+    size_t size() const { return offsets_.back(); }
+
+    /// y = A*x, or y = A^T*x
+    void multiply(const DenseColumnMatrix& x, DenseColumnMatrix& y, bool transposed) const
+    {
+      y = DenseColumnMatrix::Zero(size());
+      const size_t n = num_blocks();
+      for (size_t i = 0; i < n; ++i)
+      {
+        for (size_t j = 0; j < n; ++j)
+        {
+          if (transposed)
+            blocks_[i*n+j]->multiply_add(x.data() + offsets_[i], y.data() + offsets_[j], true);
+          else
+            blocks_[i*n+j]->multiply_add(x.data() + offsets_[j], y.data() + offsets_[i]);
+        }
+      }
+    }
+
+    /// Block Jacobi preconditioner made of the dense diagonal blocks of the
+    /// auto blocks
+    void precondition(const DenseColumnMatrix& x, DenseColumnMatrix& y, bool transposed) const
+    {
+      y.resize(size());
+      const size_t n = num_blocks();
+      for (size_t i = 0; i < n; ++i)
+        blocks_[i*n+i]->solve_diagonal_blocks(x.data() + offsets_[i], y.data() + offsets_[i], transposed);
+    }
+
+  private:
+    std::vector<size_t> offsets_;
+    std::vector<HierarchicalMatrixHandle> blocks_;
+  };
+
+  /// Y = B*inv(A) and YP = Y*P, every row y of Y solves A^T*y = b with
+  /// GMRES instead of forming the inverse. The rows are solved in parallel.
+  void solve_rows(const CompressedBlocks& A, const CompressedBlocks& P, const DenseMatrix& B,
+    DenseMatrix& Y, DenseMatrix& YP, const HierarchicalMatrixOptions& options)
+  {
+    const int max_iterations = 1000;
+    Y.resize(B.rows(), A.size());
+    YP.resize(B.rows(), P.size());
+
+    const LinearOperator op = [&A](const DenseColumnMatrix& x, DenseColumnMatrix& y) { A.multiply(x, y, true); };
+    const LinearOperator preconditioner = [&A](const DenseColumnMatrix& x, DenseColumnMatrix& y) { A.precondition(x, y, true); };
+
+    std::atomic<int> failed(0);
+    for_each_row(B.rows(), options.num_threads, [&](index_type r)
+    {
+      const DenseColumnMatrix b(B.row(r).transpose());
+      DenseColumnMatrix y, yp;
+      if (!SolveGMRES(op, preconditioner, b, y, options.tolerance, max_iterations))
+        ++failed;
+      P.multiply(y, yp, true);
+      Y.row(r) = y.transpose();
+      YP.row(r) = yp.transpose();
+    });
+
+    if (failed > 0)
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("The iterative solve of the compressed BEM matrix did not converge"));
+  }
+}
+
 class SurfaceAndPoints : public BEMAlgoImpl, public BuildBEMatrixBaseCompute
 {
 public:
+  SurfaceAndPoints(bool compress, const HierarchicalMatrixOptions& options) : compress_(compress), options_(options) {}
   virtual MatrixHandle compute(const bemfield_vector& fields) const override;
+private:
+  MatrixHandle compute_compressed(VMesh* nodes, VMesh* surface) const;
+  bool compress_;
+  HierarchicalMatrixOptions options_;
 };
 
 class SurfaceToSurface : public BEMAlgoImpl, public BuildBEMatrixBaseCompute
 {
 public:
+  SurfaceToSurface(bool compress, const HierarchicalMatrixOptions& options) : compress_(compress), options_(options) {}
   virtual MatrixHandle compute(const bemfield_vector& fields) const override;
+private:
+  MatrixHandle compute_compressed(const bemfield_vector& fields,
+    const std::vector<int>& sourcefieldindices, const std::vector<int>& measurementfieldindices) const;
+  bool compress_;
+  HierarchicalMatrixOptions options_;
 };
 
-BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields)
+BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields, bool compress,
+  const HierarchicalMatrixOptions& options)
 {
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   // Check for special case where the potentials need to be evaluated at the nodes of a lead
@@ -995,7 +1301,7 @@ BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields)
     // If all of the checks above don't flag meets_conditions as false,
     // return a value that indicates the algorithm to use is the surface-to-nodes case
     if ( meets_conditions )
-      return boost::make_shared<SurfaceAndPoints>();
+      return boost::make_shared<SurfaceAndPoints>(compress, options);
   }
 
   //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1020,7 +1326,7 @@ BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields)
   // if all fields are surfaces, there exists a measurement and a source surface, then use the surface-to-surface algorithm... else fail
   if (allsurfaces && hasmeasurementsurf && hassourcesurf)
   {
-    return boost::make_shared<SurfaceToSurface>();
+    return boost::make_shared<SurfaceToSurface>(compress, options);
   }
   else
   {
@@ -1089,6 +1395,9 @@ MatrixHandle SurfaceToSurface::compute(const bemfield_vector& fields) const
     }
   }
 
+  if (compress_)
+    return compute_compressed(fields, sourcefieldindices, measurementfieldindices);
+
   std::vector<int> fieldNodeSize(fields.size());
   std::transform(fields.begin(), fields.end(), fieldNodeSize.begin(), [this](const bemfield& f) { return numNodes(f.field_); } );
   DenseBlockMatrix EE(fieldNodeSize, fieldNodeSize);
@@ -1251,6 +1560,86 @@ MatrixHandle SurfaceToSurface::compute(const bemfield_vector& fields) const
   //MatrixHandle TransferMatrix1 = inv(Pmm - Gms * Gss * Psm) * (Gms * Gss * Pss - Pms);
 }
 
+MatrixHandle SurfaceToSurface::compute_compressed(const bemfield_vector& fields,
+  const std::vector<int>& sourcefieldindices, const std::vector<int>& measurementfieldindices) const
+{
+  // Same math as compute(), but the blocks between source surfaces, which
+  // grow with the square of the source resolution, are hierarchical
+  // matrices. Y = Gms*iGss is solved row by row, the other blocks have
+  // measurement rows or columns like the transfer matrix and stay dense:
+  // T = inv(Pmm - Y*Psm)*(Y*Pss - Pms)
+
+  const double op_cond=0.0;
+  const size_t Nsources = sourcefieldindices.size();
+  const size_t Nmeasurements = measurementfieldindices.size();
+
+  std::vector<int> sourceFieldNodeSize(Nsources), measurementNodeSize(Nmeasurements);
+  std::vector<std::vector<double> > triangleareas(Nsources);
+  for (size_t j = 0; j < Nsources; j++)
+  {
+    sourceFieldNodeSize[j] = numNodes(fields[sourcefieldindices[j]].field_);
+    pre_calc_tri_areas(fields[sourcefieldindices[j]].field_->vmesh(), triangleareas[j]);
+  }
+  for (size_t i = 0; i < Nmeasurements; i++)
+    measurementNodeSize[i] = numNodes(fields[measurementfieldindices[i]].field_);
+
+  // Pss and Gss, with the conductivities of the EE and EJ blocks in compute()
+  CompressedBlocks Pss(sourceFieldNodeSize), Gss(sourceFieldNodeSize);
+  for (size_t i = 0; i < Nsources; i++)
+  {
+    const bemfield& fi = fields[sourcefieldindices[i]];
+    for (size_t j = 0; j < Nsources; j++)
+    {
+      const bemfield& fj = fields[sourcefieldindices[j]];
+      if (i == j)
+      {
+        Pss.block(i,j) = make_auto_P_compressed(fi.field_->vmesh(), fi.insideconductivity, fi.outsideconductivity, op_cond, options_);
+        Gss.block(i,j) = make_auto_G_compressed(fi.field_->vmesh(), fi.insideconductivity, fi.outsideconductivity, op_cond, triangleareas[j], options_);
+      }
+      else
+      {
+        Pss.block(i,j) = make_cross_P_compressed(fi.field_->vmesh(), fj.field_->vmesh(), fj.insideconductivity, fj.outsideconductivity, op_cond, options_);
+        Gss.block(i,j) = make_cross_G_compressed(fi.field_->vmesh(), fj.field_->vmesh(), fields[j].insideconductivity, fields[j].outsideconductivity, op_cond, triangleareas[j], options_);
+      }
+    }
+  }
+
+  DenseBlockMatrix Pmm(measurementNodeSize, measurementNodeSize);
+  DenseBlockMatrix Pms(measurementNodeSize, sourceFieldNodeSize);
+  DenseBlockMatrix Psm(sourceFieldNodeSize, measurementNodeSize);
+  DenseBlockMatrix Gms(measurementNodeSize, sourceFieldNodeSize);
+  for (size_t i = 0; i < Nmeasurements; i++)
+  {
+    const bemfield& fi = fields[measurementfieldindices[i]];
+    for (size_t j = 0; j < Nmeasurements; j++)
+    {
+      const bemfield& fj = fields[measurementfieldindices[j]];
+      auto block = Pmm.blockRef(i,j);
+      if (i == j)
+        make_auto_P_compute(fi.field_->vmesh(), block, fi.insideconductivity, fi.outsideconductivity, op_cond);
+      else
+        make_cross_P_compute(fi.field_->vmesh(), fj.field_->vmesh(), block, fj.insideconductivity, fj.outsideconductivity, op_cond);
+    }
+    for (size_t j = 0; j < Nsources; j++)
+    {
+      const bemfield& fj = fields[sourcefieldindices[j]];
+      auto pms = Pms.blockRef(i,j);
+      make_cross_P_compute(fi.field_->vmesh(), fj.field_->vmesh(), pms, fj.insideconductivity, fj.outsideconductivity, op_cond);
+      auto psm = Psm.blockRef(j,i);
+      make_cross_P_compute(fj.field_->vmesh(), fi.field_->vmesh(), psm, fi.insideconductivity, fi.outsideconductivity, op_cond);
+      auto gms = Gms.blockRef(i,j);
+      make_cross_G_compute(fi.field_->vmesh(), fj.field_->vmesh(), gms, fields[j].insideconductivity, fields[j].outsideconductivity, op_cond, triangleareas[j]);
+    }
+  }
+
+  DenseMatrix Y, YPss;
+  solve_rows(Gss, Pss, Gms.matrix(), Y, YPss, options_);
+
+  const DenseMatrix C = Pmm.matrix() - Y * Psm.matrix();
+  const DenseMatrix D = YPss - Pms.matrix();
+  return boost::make_shared<DenseMatrix>(C.partialPivLu().solve(D));
+}
+
 
 MatrixHandle SurfaceAndPoints::compute(const bemfield_vector& fields) const
 {
@@ -1306,6 +1695,9 @@ MatrixHandle SurfaceAndPoints::compute(const bemfield_vector& fields) const
       nodes = fields[i].field_->vmesh();
   }
 
+  if (compress_)
+    return compute_compressed(nodes, surface);
+
   DenseMatrixHandle Pss;
   DenseMatrixHandle Gss;
   DenseMatrixHandle Pns;
@@ -1321,3 +1713,27 @@ MatrixHandle SurfaceAndPoints::compute(const bemfield_vector& fields) const
 
   return boost::make_shared<DenseMatrix>(*Pns - (*Gns * Gss->inverse() * *Pss));
 }
+
+MatrixHandle SurfaceAndPoints::compute_compressed(VMesh* nodes, VMesh* surface) const
+{
+  // Same transfer matrix, P_nodes_surf and G_nodes_surf have the size of
+  // the result and stay dense, G_surf_surf and P_surf_surf are hierarchical
+  // matrices and the rows of G_nodes_surf * inv( G_surf_surf) are solved
+  // iteratively.
+  std::vector<double> area;
+  pre_calc_tri_areas( surface, area );
+
+  const std::vector<int> sizes(1, numNodes(surface));
+  CompressedBlocks Pss(sizes), Gss(sizes);
+  Pss.block(0,0) = make_auto_P_compressed( surface, 1.0, 0.0, 1.0, options_ );
+  Gss.block(0,0) = make_auto_G_compressed( surface, 1.0, 0.0, 1.0, area, options_ );
+
+  DenseMatrixHandle Pns;
+  DenseMatrixHandle Gns;
+  make_cross_P( nodes, surface, Pns, 1.0, 0.0, 1.0 );
+  make_cross_G( nodes, surface, Gns, 1.0, 0.0, 1.0, area );
+
+  DenseMatrix Y, YPss;
+  solve_rows(Gss, Pss, *Gns, Y, YPss, options_);
+  return boost::make_shared<DenseMatrix>(*Pns - YPss);
+}
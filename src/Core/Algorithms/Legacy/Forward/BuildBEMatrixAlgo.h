@@ -43,6 +43,7 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/GeometryPrimitives/GeomFwd.h>
 #include <Core/Datatypes/Legacy/Field/FieldFwd.h>
 #include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/Legacy/Forward/HierarchicalMatrix.h>
 #include <Core/Algorithms/Legacy/Forward/share.h>
 
 namespace SCIRun {
@@ -55,6 +56,8 @@ namespace SCIRun {
         ALGORITHM_PARAMETER_DECL(BoundaryConditionList);
         ALGORITHM_PARAMETER_DECL(InsideConductivityList);
         ALGORITHM_PARAMETER_DECL(OutsideConductivityList);
+        ALGORITHM_PARAMETER_DECL(UseHierarchicalMatrices);
+        ALGORITHM_PARAMETER_DECL(HierarchicalMatrixTolerance);
 
         typedef std::vector<std::string> FieldTypeListType;
 
@@ -114,13 +117,16 @@ namespace SCIRun {
             const Geometry::Vector& );
 
         public:
+          /// The matrices are assembled in parallel, each thread fills a
+          /// block of rows. num_threads < 1 uses all cores.
           static void make_cross_G( VMesh*,
             VMesh*,
             Datatypes::DenseMatrixHandle&,
             double,
             double,
             double,
-            const std::vector<double>& );
+            const std::vector<double>&,
+            int num_threads = -1 );
 
           static void make_cross_G_allocate(VMesh*, VMesh*, Datatypes::DenseMatrixHandle&);
 
@@ -129,7 +135,8 @@ namespace SCIRun {
             double,
             double,
             double,
-            const std::vector<double>& );
+            const std::vector<double>&,
+            int num_threads = -1 );
 
           static void make_auto_G_allocate(VMesh*, Datatypes::DenseMatrixHandle&);
 
@@ -137,7 +144,8 @@ namespace SCIRun {
             Datatypes::DenseMatrixHandle&,
             double,
             double,
-            double );
+            double,
+            int num_threads = -1 );
 
           static int numNodes(FieldHandle f);
           static int numNodes(VMesh* hsurf);
@@ -149,11 +157,42 @@ namespace SCIRun {
             Datatypes::DenseMatrixHandle&,
             double,
             double,
-            double );
+            double,
+            int num_threads = -1 );
 
           static void make_cross_P_allocate( VMesh*,
             VMesh*, Datatypes::DenseMatrixHandle&);
 
+          /// Compressed versions of the blocks above, of the same surfaces
+          /// and conductivities, see HierarchicalMatrix.
+          static HierarchicalMatrixHandle make_auto_G_compressed( VMesh*,
+            double,
+            double,
+            double,
+            const std::vector<double>&,
+            const HierarchicalMatrixOptions& );
+
+          static HierarchicalMatrixHandle make_cross_G_compressed( VMesh*,
+            VMesh*,
+            double,
+            double,
+            double,
+            const std::vector<double>&,
+            const HierarchicalMatrixOptions& );
+
+          static HierarchicalMatrixHandle make_auto_P_compressed( VMesh*,
+            double,
+            double,
+            double,
+            const HierarchicalMatrixOptions& );
+
+          static HierarchicalMatrixHandle make_cross_P_compressed( VMesh*,
+            VMesh*,
+            double,
+            double,
+            double,
+            const HierarchicalMatrixOptions& );
+
           static void pre_calc_tri_areas(VMesh*, std::vector<double>&);
 
           static int compute_parent(const std::vector<VMesh*> &meshes, int index);
@@ -226,7 +265,11 @@ namespace SCIRun {
         class SCISHARE BEMAlgoImplFactory
         {
         public:
-          static BEMAlgoPtr create(const bemfield_vector& fields);
+          /// With compress the source blocks are hierarchical matrices and
+          /// the inverses are replaced by iterative solves, only the blocks
+          /// of the size of the transfer matrix are stored dense.
+          static BEMAlgoPtr create(const bemfield_vector& fields, bool compress = false,
+            const HierarchicalMatrixOptions& options = HierarchicalMatrixOptions());
         };
 
       }}}}
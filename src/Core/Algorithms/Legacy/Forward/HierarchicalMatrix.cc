@@ -0,0 +1,549 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+*  HierarchicalMatrix.cc:  compressed representation of boundary element
+*                          operators
+*/
+
+#include <Core/Algorithms/Legacy/Forward/HierarchicalMatrix.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Thread/Interruptible.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <Eigen/SVD>
+#include <Eigen/QR>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Forward;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+ClusterTree::ClusterTree(const std::vector<Vector>& points, size_t leaf_size) :
+  permutation_(points.size())
+{
+  std::iota(permutation_.begin(), permutation_.end(), 0);
+  split(points, 0, points.size(), std::max<size_t>(1, leaf_size));
+}
+
+int ClusterTree::split(const std::vector<Vector>& points, size_t begin, size_t end, size_t leaf_size)
+{
+  Cluster c;
+  c.begin = begin;
+  c.end = end;
+  c.left = c.right = -1;
+  if (begin < end)
+  {
+    c.min = c.max = points[permutation_[begin]];
+    for (size_t p = begin + 1; p < end; ++p)
+    {
+      c.min = Min(c.min, points[permutation_[p]]);
+      c.max = Max(c.max, points[permutation_[p]]);
+    }
+  }
+
+  const int index = static_cast<int>(clusters_.size());
+  clusters_.push_back(c);
+  if (c.size() <= leaf_size)
+    return index;
+
+  //! median split along the longest side of the box
+  const Vector side = c.max - c.min;
+  int axis = 0;
+  if (side[1] > side[axis]) axis = 1;
+  if (side[2] > side[axis]) axis = 2;
+
+  const size_t mid = begin + c.size()/2;
+  std::nth_element(permutation_.begin() + begin, permutation_.begin() + mid, permutation_.begin() + end,
+    [&](index_type a, index_type b) { return points[a][axis] < points[b][axis]; });
+
+  const int left = split(points, begin, mid, leaf_size);
+  const int right = split(points, mid, end, leaf_size);
+  clusters_[index].left = left;
+  clusters_[index].right = right;
+  return index;
+}
+
+std::vector<index_type> ClusterTree::indices(int c) const
+{
+  return std::vector<index_type>(permutation_.begin() + clusters_[c].begin, permutation_.begin() + clusters_[c].end);
+}
+
+double ClusterTree::distance(const Cluster& a, const Cluster& b)
+{
+  double d2 = 0;
+  for (int k = 0; k < 3; ++k)
+  {
+    const double gap = std::max(0.0, std::max(a.min[k] - b.max[k], b.min[k] - a.max[k]));
+    d2 += gap*gap;
+  }
+  return std::sqrt(d2);
+}
+
+HierarchicalMatrix::HierarchicalMatrix(const std::vector<Vector>& points,
+  const BlockFunction& entries, const HierarchicalMatrixOptions& options) :
+  rows_(new ClusterTree(points, options.leaf_size)),
+  cols_(rows_),
+  square_(true)
+{
+  build(entries, options);
+}
+
+HierarchicalMatrix::HierarchicalMatrix(const std::vector<Vector>& row_points,
+  const std::vector<Vector>& col_points, const BlockFunction& entries,
+  const HierarchicalMatrixOptions& options) :
+  rows_(new ClusterTree(row_points, options.leaf_size)),
+  cols_(new ClusterTree(col_points, options.leaf_size)),
+  square_(false)
+{
+  build(entries, options);
+}
+
+void HierarchicalMatrix::partition(int row_cluster, int col_cluster, double eta)
+{
+  const ClusterTree::Cluster& r = rows_->cluster(row_cluster);
+  const ClusterTree::Cluster& c = cols_->cluster(col_cluster);
+  if (r.size() == 0 || c.size() == 0)
+    return;
+
+  const double dist = ClusterTree::distance(r, c);
+  if (dist > 0 && std::min(r.diameter(), c.diameter()) <= eta*dist)
+  {
+    Block b;
+    b.row_cluster = row_cluster;
+    b.col_cluster = col_cluster;
+    b.low_rank = true;
+    blocks_.push_back(b);
+  }
+  else if (r.is_leaf() && c.is_leaf())
+  {
+    Block b;
+    b.row_cluster = row_cluster;
+    b.col_cluster = col_cluster;
+    b.low_rank = false;
+    blocks_.push_back(b);
+  }
+  else if (r.is_leaf())
+  {
+    partition(row_cluster, c.left, eta);
+    partition(row_cluster, c.right, eta);
+  }
+  else if (c.is_leaf())
+  {
+    partition(r.left, col_cluster, eta);
+    partition(r.right, col_cluster, eta);
+  }
+  else
+  {
+    partition(r.left, c.left, eta);
+    partition(r.left, c.right, eta);
+    partition(r.right, c.left, eta);
+    partition(r.right, c.right, eta);
+  }
+}
+
+void HierarchicalMatrix::build(const BlockFunction& entries, const HierarchicalMatrixOptions& options)
+{
+  if (rows() == 0 || cols() == 0)
+    return;
+
+  partition(0, 0, options.eta);
+
+  //! the blocks are interleaved over the tasks, neighbouring blocks have
+  //! about the same size
+  const int tasks = static_cast<int>(std::max<size_t>(1, std::min<size_t>(blocks_.size(),
+    options.num_threads > 0 ? options.num_threads : Parallel::NumCores())));
+  Parallel::RunTasks([&](int t)
+  {
+    for (size_t i = t; i < blocks_.size(); i += tasks)
+    {
+      Interruptible::checkForInterruption();
+      Block& b = blocks_[i];
+      if (b.low_rank)
+      {
+        cross_approximation(b, entries, options);
+      }
+      else
+      {
+        b.dense.resize(rows_->cluster(b.row_cluster).size(), cols_->cluster(b.col_cluster).size());
+        entries(rows_->indices(b.row_cluster), cols_->indices(b.col_cluster), b.dense);
+      }
+    }
+  }, tasks);
+
+  if (square_)
+  {
+    for (size_t i = 0; i < blocks_.size(); ++i)
+    {
+      if (!blocks_[i].low_rank && blocks_[i].row_cluster == blocks_[i].col_cluster)
+        diagonal_blocks_.push_back(i);
+    }
+    set_diagonal(diagonal());
+  }
+}
+
+void HierarchicalMatrix::cross_approximation(Block& b, const BlockFunction& entries,
+  const HierarchicalMatrixOptions& options) const
+{
+  const std::vector<index_type> rows = rows_->indices(b.row_cluster);
+  const std::vector<index_type> cols = cols_->indices(b.col_cluster);
+  const size_t m = rows.size();
+  const size_t n = cols.size();
+  size_t max_rank = std::min(m, n);
+  if (options.max_rank > 0) max_rank = std::min(max_rank, options.max_rank);
+
+  //! adaptive cross approximation with partial pivoting: the residual of
+  //! one row and one column is added per step, the next row is the one
+  //! where the last column is largest
+  std::vector<Eigen::VectorXd> us, vs;
+  std::vector<bool> used(m, false);
+  std::vector<index_type> one_row(1), one_col(1);
+  DenseMatrix row_values(1, n), col_values(m, 1);
+  double norm2 = 0;
+  double scale = 0;
+  size_t pivot = 0;
+
+  while (us.size() < max_rank)
+  {
+    used[pivot] = true;
+    one_row[0] = rows[pivot];
+    entries(one_row, cols, row_values);
+    scale = std::max(scale, row_values.cwiseAbs().maxCoeff());
+
+    Eigen::VectorXd v = row_values.row(0).transpose();
+    for (size_t l = 0; l < us.size(); ++l) v -= us[l](pivot)*vs[l];
+
+    Eigen::Index j;
+    const double vmax = v.cwiseAbs().maxCoeff(&j);
+    if (vmax <= 1e-15*scale)
+    {
+      //! this row is approximated already, try another one
+      pivot = std::find(used.begin(), used.end(), false) - used.begin();
+      if (pivot == m) break;
+      continue;
+    }
+    v /= v(j);
+
+    one_col[0] = cols[j];
+    entries(rows, one_col, col_values);
+    Eigen::VectorXd u = col_values.col(0);
+    for (size_t l = 0; l < vs.size(); ++l) u -= vs[l](j)*us[l];
+
+    //! Frobenius norm of the approximation so far
+    const double uv2 = u.squaredNorm()*v.squaredNorm();
+    for (size_t l = 0; l < us.size(); ++l) norm2 += 2*u.dot(us[l])*vs[l].dot(v);
+    norm2 += uv2;
+    us.push_back(u);
+    vs.push_back(v);
+
+    if (uv2 <= options.tolerance*options.tolerance*norm2)
+      break;
+
+    double umax = -1;
+    for (size_t i = 0; i < m; ++i)
+    {
+      if (!used[i] && std::fabs(u(i)) > umax)
+      {
+        umax = std::fabs(u(i));
+        pivot = i;
+      }
+    }
+    if (umax < 0) break;
+  }
+
+  const size_t k = us.size();
+  if ((m + n)*k >= m*n || k == max_rank)
+  {
+    //! no savings, or no convergence within the rank limit
+    b.low_rank = false;
+    b.dense.resize(m, n);
+    entries(rows, cols, b.dense);
+    return;
+  }
+
+  if (k == 0)
+  {
+    b.U = DenseMatrix(m, 0);
+    b.V = DenseMatrix(n, 0);
+    return;
+  }
+
+  Eigen::MatrixXd U(m, k), V(n, k);
+  for (size_t l = 0; l < k; ++l)
+  {
+    U.col(l) = us[l];
+    V.col(l) = vs[l];
+  }
+
+  //! recompression: U*V^T = Qu*Ru*Rv^T*Qv^T, the small core is truncated
+  //! with its singular values
+  Eigen::HouseholderQR<Eigen::MatrixXd> qu(U), qv(V);
+  const Eigen::MatrixXd Ru = qu.matrixQR().topRows(k).triangularView<Eigen::Upper>();
+  const Eigen::MatrixXd Rv = qv.matrixQR().topRows(k).triangularView<Eigen::Upper>();
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd(Ru*Rv.transpose(), Eigen::ComputeFullU | Eigen::ComputeFullV);
+  const Eigen::VectorXd& s = svd.singularValues();
+
+  const double total = s.squaredNorm();
+  size_t rank = k;
+  double tail = 0;
+  while (rank > 1 && tail + s(rank-1)*s(rank-1) <= options.tolerance*options.tolerance*total)
+  {
+    tail += s(rank-1)*s(rank-1);
+    --rank;
+  }
+
+  const Eigen::MatrixXd Qu = qu.householderQ()*Eigen::MatrixXd::Identity(m, k);
+  const Eigen::MatrixXd Qv = qv.householderQ()*Eigen::MatrixXd::Identity(n, k);
+  b.U = Qu*svd.matrixU().leftCols(rank)*s.head(rank).asDiagonal();
+  b.V = Qv*svd.matrixV().leftCols(rank);
+}
+
+void HierarchicalMatrix::multiply_add(const double* x, double* y, bool transposed) const
+{
+  const ClusterTree& in = transposed ? *rows_ : *cols_;
+  const ClusterTree& out = transposed ? *cols_ : *rows_;
+
+  //! vectors in the order of the cluster trees, so that every block works
+  //! on contiguous segments
+  Eigen::VectorXd xp(in.size()), yp = Eigen::VectorXd::Zero(out.size());
+  for (size_t p = 0; p < in.size(); ++p) xp(p) = x[in.index(p)];
+
+  for (const auto& b : blocks_)
+  {
+    const ClusterTree::Cluster& r = rows_->cluster(b.row_cluster);
+    const ClusterTree::Cluster& c = cols_->cluster(b.col_cluster);
+    if (!transposed)
+    {
+      auto xs = xp.segment(c.begin, c.size());
+      if (b.low_rank)
+        yp.segment(r.begin, r.size()).noalias() += b.U*(b.V.transpose()*xs);
+      else
+        yp.segment(r.begin, r.size()).noalias() += b.dense*xs;
+    }
+    else
+    {
+      auto xs = xp.segment(r.begin, r.size());
+      if (b.low_rank)
+        yp.segment(c.begin, c.size()).noalias() += b.V*(b.U.transpose()*xs);
+      else
+        yp.segment(c.begin, c.size()).noalias() += b.dense.transpose()*xs;
+    }
+  }
+
+  for (size_t p = 0; p < out.size(); ++p) y[out.index(p)] += yp(p);
+}
+
+DenseColumnMatrix HierarchicalMatrix::operator*(const DenseColumnMatrix& x) const
+{
+  DenseColumnMatrix y(DenseColumnMatrix::Zero(rows()));
+  multiply_add(x.data(), y.data());
+  return y;
+}
+
+DenseColumnMatrix HierarchicalMatrix::transpose_multiply(const DenseColumnMatrix& x) const
+{
+  DenseColumnMatrix y(DenseColumnMatrix::Zero(cols()));
+  multiply_add(x.data(), y.data(), true);
+  return y;
+}
+
+DenseColumnMatrix HierarchicalMatrix::diagonal() const
+{
+  DenseColumnMatrix d(DenseColumnMatrix::Zero(rows()));
+  for (size_t k : diagonal_blocks_)
+  {
+    const Block& b = blocks_[k];
+    const ClusterTree::Cluster& c = rows_->cluster(b.row_cluster);
+    for (size_t i = 0; i < c.size(); ++i)
+      d(rows_->index(c.begin + i)) = b.dense(i, i);
+  }
+  return d;
+}
+
+void HierarchicalMatrix::set_diagonal(const DenseColumnMatrix& d)
+{
+  diagonal_inverses_.resize(diagonal_blocks_.size());
+  for (size_t k = 0; k < diagonal_blocks_.size(); ++k)
+  {
+    Block& b = blocks_[diagonal_blocks_[k]];
+    const ClusterTree::Cluster& c = rows_->cluster(b.row_cluster);
+    for (size_t i = 0; i < c.size(); ++i)
+      b.dense(i, i) = d(rows_->index(c.begin + i));
+
+    //! a singular block is left out of the preconditioner
+    Eigen::FullPivLU<Eigen::MatrixXd> lu(b.dense);
+    if (lu.isInvertible())
+      diagonal_inverses_[k] = lu.inverse();
+    else
+      diagonal_inverses_[k] = DenseMatrix::Identity(c.size(), c.size());
+  }
+}
+
+void HierarchicalMatrix::solve_diagonal_blocks(const double* x, double* y, bool transposed) const
+{
+  if (!square_)
+  {
+    std::copy(x, x + rows(), y);
+    return;
+  }
+
+  Eigen::VectorXd xs, ys;
+  for (size_t k = 0; k < diagonal_blocks_.size(); ++k)
+  {
+    const ClusterTree::Cluster& c = rows_->cluster(blocks_[diagonal_blocks_[k]].row_cluster);
+    xs.resize(c.size());
+    for (size_t i = 0; i < c.size(); ++i) xs(i) = x[rows_->index(c.begin + i)];
+    if (transposed)
+      ys.noalias() = diagonal_inverses_[k].transpose()*xs;
+    else
+      ys.noalias() = diagonal_inverses_[k]*xs;
+    for (size_t i = 0; i < c.size(); ++i) y[rows_->index(c.begin + i)] = ys(i);
+  }
+}
+
+DenseMatrix HierarchicalMatrix::to_dense() const
+{
+  DenseMatrix A(DenseMatrix::Zero(rows(), cols()));
+  for (const auto& b : blocks_)
+  {
+    const ClusterTree::Cluster& r = rows_->cluster(b.row_cluster);
+    const ClusterTree::Cluster& c = cols_->cluster(b.col_cluster);
+    const DenseMatrix values = b.low_rank ? DenseMatrix(b.U*b.V.transpose()) : b.dense;
+    for (size_t i = 0; i < r.size(); ++i)
+      for (size_t j = 0; j < c.size(); ++j)
+        A(rows_->index(r.begin + i), cols_->index(c.begin + j)) = values(i, j);
+  }
+  return A;
+}
+
+size_t HierarchicalMatrix::stored_entries() const
+{
+  size_t n = 0;
+  for (const auto& b : blocks_)
+    n += b.low_rank ? b.U.size() + b.V.size() : b.dense.size();
+  return n;
+}
+
+size_t HierarchicalMatrix::num_low_rank_blocks() const
+{
+  return std::count_if(blocks_.begin(), blocks_.end(), [](const Block& b) { return b.low_rank; });
+}
+
+size_t HierarchicalMatrix::num_dense_blocks() const
+{
+  return blocks_.size() - num_low_rank_blocks();
+}
+
+bool SCIRun::Core::Algorithms::Forward::SolveGMRES(const LinearOperator& A, const LinearOperator& preconditioner,
+  const DenseColumnMatrix& b, DenseColumnMatrix& x, double tolerance, int max_iterations, int restart)
+{
+  const size_t n = b.size();
+  if (x.size() != static_cast<Eigen::Index>(n)) x = DenseColumnMatrix::Zero(n);
+
+  const double bnorm = b.norm();
+  if (bnorm == 0)
+  {
+    x.setZero();
+    return true;
+  }
+
+  DenseColumnMatrix r(n), w(n), z(n);
+  A(x, w);
+  r = b - w;
+
+  restart = std::max(1, restart);
+  std::vector<Eigen::VectorXd> V(restart + 1);
+  Eigen::MatrixXd H(restart + 1, restart);
+  Eigen::VectorXd cs(restart), sn(restart), g(restart + 1);
+
+  int iterations = 0;
+  while (iterations < max_iterations)
+  {
+    const double beta = r.norm();
+    if (beta <= tolerance*bnorm)
+      return true;
+
+    V[0] = r/beta;
+    g.setZero();
+    g(0) = beta;
+    H.setZero();
+
+    int k = 0;
+    while (k < restart && iterations < max_iterations)
+    {
+      z = V[k];
+      preconditioner(z, w);
+      A(w, z);
+
+      //! modified Gram-Schmidt
+      for (int i = 0; i <= k; ++i)
+      {
+        H(i, k) = z.dot(V[i]);
+        z -= H(i, k)*V[i];
+      }
+      H(k+1, k) = z.norm();
+      if (H(k+1, k) > 0) V[k+1] = z/H(k+1, k);
+
+      for (int i = 0; i < k; ++i)
+      {
+        const double t = cs(i)*H(i, k) + sn(i)*H(i+1, k);
+        H(i+1, k) = -sn(i)*H(i, k) + cs(i)*H(i+1, k);
+        H(i, k) = t;
+      }
+      const double d = std::hypot(H(k, k), H(k+1, k));
+      ++iterations;
+      if (d == 0)
+        break;
+      cs(k) = H(k, k)/d;
+      sn(k) = H(k+1, k)/d;
+      H(k, k) = d;
+      H(k+1, k) = 0;
+      g(k+1) = -sn(k)*g(k);
+      g(k) = cs(k)*g(k);
+
+      ++k;
+      if (std::fabs(g(k)) <= tolerance*bnorm)
+        break;
+    }
+
+    const Eigen::VectorXd y = H.topLeftCorner(k, k).triangularView<Eigen::Upper>().solve(g.head(k));
+    Eigen::VectorXd u = Eigen::VectorXd::Zero(n);
+    for (int i = 0; i < k; ++i) u += y(i)*V[i];
+    z = u;
+    preconditioner(z, w);
+    x += w;
+
+    A(x, w);
+    r = b - w;
+  }
+
+  return r.norm() <= tolerance*bnorm;
+}
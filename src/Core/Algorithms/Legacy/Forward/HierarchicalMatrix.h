@@ -0,0 +1,194 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+*  HierarchicalMatrix.h:  compressed representation of boundary element
+*                         operators
+*/
+
+#ifndef CORE_ALGORITHMS_LEGACY_FORWARD_HIERARCHICALMATRIX_H
+#define CORE_ALGORITHMS_LEGACY_FORWARD_HIERARCHICALMATRIX_H
+
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+#include <Core/Algorithms/Legacy/Forward/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Forward {
+
+        class SCISHARE HierarchicalMatrixOptions
+        {
+        public:
+          HierarchicalMatrixOptions() :
+            leaf_size(32),
+            eta(2.0),
+            tolerance(1e-5),
+            max_rank(0),
+            num_threads(-1) {}
+
+          size_t leaf_size; // clusters with at most this many points are not split
+          double eta; // blocks with min(diam) <= eta*dist are approximated by low rank blocks
+          double tolerance; // relative accuracy of the low rank blocks and of the iterative solves
+          size_t max_rank; // upper limit of the rank of a block, 0 for no limit
+          int num_threads; // < 1 uses all cores
+        };
+
+        /// Binary tree of point clusters, a cluster is split in two halves
+        /// along the longest side of its bounding box until it holds at most
+        /// leaf_size points. The points of a cluster are contiguous in the
+        /// permutation.
+        class SCISHARE ClusterTree
+        {
+        public:
+          ClusterTree(const std::vector<Geometry::Vector>& points, size_t leaf_size);
+
+          struct Cluster
+          {
+            size_t begin;
+            size_t end;
+            int left; // -1 for leaves
+            int right;
+            Geometry::Vector min;
+            Geometry::Vector max;
+
+            size_t size() const { return end - begin; }
+            bool is_leaf() const { return left < 0; }
+            double diameter() const { return (max - min).length(); }
+          };
+
+          size_t size() const { return permutation_.size(); }
+          const Cluster& cluster(int c) const { return clusters_[c]; }
+          /// Original index of the point at position p
+          index_type index(size_t p) const { return permutation_[p]; }
+          /// Original indices of the points of a cluster
+          std::vector<index_type> indices(int c) const;
+
+          /// Distance between the bounding boxes of two clusters
+          static double distance(const Cluster& a, const Cluster& b);
+
+        private:
+          int split(const std::vector<Geometry::Vector>& points, size_t begin, size_t end, size_t leaf_size);
+
+          std::vector<index_type> permutation_;
+          std::vector<Cluster> clusters_;
+        };
+
+        /// Hierarchical matrix: the product of two cluster trees is divided
+        /// into blocks, blocks of well separated clusters are stored as
+        /// U*V^T, computed with adaptive cross approximation from a few of
+        /// their rows and columns, the other blocks are stored dense. Storage
+        /// and the cost of a product grow as O(n log n) for the smooth kernels
+        /// of the boundary element method.
+        class SCISHARE HierarchicalMatrix
+        {
+        public:
+          /// Fills block with the entries of the rows and columns, given as
+          /// indices of the original points. Called from several threads.
+          typedef boost::function<void(const std::vector<index_type>& rows,
+            const std::vector<index_type>& cols, Datatypes::DenseMatrix& block)> BlockFunction;
+
+          /// Square matrix of the interactions of a set of points with itself
+          HierarchicalMatrix(const std::vector<Geometry::Vector>& points,
+            const BlockFunction& entries,
+            const HierarchicalMatrixOptions& options = HierarchicalMatrixOptions());
+
+          HierarchicalMatrix(const std::vector<Geometry::Vector>& row_points,
+            const std::vector<Geometry::Vector>& col_points,
+            const BlockFunction& entries,
+            const HierarchicalMatrixOptions& options = HierarchicalMatrixOptions());
+
+          size_t rows() const { return rows_->size(); }
+          size_t cols() const { return cols_->size(); }
+
+          /// y += A*x, or y += A^T*x
+          void multiply_add(const double* x, double* y, bool transposed = false) const;
+          Datatypes::DenseColumnMatrix operator*(const Datatypes::DenseColumnMatrix& x) const;
+          Datatypes::DenseColumnMatrix transpose_multiply(const Datatypes::DenseColumnMatrix& x) const;
+
+          /// Entries of the diagonal, only for square matrices
+          Datatypes::DenseColumnMatrix diagonal() const;
+          void set_diagonal(const Datatypes::DenseColumnMatrix& d);
+
+          /// Applies the inverse of the dense diagonal blocks, a block Jacobi
+          /// preconditioner for square matrices.
+          void solve_diagonal_blocks(const double* x, double* y, bool transposed = false) const;
+
+          Datatypes::DenseMatrix to_dense() const;
+
+          /// Number of stored entries, rows()*cols() for a dense matrix
+          size_t stored_entries() const;
+          size_t num_low_rank_blocks() const;
+          size_t num_dense_blocks() const;
+
+        private:
+          struct Block
+          {
+            int row_cluster;
+            int col_cluster;
+            bool low_rank;
+            Datatypes::DenseMatrix dense; // or U*V^T
+            Datatypes::DenseMatrix U;
+            Datatypes::DenseMatrix V;
+          };
+
+          void build(const BlockFunction& entries, const HierarchicalMatrixOptions& options);
+          void partition(int row_cluster, int col_cluster, double eta);
+          void cross_approximation(Block& block, const BlockFunction& entries,
+            const HierarchicalMatrixOptions& options) const;
+
+          boost::shared_ptr<ClusterTree> rows_;
+          boost::shared_ptr<ClusterTree> cols_;
+          bool square_;
+          std::vector<Block> blocks_;
+          std::vector<Datatypes::DenseMatrix> diagonal_inverses_;
+          std::vector<size_t> diagonal_blocks_;
+        };
+
+        typedef boost::shared_ptr<HierarchicalMatrix> HierarchicalMatrixHandle;
+
+        /// Operator applied to a vector, y = A*x
+        typedef boost::function<void(const Datatypes::DenseColumnMatrix& x,
+          Datatypes::DenseColumnMatrix& y)> LinearOperator;
+
+        /// Restarted GMRES with right preconditioning, solves A*x = b to a
+        /// relative residual of tolerance starting from x. Returns false
+        /// when max_iterations are reached first.
+        SCISHARE bool SolveGMRES(const LinearOperator& A, const LinearOperator& preconditioner,
+          const Datatypes::DenseColumnMatrix& b, Datatypes::DenseColumnMatrix& x,
+          double tolerance, int max_iterations, int restart = 50);
+
+      }}}}
+
+#endif
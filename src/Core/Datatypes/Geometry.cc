@@ -41,6 +41,15 @@ GeometryObject* GeometryObject::clone() const
   return nullptr; //TODO
 }
 
+std::string GeometryObject::stableID(const std::string& uniqueID)
+{
+  // Module level IDs end in <delimiter>_<hash>
+  auto pos = uniqueID.rfind(delimiter);
+  if (pos == std::string::npos || pos + 1 >= uniqueID.size() || uniqueID[pos + 1] != '_')
+    return uniqueID;
+  return uniqueID.substr(0, pos);
+}
+
 void GeometryObject::addToList(GeometryBaseHandle handle, GeomList& list)
 {
   if (handle.get() == this)
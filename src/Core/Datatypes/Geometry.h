@@ -58,6 +58,10 @@ namespace Datatypes
     virtual void addToList(GeometryBaseHandle handle, GeomList& list);
 
     const std::string& uniqueID() const { return objectName_; }
+    /// The unique ID without the hash of the inputs and state it was built
+    /// from, it is the same for every version a module sends.
+    std::string stableID() const { return stableID(objectName_); }
+    static std::string stableID(const std::string& uniqueID);
 
     virtual std::string dynamic_type_name() const override { return "GeometryObject"; }
 
@@ -0,0 +1,314 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+///
+///@file  CompactMeshStorage.h
+///@brief Node and connectivity arrays for unstructured meshes that can be
+///       switched between full precision (double coordinates, 64 bit
+///       indices) and compact precision (float coordinates, 32 bit indices).
+///
+
+#ifndef CORE_DATATYPES_COMPACTMESHSTORAGE_H
+#define CORE_DATATYPES_COMPACTMESHSTORAGE_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Persistent/PersistentSTL.h>
+#include <Core/Utils/Legacy/CheckSum.h>
+
+#include <limits>
+#include <vector>
+
+namespace SCIRun {
+
+/// Point array that stores its coordinates either as doubles (the default)
+/// or as floats. Points are always handed out as double precision points
+/// by value; writes go through set(). Requesting the underlying double
+/// array (wide()) promotes the storage back to full precision, this is what
+/// code that needs direct memory access should use.
+class CompactPointArray
+{
+  public:
+    typedef Core::Geometry::Point value_type;
+    typedef std::vector<value_type>::size_type size_type;
+
+    CompactPointArray() : compact_(false) {}
+    explicit CompactPointArray(size_type size) : compact_(false), wide_(size) {}
+
+    bool compact() const { return (compact_); }
+
+    size_type size() const
+      { return (compact_ ? narrow_.size()/3 : wide_.size()); }
+    bool empty() const { return (size() == 0); }
+
+    const value_type operator[](size_type i) const
+    {
+      if (compact_)
+      {
+        const float* p = &(narrow_[3*i]);
+        return (value_type(p[0],p[1],p[2]));
+      }
+      return (wide_[i]);
+    }
+
+    void set(size_type i, const value_type& p)
+    {
+      if (compact_)
+      {
+        float* q = &(narrow_[3*i]);
+        q[0] = static_cast<float>(p.x());
+        q[1] = static_cast<float>(p.y());
+        q[2] = static_cast<float>(p.z());
+      }
+      else wide_[i] = p;
+    }
+
+    void push_back(const value_type& p)
+    {
+      if (compact_)
+      {
+        narrow_.push_back(static_cast<float>(p.x()));
+        narrow_.push_back(static_cast<float>(p.y()));
+        narrow_.push_back(static_cast<float>(p.z()));
+      }
+      else wide_.push_back(p);
+    }
+
+    void reserve(size_type size)
+      { if (compact_) narrow_.reserve(3*size); else wide_.reserve(size); }
+    void resize(size_type size)
+      { if (compact_) narrow_.resize(3*size); else wide_.resize(size); }
+    void clear()
+      { narrow_.clear(); wide_.clear(); }
+
+    void erase(size_type i)
+    {
+      if (compact_) narrow_.erase(narrow_.begin()+3*i,narrow_.begin()+3*i+3);
+      else wide_.erase(wide_.begin()+i);
+    }
+
+    /// Convert the storage, converting to floats rounds the coordinates.
+    void set_compact(bool compact)
+    {
+      if (compact == compact_) return;
+      if (compact)
+      {
+        std::vector<float> narrow(3*wide_.size());
+        for (size_type i=0; i<wide_.size(); i++)
+        {
+          narrow[3*i]   = static_cast<float>(wide_[i].x());
+          narrow[3*i+1] = static_cast<float>(wide_[i].y());
+          narrow[3*i+2] = static_cast<float>(wide_[i].z());
+        }
+        narrow_.swap(narrow);
+        std::vector<value_type>().swap(wide_);
+      }
+      else
+      {
+        const size_type size = narrow_.size()/3;
+        std::vector<value_type> wide(size);
+        for (size_type i=0; i<size; i++)
+          wide[i] = value_type(narrow_[3*i],narrow_[3*i+1],narrow_[3*i+2]);
+        wide_.swap(wide);
+        std::vector<float>().swap(narrow_);
+      }
+      compact_ = compact;
+    }
+
+    /// Direct access to the double precision array, promotes the storage.
+    std::vector<value_type>& wide() { set_compact(false); return (wide_); }
+    value_type* wide_pointer()
+      { set_compact(false); return (wide_.empty() ? 0 : &(wide_[0])); }
+
+    /// Direct access to the float array, demotes the storage.
+    std::vector<float>& narrow() { set_compact(true); return (narrow_); }
+
+    int checksum()
+    {
+      if (compact_) return (narrow_.empty() ? 0 :
+        SCIRun::compute_checksum(&(narrow_[0]),narrow_.size()));
+      return (wide_.empty() ? 0 :
+        SCIRun::compute_checksum(&(wide_[0]),wide_.size()));
+    }
+
+  private:
+    bool                     compact_;
+    std::vector<value_type>  wide_;
+    std::vector<float>       narrow_;
+};
+
+
+/// Index array that stores its entries either as 64 bit indices (the
+/// default) or as 32 bit unsigned indices. The owner has to promote the
+/// array, and whatever is stored along with it, before storing an index
+/// for which can_store() is false.
+class CompactIndexArray
+{
+  public:
+    typedef index_type value_type;
+    typedef std::vector<value_type>::size_type size_type;
+
+    CompactIndexArray() : compact_(false) {}
+    explicit CompactIndexArray(size_type size) : compact_(false), wide_(size) {}
+
+    bool compact() const { return (compact_); }
+
+    size_type size() const
+      { return (compact_ ? narrow_.size() : wide_.size()); }
+    bool empty() const { return (size() == 0); }
+
+    value_type operator[](size_type i) const
+      { return (compact_ ? static_cast<value_type>(narrow_[i]) : wide_[i]); }
+
+    bool can_store(value_type idx) const
+      { return (!compact_ || fits(idx)); }
+
+    void set(size_type i, value_type idx)
+    {
+      if (compact_) narrow_[i] = static_cast<unsigned int>(idx);
+      else wide_[i] = idx;
+    }
+
+    void push_back(value_type idx)
+    {
+      if (compact_) narrow_.push_back(static_cast<unsigned int>(idx));
+      else wide_.push_back(idx);
+    }
+
+    void reserve(size_type size)
+      { if (compact_) narrow_.reserve(size); else wide_.reserve(size); }
+    void resize(size_type size)
+      { if (compact_) narrow_.resize(size); else wide_.resize(size); }
+    void clear()
+      { narrow_.clear(); wide_.clear(); }
+
+    /// Erase the entries in [first,last).
+    void erase(size_type first, size_type last)
+    {
+      if (compact_) narrow_.erase(narrow_.begin()+first,narrow_.begin()+last);
+      else wide_.erase(wide_.begin()+first,wide_.begin()+last);
+    }
+
+    /// Convert the storage. Returns false and leaves the array untouched if
+    /// an index does not fit in 32 bits.
+    bool set_compact(bool compact)
+    {
+      if (compact == compact_) return (true);
+      if (compact)
+      {
+        for (size_type i=0; i<wide_.size(); i++)
+          if (!fits(wide_[i])) return (false);
+        std::vector<unsigned int> narrow(wide_.begin(),wide_.end());
+        narrow_.swap(narrow);
+        std::vector<value_type>().swap(wide_);
+      }
+      else
+      {
+        std::vector<value_type> wide(narrow_.begin(),narrow_.end());
+        wide_.swap(wide);
+        std::vector<unsigned int>().swap(narrow_);
+      }
+      compact_ = compact;
+      return (true);
+    }
+
+    /// Direct access to the 64 bit array, promotes the storage.
+    std::vector<value_type>& wide() { set_compact(false); return (wide_); }
+    value_type* wide_pointer()
+      { set_compact(false); return (wide_.empty() ? 0 : &(wide_[0])); }
+
+    /// Direct access to the 32 bit array, only valid when compact() is true.
+    std::vector<unsigned int>& narrow() { return (narrow_); }
+
+    int checksum()
+    {
+      if (compact_) return (narrow_.empty() ? 0 :
+        SCIRun::compute_checksum(&(narrow_[0]),narrow_.size()));
+      return (wide_.empty() ? 0 :
+        SCIRun::compute_checksum(&(wide_[0]),wide_.size()));
+    }
+
+  private:
+    static bool fits(value_type idx)
+    {
+      return (idx >= 0 && static_cast<unsigned long long>(idx) <=
+        static_cast<unsigned long long>(std::numeric_limits<unsigned int>::max()));
+    }
+
+    bool                       compact_;
+    std::vector<value_type>    wide_;
+    std::vector<unsigned int>  narrow_;
+};
+
+
+/// Raw access and assignment for the shared virtual mesh interface, the
+/// std::vector overloads are used by meshes that do not support compact
+/// storage.
+inline Core::Geometry::Point* points_pointer(std::vector<Core::Geometry::Point>& points)
+  { return (points.empty() ? 0 : &(points[0])); }
+inline Core::Geometry::Point* points_pointer(CompactPointArray& points)
+  { return (points.wide_pointer()); }
+
+inline void set_points_value(std::vector<Core::Geometry::Point>& points,
+                             index_type i, const Core::Geometry::Point& p)
+  { points[i] = p; }
+inline void set_points_value(CompactPointArray& points,
+                             index_type i, const Core::Geometry::Point& p)
+  { points.set(i, p); }
+
+
+/// Persistent IO: a flag followed by either the compact or the full
+/// precision arrays.
+inline void Pio(Piostream& stream, CompactPointArray& points)
+{
+  stream.begin_cheap_delim();
+  int compact = points.compact() ? 1 : 0;
+  stream.io(compact);
+  if (compact) SCIRun::Pio(stream, points.narrow());
+  else SCIRun::Pio(stream, points.wide());
+  stream.end_cheap_delim();
+}
+
+inline void Pio_index(Piostream& stream, CompactIndexArray& indices)
+{
+  stream.begin_cheap_delim();
+  int compact = indices.compact() ? 1 : 0;
+  stream.io(compact);
+  if (compact)
+  {
+    indices.set_compact(true);
+    SCIRun::Pio(stream, indices.narrow());
+  }
+  else SCIRun::Pio_index(stream, indices.wide());
+  stream.end_cheap_delim();
+}
+
+} // namespace SCIRun
+
+#endif
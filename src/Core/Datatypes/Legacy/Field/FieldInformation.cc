@@ -30,6 +30,8 @@
 #include <Core/Utils/Legacy/TypeDescription.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Utils/Legacy/StringUtil.h>
 
 using namespace SCIRun;
@@ -78,6 +80,8 @@ FieldTypeInformation::insert_field_type_information(Field* field)
   const TypeDescription* container_td = field->get_type_description(Field::FDATA_TD_E);
   temp = container_td->get_name(); 
   container_type = temp.substr(0,temp.find("<"));
+
+  compact_storage = field->vmesh() && field->vmesh()->has_compact_storage();
 }
 
 
@@ -1043,6 +1047,12 @@ FieldTypeInformation::is_tetvolmesh() const
   return false;
 }
 
+bool
+FieldTypeInformation::is_compact_storage() const
+{
+  return (compact_storage);
+}
+
 bool
 FieldTypeInformation::is_prismvolmesh() const
 {
@@ -1263,6 +1273,21 @@ FieldInformation::make_unstructuredmesh()
 }
 
 
+bool
+FieldInformation::make_compact_storage()
+{
+  if (!is_tetvolmesh()) return (false);
+  compact_storage = true;
+  return (true);
+}
+
+bool
+FieldInformation::make_full_storage()
+{
+  compact_storage = false;
+  return (true);
+}
+
 bool
 FieldInformation::make_irregularmesh()
 {
@@ -1543,6 +1568,7 @@ SCIRun::CreateField(FieldInformation &info)
   MeshHandle meshhandle = CreateMesh(meshtype);
   
   if (!meshhandle) return FieldHandle();
+  if (info.is_compact_storage()) meshhandle->vmesh()->set_compact_storage(true);
 
   return (CreateField(type,meshhandle));              
 }
@@ -1559,7 +1585,10 @@ MeshHandle
 SCIRun::CreateMesh(FieldInformation &info)
 {
   std::string type = info.get_mesh_type_id();
-  return (CreateMesh(type));
+  MeshHandle meshhandle = CreateMesh(type);
+  if (meshhandle && info.is_compact_storage())
+    meshhandle->vmesh()->set_compact_storage(true);
+  return (meshhandle);
 }
 
 MeshHandle 
@@ -44,6 +44,7 @@ class SCISHARE FieldTypeInformation
 {
 
   public:
+    FieldTypeInformation() : compact_storage(false) {}
 
     bool        is_isomorphic() const;
     bool        is_nonlinear() const;
@@ -132,6 +133,9 @@ class SCISHARE FieldTypeInformation
     bool        is_prism_element() const;
     bool        is_hex_element() const;
 
+    // Whether the mesh stores float coordinates and 32 bit connectivity
+    bool        is_compact_storage() const;
+
     void insert_field_type_information(Field* field);
   protected:
   
@@ -143,7 +147,9 @@ class SCISHARE FieldTypeInformation
     std::string basis_type;
     std::string data_type;
     std::string container_type;
-    
+
+    // storage precision of the mesh
+    bool        compact_storage;
 };
 
 
@@ -244,6 +250,11 @@ class SCISHARE FieldInformation : public FieldTypeInformation {
 
     bool        make_unstructuredmesh();
     bool        make_irregularmesh();
+
+    // Select float coordinates and 32 bit connectivity for meshes created
+    // from this information. Only TetVolMesh supports this.
+    bool        make_compact_storage();
+    bool        make_full_storage();
     
     bool        operator==(const FieldInformation&) const;
     bool        operator!=(const FieldInformation&) const;
@@ -0,0 +1,297 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+///
+///@file  MeshBoundaryFaces.cc
+///
+///@brief The faces of a volume mesh that belong to a single element.
+///
+
+#include <Core/Datatypes/Legacy/Field/MeshBoundaryFaces.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/TetVolMesh.h>
+#include <Core/Datatypes/Legacy/Field/HexVolMesh.h>
+#include <Core/Thread/Parallel.h>
+
+#include <boost/cstdint.hpp>
+#include <algorithm>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Thread;
+
+namespace {
+
+typedef boost::uint64_t hash_type;
+
+/// The sorted nodes of a face, two elements share a face when these are
+/// equal. Unused corners are -1.
+struct FaceNodes
+{
+  index_type n[4];
+
+  bool operator==(const FaceNodes& f) const
+  {
+    return (n[0] == f.n[0] && n[1] == f.n[1] && n[2] == f.n[2] && n[3] == f.n[3]);
+  }
+};
+
+/// Faces in the order PrismVolMesh::compute_faces() enters them
+const int PrismVolFaceTable[5][4] = { {0,1,2,-1},{5,4,3,-1},{1,4,5,2},
+                                      {2,5,3,0},{0,3,4,1}};
+
+struct FaceRecord
+{
+  hash_type hash;
+  /// element*faces_per_elem + face
+  index_type id;
+
+  bool operator<(const FaceRecord& r) const
+  {
+    return (hash < r.hash || (hash == r.hash && id < r.id));
+  }
+};
+
+/// Faces of an element in the order and orientation of the face tables of
+/// the meshes, so the boundary is wound the same way as the faces returned
+/// by get_nodes() for a DElem. Four entries per face and -1 for the unused
+/// corner of a triangle.
+class FaceTable
+{
+public:
+  explicit FaceTable(VMesh* mesh) : num_faces(0), nodes_per_face(0)
+  {
+    if (mesh->is_tet_element())
+      set(&TetVolFaceTable[0][0], 4, 3);
+    else if (mesh->is_prism_element())
+      set(&PrismVolFaceTable[0][0], 5, 4);
+    else if (mesh->is_hex_element())
+      set(&HexVolFaceTable[0][0], 6, 4);
+  }
+
+  FaceNodes sorted(const VMesh::Node::array_type& nodes, int face) const
+  {
+    FaceNodes f;
+    const int* c = &corners[4*face];
+    for (int k = 0; k < 4; k++) f.n[k] = (c[k] < 0) ? -1 : index_type(nodes[c[k]]);
+    std::sort(f.n, f.n+4);
+    return (f);
+  }
+
+  int num_faces;
+  int nodes_per_face;
+  std::vector<int> corners;
+
+private:
+  void set(const int* table, int faces, int width)
+  {
+    num_faces = faces;
+    nodes_per_face = (width < 4) ? 3 : 4;
+    corners.assign(4*faces, -1);
+    for (int f = 0; f < faces; f++)
+      for (int k = 0; k < width; k++) corners[4*f+k] = table[width*f+k];
+  }
+};
+
+inline hash_type mix(hash_type h)
+{
+  h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return (h);
+}
+
+inline hash_type face_hash(const FaceNodes& f)
+{
+  hash_type h = 0;
+  for (int k = 0; k < 4; k++) h = mix(h ^ (static_cast<hash_type>(f.n[k]) + 0x9e3779b97f4a7c15ULL));
+  return (h);
+}
+
+}
+
+MeshBoundaryFacesHandle
+SCIRun::ComputeMeshBoundaryFaces(VMesh* mesh)
+{
+  if (!mesh || !mesh->is_volume() || mesh->is_nonlinearmesh())
+    return (MeshBoundaryFacesHandle());
+
+  const FaceTable table(mesh);
+  if (table.num_faces == 0) return (MeshBoundaryFacesHandle());
+
+  VMesh::Elem::size_type num_elems;
+  mesh->size(num_elems);
+
+  const int nf = table.num_faces;
+  const int num_tasks = static_cast<int>(std::max(1u, Parallel::NumCores()));
+
+  // Records are partitioned into buckets by the high bits of their hash,
+  // each task sorts its own buckets.
+  int bits = 0;
+  while ((1 << bits) < 8*num_tasks) bits++;
+  const size_t num_buckets = size_t(1) << bits;
+  const int shift = 64 - bits;
+
+  const index_type elems_per_task = (num_elems + num_tasks - 1) / num_tasks;
+  std::vector<size_t> counts(num_tasks*num_buckets, 0);
+
+  auto count_faces = [&](int t)
+  {
+    VMesh::Node::array_type nodes;
+    size_t* count = &counts[t*num_buckets];
+    const index_type end = std::min<index_type>(num_elems, (t+1)*elems_per_task);
+    for (index_type e = t*elems_per_task; e < end; e++)
+    {
+      mesh->get_nodes(nodes, VMesh::Elem::index_type(e));
+      for (int f = 0; f < nf; f++) count[face_hash(table.sorted(nodes, f)) >> shift]++;
+    }
+  };
+  Parallel::RunTasks(count_faces, num_tasks);
+
+  // Bucket major offsets, within a bucket the tasks write in order
+  std::vector<size_t> offsets(num_tasks*num_buckets);
+  std::vector<size_t> bucket_start(num_buckets+1);
+  size_t pos = 0;
+  for (size_t b = 0; b < num_buckets; b++)
+  {
+    bucket_start[b] = pos;
+    for (int t = 0; t < num_tasks; t++)
+    {
+      offsets[t*num_buckets+b] = pos;
+      pos += counts[t*num_buckets+b];
+    }
+  }
+  bucket_start[num_buckets] = pos;
+
+  std::vector<FaceRecord> records(pos);
+
+  auto scatter_faces = [&](int t)
+  {
+    VMesh::Node::array_type nodes;
+    size_t* offset = &offsets[t*num_buckets];
+    const index_type end = std::min<index_type>(num_elems, (t+1)*elems_per_task);
+    for (index_type e = t*elems_per_task; e < end; e++)
+    {
+      mesh->get_nodes(nodes, VMesh::Elem::index_type(e));
+      for (int f = 0; f < nf; f++)
+      {
+        FaceRecord r;
+        r.hash = face_hash(table.sorted(nodes, f));
+        r.id = e*nf + f;
+        records[offset[r.hash >> shift]++] = r;
+      }
+    }
+  };
+  Parallel::RunTasks(scatter_faces, num_tasks);
+
+  // A face is on the boundary when no other face has the same nodes. Equal
+  // hashes are confirmed by comparing the nodes.
+  std::vector<std::vector<index_type> > found(num_tasks);
+
+  auto find_boundary = [&](int t)
+  {
+    VMesh::Node::array_type nodes;
+    std::vector<FaceNodes> run;
+    for (size_t b = t; b < num_buckets; b += num_tasks)
+    {
+      std::vector<FaceRecord>::iterator it = records.begin() + bucket_start[b];
+      std::vector<FaceRecord>::iterator end = records.begin() + bucket_start[b+1];
+      std::sort(it, end);
+
+      while (it != end)
+      {
+        std::vector<FaceRecord>::iterator next = it + 1;
+        while (next != end && next->hash == it->hash) ++next;
+
+        if (next - it == 1)
+        {
+          found[t].push_back(it->id);
+        }
+        else
+        {
+          run.clear();
+          for (std::vector<FaceRecord>::iterator r = it; r != next; ++r)
+          {
+            mesh->get_nodes(nodes, VMesh::Elem::index_type(r->id / nf));
+            run.push_back(table.sorted(nodes, static_cast<int>(r->id % nf)));
+          }
+          for (size_t i = 0; i < run.size(); i++)
+          {
+            bool shared = false;
+            for (size_t j = 0; j < run.size() && !shared; j++)
+              shared = (i != j && run[i] == run[j]);
+            if (!shared) found[t].push_back((it + i)->id);
+          }
+        }
+        it = next;
+      }
+    }
+  };
+  Parallel::RunTasks(find_boundary, num_tasks);
+
+  std::vector<index_type> ids;
+  for (int t = 0; t < num_tasks; t++)
+  {
+    ids.insert(ids.end(), found[t].begin(), found[t].end());
+    std::vector<index_type>().swap(found[t]);
+  }
+  std::vector<FaceRecord>().swap(records);
+  std::sort(ids.begin(), ids.end());
+
+  boost::shared_ptr<MeshBoundaryFaces> boundary(new MeshBoundaryFaces);
+  const size_t npf = table.nodes_per_face;
+  boundary->nodes_per_face = npf;
+  boundary->nodes.resize(ids.size()*npf);
+  boundary->elems.resize(ids.size());
+  boundary->faces.resize(ids.size());
+
+  const size_t faces_per_task = (ids.size() + num_tasks - 1) / num_tasks;
+  auto fill_faces = [&](int t)
+  {
+    VMesh::Node::array_type nodes;
+    const size_t end = std::min(ids.size(), (t+1)*faces_per_task);
+    for (size_t i = t*faces_per_task; i < end; i++)
+    {
+      const index_type elem = ids[i] / nf;
+      const int face = static_cast<int>(ids[i] % nf);
+      mesh->get_nodes(nodes, VMesh::Elem::index_type(elem));
+
+      const int* c = &table.corners[4*face];
+      index_type* out = &boundary->nodes[i*npf];
+      for (size_t k = 0; k < npf; k++)
+        out[k] = (c[k] < 0) ? out[k-1] : index_type(nodes[c[k]]);
+
+      boundary->elems[i] = elem;
+      boundary->faces[i] = static_cast<unsigned char>(face);
+    }
+  };
+  Parallel::RunTasks(fill_faces, num_tasks);
+
+  return (boundary);
+}
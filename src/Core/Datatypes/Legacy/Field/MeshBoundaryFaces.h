@@ -0,0 +1,85 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+///
+///@file  MeshBoundaryFaces.h
+///
+///@brief The faces of a volume mesh that belong to a single element.
+///
+
+#ifndef CORE_DATATYPES_MESHBOUNDARYFACES_H
+#define CORE_DATATYPES_MESHBOUNDARYFACES_H
+
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+#include <Core/Datatypes/Legacy/Field/share.h>
+
+namespace SCIRun {
+
+class VMesh;
+
+/// Boundary faces are found by hashing the node sets of the faces of all
+/// elements, the face topology of the mesh (FACES_E, DELEMS_E and
+/// ELEM_NEIGHBORS_E) is not built. Faces are ordered by element and by their
+/// position in the face table of the mesh, the nodes of a face are wound as
+/// in that table. Triangular faces of prisms are padded by repeating their
+/// last node.
+class SCISHARE MeshBoundaryFaces {
+public:
+  typedef Mesh::index_type index_type;
+  typedef Mesh::size_type  size_type;
+
+  MeshBoundaryFaces() : nodes_per_face(0) {}
+
+  /// Number of boundary faces
+  size_t size() const { return (elems.size()); }
+
+  /// Nodes of the faces, nodes_per_face entries for each face
+  std::vector<index_type> nodes;
+  /// The element each face belongs to
+  std::vector<index_type> elems;
+  /// Index of the face within its element
+  std::vector<unsigned char> faces;
+
+  size_t nodes_per_face;
+};
+
+typedef boost::shared_ptr<const MeshBoundaryFaces> MeshBoundaryFacesHandle;
+
+/// Extract the boundary faces of a linear tetrahedral, prism or hexahedral
+/// mesh. The work is split over all cores. Returns an empty handle for
+/// other meshes.
+SCISHARE MeshBoundaryFacesHandle ComputeMeshBoundaryFaces(VMesh* mesh);
+
+} // end namespace SCIRun
+
+#endif
@@ -0,0 +1,236 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/MeshBoundaryFaces.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+
+#include <gtest/gtest.h>
+#include <map>
+#include <set>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  typedef std::set<std::vector<index_type> > FaceSet;
+
+  FaceSet sortedFaces(const MeshBoundaryFaces& faces)
+  {
+    FaceSet set;
+    for (size_t f = 0; f < faces.size(); f++)
+    {
+      std::vector<index_type> nodes(faces.nodes.begin() + f*faces.nodes_per_face,
+        faces.nodes.begin() + (f+1)*faces.nodes_per_face);
+      std::sort(nodes.begin(), nodes.end());
+      set.insert(nodes);
+    }
+    return set;
+  }
+
+  typedef std::map<std::vector<index_type>, std::vector<index_type> > OrderedFaces;
+
+  // Reference result using the face topology of the mesh, the sorted nodes
+  // of every boundary face mapped to the nodes in the order of get_nodes().
+  OrderedFaces orderedNeighborBoundary(VMesh* mesh)
+  {
+    mesh->synchronize(Mesh::DELEMS_E | Mesh::ELEM_NEIGHBORS_E);
+    OrderedFaces faces;
+    VMesh::DElem::array_type delems;
+    VMesh::Node::array_type nodes;
+    VMesh::Elem::index_type neighbor;
+    for (VMesh::Elem::index_type e = 0; e < mesh->num_elems(); ++e)
+    {
+      mesh->get_delems(delems, e);
+      for (size_t p = 0; p < delems.size(); p++)
+      {
+        if (mesh->get_neighbor(neighbor, e, delems[p])) continue;
+        mesh->get_nodes(nodes, delems[p]);
+        std::vector<index_type> face(nodes.begin(), nodes.end());
+        std::vector<index_type> key(face);
+        std::sort(key.begin(), key.end());
+        faces[key] = face;
+      }
+    }
+    return faces;
+  }
+
+  FaceSet neighborBoundary(VMesh* mesh)
+  {
+    FaceSet set;
+    for (const auto& face : orderedNeighborBoundary(mesh))
+      set.insert(face.first);
+    return set;
+  }
+
+  void expectWindingMatchesFaceTopology(VMesh* mesh)
+  {
+    OrderedFaces reference = orderedNeighborBoundary(mesh);
+    MeshBoundaryFacesHandle faces = ComputeMeshBoundaryFaces(mesh);
+    ASSERT_TRUE(faces != nullptr);
+    ASSERT_EQ(reference.size(), faces->size());
+    for (size_t f = 0; f < faces->size(); f++)
+    {
+      std::vector<index_type> nodes(faces->nodes.begin() + f*faces->nodes_per_face,
+        faces->nodes.begin() + (f+1)*faces->nodes_per_face);
+      std::vector<index_type> key(nodes);
+      std::sort(key.begin(), key.end());
+      OrderedFaces::const_iterator it = reference.find(key);
+      ASSERT_TRUE(it != reference.end());
+      EXPECT_EQ(it->second, nodes) << " face " << f;
+    }
+  }
+
+  // n^3 unit hexahedra with their nodes in the order of the unit element
+  FieldHandle hexVolGrid(size_type n)
+  {
+    FieldInformation fi(HEXVOLMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+    const size_type np = n + 1;
+    for (size_type k = 0; k < np; k++)
+      for (size_type j = 0; j < np; j++)
+        for (size_type i = 0; i < np; i++)
+          mesh->add_point(Point(double(i), double(j), double(k)));
+
+    static const int corner[8][3] = { {0,0,0},{1,0,0},{1,1,0},{0,1,0},
+                                      {0,0,1},{1,0,1},{1,1,1},{0,1,1} };
+    VMesh::Node::array_type hex(8);
+    for (size_type k = 0; k < n; k++)
+      for (size_type j = 0; j < n; j++)
+        for (size_type i = 0; i < n; i++)
+        {
+          for (int c = 0; c < 8; c++)
+            hex[c] = (i + corner[c][0]) + np*((j + corner[c][1]) + np*(k + corner[c][2]));
+          mesh->add_elem(hex);
+        }
+    field->vfield()->resize_values();
+    return field;
+  }
+}
+
+TEST(MeshBoundaryFacesTest, TetVolBoundaryMatchesNeighborSearch)
+{
+  FieldHandle tetvol = CreateTetVolGrid(4, true);
+  VMesh* mesh = tetvol->vmesh();
+
+  MeshBoundaryFacesHandle faces = ComputeMeshBoundaryFaces(mesh);
+  ASSERT_TRUE(faces != nullptr);
+  EXPECT_EQ(3u, faces->nodes_per_face);
+  // Two triangles per square on the six sides of the cube
+  ASSERT_EQ(6u*4*4*2, faces->size());
+  EXPECT_EQ(faces->size(), faces->elems.size());
+  EXPECT_TRUE(std::is_sorted(faces->elems.begin(), faces->elems.end()));
+
+  EXPECT_EQ(neighborBoundary(mesh), sortedFaces(*faces));
+}
+
+TEST(MeshBoundaryFacesTest, LatVolBoundaryHasOneQuadPerSideCell)
+{
+  FieldHandle latvol = CreateEmptyLatVol(3, 4, 5);
+  MeshBoundaryFacesHandle faces = ComputeMeshBoundaryFaces(latvol->vmesh());
+
+  ASSERT_TRUE(faces != nullptr);
+  EXPECT_EQ(4u, faces->nodes_per_face);
+  EXPECT_EQ(2u*(2*3 + 2*4 + 3*4), faces->size());
+  EXPECT_EQ(faces->size(), sortedFaces(*faces).size());
+}
+
+TEST(MeshBoundaryFacesTest, SurfaceMeshHasNoBoundaryFaces)
+{
+  FieldHandle trisurf = CubeTriSurfLinearBasis(DOUBLE_E);
+  EXPECT_FALSE(ComputeMeshBoundaryFaces(trisurf->vmesh()));
+  EXPECT_FALSE(trisurf->vmesh()->get_boundary_faces());
+}
+
+TEST(MeshBoundaryFacesTest, TetVolBoundaryNormalsPointOutward)
+{
+  FieldHandle tetvol = CreateTetVolGrid(4, true);
+  VMesh* mesh = tetvol->vmesh();
+
+  MeshBoundaryFacesHandle faces = ComputeMeshBoundaryFaces(mesh);
+  ASSERT_TRUE(faces != nullptr);
+  for (size_t f = 0; f < faces->size(); f++)
+  {
+    Point p[3];
+    for (int k = 0; k < 3; k++)
+      mesh->get_center(p[k], VMesh::Node::index_type(faces->nodes[3*f+k]));
+    Point centroid;
+    mesh->get_center(centroid, VMesh::Elem::index_type(faces->elems[f]));
+
+    const Vector normal = Cross(p[1]-p[0], p[2]-p[0]);
+    // Three times the offset of the face center from the element centroid
+    const Vector outward = (p[0] - centroid) + (p[1] - centroid) + (p[2] - centroid);
+    EXPECT_GT(Dot(normal, outward), 0.0) << " face " << f;
+  }
+}
+
+TEST(MeshBoundaryFacesTest, TetVolWindingMatchesFaceTopology)
+{
+  FieldHandle tetvol = CreateTetVolGrid(3, true);
+  expectWindingMatchesFaceTopology(tetvol->vmesh());
+}
+
+TEST(MeshBoundaryFacesTest, HexVolWindingMatchesFaceTopology)
+{
+  FieldHandle hexvol = hexVolGrid(3);
+  expectWindingMatchesFaceTopology(hexvol->vmesh());
+}
+
+TEST(MeshBoundaryFacesTest, BoundaryFollowsElementEdits)
+{
+  FieldHandle tetvol = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  VMesh* mesh = tetvol->vmesh();
+  VMesh::Node::index_type apex = mesh->add_point(Point(-1, -1, -1));
+  VMesh::Node::index_type far = mesh->add_point(Point(3, 3, 3));
+
+  MeshBoundaryFacesHandle faces = mesh->get_boundary_faces();
+  ASSERT_TRUE(faces != nullptr);
+  EXPECT_EQ(4u, faces->size());
+
+  // A second tetrahedron glued to one of the faces
+  VMesh::Node::array_type nodes;
+  mesh->get_nodes(nodes, VMesh::Elem::index_type(0));
+  nodes[0] = apex;
+  mesh->add_elem(nodes);
+  EXPECT_EQ(6u, mesh->get_boundary_faces()->size());
+
+  // Detached again, the number of nodes and elements stays the same
+  nodes[1] = far;
+  mesh->set_nodes(nodes, VMesh::Elem::index_type(1));
+  EXPECT_EQ(8u, mesh->get_boundary_faces()->size());
+}
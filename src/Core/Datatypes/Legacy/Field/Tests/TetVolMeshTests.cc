@@ -32,8 +32,11 @@
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Persistent/Persistent.h>
 
 #include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <limits>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -69,4 +72,140 @@ TEST(TetVolMeshTest, CheckMeshIteratorTetVolMesh)
   
 }
 
+namespace
+{
+  FieldHandle compactCopy(FieldHandle input)
+  {
+    FieldInformation fi(input);
+    EXPECT_FALSE(fi.is_compact_storage());
+    EXPECT_TRUE(fi.make_compact_storage());
+    FieldHandle output = CreateField(fi);
+
+    VMesh* imesh = input->vmesh();
+    VMesh* omesh = output->vmesh();
+    VMesh::Node::array_type nodes;
+    for (VMesh::Node::index_type i = 0; i < imesh->num_nodes(); ++i)
+      omesh->add_point(imesh->get_point(i));
+    for (VMesh::Elem::index_type i = 0; i < imesh->num_elems(); ++i)
+    {
+      imesh->get_nodes(nodes, i);
+      omesh->add_elem(nodes);
+    }
+    output->vfield()->resize_values();
+    output->vfield()->copy_values(input->vfield());
+    return output;
+  }
+
+  void expectSameMesh(FieldHandle expected, FieldHandle actual, double tolerance)
+  {
+    VMesh* emesh = expected->vmesh();
+    VMesh* amesh = actual->vmesh();
+    ASSERT_EQ(emesh->num_nodes(), amesh->num_nodes());
+    ASSERT_EQ(emesh->num_elems(), amesh->num_elems());
+    for (VMesh::Node::index_type i = 0; i < emesh->num_nodes(); ++i)
+      EXPECT_NEAR(0.0, (emesh->get_point(i) - amesh->get_point(i)).length(), tolerance);
+
+    VMesh::Node::array_type enodes, anodes;
+    for (VMesh::Elem::index_type i = 0; i < emesh->num_elems(); ++i)
+    {
+      emesh->get_nodes(enodes, i);
+      amesh->get_nodes(anodes, i);
+      EXPECT_EQ(enodes, anodes);
+    }
+  }
+}
+
+TEST(TetVolMeshTest, CompactStorageIsSelectedThroughFieldInformation)
+{
+  FieldHandle tetvol = CreateTetVolGrid(5, true, 1);
+  FieldHandle compact = compactCopy(tetvol);
+
+  EXPECT_FALSE(tetvol->vmesh()->has_compact_storage());
+  EXPECT_TRUE(compact->vmesh()->has_compact_storage());
+  EXPECT_TRUE(FieldInformation(compact).is_compact_storage());
+  expectSameMesh(tetvol, compact, 1e-6);
+
+  double volume = 0.0;
+  for (VMesh::Elem::index_type i = 0; i < compact->vmesh()->num_elems(); ++i)
+    volume += compact->vmesh()->get_volume(i);
+  EXPECT_NEAR(1.0, volume, 1e-5);
+}
+
+TEST(TetVolMeshTest, CompactStorageOnlyForTetVolMesh)
+{
+  FieldInformation fi("TriSurfMesh", 1, "double");
+  EXPECT_FALSE(fi.make_compact_storage());
+  EXPECT_FALSE(fi.is_compact_storage());
+}
+
+TEST(TetVolMeshTest, CompactStoragePromotesForRawAccess)
+{
+  FieldHandle compact = compactCopy(CreateTetVolGrid(3, false, 1));
+  VMesh* mesh = compact->vmesh();
+  ASSERT_TRUE(mesh->has_compact_storage());
 
+  VMesh::index_type* elems = mesh->get_elems_pointer();
+  ASSERT_TRUE(elems != 0);
+  EXPECT_FALSE(mesh->has_compact_storage());
+
+  VMesh::Node::array_type nodes;
+  mesh->get_nodes(nodes, VMesh::Elem::index_type(0));
+  for (size_t j = 0; j < nodes.size(); ++j)
+    EXPECT_EQ(nodes[j], elems[j]);
+}
+
+TEST(TetVolMeshTest, CompactStoragePromotesPointsAndCellsTogether)
+{
+  FieldHandle compact = compactCopy(CreateTetVolGrid(3, false, 1));
+  VMesh* mesh = compact->vmesh();
+  ASSERT_TRUE(mesh->has_compact_storage());
+
+  Point* points = mesh->get_points_pointer();
+  ASSERT_TRUE(points != 0);
+  EXPECT_FALSE(mesh->has_compact_storage());
+  ASSERT_TRUE(mesh->set_compact_storage(true));
+  EXPECT_TRUE(mesh->has_compact_storage());
+
+  // an index beyond 32 bits cannot be stored compactly
+  VMesh::Node::array_type nodes;
+  mesh->get_nodes(nodes, VMesh::Elem::index_type(0));
+  nodes[0] = static_cast<VMesh::index_type>(std::numeric_limits<unsigned int>::max()) + 1;
+  mesh->set_nodes(nodes, VMesh::Elem::index_type(0));
+  EXPECT_FALSE(mesh->has_compact_storage());
+  VMesh::Node::array_type stored;
+  mesh->get_nodes(stored, VMesh::Elem::index_type(0));
+  EXPECT_EQ(nodes[0], stored[0]);
+}
+
+TEST(TetVolMeshTest, CompactStorageSurvivesPio)
+{
+  FieldHandle compact = compactCopy(CreateTetVolGrid(4, true, 1));
+
+  const boost::filesystem::path filename = boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("compacttetvol-%%%%%%%%.fld");
+  {
+    PiostreamPtr stream = auto_ostream(filename.string(), "Binary");
+    ASSERT_FALSE(stream->error());
+    Pio(*stream, compact);
+  }
+
+  FieldHandle read;
+  {
+    PiostreamPtr stream = auto_istream(filename.string());
+    ASSERT_TRUE(stream && !stream->error());
+    Pio(*stream, read);
+  }
+  boost::filesystem::remove(filename);
+
+  ASSERT_TRUE(read != nullptr);
+  EXPECT_TRUE(read->vmesh()->has_compact_storage());
+  expectSameMesh(compact, read, 0.0);
+
+  for (VMesh::Node::index_type i = 0; i < compact->vmesh()->num_nodes(); ++i)
+  {
+    double expected, actual;
+    compact->vfield()->get_value(expected, i);
+    read->vfield()->get_value(actual, i);
+    EXPECT_EQ(expected, actual);
+  }
+}
@@ -146,6 +146,12 @@ public:
                                      Point& point);
 
   virtual VMesh::index_type* get_elems_pointer() const;
+  virtual Core::Geometry::Point* get_points_pointer() const;
+
+  virtual bool set_compact_storage(bool compact)
+    { return (this->mesh_->set_compact_storage(compact)); }
+  virtual bool has_compact_storage() const
+    { return (this->mesh_->has_compact_storage()); }
   
   virtual double inscribed_circumscribed_radius_metric(VMesh::Elem::index_type idx) const;
 };
@@ -500,13 +506,24 @@ VTetVolMesh<MESH>::get_delems(VMesh::DElem::array_type &delems,
   delems.resize(1); delems[0] = static_cast<VMesh::DElem::index_type>(idx);
 }
 
+/// Raw access needs the double precision layout, promote the points and
+/// the cells together so the mesh never ends up half compact.
 template <class MESH>
 VMesh::index_type*
 VTetVolMesh<MESH>::
 get_elems_pointer() const
 {
-  if (this->mesh_->cells_.size() == 0) return (0);
-   return (&(this->mesh_->cells_[0]));
+  this->mesh_->set_compact_storage(false);
+  return (this->mesh_->cells_.wide_pointer());
+}
+
+template <class MESH>
+Core::Geometry::Point*
+VTetVolMesh<MESH>::
+get_points_pointer() const
+{
+  this->mesh_->set_compact_storage(false);
+  return (this->mesh_->points_.wide_pointer());
 }
 
 
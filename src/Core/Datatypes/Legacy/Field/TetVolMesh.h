@@ -49,6 +49,7 @@
 #include <Core/Basis/TetQuadraticLgn.h>
 #include <Core/Basis/TetCubicHmt.h>
 
+#include <Core/Datatypes/Legacy/Field/CompactMeshStorage.h>
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
@@ -262,22 +263,22 @@ public:
     }
 
     inline
-    const Core::Geometry::Point &node0() const
+    const Core::Geometry::Point node0() const
     {
       return mesh_.points_[node0_index()];
     }
     inline
-    const Core::Geometry::Point &node1() const
+    const Core::Geometry::Point node1() const
     {
       return mesh_.points_[node1_index()];
     }
     inline
-    const Core::Geometry::Point &node2() const
+    const Core::Geometry::Point node2() const
     {
       return mesh_.points_[node2_index()];
     }
     inline
-    const Core::Geometry::Point &node3() const
+    const Core::Geometry::Point node3() const
     {
       return mesh_.points_[node3_index()];
     }
@@ -648,7 +649,7 @@ public:
   void get_point(Core::Geometry::Point &result, typename Node::index_type index) const
   { result = points_[index]; }
   void set_point(const Core::Geometry::Point &point, typename Node::index_type index)
-  { points_[index] = point; }
+  { points_.set(index, point); }
   void get_random_point(Core::Geometry::Point &p, typename Elem::index_type i, FieldRNG &r) const;
 
   /// Normals for visualizations
@@ -700,10 +701,19 @@ public:
 
   /// Functions to improve memory management. Often one knows how many
   /// nodes/elements one needs, prereserving memory is often possible.
-  void node_reserve(size_type s) { points_.reserve(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); }
-  void elem_reserve(size_type s) { cells_.reserve(static_cast<std::vector<index_type>::size_type>(s*4)); }
-  void resize_nodes(size_type s) { points_.resize(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); }
-  void resize_elems(size_type s) { cells_.resize(static_cast<std::vector<index_type>::size_type>(s*4)); }
+  void node_reserve(size_type s) { points_.reserve(static_cast<CompactPointArray::size_type>(s)); }
+  void elem_reserve(size_type s) { cells_.reserve(static_cast<CompactIndexArray::size_type>(s*4)); }
+  void resize_nodes(size_type s) { points_.resize(static_cast<CompactPointArray::size_type>(s)); }
+  void resize_elems(size_type s) { cells_.resize(static_cast<CompactIndexArray::size_type>(s*4)); }
+
+  /// Switch between double precision coordinates with 64 bit connectivity
+  /// (default) and float coordinates with 32 bit connectivity. The compact
+  /// form halves the memory used by the mesh; accessors still return double
+  /// precision points and code asking for raw pointers promotes the storage.
+  /// Returns false if the connectivity does not fit in 32 bits.
+  bool set_compact_storage(bool compact);
+  bool has_compact_storage() const
+    { return (points_.compact() && cells_.compact()); }
 
   /// Get the local coordinates for a certain point within an element
   /// This function uses a couple of newton iterations to find the local
@@ -1494,7 +1504,9 @@ public:
 			   const Core::Geometry::Point &p);
 
   /// must detach, if altering points!
-  std::vector<Core::Geometry::Point>& get_points() { return points_; }
+  /// Note: this promotes compact storage to double precision.
+  std::vector<Core::Geometry::Point>& get_points()
+    { set_compact_storage(false); return points_.wide(); }
 
   int compute_checksum();
 
@@ -1861,7 +1873,7 @@ protected:
   inline void set_nodes_by_elem(ARRAY &array, INDEX idx)
   {
     for (index_type n = 0; n < 4; ++n)
-      cells_[idx * 4 + n] = static_cast<index_type>(array[n]);
+      set_cell_node(idx * 4 + n, static_cast<index_type>(array[n]));
   }
 
   template <class INDEX1, class INDEX2>
@@ -2270,7 +2282,7 @@ protected:
   void insert_node_into_grid(typename Node::index_type ci);
   void remove_node_from_grid(typename Node::index_type ci);
 
-  const Core::Geometry::Point &point(typename Node::index_type i) { return points_[i]; }
+  const Core::Geometry::Point point(typename Node::index_type i) { return points_[i]; }
 
   template<class INDEX>
   bool inside(INDEX idx, const Core::Geometry::Point &p) const
@@ -2327,10 +2339,10 @@ protected:
   }
 
   /// all the nodes.
-  std::vector<Core::Geometry::Point>         points_;
+  CompactPointArray          points_;
 
   /// each 4 indicies make up a tet
-  std::vector<under_type>    cells_;
+  CompactIndexArray          cells_;
 
   /// Face information.
   class PFaceCell {
@@ -2558,8 +2570,29 @@ protected:
   typedef std::vector<PFaceCell> face_ct;
   typedef std::vector<PEdgeCell> edge_ct;
 
+  /// Connectivity writes, an index that does not fit in 32 bits promotes
+  /// the points and the cells to full precision together.
+  void set_cell_node(index_type i, index_type idx)
+  {
+    if (!cells_.can_store(idx)) set_compact_storage(false);
+    cells_.set(i, idx);
+  }
+  void push_cell_node(index_type idx)
+  {
+    if (!cells_.can_store(idx)) set_compact_storage(false);
+    cells_.push_back(idx);
+  }
+
   // These should not be called outside of the synchronize_lock_.
 
+  /// Convert both arrays, the points only follow if the cells fit.
+  bool set_compact_storage_unlocked(bool compact)
+  {
+    const bool ok = cells_.set_compact(compact);
+    if (ok) points_.set_compact(compact);
+    return (ok);
+  }
+
   /// container for face storage. Must be computed each time
   ///  nodes or cells change.
   face_ct faces_;
@@ -2651,11 +2684,21 @@ int
 TetVolMesh<Basis>::compute_checksum()
 {
   int sum = 0;
-  sum += SCIRun::compute_checksum(&points_[0],points_.size());
-  sum += SCIRun::compute_checksum(&cells_[0],cells_.size());
+  sum += points_.checksum();
+  sum += cells_.checksum();
   return (sum);
 }
 
+template <class Basis>
+bool
+TetVolMesh<Basis>::set_compact_storage(bool compact)
+{
+  synchronize_lock_.lock();
+  const bool ok = set_compact_storage_unlocked(compact);
+  synchronize_lock_.unlock();
+  return (ok);
+}
+
 template <class Basis>
 TetVolMesh<Basis>::TetVolMesh() :
   points_(0),
@@ -2733,11 +2776,11 @@ TetVolMesh<Basis>::fill_points(Iter begin, Iter end, Functor fill_ftor)
   synchronize_lock_.lock();
   Iter iter = begin;
   points_.resize(end - begin); // resize to the new size
-  std::vector<Core::Geometry::Point>::iterator piter = points_.begin();
+  CompactPointArray::size_type pidx = 0;
   while (iter != end)
   {
-    *piter = fill_ftor(*iter);
-    ++piter; ++iter;
+    points_.set(pidx, fill_ftor(*iter));
+    ++pidx; ++iter;
   }
   synchronize_lock_.unlock();
 }
@@ -2750,18 +2793,17 @@ TetVolMesh<Basis>::fill_cells(Iter begin, Iter end, Functor fill_ftor)
   synchronize_lock_.lock();
   Iter iter = begin;
   cells_.resize((end - begin) * 4); // resize to the new size
-  std::vector<under_type>::iterator citer = cells_.begin();
+  CompactIndexArray::size_type cidx = 0;
   while (iter != end)
   {
     index_type *nodes = fill_ftor(*iter); // returns an array of length 4
-    *citer = nodes[0];
-    ++citer;
-    *citer = nodes[1];
-    ++citer;
-    *citer = nodes[2];
-    ++citer;
-    *citer = nodes[3];
-    ++citer; ++iter;
+    for (int k = 0; k < 4; ++k)
+      if (!cells_.can_store(nodes[k])) set_compact_storage_unlocked(false);
+    cells_.set(cidx++, nodes[0]);
+    cells_.set(cidx++, nodes[1]);
+    cells_.set(cidx++, nodes[2]);
+    cells_.set(cidx++, nodes[3]);
+    ++iter;
   }
   synchronize_lock_.unlock();
 }
@@ -2869,12 +2911,9 @@ TetVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 {
   synchronize_lock_.lock();
 
-  std::vector<Core::Geometry::Point>::iterator itr = points_.begin();
-  std::vector<Core::Geometry::Point>::iterator eitr = points_.end();
-  while (itr != eitr)
+  for (CompactPointArray::size_type i = 0; i < points_.size(); ++i)
   {
-    *itr = t.project(*itr);
-    ++itr;
+    points_.set(i, t.project(points_[i]));
   }
 
   if (bbox_.valid())
@@ -3658,7 +3697,7 @@ TetVolMesh<Basis>::set_nodes(typename Node::array_type &array,
   delete_cell_syncinfo(idx);
 
   for (index_type n = 0; n < 4; ++n)
-    cells_[idx * 4 + n] = array[n];
+    set_cell_node(idx * 4 + n, array[n]);
 
   create_cell_syncinfo(idx);
 }
@@ -3900,10 +3939,10 @@ TetVolMesh<Basis>::add_tet(typename Node::index_type a,
 			   typename Node::index_type d)
 {
   const index_type tet = static_cast<index_type>(cells_.size()) / 4;
-  cells_.push_back(a);
-  cells_.push_back(b);
-  cells_.push_back(c);
-  cells_.push_back(d);
+  push_cell_node(a);
+  push_cell_node(b);
+  push_cell_node(c);
+  push_cell_node(d);
   return tet;
 }
 
@@ -3940,16 +3979,16 @@ TetVolMesh<Basis>::add_tet_pos(typename Node::index_type a,
 
   if (Dot(Cross(p1-p0,p2-p0),p3-p0) >= 0.0)
   {
-    cells_.push_back(a);
-    cells_.push_back(b);
+    push_cell_node(a);
+    push_cell_node(b);
   }
   else
   {
-    cells_.push_back(b);
-    cells_.push_back(a);
+    push_cell_node(b);
+    push_cell_node(a);
   }
-  cells_.push_back(c);
-  cells_.push_back(d);
+  push_cell_node(c);
+  push_cell_node(d);
   return tet;
 }
 
@@ -3968,16 +4007,16 @@ TetVolMesh<Basis>::mod_tet_pos(typename TetVolMesh<Basis>::Elem::index_type ci,
 
   if (Dot(Cross(p1-p0,p2-p0),p3-p0) >= 0.0)
   {
-    cells_[ci*4+0] = a;
-    cells_[ci*4+1] = b;
+    set_cell_node(ci*4+0, a);
+    set_cell_node(ci*4+1, b);
   }
   else
   {
-    cells_[ci*4+0] = b;
-    cells_[ci*4+1] = a;
+    set_cell_node(ci*4+0, b);
+    set_cell_node(ci*4+1, a);
   }
-  cells_[ci*4+2] = c;
-  cells_[ci*4+3] = d;
+  set_cell_node(ci*4+2, c);
+  set_cell_node(ci*4+3, d);
 }
 
 template <class Basis>
@@ -3991,10 +4030,7 @@ TetVolMesh<Basis>::delete_cells(std::set<index_type> &to_delete)
     // erase the correct cell
     typename TetVolMesh<Basis>::Cell::index_type ci = *iter++;
     index_type ind = ci * 4;
-    std::vector<index_type>::iterator cb = cells_.begin() + ind;
-    std::vector<index_type>::iterator ce = cb;
-    ce+=4;
-    cells_.erase(cb, ce);
+    cells_.erase(ind, ind + 4);
   }
 
   synchronized_ &= ~Mesh::LOCATE_E;
@@ -4021,8 +4057,7 @@ TetVolMesh<Basis>::delete_nodes(std::set<index_type> &to_delete)
   while (iter != to_delete.rend())
   {
     typename TetVolMesh::Node::index_type n = *iter++;
-    std::vector<Core::Geometry::Point>::iterator pit = points_.begin() + n;
-    points_.erase(pit);
+    points_.erase(n);
   }
   synchronized_ &= ~Mesh::LOCATE_E;
   synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
@@ -4364,12 +4399,12 @@ TetVolMesh<Basis>::orient(typename Cell::index_type ci)
   if (sgn < 0.0)
   {
     typename Node::index_type tmp = cells_[ci*4+0];
-    cells_[ci*4+0] = cells_[ci*4+1];
-    cells_[ci*4+1] = tmp;
+    set_cell_node(ci*4+0, cells_[ci*4+1]);
+    set_cell_node(ci*4+1, tmp);
   }
 }
 
-#define TETVOLMESH_VERSION 4
+#define TETVOLMESH_VERSION 5
 
 template <class Basis>
 void
@@ -4379,8 +4414,16 @@ TetVolMesh<Basis>::io(Piostream &stream)
 					 TETVOLMESH_VERSION);
   Mesh::io(stream);
 
-  SCIRun::Pio(stream, points_);
-  SCIRun::Pio_index(stream, cells_);
+  if (version >= 5)
+  {
+    SCIRun::Pio(stream, points_);
+    SCIRun::Pio_index(stream, cells_);
+  }
+  else
+  {
+    SCIRun::Pio(stream, points_.wide());
+    SCIRun::Pio_index(stream, cells_.wide());
+  }
   if (version == 1)
   {
     std::vector<unsigned int> neighbors;
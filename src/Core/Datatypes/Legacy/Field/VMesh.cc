@@ -823,6 +823,12 @@ VMesh::unsynchronize(unsigned int)
   ASSERTFAIL("VMesh interface: synchronize has not yet been implemented");  
 }
 
+MeshBoundaryFacesHandle
+VMesh::get_boundary_faces()
+{
+  return (ComputeMeshBoundaryFaces(this));
+}
+
 bool
 VMesh::clear_synchronization()
 {
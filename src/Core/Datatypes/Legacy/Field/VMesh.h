@@ -36,6 +36,7 @@
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
 #include <Core/Datatypes/Legacy/Field/FieldVIndex.h>
 #include <Core/Datatypes/Legacy/Field/FieldVIterator.h>
+#include <Core/Datatypes/Legacy/Field/MeshBoundaryFaces.h>
 
 #include <Core/GeometryPrimitives/SearchGridT.h>
 
@@ -774,6 +775,13 @@ public:
   // Only for unstructured data
   virtual VMesh::index_type* get_elems_pointer() const;
 
+  /// Compact storage keeps node locations as floats and connectivity as
+  /// 32 bit indices. Only meshes that support it return true, accessors
+  /// keep returning double precision and the raw pointer accessors above
+  /// promote the storage back to full precision.
+  virtual bool set_compact_storage(bool compact) { return (!compact); }
+  virtual bool has_compact_storage() const { return (false); }
+
   /// Copy nodes from one mesh to another mesh
   /// Note: currently only for irregular meshes
   /// @todo: Add regular meshes to the mix
@@ -973,6 +981,12 @@ public:
   virtual bool synchronize(unsigned int sync);
   virtual bool unsynchronize(unsigned int sync);
 
+  /// Faces of a volume mesh that belong to a single element. These are
+  /// extracted without synchronizing the faces of the mesh. The result is
+  /// not cached, callers keep it as long as they know the mesh is unchanged.
+  /// Returns an empty handle for meshes that are not linear volume meshes.
+  MeshBoundaryFacesHandle get_boundary_faces();
+
   // Only use this function when this is the only code that uses this mesh
   virtual bool clear_synchronization();
 
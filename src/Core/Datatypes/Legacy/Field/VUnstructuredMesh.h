@@ -31,6 +31,7 @@
 #define CORE_DATATYPES_VUNSTRUCTUREDMESH_H
 
 #include <Core/Datatypes/Legacy/Field/VMeshShared.h>
+#include <Core/Datatypes/Legacy/Field/CompactMeshStorage.h>
 
 /// Include needed for Windows: declares SCISHARE
 #include <Core/Datatypes/Legacy/Field/share.h>
@@ -701,7 +702,7 @@ void
 VUnstructuredMesh<MESH>::
 set_point(const Core::Geometry::Point &point, VMesh::Node::index_type i)
 {
-  this->mesh_->points_[i] = point;
+  set_points_value(this->mesh_->points_, i, point);
 }
 
 template <class MESH>
@@ -728,8 +729,7 @@ Core::Geometry::Point*
 VUnstructuredMesh<MESH>::
 get_points_pointer() const
 {
-  if (this->mesh_->points_.size() == 0) return (0);
-   return (&(this->mesh_->points_[0]));
+  return (points_pointer(this->mesh_->points_));
 }
 
 template <class MESH>
@@ -0,0 +1,79 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/IEPlugin/TextMeshRows.h>
+#include <Core/Logging/LoggerInterface.h>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Logging;
+
+bool SCIRun::readTextMeshRows(LoggerHandle pr, const std::string& filename,
+  const std::string& entries, TextMeshRows& rows)
+{
+  if (!rows.table.read(filename))
+  {
+    if (pr) pr->error("Could not open and read file: " + filename);
+    return (false);
+  }
+
+  const TextTable& table = rows.table;
+  rows.first = 0;
+  size_t header = 0;
+  bool has_header = false;
+  if (table.num_rows() > 0 && table.row_size(0) == 1)
+  {
+    has_header = true;
+    header = static_cast<size_t>(table.row(0)[0]);
+    rows.first = 1;
+  }
+
+  const long long columns = table.columns(rows.first);
+  if (columns < 0)
+  {
+    if (pr) pr->error("Improper format of text file, not every line contains the same amount of " + entries);
+    return (false);
+  }
+  rows.columns = static_cast<size_t>(columns);
+  rows.count = table.num_rows() - rows.first;
+
+  if (has_header && header != rows.count)
+  {
+    if (pr) pr->warning("Number of rows listed in header (" + boost::lexical_cast<std::string>(header) +
+                        ") does not match number of non-header rows in file (" +
+                        boost::lexical_cast<std::string>(rows.count) + ")");
+    rows.count = std::min(rows.count, header);
+  }
+
+  const std::vector<double>& values = table.values();
+  const size_t begin = (rows.first < table.num_rows()) ? table.row(rows.first) - &values[0] : values.size();
+  rows.zero_based = std::find(values.begin() + begin, values.end(), 0.0) != values.end();
+  return (true);
+}
@@ -0,0 +1,63 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_IEPLUGIN_TEXTMESHROWS_H__
+#define CORE_IEPLUGIN_TEXTMESHROWS_H__
+
+#include <Core/Logging/LoggerFwd.h>
+#include <Core/Utils/Legacy/TextTable.h>
+#include <Core/IEPlugin/share.h>
+
+namespace SCIRun
+{
+  /// Node or element file of the text mesh formats (.pts, .fac, .tet, ...):
+  /// an optional first row with a single value that holds the number of
+  /// rows, followed by rows that all have the same number of values.
+  struct SCISHARE TextMeshRows
+  {
+    TextMeshRows() : first(0), count(0), columns(0), zero_based(false) {}
+
+    TextTable table;
+    /// First row after the header and the number of rows used
+    size_t first;
+    size_t count;
+    size_t columns;
+    /// Whether any value is 0, for element files with node indices
+    bool zero_based;
+
+    const double* row(size_t i) const { return (table.row(first + i)); }
+  };
+
+  /// Reads and checks the file, errors and warnings go to pr. entries names
+  /// what the rows hold in the error messages.
+  SCISHARE bool readTextMeshRows(Core::Logging::LoggerHandle pr, const std::string& filename,
+    const std::string& entries, TextMeshRows& rows);
+}
+
+#endif
@@ -31,6 +31,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Logging/LoggerInterface.h>
 #include <Core/IEPlugin/TriSurfField_Plugin.h>
+#include <Core/IEPlugin/TextMeshRows.h>
 #include <Core/Utils/Legacy/StringUtil.h>
 #include <Core/Algorithms/Legacy/DataIO/VTKToTriSurfReader.h>
 #include <Core/Algorithms/Legacy/DataIO/TriSurfSTLASCIIConverter.h>
@@ -197,182 +198,20 @@ FieldHandle SCIRun::TextToTriSurfField_reader(LoggerHandle pr, const char *filen
   }
 
 
-  int ncols = 0;
-  int nrows = 0;
-  int line_ncols = 0;
-  int num_elems = 0, num_nodes = 0;
-
-  std::string line;
-
-  // STAGE 1 - SCAN THE FILE TO DETERMINE THE NUMBER OF NODES
-  // AND CHECK THE FILE'S INTEGRITY.
-
-  bool first_line_pts = true;
-  bool first_line = true;
-
-  std::vector<double> values;
-
+  // Both files are mapped and parsed on all cores in one pass
+  TextMeshRows pts, fac;
+  if (!readTextMeshRows(pr, pts_fn, "coordinates", pts)) return (result);
+  if (pts.count > 0 && pts.columns != 2 && pts.columns != 3)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-    try
-    {
-      inputfile.open(pts_fn.c_str());
-
-      while ( getline(inputfile,line,'\n') )
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-        line_ncols = values.size();
-
-        if (first_line_pts)
-        {
-          if (line_ncols > 0)
-          {
-            if (line_ncols == 1)
-            {
-              num_nodes =  static_cast<int>(values[0]) + 1;
-            }
-            else if ((line_ncols == 3)||(line_ncols == 2))
-            {
-              first_line_pts = false;
-              nrows++;
-              ncols = line_ncols;
-            }
-            else
-            {
-              if (pr)  pr->error("Improper format of text file, some lines contain more than 3 entries");
-              return (result);
-            }
-          }
-        }
-        else
-        {
-          if (line_ncols > 0)
-          {
-            nrows++;
-            if (ncols > 0)
-            {
-              if (ncols != line_ncols)
-              {
-                if (pr)  pr->error("Improper format of text file, not every line contains the same amount of coordinates");
-                return (result);
-              }
-            }
-            else
-            {
-              ncols = line_ncols;
-            }
-          }
-        }
-      }
-    }
-    catch (...) {
-      if (pr) pr->error("Could not open file: " + pts_fn);
-      return (result);
-    }
-    inputfile.close();
-  }
-
-  if (0 == num_nodes) {
-    num_nodes = nrows;
-  }
-
-  nrows = 0;
-  ncols = 0;
-  line_ncols = 0;
-
-  bool zero_based = false;
-
-  {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-    try
-    {
-      inputfile.open(fac_fn.c_str());
-
-      while( getline(inputfile,line,'\n'))
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-        line_ncols = values.size();
-
-        for (size_t j=0; j<values.size(); j++) if (values[j] == 0.0) zero_based = true;
-
-        if (first_line)
-        {
-          if (line_ncols > 0)
-          {
-            if (line_ncols == 1)
-            {
-              num_elems =  static_cast<int>(values[0]) + 1;
-            }
-            else if (line_ncols == 3)
-            {
-              first_line = false;
-              nrows++;
-              ncols = line_ncols;
-            }
-            else
-            {
-              if (pr)  pr->error("Improper format of text file, some lines do not contain 3 entries");
-              return (result);
-            }
-          }
-        }
-        else
-        {
-          if (line_ncols > 0)
-          {
-            nrows++;
-            if (ncols > 0)
-            {
-              if (ncols != line_ncols)
-              {
-                if (pr)  pr->error("Improper format of text file, not every line contains the same amount of coordinates");
-                return (result);
-              }
-            }
-            else
-            {
-              ncols = line_ncols;
-            }
-          }
-        }
-      }
-    }
-    catch (...) {
-      if (pr) pr->error("Could not open file: " + fac_fn);
-      return (result);
-    }
-    inputfile.close();
+    if (pr)  pr->error("Improper format of text file, some lines contain more than 3 entries");
+    return (result);
   }
 
-  if (0 == num_elems)
+  if (!readTextMeshRows(pr, fac_fn, "coordinates", fac)) return (result);
+  if (fac.count > 0 && fac.columns != 3)
   {
-    num_elems = nrows;
+    if (pr)  pr->error("Improper format of text file, some lines do not contain 3 entries");
+    return (result);
   }
 
   FieldInformation fi("TriSurfMesh", 1,"double");
@@ -380,90 +219,26 @@ FieldHandle SCIRun::TextToTriSurfField_reader(LoggerHandle pr, const char *filen
 
   VMesh *mesh = result->vmesh();
 
-  mesh->node_reserve(num_nodes);
-  mesh->elem_reserve(num_elems);
+  mesh->node_reserve(pts.count);
+  mesh->elem_reserve(fac.count);
 
+  for (size_t i = 0; i < pts.count; ++i)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-
-    try
-    {
-      inputfile.open(pts_fn.c_str());
-
-      std::vector<double> vdata(3);
-
-      for(int i = 0; i < num_nodes && getline(inputfile,line,'\n'); ++i)
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0;p<line.size();p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,values);
-
-        if (values.size() == 3) mesh->add_point(Point(values[0],values[1],values[2]));
-        if (values.size() == 2) mesh->add_point(Point(values[0],values[1],0.0));
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open file: "+std::string(pts_fn));
-      return (result);
-    }
-    inputfile.close();
+    const double* values = pts.row(i);
+    if (pts.columns == 3) mesh->add_point(Point(values[0],values[1],values[2]));
+    else mesh->add_point(Point(values[0],values[1],0.0));
   }
 
+  VMesh::Node::array_type vdata(3);
+  for (size_t i = 0; i < fac.count; ++i)
   {
-    std::ifstream inputfile;
-    inputfile.exceptions( std::ifstream::badbit );
-
-    try
+    const double* values = fac.row(i);
+    for (size_t j = 0; j < 3; j++)
     {
-      inputfile.open(fac_fn.c_str());
-
-      VMesh::Node::array_type vdata;
-      vdata.resize(3);
-
-      std::vector<VMesh::index_type> ivalues;
-
-      for (int i = 0; i < num_elems && getline(inputfile,line,'\n'); ++i)
-      {
-        if (line.size() > 0)
-        {
-          // block out comments
-          if ((line[0] == '#')||(line[0] == '%')) continue;
-        }
-
-        // replace comma's and tabs with white spaces
-        for (size_t p = 0; p < line.size(); p++)
-        {
-          if ((line[p] == '\t')||(line[p] == ',')||(line[p]=='"')) line[p] = ' ';
-        }
-
-        multiple_from_string(line,ivalues);
-        for (size_t j = 0; j < ivalues.size() && j < 3; j++)
-        {
-          if (zero_based) vdata[j] = ivalues[j];
-          else vdata[j] = ivalues[j]-1;
-        }
-
-        if (ivalues.size() > 2) mesh->add_elem(vdata);
-      }
-    }
-    catch (...)
-    {
-      if (pr) pr->error("Could not open file: "+std::string(fac_fn));
-      return (result);
+      const VMesh::index_type idx = static_cast<VMesh::index_type>(values[j]);
+      vdata[j] = fac.zero_based ? idx : idx-1;
     }
-    inputfile.close();
+    mesh->add_elem(vdata);
   }
 
   return (result);
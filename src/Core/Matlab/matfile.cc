@@ -55,6 +55,8 @@
 
 #include <Core/Matlab/matfile.h>
 #include <cstring>
+#include <algorithm>
+#include <vector>
 #include <zlib.h>
 
 using namespace SCIRun::MatlabIO;
@@ -227,6 +229,8 @@ matfile::matfile(const std::string& filename,const std::string& mode)
 {
 	m_ = new mxfile;
 	m_->fptr_ = 0;
+	m_->fcmpbuffer_ = 0;
+	m_->fcmpsize_ = 0;
 	m_->byteswap_ = 0;
 	m_->ref_ = 1;
 	m_->compressmode_ = false;
@@ -421,6 +425,7 @@ void matfile::rewind()
     }
 
   m_->compressmode_ = false;
+	m_->fcmpmbuffer_ = matfiledata();
 	m_->fcmpbuffer_ = 0;
 	m_->fcmpsize_ = 0;
 }
@@ -488,13 +493,82 @@ bool matfile::openchild()
     return(true);
 }
 
+// Size of the decompressed start of a block that is read for indexing, the
+// tags with the class, dimensions and name of a matrix fit easily
+static const int COMPRESSEDHEADERSIZE = 4096;
+
+// Size of the pieces in which compressed data is read from file
+static const int COMPRESSEDCHUNKSIZE = 262144;
+
+namespace {
+
+  // Streams a compressed block from the file through inflate, so that the
+  // compressed data never needs to be in memory as a whole and the output
+  // can be produced in pieces
+  class blockinflater {
+    public:
+      blockinflater(FILE *fptr,int offset,int size) :
+        fptr_(fptr), offset_(offset), remaining_(size), done_(false)
+      {
+        std::memset(&strm_,0,sizeof(strm_));
+        if (inflateInit(&strm_) != Z_OK) throw matfilebase::compression_error();
+        chunk_.resize(std::min(size,COMPRESSEDCHUNKSIZE));
+      }
+
+      ~blockinflater() { inflateEnd(&strm_); }
+
+      // Decompress up to len bytes into dest, returns the number of bytes
+      int read(char *dest,int len)
+      {
+        strm_.next_out = reinterpret_cast<Bytef *>(dest);
+        strm_.avail_out = static_cast<uInt>(len);
+        while ((strm_.avail_out > 0)&&(!done_))
+        {
+          if (strm_.avail_in == 0)
+          {
+            if (remaining_ == 0) break;
+            int n = std::min(remaining_,static_cast<int>(chunk_.size()));
+            if (fseek(fptr_,offset_,SEEK_SET) != 0) throw matfilebase::io_error();
+            if (static_cast<int>(fread(&chunk_[0],1,n,fptr_)) != n) throw matfilebase::io_error();
+            offset_ += n; remaining_ -= n;
+            strm_.next_in = reinterpret_cast<Bytef *>(&chunk_[0]);
+            strm_.avail_in = static_cast<uInt>(n);
+          }
+          int ret = inflate(&strm_,Z_NO_FLUSH);
+          if (ret == Z_STREAM_END) done_ = true;
+          else if ((ret != Z_OK)&&(ret != Z_BUF_ERROR)) throw matfilebase::compression_error();
+        }
+        return(len - static_cast<int>(strm_.avail_out));
+      }
+
+    private:
+      z_stream strm_;
+      FILE *fptr_;
+      int offset_;
+      int remaining_;
+      bool done_;
+      std::vector<char> chunk_;
+  };
+
+}
+
 // When encountering a miCOMPRESSION tag use this function
 // to enter the compressed data.
-// This function uncompresses the data, adds the buffer to the list of
-// uncompressed memory blocks and recomputes the block pointers to read
-// in the domain of the uncompressed memory block
+// This function uncompresses the data, keeps the buffer of the last block
+// and recomputes the block pointers to read in the domain of the
+// uncompressed memory block
 
 bool matfile::opencompression()
+{
+  return(mfopencompression(false));
+}
+
+bool matfile::opencompressionheader()
+{
+  return(mfopencompression(true));
+}
+
+bool matfile::mfopencompression(bool headeronly)
 {
 	// If the datablock cannot be found, there is nothing to do
 	// except to report an error
@@ -533,6 +607,7 @@ bool matfile::opencompression()
 			// Yeah the job has already been done
 			// Enter the data of the block in the
 			// main file descriptor
+			m_->fcmpmbuffer_ = cmpbuffer.mbuffer;
 			m_->fcmpbuffer_ = static_cast<char *>(cmpbuffer.mbuffer.databuffer());
 			m_->fcmpsize_ = cmpbuffer.buffersize;
 			m_->fcmpoffset_ = cmpbuffer.bufferoffset;
@@ -544,87 +619,51 @@ bool matfile::opencompression()
 	// We still need to uncompress the block
 	if (m_->fcmpbuffer_ == 0)
 	{
-		// We need to decompress the buffer
-		char *sourcebuffer = 0;
+		if (m_->fptr_ == 0) throw io_error();
+		blockinflater inflater(m_->fptr_,compressblockoffset,compressblocksize);
+
+		// First only decompress the header to find out how big the data segment
+		// should be. We need to know whether inside is a matrix and of what
+		// size this one is.
+		int32_t header[2];
+		if (inflater.read(reinterpret_cast<char *>(&header[0]),8) != 8) throw compression_error();
+
+		int32_t swappedheader[2] = { header[0], header[1] };
+		if (m_->byteswap_) mfswapbytes(swappedheader,sizeof(int32_t),2);
+
+		// The first int should be indicating it is a matrix
+		if (swappedheader[0] != static_cast<int>(miMATRIX)) throw invalid_file_format();
+		// The second int descibes the size of the contents of the matrix minus its header
+		// Hence the plus 8
+		int destlen = swappedheader[1]+8;
+		if (destlen < 8) throw compression_error();
+		if ((headeronly)&&(destlen > COMPRESSEDHEADERSIZE)) destlen = COMPRESSEDHEADERSIZE;
+
+		// Continue decompressing the same stream behind the header
 		matfiledata destbuffer;
-		int32_t *destbufferheader = 0;
-		int destlen = 0;
-
-		// We do some dynamic allocation here, if this fails the function
-		// should clear up its memory
-		try
+		destbuffer.newdatabuffer(destlen,miUINT8);
+		char *dest = static_cast<char *>(destbuffer.databuffer());
+		std::memcpy(dest,&header[0],8);
+		if (inflater.read(dest+8,destlen-8) != destlen-8) throw compression_error();
+
+		// A partial block is only used for reading the matrix header and is
+		// not entered in the list
+		if (!headeronly)
 		{
-			// Read the block of compressed data
-			sourcebuffer = new char[compressblocksize];
-			mfread(static_cast<void *>(sourcebuffer),sizeof(char),compressblocksize,compressblockoffset);
-
-			// first only read the header to find out how big the data segment should be
-			// Only decompress the first 8 bytes. We need to know whether inside is a matrix
-			// and of what size this one is.
-
-			destlen = 8;
-			destbufferheader = new int32_t[2];
-			// uncompress the first few bytes
-			// we need to do a few ugly casts as somehow the compiler does not recognize
-			// they are all pointers.
-
-			uLongf clen = static_cast<uLongf>(destlen);
-      uncompress(reinterpret_cast<Bytef *>(destbufferheader),&clen,reinterpret_cast<const Bytef *>(sourcebuffer),(uLong)compressblocksize);
-			destlen = static_cast<int>(clen);
-
-			// In case something weird happened
-			if (destlen != 8) throw compression_error();
-
-			// If byteswapping needs to be done, it needs to be done
-			if (m_->byteswap_) mfswapbytes(destbufferheader,sizeof(int32_t),2);
-
-			// The first int should be indicating it is a matrix
-			if (destbufferheader[0] != static_cast<int>(miMATRIX)) throw invalid_file_format();
-			// The secong int descibes the size of the contents of the matrix minus its header
-			// Hence the plus 8
-			destlen = destbufferheader[1]+8;
-
-			// Uncompress the full thing including the previously read header
-			destbuffer.newdatabuffer(destlen,miUINT8);
-			//			destbuffer = new char[destlen];
-
-      clen = static_cast<uLongf>(destlen);
-			uncompress(reinterpret_cast<Bytef *>(destbuffer.databuffer()),&clen,reinterpret_cast<const Bytef *>(sourcebuffer),(uLong)compressblocksize);
-      destlen = static_cast<int>(clen);
-			if (destlen != destbufferheader[1]+8) throw compression_error();
-
-			// enter the information in the cmpbuffer structure
 			cmpbuffer.mbuffer = destbuffer;
-			// destbuffer = 0;
 			cmpbuffer.buffersize = destlen;
 			cmpbuffer.bufferoffset = compressblockoffset;
-
-			// add this one to the list
+			m_->cmplist_.clear();
 			m_->cmplist_.push_back(cmpbuffer);
-
-			// Now fill out the fcmpbuffer stuff to
-			// force reading in the buffer
-			m_->fcmpbuffer_ = static_cast<char *>(cmpbuffer.mbuffer.databuffer());
-			m_->fcmpsize_ = cmpbuffer.buffersize;
-			m_->fcmpoffset_ = cmpbuffer.bufferoffset;
-			m_->fcmpcount_ = 0;
-
-			// free the remaining buffers
-			if (sourcebuffer != 0) delete[] sourcebuffer;
-			sourcebuffer = 0;
-			if (destbufferheader != 0) delete[] destbufferheader;
-			destbufferheader = 0;
-
-		}
-		catch(...)
-		{   // clean up
-			// if (destbuffer != 0) delete[] destbuffer;
-			if (sourcebuffer != 0) delete[] sourcebuffer;
-			sourcebuffer = 0;
-			if (destbufferheader != 0) delete[] destbufferheader;
-			destbufferheader = 0;
-			throw;
 		}
+
+		// Now fill out the fcmpbuffer stuff to
+		// force reading in the buffer
+		m_->fcmpmbuffer_ = destbuffer;
+		m_->fcmpbuffer_ = dest;
+		m_->fcmpsize_ = destlen;
+		m_->fcmpoffset_ = compressblockoffset;
+		m_->fcmpcount_ = 0;
 	}
 
     matfileptr childptr;
@@ -659,6 +698,7 @@ void matfile::closecompression()
 
     m_->ptrstack_.pop();
     m_->curptr_ = parptr;
+    m_->fcmpmbuffer_ = matfiledata();
     m_->fcmpbuffer_ = 0;
     m_->fcmpsize_ = 0;
     m_->fcmpoffset_ = 0;
@@ -798,6 +838,20 @@ void matfile::readdat(matfiledata& md)
         if (type >= miEND) throw unknown_type();
 
         m_->curptr_.type = static_cast<mitype>(type);
+
+        // Large arrays in a decompressed block are not copied, the data
+        // refers to the block instead. The block is removed from the list
+        // so that later reads do not see data that the caller may change.
+        int bufferoffset = m_->curptr_.datptr-m_->fcmpalignoffset_;
+        if ((m_->fcmpbuffer_ != 0)&&(!m_->byteswap_)&&(size >= COMPRESSEDHEADERSIZE)&&
+            (bufferoffset % md.elsize(static_cast<mitype>(type)) == 0))
+        {
+          if (bufferoffset+size > m_->fcmpsize_) throw io_error();
+          md.subdatabuffer(m_->fcmpmbuffer_,bufferoffset,size,static_cast<mitype>(type));
+          m_->cmplist_.clear();
+          return;
+        }
+
         md.newdatabuffer(size,static_cast<mitype>(type));
         if (md.size() > 0) mfread(md.databuffer(),md.elsize(),md.size(),m_->curptr_.datptr);
 
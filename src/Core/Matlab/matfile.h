@@ -166,9 +166,9 @@ class SCISHARE matfile : public matfilebase {
 												// A matfile is like a directory (tree structure)
 			matfileptr curptr_;					// current pointer
             
-			// The next list contains the compressed buffers that were allocated
-			// Hence compressed variables have to be decompressed only once, which
-			// should boost the performance, but will cost memory
+			// The next list contains the last compressed buffer that was allocated
+			// Reading the info of a variable and then the variable itself hence
+			// only decompresses it once, while memory stays limited to one variable
 			
 			std::deque<compressbuffer> cmplist_;	// maintain a list of segments that have already been decompressed
 			};
@@ -199,6 +199,10 @@ class SCISHARE matfile : public matfilebase {
 	// consistent interface.
 	// The offset version start reading at an certain location (includes a fseek at the start)
 	  
+	// Decompress a compressed block, either completely or only its start
+	// when only the tags of the matrix header are needed
+	bool mfopencompression(bool headeronly);
+
   	void mfread(void *buffer,int elsize,int size);	// read data and do byte swapping
 	void mfread(void *buffer,int elsize,int size,int offset);
    	
@@ -250,6 +254,12 @@ class SCISHARE matfile : public matfilebase {
 	
 	bool opencompression();
 	void closecompression();	
+
+	// Open only the first part of a compressed block, which contains the
+	// class, dimensions and name of the matrix. This is used for indexing
+	// files without decompressing all variables, the data itself cannot be
+	// read in this mode. The buffer is not kept after closecompression().
+	bool opencompressionheader();
 			    
 	// navigation through file:
 	// firsttag:
@@ -68,6 +68,7 @@ matfiledata::matfiledata()
   m_->bytesize_ = 0;
   m_->type_ = miUNKNOWN;
   m_->ref_ = 1; 
+  m_->parent_ = 0;
 }
 
 matfiledata::matfiledata(matfiledata::mitype type)
@@ -79,6 +80,7 @@ matfiledata::matfiledata(matfiledata::mitype type)
   m_->bytesize_ = 0;
   m_->type_ = type;
   m_->ref_ = 1; 
+  m_->parent_ = 0;
 }			 
 
 matfiledata::~matfiledata()
@@ -97,6 +99,8 @@ void matfiledata::clear()
     throw internal_error();
   }
   if ((m_->dataptr_ != 0)&&(m_->owndata_ == true)) delete[] static_cast<char *>(m_->dataptr_);
+  if (m_->parent_) release(m_->parent_);
+  m_->parent_ = 0;
   m_->owndata_ = false;
   m_->dataptr_ = 0;	
   m_->bytesize_ = 0;	
@@ -116,6 +120,17 @@ void matfiledata::clearptr()
   ptr_ = 0;
 }
 
+void matfiledata::release(mxdata *m)
+{
+  m->ref_--;
+  if (m->ref_ == 0)
+  {
+    if ((m->dataptr_ != 0)&&(m->owndata_ == true)) delete[] static_cast<char *>(m->dataptr_);
+    if (m->parent_) release(m->parent_);
+    delete m;
+  }
+}
+
 matfiledata::matfiledata(const matfiledata &mfd)
 {
   m_ = 0;
@@ -158,6 +173,27 @@ void matfiledata::newdatabuffer(int bytesize,mitype type)
 }
 
 
+void matfiledata::subdatabuffer(const matfiledata& parent,int offset,int bytesize,mitype type)
+{
+  if ((m_ == 0)||(parent.m_ == 0)||(parent.m_ == m_))
+  {
+    std::cerr << "internal error in subdatabuffer()\n";
+    throw internal_error();
+  }
+  if ((offset < 0)||(offset+bytesize > parent.m_->bytesize_)) throw out_of_range();
+
+  // Take the reference first, the parent may only be held through this object
+  mxdata *p = parent.m_;
+  p->ref_++;
+  clear();
+  m_->parent_ = p;
+  m_->dataptr_ = static_cast<void *>(static_cast<char *>(p->dataptr_) + offset);
+  m_->bytesize_ = bytesize;
+  m_->type_ = type;
+  m_->owndata_ = false;
+  ptr_ = 0;
+}
+
 matfiledata matfiledata::clone() const
 {
 	matfiledata mfd;
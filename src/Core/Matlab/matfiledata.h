@@ -116,12 +116,14 @@ namespace SCIRun
         int	bytesize_;	// Size of the data in bytes
         mitype	type_;		// The type of the data
         int	ref_;		// reference counter
+        mxdata	*parent_;	// Buffer that dataptr_ points into, if not owned
       };
 
       // data objects
       mxdata *m_;
       void *ptr_;
       void clearptr();
+      static void release(mxdata *m);
 
       // functions
     public:
@@ -142,6 +144,11 @@ namespace SCIRun
       void newdatabuffer(int bytesize,mitype type);
       // void extdatabuffer(void *databuffer, int bytesize, mitype type);
 
+      // subdatabuffer() will clear the object and point it at a range of
+      // the buffer of another object instead of copying the data. The other
+      // buffer is kept alive as long as this object refers to it.
+      void subdatabuffer(const matfiledata& parent,int offset,int bytesize,mitype type);
+
 
       // clone the current object
       // i.e create a new databuffer and copy the actual data
@@ -174,6 +181,9 @@ namespace SCIRun
       template<class T> void getandcast(T *dataptr,int size) const;
       template<class T> void getandcast(T **dataptr,int dim1, int dim2) const;
       template<class T> void getandcast(T ***dataptr,int dim1, int dim2, int dim3) const;
+      // copy and cast a FORTRAN-style array with dim1 rows and dim2 columns into
+      // a C-style array, transposing while casting so no intermediate copy is needed
+      template<class T> void getandcasttransposed(T *dataptr,int dim1, int dim2) const;
       template<class T> void putandcast(const T *dataptr,int size,mitype type);
       template<class T> void putandcast(const T **dataptr,int dim1, int dim2, mitype type);
       template<class T> void putandcast(const T ***dataptr,int dim1, int dim2, int dim3, mitype type);
@@ -223,8 +233,60 @@ namespace SCIRun
       void ptrset(void *ptr);
       void ptrclear();
 
+      template<class S, class T> static void transposecast(const S *src,T *dataptr,int dim1, int dim2);
     };
 
+    template<class S, class T> void matfiledata::transposecast(const S *src,T *dataptr,int dim1, int dim2)
+    {
+      // Work in tiles so both the source columns and the destination rows
+      // stay in the cache
+      const int tile = 32;
+      for (int r0=0;r0<dim1;r0+=tile)
+      {
+        int r1 = (r0+tile < dim1) ? r0+tile : dim1;
+        for (int c0=0;c0<dim2;c0+=tile)
+        {
+          int c1 = (c0+tile < dim2) ? c0+tile : dim2;
+          for (int r=r0;r<r1;r++)
+            for (int c=c0;c<c1;c++) dataptr[r*dim2+c] = static_cast<T>(src[r+c*dim1]);
+        }
+      }
+    }
+
+    template<class T> void matfiledata::getandcasttransposed(T *dataptr,int dim1, int dim2) const
+    {
+      if (databuffer() == 0) return;
+      if (dataptr  == 0) return;
+      if ((dim1 == 0)||(dim2 == 0)) return;
+      if (dim1*dim2 > size()) throw out_of_range();
+
+      switch (type())
+      {
+      case miINT8:
+        transposecast(static_cast<signed char *>(databuffer()),dataptr,dim1,dim2); break;
+      case miUINT8: case miUTF8:
+        transposecast(static_cast<unsigned char *>(databuffer()),dataptr,dim1,dim2); break;
+      case miINT16:
+        transposecast(static_cast<signed short *>(databuffer()),dataptr,dim1,dim2); break;
+      case miUINT16: case miUTF16:
+        transposecast(static_cast<unsigned short *>(databuffer()),dataptr,dim1,dim2); break;
+      case miINT32:
+        transposecast(static_cast<int32_t *>(databuffer()),dataptr,dim1,dim2); break;
+      case miUINT32: case miUTF32:
+        transposecast(static_cast<uint32_t *>(databuffer()),dataptr,dim1,dim2); break;
+      case miINT64:
+        transposecast(static_cast<int64_t *>(databuffer()),dataptr,dim1,dim2); break;
+      case miUINT64:
+        transposecast(static_cast<uint64_t *>(databuffer()),dataptr,dim1,dim2); break;
+      case miSINGLE:
+        transposecast(static_cast<float *>(databuffer()),dataptr,dim1,dim2); break;
+      case miDOUBLE:
+        transposecast(static_cast<double *>(databuffer()),dataptr,dim1,dim2); break;
+      default:
+        throw unknown_type();
+      }
+    }
+
     template<class T> void matfiledata::getandcast(T *dataptr,int dsize) const
     {
       // This function copies and casts the data in the matfilebuffer into
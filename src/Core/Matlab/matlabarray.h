@@ -389,6 +389,8 @@ public:
   template<class T> void getnumericarray(T **data,int dim1, int dim2) const;
   template<class T> void getimagnumericarray(T **data,int dim1, int dim2) const;
   template<class T> void getnumericarray(T ***data,int dim1, int dim2, int dim3) const;
+  // Copy a 2D array into a C-style (row major) buffer of dim1 rows and dim2 columns
+  template<class T> void getnumericarraytransposed(T *data,int dim1, int dim2) const;
   template<class T> void getimagnumericarray(T ***data,int dim1, int dim2, int dim3) const;
   
   
@@ -485,6 +487,12 @@ template<class T> inline void matlabarray::getnumericarray(T *data,int size) con
   m_->preal_.getandcast(data,size);
 }
 
+template<class T> inline void matlabarray::getnumericarraytransposed(T *data,int dim1,int dim2) const
+{
+  if(m_ == 0) throw empty_matlabarray();
+  m_->preal_.getandcasttransposed(data,dim1,dim2);
+}
+
 template<class T> inline void matlabarray::getimagnumericarray(T *data,int size) const
 {
   if(m_ == 0) throw empty_matlabarray();
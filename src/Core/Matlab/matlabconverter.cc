@@ -632,13 +632,11 @@ void matlabconverter::mlArrayTOsciMatrix(const matlabarray &ma,MatrixHandle &han
         }
         else
         {
-          DenseMatrix dm(n,m);  
-          ma.getnumericarray(dm.data(), dm.size());
-                      
-          // There is no transpose function to operate on the same memory block
-          // Hence, it is a little memory inefficient.
-                      
-          handle = boost::make_shared<DenseMatrix>(dm.transpose()); // SCIRun has a C++-style matrix and Matlab a FORTRAN-style matrix;
+          // SCIRun has a C++-style matrix and Matlab a FORTRAN-style matrix,
+          // the data is transposed while it is copied out of the file buffer
+          DenseMatrixHandle dmptr(new DenseMatrix(m,n));
+          ma.getnumericarraytransposed(dmptr->data(), m, n);
+          handle = dmptr;
         }
       }
       break;
@@ -61,8 +61,8 @@ void matlabfile::open(const std::string& filename,const std::string& accessmode)
   if (isreadaccess())
   {   // scan the file for the number of matrices
     // This function will index the file and get all the matrix names
-    // If it is a compressed file, it will automatically uncompress every
-    // block (this behavior may be changed to become more memory efficient)
+    // If it is a compressed file, only the start of every block is
+    // decompressed, the variables themselves are decompressed when read
 
     int tagptr;
     matfiledata mfd;
@@ -82,18 +82,24 @@ void matlabfile::open(const std::string& filename,const std::string& accessmode)
       if (mfd.type() == miCOMPRESSED)
       {
         compressedmatrix = true; // to mark that we have to close the compressed session
-        opencompression(); // uncompress the data
+        opencompressionheader(); // uncompress the start of the data
         readtag(mfd); // read the first tag, which should be miMATRIX
       }
       if (mfd.type() != miMATRIX) throw invalid_file_format();
 
-      openchild();
-      readtag(mfd);
-      nexttag();
-      readtag(mfd);
-      nexttag();
-      readdat(mfd);
-      closechild();
+      try
+      {
+        readmatrixname(mfd);
+      }
+      catch (io_error&)
+      {
+        // The header did not fit in the decompressed start of the block
+        if (!compressedmatrix) throw;
+        closecompression();
+        opencompression();
+        readtag(mfd);
+        readmatrixname(mfd);
+      }
       if (compressedmatrix) closecompression();
 
       strstack.push(mfd.getstring());
@@ -116,6 +122,25 @@ void matlabfile::open(const std::string& filename,const std::string& accessmode)
 }
 
 
+void matlabfile::readmatrixname(matfiledata& mfd)
+{
+  openchild();
+  try
+  {
+    readtag(mfd);
+    nexttag();
+    readtag(mfd);
+    nexttag();
+    readdat(mfd);
+  }
+  catch (...)
+  {
+    closechild();
+    throw;
+  }
+  closechild();
+}
+
 void matlabfile::close()
 {
   matfile::close();
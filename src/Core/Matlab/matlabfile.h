@@ -93,6 +93,8 @@ namespace MatlabIO
 
   private:
     void importmatlabarray(matlabarray& ma,int mode);
+    // read the name of the matrix at the current tag
+    void readmatrixname(matfiledata& mfd);
     void exportmatlabarray(matlabarray& ma); 
     mitype converttype(mxtype type);
     mxtype convertclass(mlclass mclass,mitype type);
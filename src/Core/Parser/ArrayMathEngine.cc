@@ -33,6 +33,9 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <sstream>
+
 #include <sci_debug.h>
 
 using namespace SCIRun;
@@ -1516,32 +1519,52 @@ NewArrayMathEngine::run()
 {
   std::string error_str;
   
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
   // Link everything together
   std::string full_expression = pre_expression_+";"+expression_+";"+post_expression_;
 
-  // Parse the full expression
-  if(!(parse(pprogram_,full_expression,error_str)))
-  {   
-    pr_->error(error_str);
-    return (false);
-  }
-  
-  // Get the catalog with all possible functions
-  ParserFunctionCatalogHandle catalog = ArrayMathFunctionCatalog::get_catalog();
+  // Programs only depend on the expressions and the declared variables, reuse
+  // the optimized program if these have been seen before
+  std::string key = ParserProgramCache::make_key("ArrayMath",pprogram_,full_expression);
+  ParserProgramHandle cached;
+  used_cached_program_ = ParserProgramCache::instance().find(key,cached);
 
-  // Validate the expressions
-  if (!(validate(pprogram_,catalog,error_str)))
-  {   
-    pr_->error(error_str);
-    return (false);
+  if (used_cached_program_)
+  {
+    pprogram_ = cached;
   }
-  
-  // Optimize the expressions
-  if (!(optimize(pprogram_,error_str)))
-  {   
-    pr_->error(error_str);
-    return (false);
+  else
+  {
+    // Parse the full expression
+    if(!(parse(pprogram_,full_expression,error_str)))
+    {   
+      pr_->error(error_str);
+      return (false);
+    }
+    
+    // Get the catalog with all possible functions
+    ParserFunctionCatalogHandle catalog = ArrayMathFunctionCatalog::get_catalog();
+
+    // Validate the expressions
+    if (!(validate(pprogram_,catalog,error_str)))
+    {   
+      pr_->error(error_str);
+      return (false);
+    }
+    
+    // Optimize the expressions
+    if (!(optimize(pprogram_,error_str)))
+    {   
+      pr_->error(error_str);
+      return (false);
+    }
+
+    ParserProgramCache::instance().insert(key,pprogram_);
   }
+
+  boost::posix_time::ptime parsed = boost::posix_time::microsec_clock::universal_time();
+  parse_time_ = (parsed-start).total_microseconds()*1e-6;
   
   // DEBUG CALL
 #ifdef DEBUG
@@ -1809,16 +1832,34 @@ NewArrayMathEngine::run()
     pr_->error("Could not set array size.");
     return (false);
   }
+
+  boost::posix_time::ptime translated = boost::posix_time::microsec_clock::universal_time();
+  setup_time_ = (translated-parsed).total_microseconds()*1e-6;
+
   // Run the program
   if (!(ArrayMathInterpreter::run(mprogram_,error_str)))
   {
     pr_->error(error_str);
     return (false);
   }
+
+  evaluation_time_ = (boost::posix_time::microsec_clock::universal_time()-translated).total_microseconds()*1e-6;
   return (true);
 }
 
 
+std::string
+NewArrayMathEngine::timing_report() const
+{
+  std::ostringstream oss;
+  oss << "parse " << parse_time_ << "s"
+      << (used_cached_program_ ? " (cached)" : "")
+      << ", setup " << setup_time_ << "s"
+      << ", evaluation " << evaluation_time_ << "s";
+  return (oss.str());
+}
+
+
 
 void
 NewArrayMathEngine::clear()
@@ -1827,6 +1868,9 @@ NewArrayMathEngine::clear()
   pprogram_ = 0;
   mprogram_ = 0;
 
+  used_cached_program_ = false;
+  parse_time_ = setup_time_ = evaluation_time_ = 0.0;
+
   pre_expression_.clear();
   expression_.clear();
   post_expression_.clear();
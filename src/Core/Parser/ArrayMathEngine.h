@@ -183,6 +183,19 @@ class SCISHARE NewArrayMathEngine : public Parser, public ArrayMathInterpreter
     // Run the expressions in parallel
     bool run();
 
+    // Whether the last run used the fused kernel instead of the interpreter
+    bool is_fused() const { return (mprogram_ && mprogram_->is_fused()); }
+
+    // Wall clock time spent by the last run on parsing, validating and
+    // optimizing the expressions, on binding the data and translating the
+    // program, and on evaluating it. A program found in the ParserProgramCache
+    // skips the parsing stage.
+    bool   used_cached_program() const { return (used_cached_program_); }
+    double parse_time() const { return (parse_time_); }
+    double setup_time() const { return (setup_time_); }
+    double evaluation_time() const { return (evaluation_time_); }
+    std::string timing_report() const;
+
     // Extract handles to the results
     bool get_field(const std::string& name, FieldHandle& field);
     bool get_matrix(const std::string& name, Core::Datatypes::MatrixHandle& matrix);
@@ -226,7 +239,11 @@ class SCISHARE NewArrayMathEngine : public Parser, public ArrayMathInterpreter
     std::vector<OutputBoolArray>   boolarraydata_;
     std::vector<OutputIntArray>    intarraydata_;
     std::vector<OutputDoubleArray>   doublearraydata_;
-    
+
+    bool   used_cached_program_;
+    double parse_time_;
+    double setup_time_;
+    double evaluation_time_;
 };
 
 }
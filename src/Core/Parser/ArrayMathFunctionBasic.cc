@@ -27,6 +27,7 @@
 //  
 
 #include <Core/Parser/ArrayMathFunctionCatalog.h>
+#include <Core/Parser/ArrayMathSoA.h>
 
 namespace ArrayMathFunctions {
 
@@ -480,14 +481,21 @@ bool mult_vt(SCIRun::ArrayMathProgramCode& pc)
     return false;
   }
   
-  double* inputVectorEnd = inputVector + VECTOR_LENGTH*pc.get_size();
-
-  while (inputVector != inputVectorEnd) 
+  size_type size = pc.get_size();
+  SoA::VectorBlock v, r;
+  SoA::TensorBlock t;
+  for (size_type offset = 0; offset < size; offset += SoA::BLOCK_SIZE)
   {
-    outputVector[0] = inputTensor[0]*inputVector[0] + inputTensor[1]*inputVector[1] + inputTensor[2]*inputVector[2];
-    outputVector[1] = inputTensor[1]*inputVector[0] + inputTensor[3]*inputVector[1] + inputTensor[4]*inputVector[2];
-    outputVector[2] = inputTensor[2]*inputVector[0] + inputTensor[4]*inputVector[1] + inputTensor[5]*inputVector[2];
-    outputVector+=VECTOR_LENGTH; inputTensor+=TENSOR_LENGTH; inputVector+=VECTOR_LENGTH;
+    int n = SoA::block_length(offset,size);
+    v.load(inputVector+VECTOR_LENGTH*offset,n);
+    t.load(inputTensor+TENSOR_LENGTH*offset,n);
+    for (int i = 0; i < n; i++)
+    {
+      r.c[0][i] = t.c[0][i]*v.c[0][i] + t.c[1][i]*v.c[1][i] + t.c[2][i]*v.c[2][i];
+      r.c[1][i] = t.c[1][i]*v.c[0][i] + t.c[3][i]*v.c[1][i] + t.c[4][i]*v.c[2][i];
+      r.c[2][i] = t.c[2][i]*v.c[0][i] + t.c[4][i]*v.c[1][i] + t.c[5][i]*v.c[2][i];
+    }
+    r.store(outputVector+VECTOR_LENGTH*offset,n);
   }
   
   return (true);
@@ -506,17 +514,23 @@ bool mult_tt(SCIRun::ArrayMathProgramCode& pc)
     return false;
   }
 
-  double* data2_end = data2 + TENSOR_LENGTH*pc.get_size();
-
-  while (data2 != data2_end) 
-  {
-    data0[0] = data1[0]*data2[0] + data1[1]*data2[1] + data1[2]*data2[2];
-    data0[1] = data1[1]*data2[0] + data1[3]*data2[1] + data1[4]*data2[2];
-    data0[2] = data1[2]*data2[0] + data1[4]*data2[1] + data1[5]*data2[2];
-    data0[3] = data1[1]*data2[1] + data1[3]*data2[3] + data1[4]*data2[4];
-    data0[4] = data1[2]*data2[1] + data1[4]*data2[3] + data1[5]*data2[4];
-    data0[5] = data1[2]*data2[2] + data1[4]*data2[4] + data1[5]*data2[5];
-    data0+=TENSOR_LENGTH; data1+=TENSOR_LENGTH; data2+=TENSOR_LENGTH;
+  size_type size = pc.get_size();
+  SoA::TensorBlock a, b, r;
+  for (size_type offset = 0; offset < size; offset += SoA::BLOCK_SIZE)
+  {
+    int n = SoA::block_length(offset,size);
+    a.load(data1+TENSOR_LENGTH*offset,n);
+    b.load(data2+TENSOR_LENGTH*offset,n);
+    for (int i = 0; i < n; i++)
+    {
+      r.c[0][i] = a.c[0][i]*b.c[0][i] + a.c[1][i]*b.c[1][i] + a.c[2][i]*b.c[2][i];
+      r.c[1][i] = a.c[1][i]*b.c[0][i] + a.c[3][i]*b.c[1][i] + a.c[4][i]*b.c[2][i];
+      r.c[2][i] = a.c[2][i]*b.c[0][i] + a.c[4][i]*b.c[1][i] + a.c[5][i]*b.c[2][i];
+      r.c[3][i] = a.c[1][i]*b.c[1][i] + a.c[3][i]*b.c[3][i] + a.c[4][i]*b.c[4][i];
+      r.c[4][i] = a.c[2][i]*b.c[1][i] + a.c[4][i]*b.c[3][i] + a.c[5][i]*b.c[4][i];
+      r.c[5][i] = a.c[2][i]*b.c[2][i] + a.c[4][i]*b.c[4][i] + a.c[5][i]*b.c[5][i];
+    }
+    r.store(data0+TENSOR_LENGTH*offset,n);
   }
   
   return (true);
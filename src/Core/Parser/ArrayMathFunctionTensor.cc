@@ -32,6 +32,7 @@
 
 
 #include <Core/Parser/ArrayMathFunctionCatalog.h>
+#include <Core/Parser/ArrayMathSoA.h>
 #include <Core/Math/MiscMath.h>
 
 #include <cmath>
@@ -360,79 +361,22 @@ bool eigvec3_t(SCIRun::ArrayMathProgramCode& pc)
 
 bool eigval1_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3]; double evec[9];
-
-  double* data0 = pc.get_variable(0); 
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-  
-  while (data1 != data1_end) 
-  {
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-    tenEigensolve_d(eval, evec, ten);
-
-
-    data0[0] = eval[0];
-    
-    data0++; data1 +=6;
-  }
-
+  SoA::map_eigenvalues(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double e1, double, double) { return e1; });
   return (true);
 }
 
 bool eigval2_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3]; double evec[9];
-
-  double* data0 = pc.get_variable(0); 
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-  
-  while (data1 != data1_end) 
-  {
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-    tenEigensolve_d(eval, evec, ten);
-
-
-    data0[0] = eval[1];
-    
-    data0 ++; data1 +=6;
-  }
-
+  SoA::map_eigenvalues(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double, double e2, double) { return e2; });
   return (true);
 }
 
 bool eigval3_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3]; double evec[9];
-
-  double* data0 = pc.get_variable(0); 
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-  
-  while (data1 != data1_end) 
-  {
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-    tenEigensolve_d(eval, evec, ten);
-
-
-    data0[0] = eval[2];
-    
-    data0 ++; data1 +=6;
-  }
-
+  SoA::map_eigenvalues(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double, double, double e3) { return e3; });
   return (true);
 }
 /*
@@ -453,216 +397,59 @@ bool eigval3_t(SCIRun::ArrayMathProgramCode& pc)
 
 bool trace_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3] = {0}; double evec[9];
-
-  double* data0 = pc.get_variable(0);
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-
-  while (data1 != data1_end)
-  {
-
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-
-    tenEigensolve_d(eval, evec, ten);
-
-  
-    data0[0] = eval[0]+eval[1]+eval[2];
-  
-    data0 ++; data1 +=6;
-  }
-
+  SoA::map_invariants(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double trace, double, double, double) { return trace; });
   return (true);
 }
 
 bool det_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3] = {0}; double evec[9];
-
-  double* data0 = pc.get_variable(0); 
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-  
-  while (data1 != data1_end) 
-  {
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-    tenEigensolve_d(eval, evec, ten);
-
-
-    data0[0] = eval[0]*eval[1]*eval[2];
-    
-    data0 ++; data1 +=6;
-  }
-
+  SoA::map_invariants(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double, double, double det, double) { return det; });
   return (true);
 }
 
 
 bool B_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3] = {0}; double evec[9];
-
-  double* data0 = pc.get_variable(0); 
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-  
-  while (data1 != data1_end) 
-  {
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-    tenEigensolve_d(eval, evec, ten);
-
-
-    data0[0] = eval[0]*eval[1]+eval[0]*eval[2]+eval[2]*eval[1];
-    
-    data0 ++; data1 +=6;
-  }
-
+  SoA::map_invariants(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double, double b, double, double) { return b; });
   return (true);
 }
 
 bool S_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3] = {0}; double evec[9];
-
-  double* data0 = pc.get_variable(0); 
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-  
-  while (data1 != data1_end) 
-  {
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-    tenEigensolve_d(eval, evec, ten);
-
-
-    data0[0] = eval[0]*eval[0]+eval[1]*eval[1]+eval[2]*eval[2];
-    
-    data0 ++; data1 +=6;
-  }
-
+  SoA::map_invariants(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double, double, double, double s) { return s; });
   return (true);
 }
 
 bool quality_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3] = {0}; double evec[9];
-
-  double* data0 = pc.get_variable(0); 
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-  
-  while (data1 != data1_end) 
-  {
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-    tenEigensolve_d(eval, evec, ten);
-
-
-    data0[0] = ((eval[0]*eval[0]+eval[1]*eval[1]+eval[2]*eval[2]) - 
-      (eval[0]*eval[1]+eval[0]*eval[2]+eval[2]*eval[1]))/9.0;
-    
-    data0 ++; data1 +=6;
-  }
-
+  SoA::map_invariants(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double, double b, double, double s) { return (s-b)/9.0; });
   return (true);
 }
 
 bool frobenius_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3] = {0}; double evec[9];
-
-  double* data0 = pc.get_variable(0); 
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-  
-  while (data1 != data1_end) 
-  {
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-    tenEigensolve_d(eval, evec, ten);
-
-
-    data0[0] = ::sqrt(eval[0]*eval[0]+eval[1]*eval[1]+eval[2]*eval[2]);
-    
-    data0 ++; data1 +=6;
-  }
-
+  SoA::map_invariants(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double, double, double, double s) { return ::sqrt(s); });
   return (true);
 }
 
 bool frobenius2_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3] = {0}; double evec[9];
-
-  double* data0 = pc.get_variable(0); 
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-  
-  while (data1 != data1_end) 
-  {
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-    tenEigensolve_d(eval, evec, ten);
-
-
-    data0[0] = eval[0]*eval[0]+eval[1]*eval[1]+eval[2]*eval[2];
-    
-    data0++; data1 +=6;
-  }
-
+  SoA::map_invariants(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double, double, double, double s) { return s; });
   return (true);
 }
 
 
 bool fracanisotropy_t(SCIRun::ArrayMathProgramCode& pc)
 {
-  double ten[7]; double eval[3] = {0}; double evec[9];
-
-  double* data0 = pc.get_variable(0); 
-  double* data1 = pc.get_variable(1);
-
-  double* data1_end = data1 + 6*pc.get_size();
-  
-  while (data1 != data1_end) 
-  {
-    ten[0] = 1.0; ten[1] = data1[0]; ten[2] = data1[1];
-    ten[3] = data1[2]; ten[4] = data1[3];
-    ten[5] = data1[4]; ten[6] = data1[5];
-
-    tenEigensolve_d(eval, evec, ten);
-
-
-    double S = eval[0]*eval[0]+eval[1]*eval[1]+eval[2]*eval[2];
-    double B = eval[0]*eval[1]+eval[0]*eval[2]+eval[2]*eval[1];
-    data0[0] = ::sqrt((S-B)/S);
-    
-    data0++; data1 +=6;
-  }
-
+  SoA::map_invariants(pc.get_variable(0),pc.get_variable(1),pc.get_size(),
+    [](double, double b, double, double s) { return ::sqrt((s-b)/s); });
   return (true);
 }
 
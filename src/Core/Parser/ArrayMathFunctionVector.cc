@@ -27,6 +27,7 @@
 //  
 
 #include <Core/Parser/ArrayMathFunctionCatalog.h>
+#include <Core/Parser/ArrayMathSoA.h>
 #include <Core/Math/MiscMath.h>
 
 #include <math.h>
@@ -223,12 +224,16 @@ bool norm_v(SCIRun::ArrayMathProgramCode& pc)
 { 
   double* data0 = pc.get_variable(0); 
   double* data1 = pc.get_variable(1); 
-  double* data0_end = data0 + pc.get_size();
-  
-  while (data0 != data0_end) 
+  size_type size = pc.get_size();
+
+  SoA::VectorBlock v;
+  for (size_type offset = 0; offset < size; offset += SoA::BLOCK_SIZE)
   {
-    data0[0] = ::sqrt(data1[0]*data1[0]+data1[1]*data1[1]+data1[2]*data1[2]);
-    data0++; data1+=3;
+    int n = SoA::block_length(offset,size);
+    v.load(data1+3*offset,n);
+    double* r = data0+offset;
+    for (int i = 0; i < n; i++)
+      r[i] = ::sqrt(v.c[0][i]*v.c[0][i]+v.c[1][i]*v.c[1][i]+v.c[2][i]*v.c[2][i]);
   }
   
   return (true);
@@ -641,12 +646,17 @@ bool dot_vv(SCIRun::ArrayMathProgramCode& pc)
   double* data0 = pc.get_variable(0); 
   double* data1 = pc.get_variable(1); 
   double* data2 = pc.get_variable(2); 
-  double* data0_end = data0 + pc.get_size();
-  
-  while (data0 != data0_end) 
+  size_type size = pc.get_size();
+
+  SoA::VectorBlock v, w;
+  for (size_type offset = 0; offset < size; offset += SoA::BLOCK_SIZE)
   {
-    *data0 = data1[0]*data2[0] + data1[1]*data2[1] + data1[2]*data2[2];
-    data0++; data1+=3; data2 +=3;
+    int n = SoA::block_length(offset,size);
+    v.load(data1+3*offset,n);
+    w.load(data2+3*offset,n);
+    double* r = data0+offset;
+    for (int i = 0; i < n; i++)
+      r[i] = v.c[0][i]*w.c[0][i] + v.c[1][i]*w.c[1][i] + v.c[2][i]*w.c[2][i];
   }
   
   return (true);
@@ -677,14 +687,21 @@ bool cross_vv(SCIRun::ArrayMathProgramCode& pc)
   double* data0 = pc.get_variable(0); 
   double* data1 = pc.get_variable(1); 
   double* data2 = pc.get_variable(2); 
-  double* data0_end = data0 + 3*pc.get_size();
-  
-  while (data0 != data0_end) 
+  size_type size = pc.get_size();
+
+  SoA::VectorBlock v, w, r;
+  for (size_type offset = 0; offset < size; offset += SoA::BLOCK_SIZE)
   {
-    data0[0] = data1[1]*data2[2] - data1[2]*data2[1];
-    data0[1] = data1[2]*data2[0] - data1[0]*data2[2];
-    data0[2] = data1[0]*data2[1] - data1[1]*data2[0];
-    data0+=3; data1+=3; data2 +=3;
+    int n = SoA::block_length(offset,size);
+    v.load(data1+3*offset,n);
+    w.load(data2+3*offset,n);
+    for (int i = 0; i < n; i++)
+    {
+      r.c[0][i] = v.c[1][i]*w.c[2][i] - v.c[2][i]*w.c[1][i];
+      r.c[1][i] = v.c[2][i]*w.c[0][i] - v.c[0][i]*w.c[2][i];
+      r.c[2][i] = v.c[0][i]*w.c[1][i] - v.c[1][i]*w.c[0][i];
+    }
+    r.store(data0+3*offset,n);
   }
   
   return (true);
@@ -695,19 +712,20 @@ bool normalize_v(SCIRun::ArrayMathProgramCode& pc)
 { 
   double* data0 = pc.get_variable(0); 
   double* data1 = pc.get_variable(1); 
-  double* data0_end = data0 + 3*pc.get_size();
-  
-  while (data0 != data0_end) 
-  {
-    double s = 0.0;
-    double len = ::sqrt(data1[0]*data1[0]+data1[1]*data1[1]+data1[2]*data1[2]);
-    if (len > 0.0) s = 1.0/len;
-    
-    data0[0] = s*data1[0];
-    data0[1] = s*data1[1];
-    data0[2] = s*data1[2];
+  size_type size = pc.get_size();
 
-    data0+=3; data1+=3;
+  SoA::VectorBlock v;
+  for (size_type offset = 0; offset < size; offset += SoA::BLOCK_SIZE)
+  {
+    int n = SoA::block_length(offset,size);
+    v.load(data1+3*offset,n);
+    for (int i = 0; i < n; i++)
+    {
+      double len = ::sqrt(v.c[0][i]*v.c[0][i]+v.c[1][i]*v.c[1][i]+v.c[2][i]*v.c[2][i]);
+      double s = (len > 0.0) ? 1.0/len : 0.0;
+      v.c[0][i] *= s; v.c[1][i] *= s; v.c[2][i] *= s;
+    }
+    v.store(data0+3*offset,n);
   }
   
   return (true);
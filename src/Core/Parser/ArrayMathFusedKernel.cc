@@ -0,0 +1,617 @@
+//  
+//  For more information, please see: http://software.sci.utah.edu
+//  
+//  The MIT License
+//  
+//  Copyright (c) 2015 Scientific Computing and Imaging Institute,
+//  University of Utah.
+//  
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//  
+//  The above copyright notice and this permission notice shall be included
+//  in all copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//  
+
+#include <Core/Parser/ArrayMathFusedKernel.h>
+#include <Core/Parser/ArrayMathInterpreter.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Math/MiscMath.h>
+
+#include <cmath>
+#include <map>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace {
+
+enum {
+  // Sources and sinks
+  OP_GET_SCALAR_FD, OP_GET_SCALAR_AD, OP_GET_NODE_FM, OP_GET_ELEMENT_FM,
+  OP_INDEX, OP_TO_FIELDDATA, OP_TO_DOUBLE_ARRAY,
+  // Basic arithmetic
+  OP_ADD, OP_SUB, OP_MULT, OP_DIV, OP_REM, OP_NEG, OP_SELECT,
+  // Scalar functions
+  OP_ISNAN, OP_ISFINITE, OP_ISINFINITE, OP_SIGN, OP_RAMP, OP_RECT, OP_STEP,
+  OP_NOT, OP_INV, OP_BOOLEAN, OP_ABS, OP_ROUND, OP_FLOOR, OP_CEIL,
+  OP_EXP, OP_POW, OP_SQRT, OP_LOG, OP_LOG2, OP_LOG10, OP_CBRT,
+  OP_SIN, OP_COS, OP_TAN, OP_SINH, OP_COSH, OP_ASIN, OP_ACOS, OP_ATAN,
+  OP_ATAN2, OP_ASINH, OP_ACOSH,
+  OP_AND, OP_OR, OP_EQ, OP_NEQ, OP_LE, OP_GE, OP_LS, OP_GT,
+  OP_MIN, OP_MAX, OP_MEDIAN
+};
+
+class OpCode {
+  public:
+    OpCode() : opcode_(0), component_(0) {}
+    OpCode(int opcode, int component = 0) : opcode_(opcode), component_(component) {}
+    int opcode_;
+    int component_;
+};
+
+// Function ids of the catalog that have an instruction
+std::map<std::string,OpCode> build_opcode_table()
+{
+  std::map<std::string,OpCode> table;
+  table["get_scalar$FD"] = OpCode(OP_GET_SCALAR_FD);
+  table["get_scalar$AD"] = OpCode(OP_GET_SCALAR_AD);
+  table["get_node_x$FM"] = OpCode(OP_GET_NODE_FM,0);
+  table["get_node_y$FM"] = OpCode(OP_GET_NODE_FM,1);
+  table["get_node_z$FM"] = OpCode(OP_GET_NODE_FM,2);
+  table["get_element_x$FM"] = OpCode(OP_GET_ELEMENT_FM,0);
+  table["get_element_y$FM"] = OpCode(OP_GET_ELEMENT_FM,1);
+  table["get_element_z$FM"] = OpCode(OP_GET_ELEMENT_FM,2);
+  table["index$"] = OpCode(OP_INDEX);
+  table["to_fielddata$S"] = OpCode(OP_TO_FIELDDATA);
+  table["to_double_array$S"] = OpCode(OP_TO_DOUBLE_ARRAY);
+
+  table["add$S:S"] = OpCode(OP_ADD);
+  table["sub$S:S"] = OpCode(OP_SUB);
+  table["mult$S:S"] = OpCode(OP_MULT);
+  table["div$S:S"] = OpCode(OP_DIV);
+  table["rem$S:S"] = OpCode(OP_REM);
+  table["neg$S"] = OpCode(OP_NEG);
+  table["select$S:S:S"] = OpCode(OP_SELECT);
+
+  table["isnan$S"] = OpCode(OP_ISNAN);
+  table["isfinite$S"] = OpCode(OP_ISFINITE);
+  table["isinfinite$S"] = OpCode(OP_ISINFINITE);
+  table["isinf$S"] = OpCode(OP_ISINFINITE);
+  table["sign$S"] = OpCode(OP_SIGN);
+  table["ramp$S:S:S"] = OpCode(OP_RAMP);
+  table["rect$S:S:S"] = OpCode(OP_RECT);
+  table["step$S:S"] = OpCode(OP_STEP);
+  table["not$S"] = OpCode(OP_NOT);
+  table["inv$S"] = OpCode(OP_INV);
+  table["boolean$S"] = OpCode(OP_BOOLEAN);
+  table["abs$S"] = OpCode(OP_ABS);
+  table["norm$S"] = OpCode(OP_ABS);
+  table["round$S"] = OpCode(OP_ROUND);
+  table["floor$S"] = OpCode(OP_FLOOR);
+  table["ceil$S"] = OpCode(OP_CEIL);
+  table["exp$S"] = OpCode(OP_EXP);
+  table["pow$S:S"] = OpCode(OP_POW);
+  table["sqrt$S"] = OpCode(OP_SQRT);
+  table["log$S"] = OpCode(OP_LOG);
+  table["ln$S"] = OpCode(OP_LOG);
+  table["log2$S"] = OpCode(OP_LOG2);
+  table["log10$S"] = OpCode(OP_LOG10);
+  table["cbrt$S"] = OpCode(OP_CBRT);
+  table["sin$S"] = OpCode(OP_SIN);
+  table["cos$S"] = OpCode(OP_COS);
+  table["tan$S"] = OpCode(OP_TAN);
+  table["sinh$S"] = OpCode(OP_SINH);
+  table["cosh$S"] = OpCode(OP_COSH);
+  table["asin$S"] = OpCode(OP_ASIN);
+  table["acos$S"] = OpCode(OP_ACOS);
+  table["atan$S"] = OpCode(OP_ATAN);
+  table["atan2$S:S"] = OpCode(OP_ATAN2);
+  table["asinh$S"] = OpCode(OP_ASINH);
+  table["acosh$S"] = OpCode(OP_ACOSH);
+
+  table["and$S:S"] = OpCode(OP_AND);
+  table["bitand$S:S"] = OpCode(OP_AND);
+  table["or$S:S"] = OpCode(OP_OR);
+  table["bitor$S:S"] = OpCode(OP_OR);
+  table["eq$S:S"] = OpCode(OP_EQ);
+  table["neq$S:S"] = OpCode(OP_NEQ);
+  table["le$S:S"] = OpCode(OP_LE);
+  table["ge$S:S"] = OpCode(OP_GE);
+  table["ls$S:S"] = OpCode(OP_LS);
+  table["gt$S:S"] = OpCode(OP_GT);
+  table["min$S:S"] = OpCode(OP_MIN);
+  table["max$S:S"] = OpCode(OP_MAX);
+  table["median$S:S:S"] = OpCode(OP_MEDIAN);
+  return (table);
+}
+
+const std::map<std::string,OpCode>& opcodes()
+{
+  static const std::map<std::string,OpCode> table = build_opcode_table();
+  return (table);
+}
+
+// Slot numbers handed out during compilation, these are replaced by the
+// final slot numbers once the number of registers is known
+const size_t EXTERNAL_SLOT = size_t(1) << 28;
+const size_t SPLAT_SLOT = size_t(1) << 29;
+
+}
+
+size_t
+ArrayMathFusedKernel::allocate_register(std::vector<size_t>& free_registers)
+{
+  if (free_registers.empty()) return (num_registers_++);
+  size_t reg = free_registers.back();
+  free_registers.pop_back();
+  return (reg);
+}
+
+ArrayMathFusedKernelHandle
+ArrayMathFusedKernel::compile(ParserProgramHandle& pprogram,
+                              ArrayMathProgram& mprogram)
+{
+  ArrayMathFusedKernelHandle empty;
+  size_t num_functions = pprogram->num_sequential_functions();
+  size_t num_variables = pprogram->num_sequential_variables();
+  if (num_functions == 0) return (empty);
+
+  const std::map<std::string,OpCode>& table = opcodes();
+
+  ArrayMathFusedKernelHandle kernel(new ArrayMathFusedKernel);
+  kernel->lanes_ = mprogram.get_buffer_size();
+
+  ParserScriptFunctionHandle fhandle;
+  ParserScriptVariableHandle vhandle;
+  ArrayMathProgramSource ps;
+
+  // Find the last function reading every sequential variable, after that
+  // its register can be reused
+  std::vector<int> last_use(num_variables,-1);
+  for (size_t j=0; j<num_functions; j++)
+  {
+    pprogram->get_sequential_function(j,fhandle);
+    size_t num_input_vars = fhandle->num_input_vars();
+    for (size_t i=0; i<num_input_vars; i++)
+    {
+      vhandle = fhandle->get_input_var(i);
+      int flags = vhandle->get_flags();
+      if ((flags & SCRIPT_SEQUENTIAL_VAR_E) && !(flags & SCRIPT_CONST_VAR_E))
+        last_use[vhandle->get_var_number()] = static_cast<int>(j);
+    }
+  }
+
+  std::vector<int> var_register(num_variables,-1);
+  std::vector<size_t> free_registers;
+  std::map<const double*,size_t> externals, splats;
+
+  for (size_t j=0; j<num_functions; j++)
+  {
+    pprogram->get_sequential_function(j,fhandle);
+    std::map<std::string,OpCode>::const_iterator it =
+      table.find(fhandle->get_function()->get_function_id());
+    if (it == table.end()) return (empty);
+
+    Instruction ins;
+    ins.opcode_ = it->second.opcode_;
+    ins.component_ = it->second.component_;
+    ins.line_ = j;
+
+    size_t num_input_vars = fhandle->num_input_vars();
+    if (num_input_vars > 3) return (empty);
+
+    for (size_t i=0; i<num_input_vars; i++)
+    {
+      vhandle = fhandle->get_input_var(i);
+      std::string type = vhandle->get_type();
+      std::string name = vhandle->get_name();
+      int inum = vhandle->get_var_number();
+      int flags = vhandle->get_flags();
+
+      if (type == "S")
+      {
+        if (flags & SCRIPT_SEQUENTIAL_VAR_E)
+        {
+          if (flags & SCRIPT_CONST_VAR_E)
+          {
+            // Sequential constants are shared by all processors
+            double* data = mprogram.get_sequential_variable(inum,0)->get_data();
+            if (!data) return (empty);
+            if (!externals.count(data))
+            {
+              size_t slot = EXTERNAL_SLOT + kernel->externals_.size();
+              externals[data] = slot;
+              kernel->externals_.push_back(data);
+            }
+            ins.src_[i] = externals[data];
+          }
+          else
+          {
+            if (var_register[inum] < 0) return (empty);
+            ins.src_[i] = var_register[inum];
+          }
+        }
+        else
+        {
+          // A single value, broadcast it over a register of its own
+          double* data = 0;
+          if (flags & SCRIPT_SINGLE_VAR_E)
+            data = mprogram.get_single_variable(inum)->get_data();
+          else if (flags & SCRIPT_CONST_VAR_E)
+            data = mprogram.get_const_variable(inum)->get_data();
+          if (!data) return (empty);
+          if (!splats.count(data))
+          {
+            size_t slot = SPLAT_SLOT + kernel->splats_.size();
+            splats[data] = slot;
+            kernel->splats_.push_back(std::make_pair(slot,data));
+          }
+          ins.src_[i] = splats[data];
+        }
+      }
+      else if (type == "FD")
+      {
+        mprogram.find_source(name,ps);
+        if (!ps.is_vfield() || !(ps.get_vfield()->is_scalar())) return (empty);
+        ins.vfield_ = ps.get_vfield();
+      }
+      else if (type == "FM")
+      {
+        mprogram.find_source(name,ps);
+        if (!ps.is_vmesh()) return (empty);
+        ins.vmesh_ = ps.get_vmesh();
+      }
+      else if (type == "AD")
+      {
+        mprogram.find_source(name,ps);
+        if (!ps.is_double_array()) return (empty);
+        ins.array_ = ps.get_double_array();
+      }
+      else
+      {
+        return (empty);
+      }
+    }
+
+    vhandle = fhandle->get_output_var();
+    std::string type = vhandle->get_type();
+    std::string name = vhandle->get_name();
+    int onum = vhandle->get_var_number();
+    int flags = vhandle->get_flags();
+
+    if (type == "S")
+    {
+      if (!(flags & SCRIPT_SEQUENTIAL_VAR_E) || (flags & SCRIPT_CONST_VAR_E))
+        return (empty);
+      if (var_register[onum] < 0)
+        var_register[onum] = static_cast<int>(kernel->allocate_register(free_registers));
+      ins.dst_ = var_register[onum];
+    }
+    else if (type == "FD")
+    {
+      mprogram.find_sink(name,ps);
+      if (!ps.is_vfield() || !(ps.get_vfield()->is_scalar())) return (empty);
+      ins.vfield_ = ps.get_vfield();
+    }
+    else if (type == "AD")
+    {
+      mprogram.find_sink(name,ps);
+      if (!ps.is_double_array()) return (empty);
+      ins.array_ = ps.get_double_array();
+    }
+    else
+    {
+      return (empty);
+    }
+
+    // Sources and sinks need their object
+    switch (ins.opcode_)
+    {
+      case OP_GET_SCALAR_FD:
+      case OP_TO_FIELDDATA:
+        if (!ins.vfield_) return (empty);
+        break;
+      case OP_GET_NODE_FM:
+      case OP_GET_ELEMENT_FM:
+        if (!ins.vmesh_) return (empty);
+        break;
+      case OP_GET_SCALAR_AD:
+      case OP_TO_DOUBLE_ARRAY:
+        if (!ins.array_) return (empty);
+        break;
+    }
+
+    kernel->code_.push_back(ins);
+
+    // Release the registers of values that are not read anymore
+    for (size_t i=0; i<num_input_vars; i++)
+    {
+      vhandle = fhandle->get_input_var(i);
+      int inum = vhandle->get_var_number();
+      int iflags = vhandle->get_flags();
+      if (!(iflags & SCRIPT_SEQUENTIAL_VAR_E) || (iflags & SCRIPT_CONST_VAR_E)) continue;
+      if (vhandle->get_type() != "S") continue;
+      if (last_use[inum] <= static_cast<int>(j) && var_register[inum] >= 0)
+      {
+        free_registers.push_back(var_register[inum]);
+        var_register[inum] = -1;
+      }
+    }
+    if (type == "S" && last_use[onum] <= static_cast<int>(j) && var_register[onum] >= 0)
+    {
+      free_registers.push_back(var_register[onum]);
+      var_register[onum] = -1;
+    }
+  }
+
+  // Final slot layout: registers, sequential constants, broadcast values
+  const size_t num_externals = kernel->externals_.size();
+  const size_t num_splats = kernel->splats_.size();
+  const size_t num_registers = kernel->num_registers_;
+
+  struct Resolve
+  {
+    size_t num_registers, num_externals;
+    size_t operator()(size_t slot) const
+    {
+      if (slot >= SPLAT_SLOT) return (num_registers + num_externals + (slot - SPLAT_SLOT));
+      if (slot >= EXTERNAL_SLOT) return (num_registers + (slot - EXTERNAL_SLOT));
+      return (slot);
+    }
+  } resolve = { num_registers, num_externals };
+
+  for (size_t j=0; j<kernel->code_.size(); j++)
+  {
+    Instruction& ins = kernel->code_[j];
+    for (size_t i=0; i<3; i++) ins.src_[i] = resolve(ins.src_[i]);
+  }
+  for (size_t k=0; k<num_splats; k++)
+    kernel->splats_[k].first = resolve(kernel->splats_[k].first);
+
+  const int num_proc = mprogram.get_num_proc();
+  const size_type lanes = kernel->lanes_;
+  kernel->registers_.resize(num_proc);
+  kernel->slots_.resize(num_proc);
+  for (int np=0; np<num_proc; np++)
+  {
+    std::vector<double>& mem = kernel->registers_[np];
+    std::vector<double*>& slots = kernel->slots_[np];
+    mem.resize((num_registers+num_splats)*lanes);
+    slots.resize(num_registers+num_externals+num_splats,0);
+    for (size_t r=0; r<num_registers; r++)
+      slots[r] = &(mem[r*lanes]);
+    for (size_t k=0; k<num_externals; k++)
+      slots[num_registers+k] = kernel->externals_[k];
+    for (size_t k=0; k<num_splats; k++)
+      slots[num_registers+num_externals+k] = &(mem[(num_registers+k)*lanes]);
+  }
+
+  return (kernel);
+}
+
+void
+ArrayMathFusedKernel::prepare(int proc)
+{
+  for (size_t k=0; k<splats_.size(); k++)
+  {
+    double* data = slots_[proc][splats_[k].first];
+    const double val = *(splats_[k].second);
+    for (size_type i=0; i<lanes_; i++) data[i] = val;
+  }
+}
+
+bool
+ArrayMathFusedKernel::run(int proc, index_type offset, size_type size,
+                          size_t& error_line)
+{
+  if (size > lanes_) return (false);
+  std::vector<double*>& slots = slots_[proc];
+  const size_t num_code = code_.size();
+
+  for (size_t j=0; j<num_code; j++)
+  {
+    const Instruction& ins = code_[j];
+    // Every instruction reads or writes at least one scalar, hence there
+    // is always a slot 0 for the operands an instruction does not use
+    double* d = slots[ins.dst_];
+    const double* a = slots[ins.src_[0]];
+    const double* b = slots[ins.src_[1]];
+    const double* c = slots[ins.src_[2]];
+    const size_type n = size;
+
+    switch (ins.opcode_)
+    {
+      case OP_GET_SCALAR_FD:
+        // One virtual call per buffer
+        ins.vfield_->get_values(d,n,offset);
+        break;
+      case OP_GET_SCALAR_AD:
+      {
+        const std::vector<double>& array = *(ins.array_);
+        for (size_type i=0; i<n; i++) d[i] = array[offset+i];
+        break;
+      }
+      case OP_GET_NODE_FM:
+      {
+        Point p;
+        for (size_type i=0; i<n; i++)
+        {
+          ins.vmesh_->get_center(p,VMesh::Node::index_type(offset+i));
+          d[i] = p[ins.component_];
+        }
+        break;
+      }
+      case OP_GET_ELEMENT_FM:
+      {
+        Point p;
+        for (size_type i=0; i<n; i++)
+        {
+          ins.vmesh_->get_center(p,VMesh::Elem::index_type(offset+i));
+          d[i] = p[ins.component_];
+        }
+        break;
+      }
+      case OP_INDEX:
+        for (size_type i=0; i<n; i++) d[i] = static_cast<double>(offset+i);
+        break;
+      case OP_TO_FIELDDATA:
+        ins.vfield_->set_values(a,n,offset);
+        break;
+      case OP_TO_DOUBLE_ARRAY:
+      {
+        std::vector<double>& array = *(ins.array_);
+        for (size_type i=0; i<n; i++) array[offset+i] = a[i];
+        break;
+      }
+
+      case OP_ADD:  for (size_type i=0; i<n; i++) d[i] = a[i] + b[i]; break;
+      case OP_SUB:  for (size_type i=0; i<n; i++) d[i] = a[i] - b[i]; break;
+      case OP_MULT: for (size_type i=0; i<n; i++) d[i] = a[i] * b[i]; break;
+      case OP_DIV:  for (size_type i=0; i<n; i++) d[i] = a[i] / b[i]; break;
+      case OP_REM:  for (size_type i=0; i<n; i++) d[i] = fmod(a[i],b[i]); break;
+      case OP_NEG:  for (size_type i=0; i<n; i++) d[i] = -a[i]; break;
+      case OP_SELECT:
+        for (size_type i=0; i<n; i++) d[i] = a[i] ? b[i] : c[i];
+        break;
+
+      case OP_ISNAN:
+        for (size_type i=0; i<n; i++) d[i] = IsNan(a[i]) ? 1.0 : 0.0;
+        break;
+      case OP_ISFINITE:
+        for (size_type i=0; i<n; i++) d[i] = IsFinite(a[i]) ? 1.0 : 0.0;
+        break;
+      case OP_ISINFINITE:
+        for (size_type i=0; i<n; i++) d[i] = IsInfinite(a[i]) ? 1.0 : 0.0;
+        break;
+      case OP_SIGN:
+        for (size_type i=0; i<n; i++)
+          d[i] = (a[i] > 0.0) ? 1.0 : ((a[i] < 0.0) ? -1.0 : 0.0);
+        break;
+      case OP_RAMP:
+        for (size_type i=0; i<n; i++)
+        {
+          const double start = b[i], end = c[i];
+          if (end > start)
+          {
+            if (a[i] <= start) d[i] = 0.0;
+            else if (a[i] >= end) d[i] = 1.0;
+            else d[i] = (a[i]-start)/(end-start);
+          }
+          else
+          {
+            if (a[i] >= start) d[i] = 0.0;
+            else if (a[i] <= end) d[i] = 1.0;
+            else d[i] = (start-a[i])/(start-end);
+          }
+        }
+        break;
+      case OP_RECT:
+        for (size_type i=0; i<n; i++) d[i] = (a[i] >= b[i] && a[i] <= c[i]) ? 1.0 : 0.0;
+        break;
+      case OP_STEP:
+        for (size_type i=0; i<n; i++) d[i] = (a[i] >= b[i]) ? 1.0 : 0.0;
+        break;
+      case OP_NOT:
+        for (size_type i=0; i<n; i++) d[i] = a[i] ? 0.0 : 1.0;
+        break;
+      case OP_INV:
+        for (size_type i=0; i<n; i++) d[i] = 1.0/a[i];
+        break;
+      case OP_BOOLEAN:
+        for (size_type i=0; i<n; i++) d[i] = a[i] ? 1.0 : 0.0;
+        break;
+      case OP_ABS:
+        for (size_type i=0; i<n; i++) d[i] = (a[i] < 0) ? -a[i] : a[i];
+        break;
+      case OP_ROUND:
+        for (size_type i=0; i<n; i++) d[i] = static_cast<double>(static_cast<int>(a[i]+0.5));
+        break;
+      case OP_FLOOR: for (size_type i=0; i<n; i++) d[i] = ::floor(a[i]); break;
+      case OP_CEIL:  for (size_type i=0; i<n; i++) d[i] = ::ceil(a[i]); break;
+      case OP_EXP:   for (size_type i=0; i<n; i++) d[i] = ::exp(a[i]); break;
+      case OP_POW:   for (size_type i=0; i<n; i++) d[i] = ::pow(a[i],b[i]); break;
+      case OP_SQRT:  for (size_type i=0; i<n; i++) d[i] = ::sqrt(a[i]); break;
+      case OP_LOG:   for (size_type i=0; i<n; i++) d[i] = ::log(a[i]); break;
+      case OP_LOG2:
+      {
+        const double s = 1.0/log(2.0);
+        for (size_type i=0; i<n; i++) d[i] = ::log(a[i])*s;
+        break;
+      }
+      case OP_LOG10:
+      {
+        const double s = 1.0/log(10.0);
+        for (size_type i=0; i<n; i++) d[i] = ::log(a[i])*s;
+        break;
+      }
+      case OP_CBRT:  for (size_type i=0; i<n; i++) d[i] = ::pow(a[i],1.0/3.0); break;
+      case OP_SIN:   for (size_type i=0; i<n; i++) d[i] = ::sin(a[i]); break;
+      case OP_COS:   for (size_type i=0; i<n; i++) d[i] = ::cos(a[i]); break;
+      case OP_TAN:   for (size_type i=0; i<n; i++) d[i] = ::tan(a[i]); break;
+      case OP_SINH:  for (size_type i=0; i<n; i++) d[i] = ::sinh(a[i]); break;
+      case OP_COSH:  for (size_type i=0; i<n; i++) d[i] = ::cosh(a[i]); break;
+      case OP_ASIN:  for (size_type i=0; i<n; i++) d[i] = ::asin(a[i]); break;
+      case OP_ACOS:  for (size_type i=0; i<n; i++) d[i] = ::acos(a[i]); break;
+      case OP_ATAN:  for (size_type i=0; i<n; i++) d[i] = ::atan(a[i]); break;
+      case OP_ATAN2: for (size_type i=0; i<n; i++) d[i] = ::atan2(a[i],b[i]); break;
+      case OP_ASINH:
+        for (size_type i=0; i<n; i++)
+        {
+          const double v = a[i];
+          d[i] = (v==0?0:(v>0?1:-1)) * ::log((v<0?-v:v) + ::sqrt(1+v*v));
+        }
+        break;
+      case OP_ACOSH:
+        for (size_type i=0; i<n; i++) d[i] = ::log(a[i] + ::sqrt(a[i]*a[i]-1));
+        break;
+
+      case OP_AND: for (size_type i=0; i<n; i++) d[i] = (a[i] && b[i]); break;
+      case OP_OR:  for (size_type i=0; i<n; i++) d[i] = (a[i] || b[i]); break;
+      case OP_EQ:  for (size_type i=0; i<n; i++) d[i] = (a[i] == b[i]) ? 1.0 : 0.0; break;
+      case OP_NEQ: for (size_type i=0; i<n; i++) d[i] = (a[i] != b[i]) ? 1.0 : 0.0; break;
+      case OP_LE:  for (size_type i=0; i<n; i++) d[i] = (a[i] <= b[i]) ? 1.0 : 0.0; break;
+      case OP_GE:  for (size_type i=0; i<n; i++) d[i] = (a[i] >= b[i]) ? 1.0 : 0.0; break;
+      case OP_LS:  for (size_type i=0; i<n; i++) d[i] = (a[i] < b[i]) ? 1.0 : 0.0; break;
+      case OP_GT:  for (size_type i=0; i<n; i++) d[i] = (a[i] > b[i]) ? 1.0 : 0.0; break;
+      case OP_MIN: for (size_type i=0; i<n; i++) d[i] = (a[i] < b[i]) ? a[i] : b[i]; break;
+      case OP_MAX: for (size_type i=0; i<n; i++) d[i] = (a[i] > b[i]) ? a[i] : b[i]; break;
+      case OP_MEDIAN:
+        for (size_type i=0; i<n; i++)
+        {
+          if (a[i] > b[i])
+          {
+            if (c[i] < b[i]) d[i] = b[i];
+            else d[i] = (a[i] < c[i]) ? a[i] : c[i];
+          }
+          else
+          {
+            if (c[i] < a[i]) d[i] = a[i];
+            else d[i] = (b[i] > c[i]) ? c[i] : b[i];
+          }
+        }
+        break;
+
+      default:
+        error_line = ins.line_;
+        return (false);
+    }
+  }
+
+  return (true);
+}
@@ -0,0 +1,129 @@
+//  
+//  For more information, please see: http://software.sci.utah.edu
+//  
+//  The MIT License
+//  
+//  Copyright (c) 2015 Scientific Computing and Imaging Institute,
+//  University of Utah.
+//  
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//  
+//  The above copyright notice and this permission notice shall be included
+//  in all copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//  
+
+#ifndef CORE_PARSER_ARRAYMATHFUSEDKERNEL_H
+#define CORE_PARSER_ARRAYMATHFUSEDKERNEL_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Datatypes/Legacy/Field/FieldFwd.h>
+
+#include <Core/Parser/Parser.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+
+// Include files needed for Windows
+#include <Core/Parser/share.h>
+
+namespace SCIRun {
+
+class ArrayMathProgram;
+class ArrayMathFusedKernel;
+
+typedef boost::shared_ptr<ArrayMathFusedKernel> ArrayMathFusedKernelHandle;
+
+//-----------------------------------------------------------------------------
+// Fused version of the sequential part of an ArrayMath program
+
+// The interpreter runs every sequential function as a separate call over a
+// buffer of values and keeps a separate buffer for every intermediate
+// result. When the sequential part only consists of scalar functions, this
+// class translates it into a register based bytecode instead: every
+// register is one buffer of lanes, registers are reused as soon as the value
+// they hold is no longer needed and all instructions are dispatched from one
+// loop without going through the function pointers and variable lists.
+// Field sources and sinks move a whole buffer per virtual call.
+//
+// The instructions implement the same arithmetic as the functions in the
+// catalog. Programs that use any function that has no instruction are not
+// compiled, they run through the regular interpreter.
+
+class SCISHARE ArrayMathFusedKernel : boost::noncopyable {
+  public:
+    // Compile the sequential functions of a translated program. This returns
+    // an empty handle if the program contains unsupported functions.
+    static ArrayMathFusedKernelHandle compile(ParserProgramHandle& pprogram,
+                                              ArrayMathProgram& mprogram);
+
+    // Number of lane buffers used per processor
+    size_t num_registers() const { return (num_registers_); }
+    size_t num_instructions() const { return (code_.size()); }
+
+    // Load the values of the const and single variables used by the
+    // sequential part, this needs to be called once by every processor
+    // after the const and single parts have been run.
+    void prepare(int proc);
+
+    // Evaluate the entries [offset,offset+size), size is at most the buffer
+    // size of the program. On failure error_line is the sequential function
+    // that failed.
+    bool run(int proc, index_type offset, size_type size, size_t& error_line);
+
+  private:
+    ArrayMathFusedKernel() : num_registers_(0), lanes_(0) {}
+
+    class Instruction {
+      public:
+        Instruction() : opcode_(0), line_(0), dst_(0), component_(0),
+          vfield_(0), vmesh_(0), array_(0)
+          { src_[0] = src_[1] = src_[2] = 0; }
+
+        int     opcode_;
+        // Sequential function this instruction was generated from
+        size_t  line_;
+        // Register slots of the output and the inputs
+        size_t  dst_;
+        size_t  src_[3];
+        // Coordinate for mesh sources
+        int     component_;
+        // Sources and sinks
+        VField* vfield_;
+        VMesh*  vmesh_;
+        std::vector<double>* array_;
+    };
+
+    size_t allocate_register(std::vector<size_t>& free_registers);
+
+    std::vector<Instruction> code_;
+
+    size_t    num_registers_;
+    size_type lanes_;
+
+    // Registers that hold a broadcast copy of a const or single variable
+    std::vector<std::pair<size_t,const double*> > splats_;
+    // Slots that point straight at the buffers of sequential constants
+    std::vector<double*> externals_;
+
+    // Per processor register memory and slot table
+    std::vector<std::vector<double> > registers_;
+    std::vector<std::vector<double*> > slots_;
+};
+
+}
+
+#endif
@@ -1188,6 +1188,14 @@ ArrayMathInterpreter::translate(ParserProgramHandle& pprogram,
     }
   }
 
+  // Replace the sequential function calls by one fused kernel if all of
+  // them are supported, otherwise the program code above is used
+  mprogram->set_fused_kernel(ArrayMathFusedKernelHandle());
+  if (fuse_)
+  {
+    mprogram->set_fused_kernel(ArrayMathFusedKernel::compile(pprogram,*mprogram));
+  }
+
   return (true);
 }
 
@@ -1541,6 +1549,27 @@ ArrayMathProgram::run_parallel(int proc)
   offset = start;
   success_[proc] = true;
 
+  if (fused_kernel_)
+  {
+    fused_kernel_->prepare(proc);
+    while (offset < end)
+    {
+      sz = buffer_size_;
+      if (offset+sz >= end) sz = end-offset;
+
+      size_t error_line;
+      if (!(fused_kernel_->run(proc,offset,sz,error_line)))
+      {
+        error_line_[proc] = error_line;
+        success_[proc] = false;
+      }
+      offset += sz;
+    }
+
+    barrier_.wait();
+    return;
+  }
+
   while (offset < end)
   {
     sz = buffer_size_;
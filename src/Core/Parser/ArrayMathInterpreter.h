@@ -39,6 +39,7 @@
 #include <Core/Containers/StackBasedVector.h>
 
 #include <Core/Parser/Parser.h>
+#include <Core/Parser/ArrayMathFusedKernel.h>
 
 #include <boost/function.hpp>
 #include <boost/variant.hpp>
@@ -418,6 +419,11 @@ class SCISHARE ArrayMathProgramSource {
     
     void set_parser_program(ParserProgramHandle handle) { pprogram_ = handle; }      
     ParserProgramHandle get_parser_program() { return (pprogram_); }
+
+    // Fused kernel that replaces the sequential program code, if the
+    // sequential part could be compiled into one
+    void set_fused_kernel(ArrayMathFusedKernelHandle kernel) { fused_kernel_ = kernel; }
+    bool is_fused() const { return (fused_kernel_.get() != 0); }
                             
   private:    
   
@@ -447,6 +453,8 @@ class SCISHARE ArrayMathProgramSource {
     std::vector<std::vector<ArrayMathProgramCodePtr> > sequential_functions_;
     
     ParserProgramHandle pprogram_;
+
+    ArrayMathFusedKernelHandle fused_kernel_;
     
     // For parallel code
   private:
@@ -462,6 +470,13 @@ class SCISHARE ArrayMathProgramSource {
 class SCISHARE ArrayMathInterpreter {
 
   public:
+    ArrayMathInterpreter() : fuse_(true) {}
+
+    // Compile the sequential part of scalar programs into a fused kernel
+    // (default), or always run the function calls one by one
+    void set_fusion(bool fuse) { fuse_ = fuse; }
+    bool get_fusion() const { return (fuse_); }
+
     // The interpreter Creates executable code from the parsed code
     // The first step is setting the data sources and sinks
 
@@ -557,7 +572,9 @@ class SCISHARE ArrayMathInterpreter {
     // Step 4: Run the code
   
     bool run(ArrayMathProgramHandle& mprogram,std::string& error);
-    
+
+  private:
+    bool fuse_;
 };
 
 }
@@ -0,0 +1,176 @@
+//  
+//  For more information, please see: http://software.sci.utah.edu
+//  
+//  The MIT License
+//  
+//  Copyright (c) 2015 Scientific Computing and Imaging Institute,
+//  University of Utah.
+//  
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//  
+//  The above copyright notice and this permission notice shall be included
+//  in all copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//  
+
+#ifndef CORE_PARSER_ARRAYMATHSOA_H
+#define CORE_PARSER_ARRAYMATHSOA_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Math/MiscMath.h>
+
+#include <cmath>
+
+namespace ArrayMathFunctions {
+namespace SoA {
+
+//-----------------------------------------------------------------------------
+// Structure of arrays blocks for vector and tensor functions
+
+// The interpreter stores vectors as 3 and tensors as 6 interleaved doubles,
+// every source, sink and function depends on that layout. The functions that
+// dominate vector and tensor heavy programs copy their inputs into small
+// blocks with one array per component instead, so the arithmetic runs as
+// unit stride loops that the compiler turns into SIMD code, and copy the
+// results back. A block stays in the L1 cache.
+
+const int BLOCK_SIZE = 64;
+
+template<int N>
+class Block {
+  public:
+    double c[N][BLOCK_SIZE];
+
+    inline void load(const double* data, int n)
+    {
+      for (int i = 0; i < n; i++)
+        for (int k = 0; k < N; k++) c[k][i] = data[N*i+k];
+    }
+
+    inline void store(double* data, int n) const
+    {
+      for (int i = 0; i < n; i++)
+        for (int k = 0; k < N; k++) data[N*i+k] = c[k][i];
+    }
+};
+
+typedef Block<1> ScalarBlock;
+typedef Block<3> VectorBlock;
+typedef Block<6> TensorBlock;
+
+// Number of entries in the block starting at offset
+inline int block_length(SCIRun::size_type offset, SCIRun::size_type size)
+{
+  SCIRun::size_type n = size - offset;
+  return (static_cast<int>(n < BLOCK_SIZE ? n : BLOCK_SIZE));
+}
+
+// Invariants of the symmetric tensors in a block, tensors are stored as
+// xx, xy, xz, yy, yz, zz. These equal the sum, the sum of the pairwise
+// products and the product of the eigenvalues, and the sum of their squares.
+inline void invariants(const TensorBlock& t, int n,
+                       double* trace, double* b, double* det, double* s)
+{
+  const double* xx = t.c[0]; const double* xy = t.c[1];
+  const double* xz = t.c[2]; const double* yy = t.c[3];
+  const double* yz = t.c[4]; const double* zz = t.c[5];
+
+  for (int i = 0; i < n; i++)
+  {
+    trace[i] = xx[i] + yy[i] + zz[i];
+    b[i] = xx[i]*yy[i] + xx[i]*zz[i] + yy[i]*zz[i]
+      - xy[i]*xy[i] - xz[i]*xz[i] - yz[i]*yz[i];
+    det[i] = xx[i]*(yy[i]*zz[i]-yz[i]*yz[i]) - xy[i]*(xy[i]*zz[i]-yz[i]*xz[i])
+      + xz[i]*(xy[i]*yz[i]-yy[i]*xz[i]);
+    s[i] = xx[i]*xx[i] + yy[i]*yy[i] + zz[i]*zz[i]
+      + 2.0*(xy[i]*xy[i] + xz[i]*xz[i] + yz[i]*yz[i]);
+  }
+}
+
+// Eigenvalues of the symmetric tensors in a block in descending order, using
+// the closed form solution of the characteristic polynomial. The loop has no
+// branches, isotropic tensors are handled by clamping.
+inline void eigenvalues(const TensorBlock& t, int n,
+                        double* e1, double* e2, double* e3)
+{
+  const double* xx = t.c[0]; const double* xy = t.c[1];
+  const double* xz = t.c[2]; const double* yy = t.c[3];
+  const double* yz = t.c[4]; const double* zz = t.c[5];
+  const double third = 1.0/3.0;
+  const double shift = 2.0*M_PI/3.0;
+
+  for (int i = 0; i < n; i++)
+  {
+    const double q = (xx[i]+yy[i]+zz[i])*third;
+    const double a = xx[i]-q, d = yy[i]-q, f = zz[i]-q;
+    const double off = xy[i]*xy[i] + xz[i]*xz[i] + yz[i]*yz[i];
+    const double p2 = a*a + d*d + f*f + 2.0*off;
+    const double p = std::sqrt(p2/6.0);
+    const double ip = (p > 0.0) ? 1.0/p : 0.0;
+
+    // Half the determinant of (T-qI)/p
+    double r = 0.5*ip*ip*ip*(a*(d*f-yz[i]*yz[i]) - xy[i]*(xy[i]*f-yz[i]*xz[i])
+      + xz[i]*(xy[i]*yz[i]-d*xz[i]));
+    r = (r < -1.0) ? -1.0 : ((r > 1.0) ? 1.0 : r);
+
+    const double phi = std::acos(r)*third;
+    e1[i] = q + 2.0*p*std::cos(phi);
+    e3[i] = q + 2.0*p*std::cos(phi+shift);
+    e2[i] = 3.0*q - e1[i] - e3[i];
+  }
+}
+
+// Applies expr(trace, b, det, s) to the invariants of every tensor in the
+// interleaved input and writes one scalar per tensor. The functions that only
+// depend on the invariants need no eigen decomposition.
+template<class Expr>
+inline void map_invariants(double* result, const double* tensors,
+                           SCIRun::size_type size, Expr expr)
+{
+  TensorBlock t;
+  Block<4> I;
+  for (SCIRun::size_type offset = 0; offset < size; offset += BLOCK_SIZE)
+  {
+    int n = block_length(offset,size);
+    t.load(tensors+6*offset,n);
+    invariants(t,n,I.c[0],I.c[1],I.c[2],I.c[3]);
+    double* r = result+offset;
+    for (int i = 0; i < n; i++) r[i] = expr(I.c[0][i],I.c[1][i],I.c[2][i],I.c[3][i]);
+  }
+}
+
+// Applies expr(e1, e2, e3) to the eigenvalues of every tensor in the
+// interleaved input and writes one scalar per tensor.
+template<class Expr>
+inline void map_eigenvalues(double* result, const double* tensors,
+                            SCIRun::size_type size, Expr expr)
+{
+  TensorBlock t;
+  Block<3> e;
+  for (SCIRun::size_type offset = 0; offset < size; offset += BLOCK_SIZE)
+  {
+    int n = block_length(offset,size);
+    t.load(tensors+6*offset,n);
+    eigenvalues(t,n,e.c[0],e.c[1],e.c[2]);
+    double* r = result+offset;
+    for (int i = 0; i < n; i++) r[i] = expr(e.c[0][i],e.c[1][i],e.c[2][i]);
+  }
+}
+
+}
+}
+
+#endif
@@ -30,6 +30,9 @@
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Logging/ConsoleLogger.h>
 
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <sstream>
+
 namespace SCIRun {
 
   using namespace SCIRun::Core::Datatypes;
@@ -132,33 +135,52 @@ NewLinAlgEngine::run()
 {
   std::string error_str;
 
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
   // Link everything together
   std::string full_expression = pre_expression_+";"+expression_+";"+post_expression_;
 
-  // Parse the full expression
-  if(!(parse(pprogram_,full_expression,error_str)))
-  {
-    pr_->error(error_str);
-    return (false);
-  }
-
-  // Get the catalog with all possible functions
-  ParserFunctionCatalogHandle catalog = LinAlgFunctionCatalog::get_catalog();
+  // Reuse the optimized program if the expressions and variables are known
+  std::string key = ParserProgramCache::make_key("LinAlg",pprogram_,full_expression);
+  ParserProgramHandle cached;
+  used_cached_program_ = ParserProgramCache::instance().find(key,cached);
 
-  // Validate the expressions
-  if (!(validate(pprogram_,catalog,error_str)))
+  if (used_cached_program_)
   {
-    pr_->error(error_str);
-    return (false);
+    pprogram_ = cached;
   }
-
-  // Optimize the expressions
-  if (!(optimize(pprogram_,error_str)))
+  else
   {
-    pr_->error(error_str);
-    return (false);
+    // Parse the full expression
+    if(!(parse(pprogram_,full_expression,error_str)))
+    {
+      pr_->error(error_str);
+      return (false);
+    }
+
+    // Get the catalog with all possible functions
+    ParserFunctionCatalogHandle catalog = LinAlgFunctionCatalog::get_catalog();
+
+    // Validate the expressions
+    if (!(validate(pprogram_,catalog,error_str)))
+    {
+      pr_->error(error_str);
+      return (false);
+    }
+
+    // Optimize the expressions
+    if (!(optimize(pprogram_,error_str)))
+    {
+      pr_->error(error_str);
+      return (false);
+    }
+
+    ParserProgramCache::instance().insert(key,pprogram_);
   }
 
+  boost::posix_time::ptime parsed = boost::posix_time::microsec_clock::universal_time();
+  parse_time_ = (parsed-start).total_microseconds()*1e-6;
+
   // DEBUG CALL
 #ifdef DEBUG
 //  pprogram_->print();
@@ -181,10 +203,21 @@ NewLinAlgEngine::run()
     return (false);
   }
 
+  evaluation_time_ = (boost::posix_time::microsec_clock::universal_time()-parsed).total_microseconds()*1e-6;
+
   return (true);
 }
 
 
+std::string
+NewLinAlgEngine::timing_report() const
+{
+  std::ostringstream oss;
+  oss << "parse " << parse_time_ << "s"
+      << (used_cached_program_ ? " (cached)" : "")
+      << ", evaluation " << evaluation_time_ << "s";
+  return (oss.str());
+}
 
 void
 NewLinAlgEngine::clear()
@@ -193,6 +226,9 @@ NewLinAlgEngine::clear()
   pprogram_.reset();
   mprogram_.reset();
 
+  used_cached_program_ = false;
+  parse_time_ = evaluation_time_ = 0.0;
+
   pre_expression_.clear();
   expression_.clear();
   post_expression_.clear();
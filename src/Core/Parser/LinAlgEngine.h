@@ -73,6 +73,13 @@ class SCISHARE NewLinAlgEngine : public Parser, public LinAlgInterpreter
     // Run the expressions in parallel
     bool run();
 
+    // Wall clock time of the parsing and of the translation and evaluation
+    // stages of the last run, a cached program skips the parsing stage
+    bool   used_cached_program() const { return (used_cached_program_); }
+    double parse_time() const { return (parse_time_); }
+    double evaluation_time() const { return (evaluation_time_); }
+    std::string timing_report() const;
+
     // Extract handles to the results
     bool get_matrix(const std::string& name, Core::Datatypes::MatrixHandle& matrix);
 
@@ -105,6 +112,10 @@ class SCISHARE NewLinAlgEngine : public Parser, public LinAlgInterpreter
     // the expression tree
 
     std::vector<OutputMatrix>    matrixdata_;
+
+    bool   used_cached_program_;
+    double parse_time_;
+    double evaluation_time_;
 };
 
 }
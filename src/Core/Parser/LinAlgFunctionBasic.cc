@@ -47,12 +47,12 @@ using namespace SCIRun::Core::Datatypes::MatrixMath;
 // Add functions
 
 // Add scalar + scalar
-bool add_ss(SCIRun::LinAlgProgramCode& pc, std::string& err)
+bool add_matrices(const MatrixHandle& m1, const MatrixHandle& m2, MatrixHandle& m0, std::string& err)
 {
   err = "";
-  MatrixHandle* data0 = pc.get_handle(0);
-  MatrixHandle* data1 = pc.get_handle(1);
-  MatrixHandle* data2 = pc.get_handle(2);
+  MatrixHandle* data0 = &m0;
+  const MatrixHandle* data1 = &m1;
+  const MatrixHandle* data2 = &m2;
 
   if (!(*data1)) return (false);
   if (!(*data2)) return (false);
@@ -98,16 +98,20 @@ bool add_ss(SCIRun::LinAlgProgramCode& pc, std::string& err)
   return *data0 != nullptr;
 }
 
+bool add_ss(SCIRun::LinAlgProgramCode& pc, std::string& err)
+{
+  return (add_matrices(pc.handle(1),pc.handle(2),pc.handle(0),err));
+}
+
 //--------------------------------------------------------------------------
 // Sub functions
 
-bool sub_ss(SCIRun::LinAlgProgramCode& pc, std::string& err)
+bool subtract_matrices(const MatrixHandle& m1, const MatrixHandle& m2, MatrixHandle& m0, std::string& err)
 {
   err = "";
-
-  MatrixHandle* data0 = pc.get_handle(0);
-  MatrixHandle* data1 = pc.get_handle(1);
-  MatrixHandle* data2 = pc.get_handle(2);
+  MatrixHandle* data0 = &m0;
+  const MatrixHandle* data1 = &m1;
+  const MatrixHandle* data2 = &m2;
 
   if (!(*data1)) return (false);
   if (!(*data2)) return (false);
@@ -153,15 +157,19 @@ bool sub_ss(SCIRun::LinAlgProgramCode& pc, std::string& err)
   return *data0 != nullptr;
 }
 
+bool sub_ss(SCIRun::LinAlgProgramCode& pc, std::string& err)
+{
+  return (subtract_matrices(pc.handle(1),pc.handle(2),pc.handle(0),err));
+}
+
 //--------------------------------------------------------------------------
 // Neg functions
 
-bool neg_s(SCIRun::LinAlgProgramCode& pc, std::string& err)
+bool negate_matrix(const MatrixHandle& m1, MatrixHandle& m0, std::string& err)
 {
   err = "";
-
-  MatrixHandle* data0 = pc.get_handle(0);
-  MatrixHandle* data1 = pc.get_handle(1);
+  MatrixHandle* data0 = &m0;
+  const MatrixHandle* data1 = &m1;
 
   if (!(*data1)) return (false);
   if ((*data1)->empty()) return (false);
@@ -173,18 +181,22 @@ bool neg_s(SCIRun::LinAlgProgramCode& pc, std::string& err)
   return *data0 != nullptr;
 }
 
+bool neg_s(SCIRun::LinAlgProgramCode& pc, std::string& err)
+{
+  return (negate_matrix(pc.handle(1),pc.handle(0),err));
+}
+
 
 //--------------------------------------------------------------------------
 // Mult functions
 
 
-bool mult_ss(SCIRun::LinAlgProgramCode& pc, std::string& err)
+bool multiply_matrices(const MatrixHandle& m1, const MatrixHandle& m2, MatrixHandle& m0, std::string& err)
 {
   err = "";
-
-  MatrixHandle* data0 = pc.get_handle(0);
-  MatrixHandle* data1 = pc.get_handle(1);
-  MatrixHandle* data2 = pc.get_handle(2);
+  MatrixHandle* data0 = &m0;
+  const MatrixHandle* data1 = &m1;
+  const MatrixHandle* data2 = &m2;
 
   if (!(*data1)) return (false);
   if (!(*data2)) return (false);
@@ -229,6 +241,11 @@ bool mult_ss(SCIRun::LinAlgProgramCode& pc, std::string& err)
   return *data0 != nullptr;
 }
 
+bool mult_ss(SCIRun::LinAlgProgramCode& pc, std::string& err)
+{
+  return (multiply_matrices(pc.handle(1),pc.handle(2),pc.handle(0),err));
+}
+
 
 bool mmult_ss(SCIRun::LinAlgProgramCode& pc, std::string& err)
 {
@@ -759,9 +776,195 @@ bool assign_range_ssssss(SCIRun::LinAlgProgramCode& pc, std::string& err)
 #endif
 
 
+//--------------------------------------------------------------------------
+// Fused functions
+
+namespace {
+
+bool is_scalar(const MatrixHandle& m)
+{
+  return ((m->nrows() == 1)&&(m->ncols() == 1)&&(m->get_dense_size() == 1));
+}
+
+bool chain_product(const std::vector<MatrixHandle>& factors,
+                   const std::vector<size_t>& split, size_t n,
+                   size_t i, size_t j, MatrixHandle& product, std::string& err)
+{
+  if (i == j) { product = factors[i]; return (true); }
+
+  size_t k = split[i*n+j];
+  MatrixHandle left, right;
+  if (!(chain_product(factors,split,n,i,k,left,err))) return (false);
+  if (!(chain_product(factors,split,n,k+1,j,right,err))) return (false);
+  return (multiply_matrices(left,right,product,err));
+}
+
+}
+
+bool nop(SCIRun::LinAlgProgramCode&, std::string& err)
+{
+  err = "";
+  return (true);
+}
+
+bool mult_chain(SCIRun::LinAlgProgramCode& pc, std::string& err)
+{
+  err = "";
+
+  size_t num_operands = pc.num_handles()-1;
+  std::vector<MatrixHandle> factors;
+  double scale = 1.0;
+  bool scaled = false;
+
+  for (size_t j = 1; j <= num_operands; j++)
+  {
+    const MatrixHandle& m = pc.handle(j);
+    if (!m) return (false);
+    if (is_scalar(m)) { scale *= m->get(0,0); scaled = true; }
+    else factors.push_back(m);
+  }
+
+  if (factors.empty())
+  {
+    pc.handle(0).reset(new DenseMatrix(1, 1, scale));
+    return (true);
+  }
+
+  size_t n = factors.size();
+  bool compatible = true;
+  for (size_t j = 0; j+1 < n; j++)
+  {
+    if (factors[j]->ncols() != factors[j+1]->nrows()) compatible = false;
+  }
 
+  MatrixHandle product;
+  if (!compatible)
+  {
+    // An intermediate product is a scalar, evaluate from left to right as
+    // the separate products would have done
+    product = pc.handle(1);
+    for (size_t j = 2; j <= num_operands; j++)
+    {
+      MatrixHandle next;
+      if (!(multiply_matrices(product,pc.handle(j),next,err))) return (false);
+      product = next;
+    }
+    pc.handle(0) = product;
+    return (product != nullptr);
+  }
 
+  // Matrix chain ordering: cost[i][j] is the number of multiplications needed
+  // for the product of factors i to j
+  std::vector<double> dims(n+1);
+  for (size_t j = 0; j < n; j++) dims[j] = static_cast<double>(factors[j]->nrows());
+  dims[n] = static_cast<double>(factors[n-1]->ncols());
 
+  std::vector<double> cost(n*n,0.0);
+  std::vector<size_t> split(n*n,0);
+  for (size_t len = 2; len <= n; len++)
+  {
+    for (size_t i = 0; i+len <= n; i++)
+    {
+      size_t j = i+len-1;
+      cost[i*n+j] = -1.0;
+      for (size_t k = i; k < j; k++)
+      {
+        double c = cost[i*n+k] + cost[(k+1)*n+j] + dims[i]*dims[k+1]*dims[j+1];
+        if (cost[i*n+j] < 0.0 || c < cost[i*n+j]) { cost[i*n+j] = c; split[i*n+j] = k; }
+      }
+    }
+  }
+
+  if (!(chain_product(factors,split,n,0,n-1,product,err))) return (false);
+
+  if (scaled)
+  {
+    MatrixHandle factor(new DenseMatrix(1, 1, scale));
+    return (multiply_matrices(factor,product,pc.handle(0),err));
+  }
+
+  pc.handle(0) = product;
+  return (product != nullptr);
+}
+
+bool linear_combination(SCIRun::LinAlgProgramCode& pc, std::string& err)
+{
+  err = "";
+
+  size_t num_operands = pc.num_handles()-1;
+  double offset = 0.0;
+  size_type nrows = -1, ncols = -1;
+  bool dense = true;
+
+  for (size_t j = 1; j <= num_operands; j++)
+  {
+    const MatrixHandle& m = pc.handle(j);
+    if (!m) return (false);
+    if (is_scalar(m))
+    {
+      offset += pc.get_parameter(j-1)*m->get(0,0);
+    }
+    else if (!(matrixIs::dense(m)||matrixIs::column(m)))
+    {
+      dense = false;
+    }
+    else if (nrows < 0)
+    {
+      nrows = m->nrows(); ncols = m->ncols();
+    }
+    else if (static_cast<size_type>(m->nrows()) != nrows || static_cast<size_type>(m->ncols()) != ncols)
+    {
+      dense = false;
+    }
+  }
+
+  if (dense)
+  {
+    // Accumulate all terms into one matrix
+    if (nrows < 0)
+    {
+      pc.handle(0).reset(new DenseMatrix(1, 1, offset));
+      return (true);
+    }
+
+    DenseMatrixHandle sum(new DenseMatrix(nrows, ncols, offset));
+    for (size_t j = 1; j <= num_operands; j++)
+    {
+      const MatrixHandle& m = pc.handle(j);
+      if (is_scalar(m)) continue;
+      if (pc.get_parameter(j-1) > 0.0) *sum += *convertMatrix::toDense(m);
+      else *sum -= *convertMatrix::toDense(m);
+    }
+    pc.handle(0) = sum;
+    return (true);
+  }
+
+  // Sparse terms or unequal sizes, add one term at a time
+  MatrixHandle result = pc.handle(1);
+  if (pc.get_parameter(0) < 0.0)
+  {
+    MatrixHandle negated;
+    if (!(negate_matrix(result,negated,err))) return (false);
+    result = negated;
+  }
+
+  for (size_t j = 2; j <= num_operands; j++)
+  {
+    MatrixHandle next;
+    if (pc.get_parameter(j-1) > 0.0)
+    {
+      if (!(add_matrices(result,pc.handle(j),next,err))) return (false);
+    }
+    else
+    {
+      if (!(subtract_matrices(result,pc.handle(j),next,err))) return (false);
+    }
+    result = next;
+  }
+
+  pc.handle(0) = result;
+  return (result != nullptr);
+}
 
 
 } // end namsespace
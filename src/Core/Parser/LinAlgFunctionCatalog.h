@@ -77,4 +77,18 @@ void SCISHARE InsertScalarLinAlgFunctionCatalog(LinAlgFunctionCatalogHandle& cat
 
 }
 
+//-----------------------------------------------------------------------------
+// Functions that are not in the catalog, the interpreter substitutes these for
+// trees of products and of sums. Handle 0 is the output, the other handles are
+// the operands; linear_combination takes the sign of each operand from the
+// parameters. Functions merged into another one are replaced by nop.
+
+namespace LinAlgFunctions {
+
+bool nop(SCIRun::LinAlgProgramCode& pc, std::string& err);
+bool mult_chain(SCIRun::LinAlgProgramCode& pc, std::string& err);
+bool linear_combination(SCIRun::LinAlgProgramCode& pc, std::string& err);
+
+}
+
 #endif
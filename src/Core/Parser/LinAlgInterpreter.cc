@@ -407,9 +407,148 @@ namespace SCIRun {
       mprogram->set_single_program_code(j, pc);
     }
 
+    if (fuse_) fuse(pprogram, mprogram);
+
     return (true);
   }
 
+  // -------------------------------------------------------------------------
+  // Merge trees of products and sums
+
+  namespace {
+
+  // Scalar variables are identified by their part of the program and number
+  typedef std::pair<int, int> VariableKey;
+
+  VariableKey variable_key(const ParserScriptVariableHandle& var)
+  {
+    if (var->get_type() != "S") return (VariableKey(-1, -1));
+    if (var->get_flags() & SCRIPT_SINGLE_VAR_E) return (VariableKey(1, var->get_var_number()));
+    if (var->get_flags() & SCRIPT_CONST_VAR_E) return (VariableKey(0, var->get_var_number()));
+    return (VariableKey(-1, -1));
+  }
+
+  // 1 for products, 2 for sums, 0 for anything that cannot be merged
+  int function_family(const ParserScriptFunctionHandle& fhandle)
+  {
+    const std::string id = fhandle->get_function()->get_function_id();
+    if (id == "mult$S:S") return (1);
+    if (id == "add$S:S" || id == "sub$S:S" || id == "neg$S") return (2);
+    return (0);
+  }
+
+  class FunctionFuser {
+    public:
+      FunctionFuser(std::vector<ParserScriptFunctionHandle>& functions,
+                    std::vector<LinAlgProgramCode*>& code,
+                    std::map<VariableKey, int>& uses) :
+        functions_(functions), code_(code), uses_(uses),
+        absorbed_(functions.size(), false)
+      {
+        for (size_t j = 0; j < functions_.size(); j++)
+        {
+          VariableKey key = variable_key(functions_[j]->get_output_var());
+          if (key.first >= 0) producers_[key] = j;
+        }
+      }
+
+      void run()
+      {
+        // Start at the end, so the outermost function of each tree absorbs
+        // the others
+        for (size_t j = functions_.size(); j-- > 0;)
+        {
+          if (absorbed_[j]) continue;
+          int family = function_family(functions_[j]);
+          if (family == 0) continue;
+
+          operands_.clear();
+          signs_.clear();
+          merged_.clear();
+          flatten(j, family, 1.0);
+          if (merged_.empty()) continue;
+
+          LinAlgProgramCode pc(family == 1 ? LinAlgFunctions::mult_chain :
+            LinAlgFunctions::linear_combination);
+          pc.set_handle(0, code_[j]->get_handle(0));
+          for (size_t i = 0; i < operands_.size(); i++) pc.set_handle(i + 1, operands_[i]);
+          pc.set_parameters(signs_);
+          *(code_[j]) = pc;
+
+          for (size_t i = 0; i < merged_.size(); i++)
+            code_[merged_[i]]->set_function(LinAlgFunctions::nop);
+        }
+      }
+
+    private:
+      void flatten(size_t j, int family, double sign)
+      {
+        const std::string id = functions_[j]->get_function()->get_function_id();
+        size_t num_input_vars = functions_[j]->num_input_vars();
+        for (size_t i = 0; i < num_input_vars; i++)
+        {
+          double s = sign;
+          if ((id == "sub$S:S" && i == 1) || id == "neg$S") s = -sign;
+
+          // Intermediate results that only feed into this function are merged
+          VariableKey key = variable_key(functions_[j]->get_input_var(i));
+          std::map<VariableKey, size_t>::iterator it = producers_.find(key);
+          if (it != producers_.end() && it->second < j && !absorbed_[it->second] &&
+              uses_[key] == 1 && function_family(functions_[it->second]) == family)
+          {
+            absorbed_[it->second] = true;
+            merged_.push_back(it->second);
+            flatten(it->second, family, s);
+          }
+          else
+          {
+            operands_.push_back(code_[j]->get_handle(i + 1));
+            signs_.push_back(s);
+          }
+        }
+      }
+
+      std::vector<ParserScriptFunctionHandle>& functions_;
+      std::vector<LinAlgProgramCode*>& code_;
+      std::map<VariableKey, int>& uses_;
+      std::map<VariableKey, size_t> producers_;
+      std::vector<bool> absorbed_;
+
+      std::vector<MatrixHandle*> operands_;
+      std::vector<double> signs_;
+      std::vector<size_t> merged_;
+  };
+
+  }
+
+  void LinAlgInterpreter::fuse(ParserProgramHandle& pprogram, LinAlgProgramHandle& mprogram)
+  {
+    std::vector<ParserScriptFunctionHandle> const_functions(pprogram->num_const_functions());
+    std::vector<ParserScriptFunctionHandle> single_functions(pprogram->num_single_functions());
+    std::vector<LinAlgProgramCode*> const_code(const_functions.size());
+    std::vector<LinAlgProgramCode*> single_code(single_functions.size());
+    std::map<VariableKey, int> uses;
+
+    for (size_t j = 0; j < const_functions.size(); j++)
+    {
+      pprogram->get_const_function(j, const_functions[j]);
+      const_code[j] = &(mprogram->get_const_program_code(j));
+      for (size_t i = 0; i < const_functions[j]->num_input_vars(); i++)
+        uses[variable_key(const_functions[j]->get_input_var(i))]++;
+    }
+
+    for (size_t j = 0; j < single_functions.size(); j++)
+    {
+      pprogram->get_single_function(j, single_functions[j]);
+      single_code[j] = &(mprogram->get_single_program_code(j));
+      for (size_t i = 0; i < single_functions[j]->num_input_vars(); i++)
+        uses[variable_key(single_functions[j]->get_input_var(i))]++;
+    }
+
+    FunctionFuser(const_functions, const_code, uses).run();
+    FunctionFuser(single_functions, single_code, uses).run();
+  }
+
   bool LinAlgInterpreter::run(LinAlgProgramHandle& mprogram, std::string& error)
   {
     // This does not optimally make use of the parser, in principal the
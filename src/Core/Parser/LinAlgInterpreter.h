@@ -131,6 +131,16 @@ class SCISHARE LinAlgProgramCode {
     inline Core::Datatypes::MatrixHandle& handle(size_t j)
       { return (*(variables_[j])); }
 
+    inline size_t num_handles() const
+      { return (variables_.size()); }
+
+    // Constant coefficients for functions that are generated by the
+    // interpreter instead of by the parser
+    inline void set_parameters(const std::vector<double>& parameters)
+      { parameters_ = parameters; }
+    inline double get_parameter(size_t j) const
+      { return (parameters_[j]); }
+
     // Run this code segment
     // Run time errors are reported by returning a false,
     // After which we can look in the parser script to see
@@ -152,6 +162,8 @@ class SCISHARE LinAlgProgramCode {
     // This way one can allocate new matrices and remove them when the handle
     // is no loner used. The handles are stored in a different array
     std::vector<Core::Datatypes::MatrixHandle*> variables_;
+
+    std::vector<double> parameters_;
 };
 
 
@@ -240,6 +252,11 @@ class SCISHARE LinAlgProgram {
     void set_single_program_code(size_t j, LinAlgProgramCode& pc)
       { single_functions_[j] = pc; }
 
+    LinAlgProgramCode& get_const_program_code(size_t j)
+      { return (const_functions_[j]); }
+    LinAlgProgramCode& get_single_program_code(size_t j)
+      { return (single_functions_[j]); }
+
     // Code to find the pointers that are given for sources and sinks
     bool find_source(const std::string& name,  LinAlgProgramSource& ps) const;
     bool find_sink(const std::string& name,  LinAlgProgramSource& ps) const;
@@ -271,6 +288,8 @@ class SCISHARE LinAlgProgram {
 class SCISHARE LinAlgInterpreter {
 
   public:
+    LinAlgInterpreter() : fuse_(true) {}
+
     // The interpreter Creates executable code from the parsed code
     // The first step is setting the data sources and sinks
 
@@ -303,10 +322,23 @@ class SCISHARE LinAlgInterpreter {
                    LinAlgProgramHandle& mprogram,
                    std::string& error);
 
+    // Products of products and sums of sums whose intermediate results are
+    // not used anywhere else are evaluated as one function. Products are
+    // evaluated in the order that needs the fewest operations for the sizes
+    // of the matrices and dense sums are accumulated into one matrix, so
+    // the intermediate matrices are never stored. On by default.
+    void set_fusion(bool fuse) { fuse_ = fuse; }
+    bool get_fusion() const { return (fuse_); }
+
     //------------------------------------------------------------------------
     // Step 3: Run the code
 
     bool run(LinAlgProgramHandle& mprogram,std::string& error);
+
+  private:
+    void fuse(ParserProgramHandle& pprogram, LinAlgProgramHandle& mprogram);
+
+    bool fuse_;
 };
 
 }
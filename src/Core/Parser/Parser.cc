@@ -30,6 +30,7 @@
 #include <Core/Parser/Parser.h> 
 #include <Core/Datatypes/Legacy/Base/Types.h>
 #include <iostream>
+#include <sstream>
 #include <sci_debug.h>
 #include <boost/math/constants/constants.hpp>
 #include <boost/algorithm/string.hpp>
@@ -3200,3 +3201,97 @@ ParserProgram::get_sequential_function(size_t j,ParserScriptFunctionHandle& hand
   handle = sequential_functions_[j];
   return (true);
 } 
+
+
+ParserProgramCache::ParserProgramCache() :
+  lock_("ParserProgramCache"),
+  max_size_(64)
+{
+}
+
+ParserProgramCache&
+ParserProgramCache::instance()
+{
+  static ParserProgramCache cache;
+  return (cache);
+}
+
+std::string
+ParserProgramCache::make_key(const std::string& engine,
+                             ParserProgramHandle program,
+                             const std::string& expressions)
+{
+  std::ostringstream key;
+  key << engine << "\n";
+  if (program)
+  {
+    ParserVariableList var_list;
+    program->get_input_variables(var_list);
+    for (ParserVariableList::iterator it = var_list.begin(); it != var_list.end(); ++it)
+    {
+      key << "I:" << (*it).first << ":" << (*it).second->get_type() << ":"
+          << (*it).second->get_flags() << "\n";
+    }
+    program->get_output_variables(var_list);
+    for (ParserVariableList::iterator it = var_list.begin(); it != var_list.end(); ++it)
+    {
+      key << "O:" << (*it).first << ":" << (*it).second->get_type() << ":"
+          << (*it).second->get_flags() << "\n";
+    }
+  }
+  key << expressions;
+  return (key.str());
+}
+
+bool
+ParserProgramCache::find(const std::string& key, ParserProgramHandle& program)
+{
+  Core::Thread::Guard g(lock_.get());
+  std::list<std::pair<std::string,ParserProgramHandle> >::iterator it = programs_.begin();
+  for (; it != programs_.end(); ++it)
+  {
+    if ((*it).first == key)
+    {
+      // Move to the front, the back is dropped first
+      programs_.splice(programs_.begin(),programs_,it);
+      program = programs_.front().second;
+      return (true);
+    }
+  }
+  return (false);
+}
+
+void
+ParserProgramCache::insert(const std::string& key, ParserProgramHandle program)
+{
+  Core::Thread::Guard g(lock_.get());
+  std::list<std::pair<std::string,ParserProgramHandle> >::iterator it = programs_.begin();
+  for (; it != programs_.end(); ++it)
+  {
+    if ((*it).first == key) { programs_.erase(it); break; }
+  }
+  programs_.push_front(std::make_pair(key,program));
+  while (programs_.size() > max_size_) programs_.pop_back();
+}
+
+void
+ParserProgramCache::clear()
+{
+  Core::Thread::Guard g(lock_.get());
+  programs_.clear();
+}
+
+size_t
+ParserProgramCache::size()
+{
+  Core::Thread::Guard g(lock_.get());
+  return (programs_.size());
+}
+
+void
+ParserProgramCache::set_max_size(size_t max_size)
+{
+  Core::Thread::Guard g(lock_.get());
+  max_size_ = max_size;
+  while (programs_.size() > max_size_) programs_.pop_back();
+}
@@ -901,6 +901,45 @@ class SCISHARE Parser {
 
 };
 
+
+//-----------------------------------------------------------------------------
+// Cache for parsed programs
+
+// Parsing, validating and optimizing a program only depends on the
+// expressions and on the names, types and flags of the variables that were
+// declared before parsing. Engines that evaluate the same expressions many
+// times, e.g. in a loop or a parameter sweep, look the optimized program up
+// here and only bind new data to it. Programs in the cache are shared and
+// should not be altered once they have been inserted.
+
+class SCISHARE ParserProgramCache {
+  public:
+    static ParserProgramCache& instance();
+
+    // Key for a program whose variables have been declared, but that has not
+    // been parsed yet. The engine name separates programs for different
+    // function catalogs.
+    static std::string make_key(const std::string& engine,
+                                ParserProgramHandle program,
+                                const std::string& expressions);
+
+    bool find(const std::string& key, ParserProgramHandle& program);
+    void insert(const std::string& key, ParserProgramHandle program);
+
+    void clear();
+    size_t size();
+
+    // Maximum number of programs, the least recently used ones are dropped
+    void set_max_size(size_t max_size);
+
+  private:
+    ParserProgramCache();
+
+    Core::Thread::Mutex lock_;
+    size_t max_size_;
+    std::list<std::pair<std::string,ParserProgramHandle> > programs_;
+};
+
 }
 
 #endif
@@ -31,8 +31,13 @@
 
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Parser/ArrayMathEngine.h>
+#include <Core/Parser/LinAlgEngine.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Eigen/Eigenvalues>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Geometry;
@@ -1577,6 +1582,220 @@ TEST_F(BasicParserTests, CreateFieldData_fracanisotropy)
 
 */
 
+namespace
+{
+  std::vector<double> evaluateOnLatVol(FieldHandle field, const std::string& function,
+    bool fuse, bool& fused, bool withLocation = false)
+  {
+    NewArrayMathEngine engine;
+    engine.set_fusion(fuse);
+    if (withLocation)
+    {
+      EXPECT_TRUE(engine.add_input_fielddata_location("POS",field,1));
+    }
+    EXPECT_TRUE(engine.add_input_fielddata_coordinates("X","Y","Z",field,1));
+    EXPECT_TRUE(engine.add_output_fielddata("RESULT",field,1,"double"));
+    EXPECT_TRUE(engine.add_index("INDEX"));
+    EXPECT_TRUE(engine.add_size("SIZE"));
+    EXPECT_TRUE(engine.add_expressions(function));
+    EXPECT_TRUE(engine.run());
+    fused = engine.is_fused();
+
+    std::vector<double> values;
+    FieldHandle ofield;
+    engine.get_field("RESULT",ofield);
+    if (ofield) ofield->vfield()->get_values(values);
+    return values;
+  }
+}
+
+TEST_F(BasicParserTests, FusedKernelMatchesInterpreter)
+{
+  // The number of nodes is not a multiple of the buffer size
+  FieldHandle field(CreateEmptyLatVol(11,12,13));
+  const std::string function =
+    "A = X*X + Y*Y; B = select(X > 0, sqrt(A), -abs(Z));"
+    "RESULT = B + max(sin(X), cos(Y))*2 - INDEX/SIZE + pow(2, Z) + median(X, Y, Z)"
+    " + ramp(Y, -0.5, 0.5) + rem(INDEX, 7) + and(X > Y, Z <= 0);";
+
+  bool fused, interpreted;
+  auto expected = evaluateOnLatVol(field, function, false, interpreted);
+  auto actual = evaluateOnLatVol(field, function, true, fused);
+
+  EXPECT_FALSE(interpreted);
+  EXPECT_TRUE(fused);
+  ASSERT_EQ(11*12*13, actual.size());
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i)
+    EXPECT_DOUBLE_EQ(expected[i], actual[i]);
+}
+
+TEST_F(BasicParserTests, FusedKernelFallsBackToInterpreter)
+{
+  FieldHandle field(CreateEmptyLatVol(5,6,7));
+  const std::string function = "RESULT = dot(POS, POS) + X;";
+
+  bool fused, interpreted;
+  auto expected = evaluateOnLatVol(field, function, false, interpreted, true);
+  auto actual = evaluateOnLatVol(field, function, true, fused, true);
+
+  EXPECT_FALSE(fused);
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i)
+    EXPECT_DOUBLE_EQ(expected[i], actual[i]);
+}
+
+TEST_F(BasicParserTests, VectorAndTensorBlockKernels)
+{
+  // 1716 nodes, the buffers end with partial blocks
+  FieldHandle field(CreateEmptyLatVol(11,12,13));
+  const std::string tensor = "T = tensor(X, Y, Z, X*Y+2, Y-Z, 3+Z*Z);";
+  const std::string vectors = "V = vector(X, Y, Z); W = vector(Y, Z+1, X);";
+  bool fused;
+  auto evaluate = [&](const std::string& result)
+  {
+    return evaluateOnLatVol(field, tensor + vectors + "RESULT = " + result + ";", true, fused);
+  };
+
+  auto l1 = evaluate("eigval1(T)");
+  auto l2 = evaluate("eigval2(T)");
+  auto l3 = evaluate("eigval3(T)");
+  auto trace = evaluate("trace(T)");
+  auto det = evaluate("det(T)");
+  auto b = evaluate("B(T)");
+  auto frobenius2 = evaluate("frobenius2(T)");
+  auto vectorErrors = evaluate("abs(dot(cross(V,W),V)) + abs(dot(cross(V,W),W)) + abs(norm(normalize(W))-1)"
+    " + abs(dot(V,W) - (X*Y + Y*(Z+1) + Z*X))");
+  ASSERT_EQ(11u*12u*13u, l1.size());
+
+  // Reference eigenvalues from an independent solver, in ascending order
+  VMesh* mesh = field->vmesh();
+  for (size_t i = 0; i < l1.size(); ++i)
+  {
+    Point p;
+    mesh->get_center(p, VMesh::Node::index_type(i));
+    const double x = p.x(), y = p.y(), z = p.z();
+    Eigen::Matrix3d t;
+    t << x, y, z,
+         y, x*y+2, y-z,
+         z, y-z, 3+z*z;
+    Eigen::Vector3d e = Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d>(t, Eigen::EigenvaluesOnly).eigenvalues();
+
+    EXPECT_NEAR(e[2], l1[i], 1e-8) << " at " << i;
+    EXPECT_NEAR(e[1], l2[i], 1e-8) << " at " << i;
+    EXPECT_NEAR(e[0], l3[i], 1e-8) << " at " << i;
+    EXPECT_NEAR(e.sum(), trace[i], 1e-10) << " at " << i;
+    EXPECT_NEAR(e.prod(), det[i], 1e-8) << " at " << i;
+    EXPECT_NEAR(e[0]*e[1] + e[0]*e[2] + e[1]*e[2], b[i], 1e-8) << " at " << i;
+    EXPECT_NEAR(e.squaredNorm(), frobenius2[i], 1e-8) << " at " << i;
+    EXPECT_NEAR(0.0, vectorErrors[i], 1e-10) << " at " << i;
+  }
+}
+
+namespace
+{
+  bool runCached(FieldHandle field, const std::string& function, std::vector<double>& values)
+  {
+    NewArrayMathEngine engine;
+    EXPECT_TRUE(engine.add_input_fielddata("DATA",field));
+    EXPECT_TRUE(engine.add_input_fielddata_coordinates("X","Y","Z",field,1));
+    EXPECT_TRUE(engine.add_output_fielddata("RESULT",field,1,"double"));
+    EXPECT_TRUE(engine.add_expressions(function));
+    EXPECT_TRUE(engine.run());
+    EXPECT_LE(0.0, engine.parse_time());
+    EXPECT_LE(0.0, engine.setup_time());
+    EXPECT_LE(0.0, engine.evaluation_time());
+
+    FieldHandle ofield;
+    engine.get_field("RESULT",ofield);
+    values.clear();
+    if (ofield) ofield->vfield()->get_values(values);
+    return engine.used_cached_program();
+  }
+}
+
+TEST_F(BasicParserTests, ProgramCacheReusesParsedPrograms)
+{
+  ParserProgramCache::instance().clear();
+  FieldHandle field(CreateEmptyLatVol(4,5,6));
+  const std::string function = "RESULT = X*Y + DATA*Z;";
+
+  std::vector<double> first, second;
+  EXPECT_FALSE(runCached(field, function, first));
+  EXPECT_TRUE(runCached(field, function, second));
+  EXPECT_EQ(1u, ParserProgramCache::instance().size());
+  EXPECT_EQ(first, second);
+
+  // The same expression on vector data is a different program
+  FieldInformation fi(field);
+  fi.make_vector();
+  FieldHandle vectors = CreateField(fi,field->mesh());
+  EXPECT_FALSE(runCached(vectors, function, first));
+  EXPECT_TRUE(runCached(vectors, function, second));
+  EXPECT_EQ(2u, ParserProgramCache::instance().size());
+
+  ParserProgramCache::instance().set_max_size(1);
+  EXPECT_EQ(1u, ParserProgramCache::instance().size());
+  ParserProgramCache::instance().set_max_size(64);
+  ParserProgramCache::instance().clear();
+}
+
+namespace
+{
+  SCIRun::Core::Datatypes::DenseMatrixHandle evaluateLinAlg(const std::string& function, bool fuse)
+  {
+    using namespace SCIRun::Core::Datatypes;
+    DenseMatrixHandle A(new DenseMatrix(40, 3));
+    DenseMatrixHandle B(new DenseMatrix(3, 40));
+    DenseMatrixHandle x(new DenseMatrix(40, 1));
+    for (int i = 0; i < 40; ++i)
+    {
+      for (int j = 0; j < 3; ++j)
+      {
+        (*A)(i, j) = i - 2.0*j;
+        (*B)(j, i) = 0.5*i*j + 1.0;
+      }
+      (*x)(i, 0) = 1.0/(i+1);
+    }
+
+    NewLinAlgEngine engine;
+    engine.set_fusion(fuse);
+    EXPECT_TRUE(engine.add_input_matrix("A", A));
+    EXPECT_TRUE(engine.add_input_matrix("B", B));
+    EXPECT_TRUE(engine.add_input_matrix("x", x));
+    EXPECT_TRUE(engine.add_output_matrix("o1"));
+    EXPECT_TRUE(engine.add_expressions(function));
+    EXPECT_TRUE(engine.run());
+
+    MatrixHandle result;
+    engine.get_matrix("o1", result);
+    return castMatrix::toDense(result);
+  }
+}
+
+TEST(LinAlgEngineTests, FusedProductsAndSumsMatchSeparateFunctions)
+{
+  const std::string functions[] = {
+    "o1 = A*B*x;",
+    "o1 = 2*A*B*x - A*(B*x)*3 + x;",
+    "o1 = -(A*B - 2) + 1 - A*B;",
+    "o1 = 3*x*2;"
+  };
+
+  for (const auto& function : functions)
+  {
+    auto expected = evaluateLinAlg(function, false);
+    auto actual = evaluateLinAlg(function, true);
+    ASSERT_TRUE(expected != nullptr) << function;
+    ASSERT_TRUE(actual != nullptr) << function;
+    ASSERT_EQ(expected->nrows(), actual->nrows()) << function;
+    ASSERT_EQ(expected->ncols(), actual->ncols()) << function;
+    for (size_t i = 0; i < expected->nrows(); ++i)
+      for (size_t j = 0; j < expected->ncols(); ++j)
+        EXPECT_NEAR((*expected)(i, j), (*actual)(i, j), 1e-9*(1.0 + std::fabs((*expected)(i, j)))) << function;
+  }
+}
+
 TEST(FieldHashTests, TestShiftingZero)
 {
   // copied from TetVolMesh.h, failing compilation on GCC 6.2.
@@ -0,0 +1,540 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Persistent/BlockCompressedPiostream.h>
+#include <Core/Utils/Legacy/MappedFile.h>
+#include <Core/Logging/LoggerInterface.h>
+#include <Core/Thread/Parallel.h>
+
+#include <zlib.h>
+#include <string.h>
+#include <algorithm>
+
+using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Core::Thread;
+
+namespace SCIRun {
+
+static const char BLOCK_INDEX_MAGIC[8] = { 'B', 'L', 'Z', 'I', 'N', 'D', 'E', 'X' };
+
+// Arrays smaller than this are written in line with the other data
+static const size_t MIN_SHUFFLE_SIZE = 4096;
+
+static bool
+seek_file(FILE* fp, int64_t offset, int whence)
+{
+#ifdef _WIN32
+  return (_fseeki64(fp, offset, whence) == 0);
+#else
+  return (fseeko(fp, static_cast<off_t>(offset), whence) == 0);
+#endif
+}
+
+// Group byte k of every value together
+static void
+shuffle_bytes(const char* src, char* dst, size_t size, size_t element_size)
+{
+  const size_t n = size/element_size;
+  for (size_t k = 0; k < element_size; k++)
+  {
+    char* out = dst + k*n;
+    for (size_t i = 0; i < n; i++) out[i] = src[i*element_size+k];
+  }
+}
+
+static void
+unshuffle_bytes(const char* src, char* dst, size_t size, size_t element_size)
+{
+  const size_t n = size/element_size;
+  for (size_t k = 0; k < element_size; k++)
+  {
+    const char* in = src + k*n;
+    for (size_t i = 0; i < n; i++) dst[i*element_size+k] = in[i];
+  }
+}
+
+
+BlockCompressedPiostream::BlockCompressedPiostream(const std::string& filename,
+                                                   Direction dir,
+                                                   LoggerHandle pr,
+                                                   size_t block_size)
+  : BinaryPiostream(dir, filename, pr),
+    block_size_(std::max(block_size, MIN_SHUFFLE_SIZE)),
+    batch_size_(2*std::max(Parallel::NumCores(), 1u)),
+    file_offset_(16),
+    raw_offset_(0),
+    num_pending_(0),
+    window_first_(0),
+    window_count_(0),
+    block_(0),
+    block_position_(0)
+{
+  if (dir == Read)
+  {
+    fp_ = fopen(filename.c_str(), "rb");
+    if (!fp_)
+    {
+      reporter_->error("Error opening file: " + filename + " for reading.");
+      err = true;
+      return;
+    }
+
+    char hdr[16];
+    if (fread(hdr, 1, 16, fp_) != 16 ||
+        !readHeader(reporter_, filename, hdr, "BLZ", version_, file_endian))
+    {
+      reporter_->error("Header read failed.");
+      err = true;
+      return;
+    }
+    if (file_endian != Little)
+    {
+      reporter_->error("Compressed file " + filename +
+                       " was written on a big endian machine.");
+      err = true;
+      return;
+    }
+
+    read_index();
+    window_.resize(batch_size_);
+
+    if (MappedFile::enabled())
+    {
+      mapped_.reset(new MappedFile(filename));
+      if (!mapped_->is_open()) mapped_.reset();
+    }
+  }
+  else
+  {
+    fp_ = fopen(filename.c_str(), "wb");
+    if (!fp_)
+    {
+      reporter_->error("Error opening file '" + filename + "' for writing.");
+      err = true;
+      return;
+    }
+
+    char hdr[17];
+    sprintf(hdr, "SCI\nBLZ\n%03d\n%s", version_, endianness());
+    if (fwrite(hdr, 1, 16, fp_) != 16)
+    {
+      reporter_->error("Header write failed.");
+      err = true;
+      return;
+    }
+    pending_.resize(batch_size_);
+  }
+}
+
+
+BlockCompressedPiostream::~BlockCompressedPiostream()
+{
+  if (writing() && fp_)
+  {
+    finish_block();
+    flush_pending();
+    write_index();
+  }
+}
+
+
+void
+BlockCompressedPiostream::read_index()
+{
+  uint64_t footer[3];
+  if (!seek_file(fp_, -static_cast<int64_t>(sizeof(footer)), SEEK_END) ||
+      fread(footer, sizeof(uint64_t), 3, fp_) != 3 ||
+      memcmp(&footer[2], BLOCK_INDEX_MAGIC, 8) != 0)
+  {
+    reporter_->error("Compressed file " + file_name + " has no block index.");
+    err = true;
+    return;
+  }
+
+  const uint64_t num = footer[0];
+  std::vector<uint64_t> entries(5*num);
+  if (!seek_file(fp_, static_cast<int64_t>(footer[1]), SEEK_SET) ||
+      (num && fread(&entries[0], sizeof(uint64_t), 5*num, fp_) != 5*num))
+  {
+    reporter_->error("Could not read the block index of " + file_name + ".");
+    err = true;
+    return;
+  }
+
+  index_.resize(num);
+  uint64_t raw_offset = 0;
+  for (size_t i = 0; i < num; i++)
+  {
+    BlockInfo& info = index_[i];
+    info.file_offset = entries[5*i];
+    info.raw_offset = entries[5*i+1];
+    info.compressed_size = entries[5*i+2];
+    info.raw_size = entries[5*i+3];
+    info.shuffle = entries[5*i+4];
+    if (info.raw_offset != raw_offset || info.raw_size == 0 ||
+        info.file_offset + info.compressed_size > footer[1] ||
+        (info.shuffle && info.raw_size % info.shuffle))
+    {
+      reporter_->error("The block index of " + file_name + " is corrupt.");
+      err = true;
+      index_.clear();
+      return;
+    }
+    raw_offset += info.raw_size;
+  }
+}
+
+
+void
+BlockCompressedPiostream::write_index()
+{
+  std::vector<uint64_t> entries;
+  entries.reserve(5*index_.size() + 3);
+  for (size_t i = 0; i < index_.size(); i++)
+  {
+    const BlockInfo& info = index_[i];
+    entries.push_back(info.file_offset);
+    entries.push_back(info.raw_offset);
+    entries.push_back(info.compressed_size);
+    entries.push_back(info.raw_size);
+    entries.push_back(info.shuffle);
+  }
+
+  uint64_t magic;
+  memcpy(&magic, BLOCK_INDEX_MAGIC, 8);
+  entries.push_back(index_.size());
+  entries.push_back(file_offset_);
+  entries.push_back(magic);
+
+  if (fwrite(&entries[0], sizeof(uint64_t), entries.size(), fp_) != entries.size())
+  {
+    reporter_->error("BlockCompressedPiostream error writing block index.");
+    err = true;
+  }
+}
+
+
+void
+BlockCompressedPiostream::finish_block()
+{
+  if (current_.empty()) return;
+  queue_block(&current_[0], current_.size(), 0);
+  current_.clear();
+}
+
+
+void
+BlockCompressedPiostream::queue_block(const char* data, size_t size, size_t shuffle)
+{
+  PendingBlock& block = pending_[num_pending_++];
+  block.raw.assign(data, data + size);
+  block.shuffle = shuffle;
+  if (num_pending_ == batch_size_) flush_pending();
+}
+
+
+void
+BlockCompressedPiostream::flush_pending()
+{
+  if (num_pending_ == 0) return;
+
+  const size_t num = num_pending_;
+  const int nproc = static_cast<int>(std::min<size_t>(Parallel::NumCores(), num));
+
+  auto compress_task = [this, num, nproc](int proc)
+  {
+    std::vector<char> shuffled;
+    for (size_t i = proc; i < num; i += nproc)
+    {
+      PendingBlock& block = pending_[i];
+      const size_t size = block.raw.size();
+      const char* src = &block.raw[0];
+      if (block.shuffle > 1)
+      {
+        shuffled.resize(size);
+        shuffle_bytes(src, &shuffled[0], size, block.shuffle);
+        src = &shuffled[0];
+      }
+
+      uLongf len = compressBound(static_cast<uLong>(size));
+      block.compressed.resize(len);
+      if (compress2(reinterpret_cast<Bytef*>(&block.compressed[0]), &len,
+                    reinterpret_cast<const Bytef*>(src), static_cast<uLong>(size),
+                    Z_BEST_SPEED) != Z_OK || len >= size)
+      {
+        // Stored as is, recognized by equal sizes
+        block.compressed.assign(src, src + size);
+      }
+      else
+      {
+        block.compressed.resize(len);
+      }
+    }
+  };
+  Parallel::RunTasks(compress_task, nproc);
+
+  for (size_t i = 0; i < num; i++)
+  {
+    const PendingBlock& block = pending_[i];
+    if (!err && fwrite(&block.compressed[0], 1, block.compressed.size(), fp_) != block.compressed.size())
+    {
+      reporter_->error("BlockCompressedPiostream error writing block.");
+      err = true;
+    }
+
+    BlockInfo info;
+    info.file_offset = file_offset_;
+    info.raw_offset = raw_offset_;
+    info.compressed_size = block.compressed.size();
+    info.raw_size = block.raw.size();
+    info.shuffle = block.shuffle;
+    index_.push_back(info);
+
+    file_offset_ += info.compressed_size;
+    raw_offset_ += info.raw_size;
+  }
+  num_pending_ = 0;
+}
+
+
+bool
+BlockCompressedPiostream::load_window(size_t first)
+{
+  const size_t num = std::min(batch_size_, index_.size() - first);
+  window_first_ = first;
+  window_count_ = 0;
+
+  // The compressed data comes straight from the mapping if there is one,
+  // otherwise it is read in one go, the blocks are stored back to back.
+  std::vector<const char*> sources(num);
+  for (size_t i = 0; i < num; i++)
+  {
+    const BlockInfo& info = index_[first+i];
+    if (mapped_)
+    {
+      if (info.file_offset + info.compressed_size > mapped_->size()) return (false);
+      sources[i] = mapped_->data() + info.file_offset;
+    }
+    else
+    {
+      std::vector<char>& compressed = window_[i].compressed;
+      compressed.resize(info.compressed_size);
+      if ((i == 0 && !seek_file(fp_, static_cast<int64_t>(info.file_offset), SEEK_SET)) ||
+          fread(&compressed[0], 1, compressed.size(), fp_) != compressed.size())
+        return (false);
+      sources[i] = &compressed[0];
+    }
+  }
+
+  std::vector<char> ok(num, 1);
+  const int nproc = static_cast<int>(std::min<size_t>(Parallel::NumCores(), num));
+
+  auto decompress_task = [this, first, num, nproc, &sources, &ok](int proc)
+  {
+    std::vector<char> shuffled;
+    for (size_t i = proc; i < num; i += nproc)
+    {
+      const BlockInfo& info = index_[first+i];
+      std::vector<char>& raw = window_[i].raw;
+      raw.resize(info.raw_size);
+
+      char* dst = &raw[0];
+      if (info.shuffle > 1)
+      {
+        shuffled.resize(info.raw_size);
+        dst = &shuffled[0];
+      }
+
+      if (info.compressed_size == info.raw_size)
+      {
+        memcpy(dst, sources[i], info.raw_size);
+      }
+      else
+      {
+        uLongf len = static_cast<uLongf>(info.raw_size);
+        if (uncompress(reinterpret_cast<Bytef*>(dst), &len,
+                       reinterpret_cast<const Bytef*>(sources[i]),
+                       static_cast<uLong>(info.compressed_size)) != Z_OK ||
+            len != info.raw_size)
+        {
+          ok[i] = 0;
+          continue;
+        }
+      }
+
+      if (info.shuffle > 1)
+        unshuffle_bytes(dst, &raw[0], info.raw_size, info.shuffle);
+    }
+  };
+  Parallel::RunTasks(decompress_task, nproc);
+
+  if (std::find(ok.begin(), ok.end(), 0) != ok.end()) return (false);
+  window_count_ = num;
+  return (true);
+}
+
+
+size_t
+BlockCompressedPiostream::read_data(void* data, size_t size, size_t nmemb)
+{
+  if (err || size == 0) return (0);
+
+  char* out = static_cast<char*>(data);
+  const size_t bytes = size*nmemb;
+  size_t done = 0;
+  while (done < bytes && block_ < index_.size())
+  {
+    if (block_ < window_first_ || block_ >= window_first_ + window_count_)
+    {
+      if (!load_window(block_))
+      {
+        reporter_->error("BlockCompressedPiostream error decompressing block.");
+        err = true;
+        break;
+      }
+    }
+
+    const std::vector<char>& raw = window_[block_ - window_first_].raw;
+    const size_t n = std::min(bytes - done, raw.size() - block_position_);
+    memcpy(out + done, &raw[block_position_], n);
+    done += n;
+    block_position_ += n;
+    if (block_position_ == raw.size())
+    {
+      block_++;
+      block_position_ = 0;
+    }
+  }
+  return (done/size);
+}
+
+
+size_t
+BlockCompressedPiostream::write_data(const void* data, size_t size, size_t nmemb)
+{
+  if (err) return (0);
+
+  const char* in = static_cast<const char*>(data);
+  size_t bytes = size*nmemb;
+  while (bytes)
+  {
+    const size_t n = std::min(bytes, block_size_ - current_.size());
+    current_.insert(current_.end(), in, in + n);
+    in += n;
+    bytes -= n;
+    if (current_.size() == block_size_) finish_block();
+  }
+  return (err ? 0 : nmemb);
+}
+
+
+bool
+BlockCompressedPiostream::block_io(void* data, size_t s, size_t nmemb)
+{
+  if (err) return (true);
+  const size_t bytes = s*nmemb;
+
+  if (dir == Read)
+  {
+    if (read_data(data, s, nmemb) != nmemb)
+    {
+      err = true;
+      reporter_->error("BlockCompressedPiostream error reading block io.");
+    }
+    return (true);
+  }
+
+  if ((s != 2 && s != 4 && s != 8) || bytes < MIN_SHUFFLE_SIZE)
+  {
+    write_data(data, s, nmemb);
+    return (true);
+  }
+
+  // Large arrays of numbers get shuffled blocks of their own
+  finish_block();
+  const char* in = static_cast<const char*>(data);
+  const size_t chunk = (block_size_/s)*s;
+  for (size_t offset = 0; offset < bytes; offset += chunk)
+    queue_block(in + offset, std::min(chunk, bytes - offset), s);
+  return (true);
+}
+
+
+bool
+BlockCompressedPiostream::seek_uncompressed(uint64_t offset)
+{
+  if (!reading()) return (false);
+
+  // First block that starts after offset
+  size_t hi = index_.size();
+  size_t lo = 0;
+  while (lo < hi)
+  {
+    const size_t mid = (lo + hi)/2;
+    if (index_[mid].raw_offset <= offset) lo = mid + 1;
+    else hi = mid;
+  }
+
+  if (lo == 0)
+  {
+    block_ = 0;
+    block_position_ = 0;
+    return (offset == 0);
+  }
+
+  const BlockInfo& info = index_[lo-1];
+  if (offset > info.raw_offset + info.raw_size) return (false);
+  block_ = lo-1;
+  block_position_ = static_cast<size_t>(offset - info.raw_offset);
+  if (block_position_ == info.raw_size)
+  {
+    block_++;
+    block_position_ = 0;
+  }
+  return (true);
+}
+
+
+uint64_t
+BlockCompressedPiostream::uncompressed_size() const
+{
+  uint64_t size = index_.empty() ? 0 : index_.back().raw_offset + index_.back().raw_size;
+  for (size_t i = 0; i < num_pending_; i++) size += pending_[i].raw.size();
+  return (size + current_.size());
+}
+
+
+void
+BlockCompressedPiostream::reset_post_header()
+{
+  if (!reading()) return;
+  seek_uncompressed(0);
+}
+
+}
@@ -0,0 +1,128 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_PERSISTENT_BLOCKCOMPRESSEDPIOSTREAM_H
+#define CORE_PERSISTENT_BLOCKCOMPRESSEDPIOSTREAM_H 1
+
+#include <Core/Persistent/Pstreams.h>
+#include <vector>
+#include <stdint.h>
+
+#include <Core/Persistent/share.h>
+
+namespace SCIRun {
+
+/// Compressed version of the binary stream. The data written by
+/// BinaryPiostream is cut into blocks that are compressed independently, so
+/// blocks are compressed and decompressed on all cores and any position in
+/// the data can be reached by decompressing one block. Arrays written with
+/// block_io get blocks of their own with a byte shuffle filter applied
+/// before compression: storing the first bytes of all values, then the
+/// second bytes etc. puts the slowly varying exponent bytes of doubles next
+/// to each other, which compresses much better than the interleaved values.
+///
+/// File layout, all numbers little endian:
+///   header  "SCI\nBLZ\n002\nLIT\n"
+///   blocks  zlib streams (or raw data when compression does not help)
+///   index   per block: file offset, uncompressed offset, compressed size,
+///           uncompressed size, shuffle element size (5 x uint64)
+///   footer  number of blocks, index offset, "BLZINDEX" (3 x uint64)
+class SCISHARE BlockCompressedPiostream : public BinaryPiostream {
+public:
+  BlockCompressedPiostream(const std::string& filename, Direction dir,
+                           Core::Logging::LoggerHandle pr = Core::Logging::LoggerHandle(),
+                           size_t block_size = DEFAULT_BLOCK_SIZE);
+  virtual ~BlockCompressedPiostream();
+
+  virtual bool supports_block_io() { return true; }
+  virtual bool block_io(void*, size_t, size_t);
+
+  /// Random access when reading: continue reading at this offset in the
+  /// uncompressed data.
+  bool seek_uncompressed(uint64_t offset);
+  uint64_t uncompressed_size() const;
+  size_t num_blocks() const { return (index_.size()); }
+
+  static const size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+protected:
+  virtual void reset_post_header();
+  virtual size_t read_data(void* data, size_t size, size_t nmemb);
+  virtual size_t write_data(const void* data, size_t size, size_t nmemb);
+
+private:
+  struct BlockInfo
+  {
+    uint64_t file_offset;
+    uint64_t raw_offset;
+    uint64_t compressed_size;
+    uint64_t raw_size;
+    uint64_t shuffle;
+  };
+
+  struct PendingBlock
+  {
+    std::vector<char> raw;
+    std::vector<char> compressed;
+    size_t shuffle;
+  };
+
+  void read_index();
+  void write_index();
+
+  // Writing: blocks are collected in batches and the batch is compressed
+  // in parallel once it is full.
+  void finish_block();
+  void queue_block(const char* data, size_t size, size_t shuffle);
+  void flush_pending();
+
+  // Reading: a window of consecutive blocks is decompressed in parallel.
+  bool load_window(size_t first);
+  bool advance_block();
+
+  size_t block_size_;
+  size_t batch_size_;
+  std::vector<BlockInfo> index_;
+  uint64_t file_offset_;
+  uint64_t raw_offset_;
+
+  std::vector<char> current_;
+  std::vector<PendingBlock> pending_;
+  size_t num_pending_;
+
+  std::vector<PendingBlock> window_;
+  size_t window_first_;
+  size_t window_count_;
+  size_t block_;
+  size_t block_position_;
+};
+
+}
+
+#endif
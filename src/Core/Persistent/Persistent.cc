@@ -41,6 +41,7 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Persistent/Persistent.h>
 #include <Core/Persistent/Pstreams.h>
+#include <Core/Persistent/BlockCompressedPiostream.h>
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
 #include <Core/Persistent/GZstream.h>
 #endif
@@ -455,6 +456,10 @@ auto_istream(const std::string& filename, LoggerHandle pr)
   {
     return PiostreamPtr(new TextPiostream(filename, Piostream::Read, pr));
   }
+  else if (m1 == 'B' && m2 == 'L' && m3 == 'Z')
+  {
+    return PiostreamPtr(new BlockCompressedPiostream(filename, Piostream::Read, pr));
+  }
 
   if (pr) pr->error(filename + " is an unknown type!");
   else std::cerr << filename << " is an unknown type!" << std::endl;
@@ -470,6 +475,7 @@ auto_ostream(const std::string& filename, const std::string& type, LoggerHandle
   //     Binary:  Return a BinaryPiostream 
   //     Fast:    Return FastPiostream
   //     Text:    Return a TextPiostream
+  //     Compressed: Return BlockCompressedPiostream
   //     Default: Return BinaryPiostream 
   // NOTE: Binary will never return BinarySwap so we always write
   //       out the endianness of the machine we are on
@@ -486,6 +492,10 @@ auto_ostream(const std::string& filename, const std::string& type, LoggerHandle
   {
     stream = new FastPiostream(filename, Piostream::Write, pr);
   }
+  else if (type == "Compressed")
+  {
+    stream = new BlockCompressedPiostream(filename, Piostream::Write, pr);
+  }
   else
   {
     stream = new BinaryPiostream(filename, Piostream::Write, -1, pr);
@@ -556,6 +566,8 @@ Piostream::readHeader( LoggerHandle pr,
   bool is_binary = false;
   if (hdr[4] == 'B' && hdr[5] == 'I' && hdr[6] == 'N' && hdr[7] == '\n')
     is_binary = true;
+  if (hdr[4] == 'B' && hdr[5] == 'L' && hdr[6] == 'Z' && hdr[7] == '\n')
+    is_binary = true;
   if(version > 1 && is_binary) 
   {
     // can only be BIG or LIT
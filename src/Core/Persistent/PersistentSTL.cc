@@ -205,9 +205,7 @@ namespace SCIRun {
           data.resize(static_cast<size_t>(size));
           if (size > 0)
           {
-            if (stream.supports_block_io())
-              stream.block_io(&data.front(), 4, static_cast<size_t>(size));
-            else
+            if (!stream.block_io(&data.front(), 4, static_cast<size_t>(size)))
             {
               for (long long i = 0; i < size; i++)
               {
@@ -222,9 +220,7 @@ namespace SCIRun {
           indices.resize(static_cast<size_t>(size));
           if (size > 0)
           {
-            if (stream.supports_block_io())
-              stream.block_io(&indices.front(), 4, static_cast<size_t>(size));
-            else
+            if (!stream.block_io(&indices.front(), 4, static_cast<size_t>(size)))
             {
               for (unsigned int i = 0; i < size; i++)
               {
@@ -245,9 +241,7 @@ namespace SCIRun {
           indices.resize(static_cast<size_t>(size));
           if (size > 0)
           {
-            if (stream.supports_block_io())
-              stream.block_io(&indices.front(), 8, static_cast<size_t>(size));
-            else
+            if (!stream.block_io(&indices.front(), 8, static_cast<size_t>(size)))
               for (long long i = 0; i < size; i++)
               {
                 stream.io(indices[i]);
@@ -265,9 +259,7 @@ namespace SCIRun {
           data.resize(static_cast<size_t>(size));
           if (size > 0)
           {
-            if (stream.supports_block_io())
-              stream.block_io(&data.front(), 8, static_cast<size_t>(size));
-            else
+            if (!stream.block_io(&data.front(), 8, static_cast<size_t>(size)))
             {
               for (long long i = 0; i < size; i++)
               {
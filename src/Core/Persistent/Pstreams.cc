@@ -43,6 +43,7 @@
 ///
 
 #include <Core/Persistent/Pstreams.h>
+#include <Core/Utils/Legacy/MappedFile.h>
 #include <Core/Logging/LoggerInterface.h>
 #include <Core/Utils/Legacy/StringUtil.h>
 
@@ -55,6 +56,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <fstream>
+#include <algorithm>
 #include <iostream>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -68,6 +70,23 @@ using namespace SCIRun::Core::Logging;
 
 namespace SCIRun {
 
+// Map a file that was opened for reading, positioned where fp already is.
+static boost::shared_ptr<MappedFile>
+map_for_reading(const std::string& filename, FILE* fp)
+{
+  boost::shared_ptr<MappedFile> mapped;
+  if (!MappedFile::enabled()) return (mapped);
+
+  mapped.reset(new MappedFile(filename));
+  if (!mapped->is_open())
+  {
+    mapped.reset();
+    return (mapped);
+  }
+  mapped->seek(ftell(fp));
+  return (mapped);
+}
+
 // BinaryPiostream -- portable
   BinaryPiostream::BinaryPiostream(const std::string& filename, Direction dir,
     const int& v, LoggerHandle pr)
@@ -112,6 +131,8 @@ namespace SCIRun {
           return;
         }
       }
+
+      mapped_ = map_for_reading(filename, fp_);
     }
     else
     {
@@ -237,6 +258,15 @@ BinaryPiostream::BinaryPiostream(int fd, Direction dir, const int& v,
 }
 
 
+BinaryPiostream::BinaryPiostream(Direction dir, const std::string& filename,
+                                 LoggerHandle pr)
+  : Piostream(dir, PERSISTENT_VERSION, filename, pr),
+    fp_(0)
+{
+  version_ = PERSISTENT_VERSION;
+}
+
+
 BinaryPiostream::~BinaryPiostream()
 {
   if (fp_) fclose(fp_);
@@ -264,6 +294,23 @@ BinaryPiostream::reset_post_header()
     // read header
     fread(hdr, 1, 16, fp_);
   }
+
+  if (mapped_) mapped_->seek(ftell(fp_));
+}
+
+
+size_t
+BinaryPiostream::read_data(void* data, size_t size, size_t nmemb)
+{
+  if (mapped_) return (mapped_->read(data, size, nmemb));
+  return (fread(data, size, nmemb, fp_));
+}
+
+
+size_t
+BinaryPiostream::write_data(const void* data, size_t size, size_t nmemb)
+{
+  return (fwrite(data, size, nmemb, fp_));
 }
 
 const char *
@@ -285,7 +332,7 @@ BinaryPiostream::gen_io(T& data, const char *iotype)
   if (err) return;
   if (dir==Read)
   {
-    if (!fread(&data, sizeof(data), 1, fp_))
+    if (!read_data(&data, sizeof(data), 1))
     {
       err = true;
       reporter_->error(std::string("BinaryPiostream error reading ") +
@@ -294,7 +341,7 @@ BinaryPiostream::gen_io(T& data, const char *iotype)
   }
   else
   {
-    if (!fwrite(&data, sizeof(data), 1, fp_))
+    if (!write_data(&data, sizeof(data), 1))
     {
       err = true;
       reporter_->error(std::string("BinaryPiostream error writing ") +
@@ -496,14 +543,14 @@ BinaryPiostream::io(std::string& data)
       // to the 4 byte boundary with zeros.
       chars = data.size();
       io(chars);
-      if (!fwrite(data.c_str(), sizeof(char), chars, fp_)) err = true;
+      if (!write_data(data.c_str(), sizeof(char), chars)) err = true;
 
       // Pad data out to 4 bytes.
       int extra = chars % 4;
       if (extra)
       {
         static const char pad[4] = {0, 0, 0, 0};
-        if (!fwrite(pad, sizeof(char), 4 - extra, fp_)) err = true;
+        if (!write_data(pad, sizeof(char), 4 - extra)) err = true;
       }
     }
     else
@@ -511,7 +558,7 @@ BinaryPiostream::io(std::string& data)
       const char* p = data.c_str();
       chars = static_cast<int>(strlen(p)) + 1;
       io(chars);
-      if (!fwrite(p, sizeof(char), chars, fp_)) err = true;
+      if (!write_data(p, sizeof(char), chars)) err = true;
     }
   }
   if (dir == Read)
@@ -532,7 +579,7 @@ BinaryPiostream::io(std::string& data)
         char* buf = new char[buf_size];
 
         // Read in data plus padding.
-        if (!fread(buf, sizeof(char), buf_size, fp_))
+        if (!read_data(buf, sizeof(char), buf_size))
         {
           err = true;
           delete [] buf;
@@ -548,7 +595,7 @@ BinaryPiostream::io(std::string& data)
     else
     {
       char* buf = new char[chars];
-      fread(buf, sizeof(char), chars, fp_);
+      read_data(buf, sizeof(char), chars);
       data = std::string(buf);
       delete[] buf;
     }
@@ -562,7 +609,7 @@ BinaryPiostream::block_io(void *data, size_t s, size_t nmemb)
   if (err || version() == 1) { return false; }
   if (dir == Read)
   {
-    const size_t did = fread(data, s, nmemb, fp_);
+    const size_t did = read_data(data, s, nmemb);
     if (did != nmemb)
     {
       err = true;
@@ -571,7 +618,7 @@ BinaryPiostream::block_io(void *data, size_t s, size_t nmemb)
   }
   else
   {
-    const size_t did = fwrite(data, s, nmemb, fp_);
+    const size_t did = write_data(data, s, nmemb);
     if (did != nmemb)
     {
       err = true;
@@ -615,6 +662,73 @@ BinarySwapPiostream::endianness()
     //return "BIG\n";
 }
 
+// Reverse the bytes of every element, the shifts compile to bswap
+// instructions and the loops vectorize.
+static void
+swap_bytes(void* data, size_t s, size_t nmemb)
+{
+  char* p = static_cast<char*>(data);
+  if (s == 2)
+  {
+    for (size_t i = 0; i < nmemb; i++, p += 2)
+    {
+      unsigned short v;
+      memcpy(&v, p, 2);
+      v = static_cast<unsigned short>((v >> 8) | (v << 8));
+      memcpy(p, &v, 2);
+    }
+  }
+  else if (s == 4)
+  {
+    for (size_t i = 0; i < nmemb; i++, p += 4)
+    {
+      unsigned int v;
+      memcpy(&v, p, 4);
+      v = (v >> 24) | ((v >> 8) & 0x0000FF00u) | ((v << 8) & 0x00FF0000u) | (v << 24);
+      memcpy(p, &v, 4);
+    }
+  }
+  else if (s == 8)
+  {
+    for (size_t i = 0; i < nmemb; i++, p += 8)
+    {
+      unsigned long long v;
+      memcpy(&v, p, 8);
+      v = ((v >> 56) & 0x00000000000000FFull) | ((v >> 40) & 0x000000000000FF00ull) |
+          ((v >> 24) & 0x0000000000FF0000ull) | ((v >>  8) & 0x00000000FF000000ull) |
+          ((v <<  8) & 0x000000FF00000000ull) | ((v << 24) & 0x0000FF0000000000ull) |
+          ((v << 40) & 0x00FF000000000000ull) | ((v << 56) & 0xFF00000000000000ull);
+      memcpy(p, &v, 8);
+    }
+  }
+}
+
+
+bool
+BinarySwapPiostream::block_io(void *data, size_t s, size_t nmemb)
+{
+  if (err || version() == 1 || dir != Read) return false;
+  if (s != 1 && s != 2 && s != 4 && s != 8) return false;
+
+  // Swap in chunks that are still in the cache after reading them
+  const size_t chunk = (64*1024)/s;
+  char* p = static_cast<char*>(data);
+  for (size_t done = 0; done < nmemb; done += chunk)
+  {
+    const size_t n = std::min(chunk, nmemb - done);
+    if (read_data(p, s, n) != n)
+    {
+      err = true;
+      reporter_->error("BinarySwapPiostream error reading block io.");
+      return true;
+    }
+    swap_bytes(p, s, n);
+    p += n*s;
+  }
+  return true;
+}
+
+
 template <class T>
 inline void
 BinarySwapPiostream::gen_io(T& data, const char *iotype)
@@ -623,7 +737,7 @@ BinarySwapPiostream::gen_io(T& data, const char *iotype)
   if (dir==Read)
   {
     unsigned char tmp[sizeof(data)];
-    if (!fread(tmp, sizeof(data), 1, fp_))
+    if (!read_data(tmp, sizeof(data), 1))
     {
       err = true;
       reporter_->error(std::string("BinaryPiostream error reading ") +
@@ -1748,6 +1862,7 @@ FastPiostream::FastPiostream(const std::string& filename, Direction dir,
       return;
     }
     readHeader(reporter_, filename, hdr, "FAS", version_, file_endian);
+    mapped_ = map_for_reading(filename, fp_);
   }
   else
   {
@@ -1884,6 +1999,24 @@ FastPiostream::reset_post_header()
     // header (LIT | BIG).
     fseek(fp_, 17, SEEK_SET);
   }
+
+  if (mapped_) mapped_->seek(ftell(fp_));
+}
+
+
+size_t
+FastPiostream::read_data(void* data, size_t size, size_t nmemb)
+{
+  if (mapped_) return (mapped_->read(data, size, nmemb));
+  return (fread(data, size, nmemb, fp_));
+}
+
+
+bool
+FastPiostream::at_end() const
+{
+  if (mapped_) return (mapped_->eof());
+  return (feof(fp_) != 0);
 }
 
 
@@ -1896,8 +2029,8 @@ FastPiostream::gen_io(T& data, const char *iotype)
   size_t did = 0;
   if (dir == Read)
   {
-    did = fread(&data, sizeof(data), 1, fp_);
-    if (expect != did && !feof(fp_))
+    did = read_data(&data, sizeof(data), 1);
+    if (expect != did && !at_end())
     {
       err = true;
       reporter_->error(std::string("FastPiostream error reading ") + iotype + ".");
@@ -2027,9 +2160,9 @@ FastPiostream::io(std::string& data)
   }
   if (dir==Read)
   {
-    fread(&chars, sizeof(unsigned int), 1, fp_);
+    read_data(&chars, sizeof(unsigned int), 1);
     char* buf = new char[chars];
-    fread(buf, sizeof(char), chars, fp_);
+    read_data(buf, sizeof(char), chars);
     data=std::string(buf);
     delete[] buf;
   }
@@ -2041,7 +2174,7 @@ FastPiostream::block_io(void *data, size_t s, size_t nmemb)
 {
   if (dir == Read)
   {
-    const size_t did = fread(data, s, nmemb, fp_);
+    const size_t did = read_data(data, s, nmemb);
     if (did != nmemb)
     {
       err = true;
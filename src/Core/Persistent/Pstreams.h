@@ -45,14 +45,29 @@
 #include <Core/Persistent/Persistent.h>
 #include <cstdio>
 #include <iosfwd>
+#include <boost/shared_ptr.hpp>
 
 #include <Core/Persistent/share.h>
 
 namespace SCIRun {
 
+class MappedFile;
+
 class SCISHARE BinaryPiostream : public Piostream {
 protected:
   FILE* fp_;
+  /// When reading from a file, the data is read from this mapping instead
+  /// of fp_ (see MappedFile).
+  boost::shared_ptr<MappedFile> mapped_;
+
+  /// fread from the mapping if there is one, otherwise from fp_. Derived
+  /// streams that store the data differently override these two.
+  virtual size_t read_data(void* data, size_t size, size_t nmemb);
+  virtual size_t write_data(const void* data, size_t size, size_t nmemb);
+
+  /// For derived streams that open the file and handle the header themselves.
+  BinaryPiostream(Direction dir, const std::string& filename,
+                  Core::Logging::LoggerHandle pr);
 
   virtual const char *endianness();
   virtual void reset_post_header();
@@ -110,8 +125,12 @@ public:
   virtual void io(double&);
   virtual void io(float&);
 
+  /// Reads the whole block and swaps it in place. Only elements of 2, 4 or
+  /// 8 bytes (and single bytes) can be swapped, block_io returns false for
+  /// anything else so the caller does element wise io. supports_block_io()
+  /// stays false as some callers ignore that return value.
   virtual bool supports_block_io() { return false; }
-  virtual bool block_io(void*, size_t, size_t) { return false; }
+  virtual bool block_io(void*, size_t, size_t);
 };
 
 
@@ -164,6 +183,10 @@ public:
 class SCISHARE FastPiostream : public Piostream {
 private:
   FILE* fp_;
+  boost::shared_ptr<MappedFile> mapped_;
+
+  size_t read_data(void* data, size_t size, size_t nmemb);
+  bool at_end() const;
 
   void report_error(const char *);
   template <class T> void gen_io(T&, const char *);
@@ -0,0 +1,128 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_THREAD_BACKGROUNDTASK_H
+#define CORE_THREAD_BACKGROUNDTASK_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <atomic>
+
+namespace SCIRun
+{
+namespace Core
+{
+namespace Thread
+{
+  /// Computes a value on its own thread while the caller goes on, e.g. the
+  /// full resolution version of a result that was already sent out at a
+  /// lower resolution. Starting another computation interrupts the running
+  /// one; it stops at its next interruption point (see Interruptible) and
+  /// its result is dropped.
+  template <class T>
+  class BackgroundTask : public boost::noncopyable
+  {
+  public:
+    typedef boost::function<T()> Computation;
+    typedef boost::function<void()> Callback;
+
+    ~BackgroundTask() { cancel(); }
+
+    /// finished is called on the worker thread once the result is ready,
+    /// unless the computation was interrupted. Module::enqueueExecuteAgain
+    /// may be called there, the request is queued to the GUI thread.
+    void start(Computation compute, Callback finished = Callback())
+    {
+      cancel();
+      boost::shared_ptr<Result> result = boost::make_shared<Result>();
+      result_ = result;
+      thread_ = boost::thread([compute, finished, result]()
+      {
+        try
+        {
+          result->value = compute();
+        }
+        catch (...)
+        {
+          result->error = boost::current_exception();
+        }
+        result->done = true;
+        if (finished && !boost::this_thread::interruption_requested())
+          finished();
+      });
+    }
+
+    void cancel()
+    {
+      if (thread_.joinable())
+      {
+        thread_.interrupt();
+        thread_.join();
+      }
+      result_.reset();
+    }
+
+    /// Whether a result is waiting to be picked up by wait()
+    bool pending() const { return result_ != nullptr; }
+
+    /// Whether the computation is done, wait() will not block
+    bool ready() const { return result_ && result_->done; }
+
+    /// Blocks until the computation is done and hands out its result once.
+    /// Exceptions of the computation are thrown here.
+    T wait()
+    {
+      if (!result_)
+        return T();
+      thread_.join();
+      boost::shared_ptr<Result> result = result_;
+      result_.reset();
+      if (result->error)
+        boost::rethrow_exception(result->error);
+      return result->value;
+    }
+
+  private:
+    struct Result
+    {
+      Result() : value(), done(false) {}
+      T value;
+      boost::exception_ptr error;
+      std::atomic<bool> done;
+    };
+
+    boost::thread thread_;
+    boost::shared_ptr<Result> result_;
+  };
+
+}}}
+
+#endif
@@ -49,7 +49,11 @@ void Parallel::RunTasks(IndexedTask task, int numProcs)
   }
   catch (boost::thread_interrupted&)
   {
+    // The tasks usually refer to the caller's stack, so they have to be
+    // done before it unwinds. They stop at their next interruption point.
     threads.interrupt_all();
+    boost::this_thread::disable_interruption wait;
+    threads.join_all();
     throw;
   }
 }
@@ -46,9 +46,9 @@ namespace Thread
     static void RunTasks(IndexedTask task, int numProcs);
     static unsigned int NumCores();
     static void SetMaximumCores(unsigned int max);
+    static unsigned int capByUserCoreCount(unsigned int numProcs);
   private:
     static unsigned int maximumCoresSetByUser_;
-    static unsigned int capByUserCoreCount(unsigned int numProcs);
   };
 
 }}}
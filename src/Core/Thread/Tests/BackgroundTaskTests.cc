@@ -0,0 +1,85 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <atomic>
+
+#include <Core/Thread/BackgroundTask.h>
+#include <Core/Thread/Interruptible.h>
+
+using namespace SCIRun::Core::Thread;
+
+TEST(BackgroundTaskTests, ResultIsHandedOutOnce)
+{
+  BackgroundTask<int> task;
+  EXPECT_FALSE(task.pending());
+
+  task.start([]() { return 42; });
+  EXPECT_TRUE(task.pending());
+  while (!task.ready())
+    boost::this_thread::yield();
+  EXPECT_EQ(42, task.wait());
+  EXPECT_FALSE(task.pending());
+  EXPECT_FALSE(task.ready());
+  EXPECT_EQ(0, task.wait());
+}
+
+TEST(BackgroundTaskTests, CallbackRunsWhenResultIsReady)
+{
+  BackgroundTask<int> task;
+  std::atomic<bool> ready(false);
+  task.start([]() { return 7; }, [&]() { ready = task.ready(); });
+  EXPECT_EQ(7, task.wait());
+  EXPECT_TRUE(ready);
+}
+
+TEST(BackgroundTaskTests, ExceptionsAreThrownByWait)
+{
+  BackgroundTask<int> task;
+  task.start([]() -> int { throw std::runtime_error("failed"); });
+  EXPECT_THROW(task.wait(), std::exception);
+}
+
+TEST(BackgroundTaskTests, StartingAgainInterruptsRunningComputation)
+{
+  BackgroundTask<int> task;
+  task.start([]()
+  {
+    // Only ends when interrupted
+    for (;;)
+    {
+      Interruptible::checkForInterruption();
+      boost::this_thread::yield();
+    }
+    return 1;
+  });
+
+  task.start([]() { return 2; });
+  EXPECT_EQ(2, task.wait());
+}
@@ -31,7 +31,12 @@
 #include <fstream>
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/Interruptible.h>
 #include <boost/filesystem/path.hpp>
+#include <boost/thread/thread.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <Testing/Utils/SCIRunUnitTests.h>
 
 using namespace SCIRun::Core::Thread;
@@ -52,6 +57,43 @@ TEST(ParallelTests, CanDoubleNumberInParallel)
   EXPECT_EQ(expectedSum * 2, std::accumulate(nums.begin(), nums.end(), 0, std::plus<int>()));
 }
 
+TEST(ParallelTests, InterruptedCallerWaitsForItsTasks)
+{
+  std::atomic<int> running(0);
+  std::atomic<int> runningWhenInterrupted(-1);
+
+  boost::thread caller([&]()
+  {
+    try
+    {
+      Parallel::RunTasks([&](int)
+      {
+        // Stands in for the stack of an algorithm: the task still uses it
+        // while it unwinds after the interruption.
+        struct Running
+        {
+          explicit Running(std::atomic<int>& r) : r_(r) { ++r_; }
+          ~Running() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); --r_; }
+          std::atomic<int>& r_;
+        } task(running);
+        for (;;)
+          Interruptible::checkForInterruption();
+      }, 2);
+    }
+    catch (boost::thread_interrupted&)
+    {
+      runningWhenInterrupted = running.load();
+    }
+  });
+
+  while (running < 2)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  caller.interrupt();
+  caller.join();
+
+  EXPECT_EQ(0, runningWhenInterrupted);
+}
+
 /// @todo
 #if 0
 TEST(ParallelTests, CanDoubleNumberWithParallelForEach)
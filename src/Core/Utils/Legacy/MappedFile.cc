@@ -0,0 +1,146 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Utils/Legacy/MappedFile.h>
+
+#include <string.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace SCIRun {
+
+static bool mapping_enabled_ = true;
+
+bool
+MappedFile::enabled()
+{
+  return (mapping_enabled_);
+}
+
+void
+MappedFile::set_enabled(bool enable)
+{
+  mapping_enabled_ = enable;
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename) :
+  data_(0), size_(0), position_(0), file_(0), mapping_(0)
+{
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+    0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+  if (file == INVALID_HANDLE_VALUE) return;
+  file_ = file;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 ||
+      static_cast<unsigned long long>(size.QuadPart) > static_cast<size_t>(-1))
+    return;
+
+  HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+  if (!mapping) return;
+  mapping_ = mapping;
+
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!view) return;
+
+  data_ = static_cast<const char*>(view);
+  size_ = static_cast<size_t>(size.QuadPart);
+}
+
+MappedFile::~MappedFile()
+{
+  if (data_) UnmapViewOfFile(data_);
+  if (mapping_) CloseHandle(mapping_);
+  if (file_) CloseHandle(file_);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) :
+  data_(0), size_(0), position_(0)
+{
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) return;
+
+  struct stat info;
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 &&
+      static_cast<unsigned long long>(info.st_size) <= static_cast<size_t>(-1))
+  {
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* addr = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED)
+    {
+      madvise(addr, size, MADV_SEQUENTIAL);
+      madvise(addr, size, MADV_WILLNEED);
+      data_ = static_cast<const char*>(addr);
+      size_ = size;
+    }
+  }
+  // The mapping stays valid after the descriptor is closed
+  ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+  if (data_) munmap(const_cast<char*>(data_), size_);
+}
+
+#endif
+
+size_t
+MappedFile::read(void* buffer, size_t size, size_t nmemb)
+{
+  if (size == 0 || nmemb == 0) return (0);
+  const size_t available = (size_ - position_)/size;
+  const size_t count = nmemb < available ? nmemb : available;
+  memcpy(buffer, data_ + position_, count*size);
+  position_ += count*size;
+  return (count);
+}
+
+const char*
+MappedFile::consume(size_t len)
+{
+  if (len > size_ - position_) return (0);
+  const char* ptr = data_ + position_;
+  position_ += len;
+  return (ptr);
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_UTIL_LEGACY_MAPPEDFILE_H
+#define CORE_UTIL_LEGACY_MAPPEDFILE_H 1
+
+#include <boost/noncopyable.hpp>
+#include <string>
+#include <cstddef>
+
+#include <Core/Utils/Legacy/share.h>
+
+namespace SCIRun {
+
+/// Read only memory mapping of a complete file with a read position, used
+/// by the binary Piostreams instead of stdio when reading from a file and by
+/// TextTable. A read copies straight from the page cache instead of going
+/// through the stdio buffer, and the kernel is told the file is read front
+/// to back so it reads ahead aggressively. Large blocks (field data, matrix
+/// entries) are copied with a single memcpy.
+class SCISHARE MappedFile : boost::noncopyable
+{
+public:
+  /// Maps the file, is_open() returns false if the file cannot be mapped
+  /// (empty files, special files, out of address space). Callers then fall
+  /// back to stdio.
+  explicit MappedFile(const std::string& filename);
+  ~MappedFile();
+
+  bool is_open() const { return (data_ != 0); }
+  const char* data() const { return (data_); }
+  size_t size() const { return (size_); }
+
+  /// Same semantics as fread: returns the number of complete members read.
+  size_t read(void* buffer, size_t size, size_t nmemb);
+  /// Pointer to the next len bytes, which are consumed, or 0 if the file
+  /// does not have that many bytes left.
+  const char* consume(size_t len);
+
+  void seek(size_t position) { position_ = position < size_ ? position : size_; }
+  size_t tell() const { return (position_); }
+  bool eof() const { return (position_ >= size_); }
+
+  /// Whether the Piostreams map files when reading, on by default.
+  static bool enabled();
+  static void set_enabled(bool enable);
+
+private:
+  const char* data_;
+  size_t size_;
+  size_t position_;
+#ifdef _WIN32
+  void* file_;
+  void* mapping_;
+#endif
+};
+
+}
+
+#endif
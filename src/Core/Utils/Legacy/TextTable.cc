@@ -0,0 +1,320 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Utils/Legacy/TextTable.h>
+#include <Core/Utils/Legacy/MappedFile.h>
+#include <Core/Thread/Parallel.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+using namespace SCIRun::Core::Thread;
+
+namespace SCIRun {
+
+// Below this size the whole buffer is parsed by the calling thread
+static const size_t MIN_PARALLEL_SIZE = 1 << 20;
+
+static const double powers_of_ten[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+static inline bool
+is_separator(char c)
+{
+  return (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == '"');
+}
+
+static inline bool
+is_digit(char c)
+{
+  return (c >= '0' && c <= '9');
+}
+
+// Parse with strtod, for everything the fast path does not handle exactly
+static const char*
+parse_double_slow(const char* begin, const char* end, double& value)
+{
+  const char* token_end = begin;
+  while (token_end < end && !is_separator(*token_end)) token_end++;
+  const std::string token(begin, token_end);
+  char* stop = 0;
+  value = strtod(token.c_str(), &stop);
+  return (begin + (stop - token.c_str()));
+}
+
+const char*
+TextTable::parse_double(const char* begin, const char* end, double& value)
+{
+  const char* p = begin;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) { negative = (*p == '-'); p++; }
+
+  // Up to 19 significant digits fit in the mantissa
+  unsigned long long mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool any = false;
+  bool truncated = false;
+
+  for (; p < end && is_digit(*p); p++)
+  {
+    any = true;
+    if (digits < 19)
+    {
+      mantissa = 10*mantissa + (*p - '0');
+      if (mantissa) digits++;
+    }
+    else
+    {
+      exponent++;
+      truncated = true;
+    }
+  }
+
+  if (p < end && *p == '.')
+  {
+    for (p++; p < end && is_digit(*p); p++)
+    {
+      any = true;
+      if (digits < 19)
+      {
+        mantissa = 10*mantissa + (*p - '0');
+        if (mantissa) digits++;
+        exponent--;
+      }
+      else if (*p != '0')
+      {
+        truncated = true;
+      }
+    }
+  }
+
+  // inf, nan and hexadecimal numbers
+  if (!any) return (parse_double_slow(begin, end, value));
+
+  if (p < end && (*p == 'e' || *p == 'E'))
+  {
+    const char* q = p + 1;
+    bool negative_exponent = false;
+    if (q < end && (*q == '-' || *q == '+')) { negative_exponent = (*q == '-'); q++; }
+    if (q < end && is_digit(*q))
+    {
+      int e = 0;
+      for (; q < end && is_digit(*q); q++)
+        if (e < 100000) e = 10*e + (*q - '0');
+      exponent += negative_exponent ? -e : e;
+      p = q;
+    }
+  }
+
+  // Both the mantissa and the power of ten are exact doubles, so a single
+  // multiplication or division rounds correctly
+  if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+  {
+    double v = static_cast<double>(mantissa);
+    v = (exponent < 0) ? v/powers_of_ten[-exponent] : v*powers_of_ten[exponent];
+    value = negative ? -v : v;
+    return (p);
+  }
+
+  return (parse_double_slow(begin, end, value));
+}
+
+// All numbers of one line, or of a whole buffer when lines do not matter
+static void
+parse_tokens(const char* p, const char* end, std::vector<double>& values)
+{
+  while (p < end)
+  {
+    while (p < end && is_separator(*p)) p++;
+    if (p >= end) break;
+
+    double value;
+    const char* q = TextTable::parse_double(p, end, value);
+    if (q != p) values.push_back(value);
+
+    // Skip what is left of the word
+    while (q < end && !is_separator(*q)) q++;
+    p = q;
+  }
+}
+
+namespace {
+
+  struct Chunk
+  {
+    const char* begin;
+    const char* end;
+    std::vector<double> values;
+    std::vector<size_t> rows;
+  };
+
+  void parse_lines(Chunk& chunk)
+  {
+    const char* p = chunk.begin;
+    while (p < chunk.end)
+    {
+      const char* line_end = static_cast<const char*>(memchr(p, '\n', chunk.end - p));
+      if (!line_end) line_end = chunk.end;
+
+      if (*p != '#' && *p != '%')
+      {
+        const size_t before = chunk.values.size();
+        parse_tokens(p, line_end, chunk.values);
+        if (chunk.values.size() > before) chunk.rows.push_back(before);
+      }
+      p = (line_end < chunk.end) ? line_end + 1 : chunk.end;
+    }
+  }
+
+  // Split into one chunk per core, moving every boundary forward to the
+  // first position for which at_boundary holds
+  template <class Boundary>
+  std::vector<Chunk> split(const char* begin, const char* end, Boundary at_boundary)
+  {
+    const size_t size = end - begin;
+    size_t num = 1;
+    if (size >= MIN_PARALLEL_SIZE) num = std::max(Parallel::NumCores(), 1u);
+
+    std::vector<Chunk> chunks(num);
+    const char* p = begin;
+    for (size_t i = 0; i < num; i++)
+    {
+      const char* q = (i+1 == num) ? end : std::max(p, begin + (size*(i+1))/num);
+      while (q < end && !at_boundary(q, begin)) q++;
+      chunks[i].begin = p;
+      chunks[i].end = q;
+      p = q;
+    }
+    return (chunks);
+  }
+
+  void run(std::vector<Chunk>& chunks, void (*task)(Chunk&))
+  {
+    if (chunks.size() == 1)
+    {
+      task(chunks[0]);
+      return;
+    }
+    auto parse_task = [&chunks, task](int proc) { task(chunks[proc]); };
+    Parallel::RunTasks(parse_task, static_cast<int>(chunks.size()));
+  }
+
+  void parse_all(Chunk& chunk)
+  {
+    parse_tokens(chunk.begin, chunk.end, chunk.values);
+  }
+
+  void concatenate(std::vector<Chunk>& chunks, std::vector<double>& values, std::vector<size_t>* rows)
+  {
+    size_t num_values = 0, num_rows = 0;
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+      num_values += chunks[i].values.size();
+      num_rows += chunks[i].rows.size();
+    }
+
+    values.resize(num_values);
+    if (rows) rows->resize(num_rows);
+
+    size_t value_offset = 0, row_offset = 0;
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+      const Chunk& chunk = chunks[i];
+      if (!chunk.values.empty())
+        memcpy(&values[value_offset], &chunk.values[0], chunk.values.size()*sizeof(double));
+      if (rows)
+      {
+        for (size_t r = 0; r < chunk.rows.size(); r++)
+          (*rows)[row_offset + r] = value_offset + chunk.rows[r];
+      }
+      value_offset += chunk.values.size();
+      row_offset += chunk.rows.size();
+    }
+  }
+
+}
+
+bool
+TextTable::read(const std::string& filename)
+{
+  MappedFile mapped(filename);
+  if (mapped.is_open())
+  {
+    parse(mapped.data(), mapped.data() + mapped.size());
+    return (true);
+  }
+
+  // Empty or special files cannot be mapped
+  FILE* fp = fopen(filename.c_str(), "rb");
+  if (!fp) return (false);
+  std::vector<char> buffer;
+  char block[65536];
+  size_t n;
+  while ((n = fread(block, 1, sizeof(block), fp)) > 0)
+    buffer.insert(buffer.end(), block, block + n);
+  fclose(fp);
+
+  if (buffer.empty()) parse(0, 0);
+  else parse(&buffer[0], &buffer[0] + buffer.size());
+  return (true);
+}
+
+void
+TextTable::parse(const char* begin, const char* end)
+{
+  std::vector<Chunk> chunks = split(begin, end,
+    [](const char* p, const char* start) { return (p > start && p[-1] == '\n'); });
+  run(chunks, parse_lines);
+  concatenate(chunks, values_, &row_begin_);
+}
+
+void
+TextTable::parse_numbers(const char* begin, const char* end, std::vector<double>& values)
+{
+  std::vector<Chunk> chunks = split(begin, end,
+    [](const char* p, const char*) { return (is_separator(*p)); });
+  run(chunks, parse_all);
+  concatenate(chunks, values, 0);
+}
+
+long long
+TextTable::columns(size_t first) const
+{
+  if (first >= num_rows()) return (0);
+  const size_t n = row_size(first);
+  for (size_t r = first + 1; r < num_rows(); r++)
+    if (row_size(r) != n) return (-1);
+  return (static_cast<long long>(n));
+}
+
+}
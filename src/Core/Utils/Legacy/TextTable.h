@@ -0,0 +1,83 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_UTIL_LEGACY_TEXTTABLE_H
+#define CORE_UTIL_LEGACY_TEXTTABLE_H 1
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include <Core/Utils/Legacy/share.h>
+
+namespace SCIRun {
+
+/// Numbers in a text file as one flat array, for the importers of text
+/// meshes and matrices. The file is mapped and cut into chunks on line
+/// boundaries that are parsed on all cores, numbers are converted without
+/// going through streams or temporary strings.
+///
+/// The rules follow multiple_from_string as used by the importers: lines
+/// starting with '#' or '%' are comments, spaces, tabs, commas and double
+/// quotes separate values, words that do not start with a number are
+/// skipped. Lines without any number do not count as rows.
+class SCISHARE TextTable
+{
+public:
+  /// Returns false if the file cannot be opened.
+  bool read(const std::string& filename);
+  void parse(const char* begin, const char* end);
+
+  size_t num_rows() const { return (row_begin_.size()); }
+  size_t row_size(size_t row) const
+  {
+    return ((row+1 < row_begin_.size() ? row_begin_[row+1] : values_.size()) - row_begin_[row]);
+  }
+  const double* row(size_t row) const { return (&values_[row_begin_[row]]); }
+  const std::vector<double>& values() const { return (values_); }
+
+  /// Number of values on every row starting at first, -1 if that differs.
+  long long columns(size_t first = 0) const;
+
+  /// All numbers in [begin,end) ignoring lines and comments, parsed in
+  /// parallel.
+  static void parse_numbers(const char* begin, const char* end, std::vector<double>& values);
+
+  /// Parses the number at begin, returns the position after it or begin if
+  /// there is no number.
+  static const char* parse_double(const char* begin, const char* end, double& value);
+
+private:
+  std::vector<double> values_;
+  std::vector<size_t> row_begin_;
+};
+
+}
+
+#endif
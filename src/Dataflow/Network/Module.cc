@@ -358,6 +358,11 @@ void Module::copyStateToMetadata()
   impl_->metadata_.setMetadata("Module state", stateMetaInfo());
 }
 
+void Module::setMetadata(const std::string& key, const std::string& value)
+{
+  impl_->metadata_.setMetadata(key, value);
+}
+
 bool Module::executeWithSignals() NOEXCEPT
 {
   auto starting = "STARTING MODULE: " + get_id().id_;
@@ -175,6 +175,8 @@ namespace Networks {
     void sendFeedbackUpstreamAlongIncomingConnections(const Core::Datatypes::ModuleFeedback& feedback) const;
     std::string stateMetaInfo() const;
     void copyStateToMetadata();
+    /// Additional execution details shown in the module metadata, e.g. timings.
+    void setMetadata(const std::string& key, const std::string& value);
 
     friend class ModuleBuilder;
 
@@ -14,6 +14,7 @@ namespace fs = spire;
 namespace ren {
 
 std::string ShaderMan::mShaderHeader;
+std::map<std::string, std::string> ShaderMan::mFragmentShaderAssets;
 
 ShaderMan::ShaderMan(int numRetries) :
     mNewUnfulfilledAssets(false),
@@ -35,6 +36,12 @@ void ShaderMan::setShaderHeaderCode(const std::string& header)
   mShaderHeader = header;
 }
 
+void ShaderMan::setFragmentShaderAsset(const std::string& assetName,
+                                       const std::string& fragmentAssetName)
+{
+  mFragmentShaderAssets[assetName] = fragmentAssetName;
+}
+
 void ShaderMan::loadVertexAndFragmentShader(
     spire::CerealCore& core, uint64_t entityID,
     const std::string& assetName)
@@ -126,7 +133,9 @@ void ShaderMan::loadVertexShaderCB(const std::string& /* vsName */, bool error,
 
     std::free(vertexSourceRaw);
 
-    std::string fragmentShader = assetName + ".fs";
+    auto fragmentAsset = mFragmentShaderAssets.find(assetName);
+    std::string fragmentShader = (fragmentAsset != mFragmentShaderAssets.end() ?
+                                  fragmentAsset->second : assetName) + ".fs";
     fs::StaticFS* frag = core.getStaticComponent<fs::StaticFS>();
 
     /// \todo Get rid of this code when we switch to the new emscripten backend.
@@ -29,13 +29,19 @@ public:
 
   static void setShaderHeaderCode(const std::string& header);
 
+  /// Compiles 'assetName' with the fragment shader of 'fragmentAssetName',
+  /// for shaders that only differ in their vertex stage.
+  static void setFragmentShaderAsset(const std::string& assetName,
+                                     const std::string& fragmentAssetName);
+
   /// Loads a vertex and fragment shader given an asset name. This load does not
   /// happen immediately and is performed asynchronously. ShaderPromiseFV is
   /// used to keep track of the promises and add the shader component when
   /// it is loaded. If the asset is already loaded, then the shader component
   /// will be applied the next time the promise fulfillment system is run.
   /// The vertex and fragment shader *must* conform to the following
-  /// naming convention: assetName + ".vs" and assetName + ".fs"
+  /// naming convention: assetName + ".vs" and assetName + ".fs", unless
+  /// another fragment shader was set with setFragmentShaderAsset.
   /// \param  core        Core base.
   /// \param  entityID    Entity ID which will receive the ren::Shader component.
   /// \param  assetName   Name of the asset which to load.
@@ -114,6 +120,9 @@ private:
 
   // Shader header.
   static std::string mShaderHeader;
+
+  // Fragment shader assets used in place of assetName + ".fs".
+  static std::map<std::string, std::string> mFragmentShaderAssets;
 };
 
 } // namespace ren
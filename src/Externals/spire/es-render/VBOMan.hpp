@@ -55,6 +55,9 @@ public:
                         const std::vector<std::tuple<std::string, size_t, bool>>& attribs,
                         const std::string& assetName);
 
+  /// Deletes a VBO added with addInMemoryVBO.
+  void removeInMemoryVBO(GLuint glid);
+
   /// Returns a list of sorted VBO attributes, based on glid.
   const std::vector<spire::ShaderAttribute>& getVBOAttributes(GLuint glid) const;
 
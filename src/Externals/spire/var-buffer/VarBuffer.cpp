@@ -56,6 +56,21 @@ void VarBuffer::writeNullTermString(const char* str)
   mSerializer->writeNullTermString(str);
 }
 
+char* VarBuffer::allocate(size_t numBytes)
+{
+  RENDERER_LOG("VarBuffer allocate (numBytes {})", numBytes);
+
+  // Resize the buffer if necessary.
+  while (mSerializer->getOffset() + numBytes > static_cast<size_t>(mBufferSize))
+  {
+    resize();
+  }
+
+  size_t offset = mSerializer->getOffset();
+  mSerializer->setOffset(offset + numBytes);
+  return getBuffer() + offset;
+}
+
 void VarBuffer::resize()
 {
   mBufferSize *= 2;
@@ -31,6 +31,10 @@ public:
   /// Writes a null terminated string.
   void writeNullTermString(const char* str);
 
+  /// Reserves \p numBytes at the current write position and returns a
+  /// pointer to them, so large arrays can be filled in place.
+  char* allocate(size_t numBytes);
+
   template <typename T>
   void write(const T& val)
   {
@@ -37,6 +37,7 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <limits>
 #include <glm/glm.hpp>
 #include <var-buffer/VarBuffer.hpp>
 #include <es-cereal/ComponentSerialize.hpp>
@@ -64,6 +65,7 @@ namespace SCIRun {
         RENDER_VBO_IBO,
         RENDER_RLIST_SPHERE,
         RENDER_RLIST_CYLINDER,
+        RENDER_INSTANCED,
       };
 
       // Could require rvalue references...
@@ -145,6 +147,40 @@ namespace SCIRun {
         std::vector<uint8_t>                  bitmap;
       };
 
+      /// Per instance attributes of a RENDER_INSTANCED pass, the VBO and IBO of
+      /// the pass are drawn once for every instance. An instance is an affine
+      /// frame of 12 floats, the three (scaled) axes followed by the origin,
+      /// and an RGBA color of 4 bytes.
+      struct SpireInstances
+      {
+        SpireInstances() : numInstances(0) {}
+        SpireInstances(std::shared_ptr<spire::VarBuffer> instanceData, int64_t num) :
+          data(instanceData),
+          numInstances(num)
+        {}
+
+        static size_t instanceSize() { return 12 * sizeof(float) + 4 * sizeof(uint8_t); }
+
+        std::shared_ptr<spire::VarBuffer> data;
+        int64_t                               numInstances;
+      };
+
+      /// Screen space range in which a pass is drawn, used to switch between
+      /// meshes of different resolution. The size is the diameter of the
+      /// bounding sphere on screen as a fraction of the viewport height (1
+      /// when the sphere just fills the view vertically), the pass is drawn while
+      /// minSize <= size < maxSize. A zero radius draws the pass at any size.
+      struct SpireLevelOfDetail
+      {
+        SpireLevelOfDetail() : center(0.0f), radius(0.0f), minSize(0.0f),
+          maxSize(std::numeric_limits<float>::max()) {}
+
+        glm::vec3 center;
+        float     radius;
+        float     minSize;
+        float     maxSize;
+      };
+
       /// Defines a Spire object 'pass'.
       struct SpireSubPass
       {
@@ -184,6 +220,8 @@ namespace SCIRun {
         SpireVBO			vbo;
         SpireIBO			ibo;
         SpireText     text;//draw a string (usually single character) on geometry
+        SpireInstances instances;
+        SpireLevelOfDetail lod;
         double        scalar;
 
         struct Uniform
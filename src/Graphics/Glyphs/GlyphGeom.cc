@@ -29,6 +29,9 @@ DEALINGS IN THE SOFTWARE.
 #include <Graphics/Glyphs/GlyphGeom.h>
 #include <Core/Math/MiscMath.h>
 #include <Core/GeometryPrimitives/Transform.h>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <map>
 
 using namespace SCIRun;
 using namespace Graphics;
@@ -206,6 +209,164 @@ void GlyphGeom::buildObject(GeometryObjectSpire& geom, const std::string& unique
   geom.passes().push_back(pass);
 }
 
+namespace
+{
+  struct TemplateBuffers
+  {
+    std::shared_ptr<spire::VarBuffer> vbo;
+    std::shared_ptr<spire::VarBuffer> ibo;
+    int64_t numVertices;
+  };
+
+  // Template meshes are immutable once built, objects with the same shape and
+  // resolution share the buffers.
+  boost::mutex templateLock;
+  std::map<std::pair<int, int>, TemplateBuffers> templateCache;
+}
+
+void GlyphGeom::getTemplateMesh(TemplateShape shape, double resolution,
+  std::vector<Vector>& points, std::vector<Vector>& normals, std::vector<uint32_t>& indices)
+{
+  GlyphGeom glyphs;
+  std::vector<ColorRGB> colors;
+  int64_t numVBOElements = 0;
+  const ColorRGB white;
+  const Point origin(0, 0, 0), mid(0, 0, 0.5), tip(0, 0, 1);
+
+  points.clear();
+  normals.clear();
+  indices.clear();
+
+  switch (shape)
+  {
+  case TemplateShape::ARROW:
+    glyphs.generateCylinder(origin, mid, 1.0 / 6.0, 1.0 / 6.0, resolution, white, white, numVBOElements, points, normals, indices, colors);
+    glyphs.generateCylinder(mid, tip, 1.0, 0.0, resolution, white, white, numVBOElements, points, normals, indices, colors);
+    break;
+  case TemplateShape::CONE:
+    glyphs.generateCylinder(origin, tip, 1.0, 0.0, resolution, white, white, numVBOElements, points, normals, indices, colors);
+    break;
+  case TemplateShape::CYLINDER:
+    glyphs.generateCylinder(origin, tip, 1.0, 1.0, resolution, white, white, numVBOElements, points, normals, indices, colors);
+    break;
+  case TemplateShape::SPHERE:
+    glyphs.generateSphere(origin, 1.0, 1.0, resolution, white, numVBOElements, points, normals, indices, colors);
+    break;
+  }
+}
+
+void GlyphGeom::addInstance(const Point& p1, const Point& p2, double radius, const ColorRGB& color)
+{
+  Vector z = p2 - p1;
+  double length = z.length();
+
+  // Same construction of the perpendicular axes as generateCylinder
+  Vector n = length > 0.0 ? -z / length : Vector(0, 0, -1);
+  Vector u = (10 * n + Vector(10, 10, 10)).normal();
+  Vector crx = Cross(u, n).normal();
+  u = Cross(crx, n).normal();
+
+  addInstance(p1, radius * u, radius * crx, z, color);
+}
+
+void GlyphGeom::addInstance(const Point& center, const Vector& x, const Vector& y, const Vector& z, const ColorRGB& color)
+{
+  const Vector axes[4] = { x, y, z, Vector(center) };
+  for (const auto& a : axes)
+  {
+    instanceFrames_.push_back(static_cast<float>(a.x()));
+    instanceFrames_.push_back(static_cast<float>(a.y()));
+    instanceFrames_.push_back(static_cast<float>(a.z()));
+  }
+  instanceColors_.push_back(color);
+}
+
+void GlyphGeom::buildInstancedObject(GeometryObjectSpire& geom, const std::string& uniqueNodeID,
+  TemplateShape shape, double resolution, const bool isTransparent, const double transparencyValue,
+  const ColorScheme& colorScheme, RenderState state, const BBox& bbox)
+{
+  std::string vboName = uniqueNodeID + "TemplateVBO";
+  std::string iboName = uniqueNodeID + "TemplateIBO";
+  std::string passName = uniqueNodeID + "Pass";
+
+  TemplateBuffers buffers;
+  {
+    boost::lock_guard<boost::mutex> lock(templateLock);
+    auto key = std::make_pair(static_cast<int>(shape), static_cast<int>(resolution));
+    auto it = templateCache.find(key);
+    if (it == templateCache.end())
+    {
+      std::vector<Vector> points, normals;
+      std::vector<uint32_t> indices;
+      getTemplateMesh(shape, resolution, points, normals, indices);
+
+      buffers.numVertices = static_cast<int64_t>(points.size());
+      buffers.vbo.reset(new spire::VarBuffer(points.size() * 6 * sizeof(float)));
+      buffers.ibo.reset(new spire::VarBuffer(indices.size() * sizeof(uint32_t)));
+      for (size_t i = 0; i < points.size(); i++)
+      {
+        buffers.vbo->write(static_cast<float>(points[i].x()));
+        buffers.vbo->write(static_cast<float>(points[i].y()));
+        buffers.vbo->write(static_cast<float>(points[i].z()));
+        buffers.vbo->write(static_cast<float>(normals[i].x()));
+        buffers.vbo->write(static_cast<float>(normals[i].y()));
+        buffers.vbo->write(static_cast<float>(normals[i].z()));
+      }
+      for (auto a : indices)
+        buffers.ibo->write(a);
+      it = templateCache.insert(std::make_pair(key, buffers)).first;
+    }
+    buffers = it->second;
+  }
+
+  std::vector<SpireVBO::AttributeData> attribs;
+  attribs.push_back(SpireVBO::AttributeData("aPos", 3 * sizeof(float)));
+  attribs.push_back(SpireVBO::AttributeData("aNormal", 3 * sizeof(float)));
+
+  // The colors of all schemes are resolved per instance, the renderer sets
+  // uDiffuseColor before drawing each instance.
+  std::string shader = geom.isClippable() ? "Shaders/DirPhongInstanced" : "Shaders/DirPhongNoClipping";
+  std::vector<SpireSubPass::Uniform> uniforms;
+  if (isTransparent)
+    uniforms.push_back(SpireSubPass::Uniform("uTransparency", static_cast<float>(transparencyValue)));
+  uniforms.push_back(SpireSubPass::Uniform("uAmbientColor", glm::vec4(0.1f, 0.1f, 0.1f, 1.0f)));
+  uniforms.push_back(SpireSubPass::Uniform("uDiffuseColor", glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)));
+  uniforms.push_back(SpireSubPass::Uniform("uSpecularColor", glm::vec4(0.1f, 0.1f, 0.1f, 0.1f)));
+  uniforms.push_back(SpireSubPass::Uniform("uSpecularPower", 32.0f));
+
+  const size_t num = instanceColors_.size();
+  std::shared_ptr<spire::VarBuffer> instanceBuffer(new spire::VarBuffer(num * SpireInstances::instanceSize()));
+  const uint8_t alpha = static_cast<uint8_t>(255.0 * std::max(0.0, std::min(1.0, transparencyValue)));
+  for (size_t i = 0; i < num; i++)
+  {
+    for (size_t k = 0; k < 12; k++)
+      instanceBuffer->write(instanceFrames_[12 * i + k]);
+
+    const ColorRGB& c = colorScheme == ColorScheme::COLOR_UNIFORM ? state.defaultColor : instanceColors_[i];
+    instanceBuffer->write(static_cast<uint8_t>(255.0 * std::max(0.0, std::min(1.0, c.r()))));
+    instanceBuffer->write(static_cast<uint8_t>(255.0 * std::max(0.0, std::min(1.0, c.g()))));
+    instanceBuffer->write(static_cast<uint8_t>(255.0 * std::max(0.0, std::min(1.0, c.b()))));
+    instanceBuffer->write(alpha);
+  }
+
+  SpireVBO geomVBO(vboName, attribs, buffers.vbo, buffers.numVertices, bbox, true);
+  SpireIBO geomIBO(iboName, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), buffers.ibo);
+
+  state.set(RenderState::IS_ON, true);
+  state.set(RenderState::HAS_DATA, true);
+
+  SpireText text;
+
+  SpireSubPass pass(passName, vboName, iboName, shader, colorScheme, state, RenderType::RENDER_INSTANCED, geomVBO, geomIBO, text);
+  pass.instances = SpireInstances(instanceBuffer, static_cast<int64_t>(num));
+
+  for (const auto& uniform : uniforms) { pass.addUniform(uniform); }
+
+  geom.vbos().push_back(geomVBO);
+  geom.ibos().push_back(geomIBO);
+  geom.passes().push_back(pass);
+}
+
 void GlyphGeom::addArrow(const Point& p1, const Point& p2, double radius, double resolution,
   const ColorRGB& color1, const ColorRGB& color2)
 {
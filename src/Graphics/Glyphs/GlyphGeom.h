@@ -45,6 +45,17 @@ namespace SCIRun {
     public:
       typedef std::vector<std::pair<Core::Geometry::Point, Core::Geometry::Vector>> QuadStrip;
 
+      /// Shapes that can be drawn as copies of a single template mesh. The
+      /// templates have unit radius and run from the origin along +z to z = 1,
+      /// the sphere is centered at the origin.
+      enum class TemplateShape
+      {
+        ARROW,
+        CONE,
+        CYLINDER,
+        SPHERE
+      };
+
       GlyphGeom();
 
       void getBufferInfo(int64_t& numVBOElements, std::vector<Core::Geometry::Vector>& points,
@@ -75,6 +86,29 @@ namespace SCIRun {
         const Core::Datatypes::ColorRGB& color1, const Core::Datatypes::ColorRGB& color2);
       void addPoint(const Core::Geometry::Point& p, const Core::Datatypes::ColorRGB& color);
 
+      /// Instanced glyphs: instead of tessellating every glyph, only a frame
+      /// and a color are stored per glyph. The glyph from p1 to p2 of the
+      /// given radius, for the arrow, cone and cylinder templates.
+      void addInstance(const Core::Geometry::Point& p1, const Core::Geometry::Point& p2, double radius,
+        const Core::Datatypes::ColorRGB& color);
+      /// A glyph with a general frame, e.g. the scaled eigenvectors of a tensor.
+      void addInstance(const Core::Geometry::Point& center, const Core::Geometry::Vector& x,
+        const Core::Geometry::Vector& y, const Core::Geometry::Vector& z, const Core::Datatypes::ColorRGB& color);
+      size_t numInstances() const { return instanceColors_.size(); }
+
+      /// Builds a pass that draws the template mesh once per instance. The
+      /// template is shared between all objects using the same shape and
+      /// resolution. The expanded add* functions and buildObject remain the
+      /// path for consumers that need plain triangles.
+      void buildInstancedObject(Datatypes::GeometryObjectSpire& geom, const std::string& uniqueNodeID,
+        TemplateShape shape, double resolution, const bool isTransparent, const double transparencyValue,
+        const Datatypes::ColorScheme& colorScheme, RenderState state, const Core::Geometry::BBox& bbox);
+
+      /// The template mesh of a shape as triangles with normals.
+      static void getTemplateMesh(TemplateShape shape, double resolution,
+        std::vector<Core::Geometry::Vector>& points, std::vector<Core::Geometry::Vector>& normals,
+        std::vector<uint32_t>& indices);
+
       //From SCIRun4
       void addArrow(const Core::Geometry::Point& center, const Core::Geometry::Vector& t, double radius, double length, int nu = 20, int nv = 0);
       void addBox(const Core::Geometry::Point& center, const Core::Geometry::Vector& t, double x_side, double y_side, double z_side);
@@ -89,6 +123,8 @@ namespace SCIRun {
       std::vector<uint32_t> indices_;
       int64_t numVBOElements_;
       uint32_t lineIndex_;
+      std::vector<float> instanceFrames_;
+      std::vector<Core::Datatypes::ColorRGB> instanceColors_;
 
       void generateCylinder(const  Core::Geometry::Point& p1, const  Core::Geometry::Point& p2, double radius1, double radius2, double resolution, const Core::Datatypes::ColorRGB& color1, const Core::Datatypes::ColorRGB& color2,
         int64_t& numVBOElements, std::vector<Core::Geometry::Vector>& points, std::vector<Core::Geometry::Vector>& normals, std::vector<uint32_t>& indices, std::vector<Core::Datatypes::ColorRGB>& colors);
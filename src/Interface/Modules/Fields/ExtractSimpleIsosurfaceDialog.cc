@@ -47,4 +47,5 @@ ExtractSimpleIsosurfaceDialog::ExtractSimpleIsosurfaceDialog(const std::string&
   addTextEditManager(isovalListFromQuantityTextEdit_, Parameters::IsovalueListString);
   WidgetStyleMixin::tabStyle(tabWidget);
   addTabManager(tabWidget, Parameters::IsovalueChoice);
+  addCheckBoxManager(coarseToFineCheckBox_, Parameters::IsosurfaceCoarseToFine);
 }
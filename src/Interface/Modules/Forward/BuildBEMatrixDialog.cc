@@ -57,6 +57,9 @@ BuildBEMatrixDialog::BuildBEMatrixDialog(const std::string& name, ModuleStateHan
   WidgetStyleMixin::tableHeaderStyle(this->tableWidget);
   tableWidget->resizeColumnsToContents();
 
+  addCheckBoxManager(useHierarchicalMatricesCheckBox_, Parameters::UseHierarchicalMatrices);
+  addDoubleSpinBoxManager(hierarchicalMatrixToleranceSpinBox_, Parameters::HierarchicalMatrixTolerance);
+
   connect(tableWidget, SIGNAL(cellChanged(int,int)), this, SLOT(pushTable(int,int)));
 }
 
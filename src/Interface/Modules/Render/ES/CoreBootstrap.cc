@@ -88,6 +88,9 @@ public:
     core.addGarbageCollectorSystem(ren::IBOMan::getGCName());
     core.addGarbageCollectorSystem(ren::VBOMan::getGCName());
 
+    // Instances are lit like any other DirPhong geometry.
+    ren::ShaderMan::setFragmentShaderAsset("Shaders/DirPhongInstanced", "Shaders/DirPhong");
+
     // -- Static Rendering Components --
     core.addStaticComponent(ren::StaticShaderMan());
     core.addExemptComponent<ren::StaticShaderMan>();
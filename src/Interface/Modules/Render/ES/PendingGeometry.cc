@@ -0,0 +1,146 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Interface/Modules/Render/ES/PendingGeometry.h>
+#include <algorithm>
+
+using namespace SCIRun::Render;
+using namespace SCIRun::Graphics::Datatypes;
+using namespace SCIRun::Core::Datatypes;
+
+bool SCIRun::Render::isSameObject(const std::string& id, const std::string& otherID)
+{
+  return GeometryObject::stableID(id) == GeometryObject::stableID(otherID);
+}
+
+PendingObject::PendingObject() : port(0), progressive(false), numPassesAdded(0)
+{
+}
+
+PendingObject::PendingObject(GeometryHandle obj, int objPort,
+  const GeometryBuffers* currentVBOs, const GeometryBuffers* currentIBOs,
+  const std::string& assetSuffix, const IsOnGPU& isOnGPU) :
+  object(obj), port(objPort), progressive(!currentVBOs || !currentIBOs), numPassesAdded(0)
+{
+  auto queue = [&](bool isVBO, const std::string& name, std::shared_ptr<spire::VarBuffer> data,
+    const GeometryBuffers* current)
+  {
+    GeometryBuffers& buffers = isVBO ? vbos : ibos;
+    if (buffers.count(name)) return;
+
+    GeometryBuffer buffer = { data, name + assetSuffix };
+    if (current)
+    {
+      auto old = current->find(name);
+      if (old != current->end() && old->second.data == data && isOnGPU(isVBO, old->second.assetName))
+        buffer.assetName = old->second.assetName;
+    }
+    buffers[name] = buffer;
+    if (buffer.assetName == name + assetSuffix)
+    {
+      uploads.push_back(Upload(isVBO, name));
+      (isVBO ? waitingVBOs : waitingIBOs).insert(name);
+    }
+  };
+  auto queueVBO = [&](const SpireVBO& vbo)
+  {
+    if (vbo.onGPU) queue(true, vbo.name, vbo.data, currentVBOs);
+  };
+  auto queueIBO = [&](const SpireIBO& ibo)
+  {
+    queue(false, ibo.name, ibo.data, currentIBOs);
+  };
+
+  for (const auto& pass : object->passes())
+  {
+    for (const auto& vbo : object->vbos())
+      if (vbo.name == pass.vboName) queueVBO(vbo);
+    for (const auto& ibo : object->ibos())
+      if (ibo.name == pass.iboName) queueIBO(ibo);
+  }
+  for (const auto& vbo : object->vbos()) queueVBO(vbo);
+  for (const auto& ibo : object->ibos()) queueIBO(ibo);
+}
+
+std::list<PendingObject::Upload> PendingObject::takeUploads(size_t& budget)
+{
+  // At least one buffer is uploaded per frame, larger ones are split into
+  // chunks by the modules.
+  std::list<Upload> taken;
+  while (!uploads.empty() && budget > 0)
+  {
+    const Upload upload = uploads.front();
+    uploads.pop_front();
+    budget -= std::min(budget, std::max<size_t>(bufferSize(upload), 1));
+
+    (upload.first ? waitingVBOs : waitingIBOs).erase(upload.second);
+    uploaded.push_back(upload);
+    taken.push_back(upload);
+  }
+  return taken;
+}
+
+size_t PendingObject::readyPasses() const
+{
+  size_t ready = 0;
+  for (const auto& pass : object->passes())
+  {
+    if (waitingVBOs.count(pass.vboName) || waitingIBOs.count(pass.iboName))
+      break;
+    ++ready;
+  }
+  return ready;
+}
+
+std::vector<std::string> PendingObject::replacedAssets(const GeometryBuffers& buffers,
+  const GeometryBuffers& next)
+{
+  std::vector<std::string> replaced;
+  for (const auto& buffer : buffers)
+  {
+    auto kept = next.find(buffer.first);
+    if (kept == next.end() || kept->second.assetName != buffer.second.assetName)
+      replaced.push_back(buffer.second.assetName);
+  }
+  return replaced;
+}
+
+size_t PendingObject::bufferSize(const Upload& upload) const
+{
+  if (upload.first)
+  {
+    for (const auto& vbo : object->vbos())
+      if (vbo.name == upload.second) return vbo.data->getBufferSize();
+  }
+  else
+  {
+    for (const auto& ibo : object->ibos())
+      if (ibo.name == upload.second) return ibo.data->getBufferSize();
+  }
+  return 0;
+}
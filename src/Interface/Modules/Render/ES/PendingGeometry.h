@@ -0,0 +1,119 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INTERFACE_MODULES_RENDER_ES_PENDINGGEOMETRY_H
+#define INTERFACE_MODULES_RENDER_ES_PENDINGGEOMETRY_H
+
+#include <Graphics/Datatypes/GeometryImpl.h>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include <Interface/Modules/Render/share.h>
+
+namespace SCIRun {
+namespace Render {
+
+/// A buffer on the GPU and the name of its asset. Every upload gets a new
+/// asset name, so a new version of an object can be uploaded while the old
+/// one is still drawn.
+struct GeometryBuffer
+{
+  std::shared_ptr<spire::VarBuffer> data;
+  std::string                       assetName;
+};
+
+/// Buffers of an object by name.
+typedef std::map<std::string, GeometryBuffer> GeometryBuffers;
+
+/// Whether two geometry IDs name versions of the same object. Modules send
+/// every version under a new ID, only the stable part stays the same.
+SCISHARE bool isSameObject(const std::string& id, const std::string& otherID);
+
+/// Geometry whose buffers are still being uploaded. Uploads are limited per
+/// frame, large objects arrive over several frames. A new object is drawn
+/// pass by pass as soon as the buffers of a pass are on the GPU. A new
+/// version of an existing object replaces the old one once all of its
+/// buffers are uploaded.
+///
+/// This is the bookkeeping only, the renderer does the uploads.
+struct SCISHARE PendingObject
+{
+  /// Whether the buffer is a VBO, and its name.
+  typedef std::pair<bool, std::string> Upload;
+
+  /// Whether a VBO (true) or IBO asset is on the GPU.
+  typedef std::function<bool(bool, const std::string&)> IsOnGPU;
+
+  PendingObject();
+
+  /// Queues the buffers of obj in the order of the passes that draw them.
+  /// currentVBOs and currentIBOs hold the buffers of the version on screen,
+  /// they are null for a new object. A buffer that comes back unchanged
+  /// under the same name keeps its asset, all others are uploaded under
+  /// their name followed by assetSuffix.
+  PendingObject(Graphics::Datatypes::GeometryHandle obj, int port,
+    const GeometryBuffers* currentVBOs, const GeometryBuffers* currentIBOs,
+    const std::string& assetSuffix, const IsOnGPU& isOnGPU);
+
+  /// The next buffers to upload, at least one and otherwise as many as fit
+  /// into budget, which is reduced by their size. They count as uploaded.
+  std::list<Upload> takeUploads(size_t& budget);
+
+  bool complete() const { return uploads.empty(); }
+
+  /// Number of leading passes whose buffers are all on the GPU.
+  size_t readyPasses() const;
+
+  /// Asset names in buffers that the next version does not share, these are
+  /// deleted when it is swapped in.
+  static std::vector<std::string> replacedAssets(const GeometryBuffers& buffers,
+    const GeometryBuffers& next);
+
+  Graphics::Datatypes::GeometryHandle object;
+  int                                 port;
+  bool                                progressive;
+  size_t                              numPassesAdded;
+
+  GeometryBuffers                     vbos;
+  GeometryBuffers                     ibos;
+  std::list<Upload>                   uploads;
+  std::list<Upload>                   uploaded;
+  std::set<std::string>               waitingVBOs;
+  std::set<std::string>               waitingIBOs;
+
+private:
+  size_t bufferSize(const Upload& upload) const;
+};
+
+}}
+
+#endif
@@ -35,6 +35,7 @@
 #include "comp/RenderBasicGeom.h"
 #include "comp/SRRenderState.h"
 #include "comp/RenderList.h"
+#include "comp/RenderLevelOfDetail.h"
 #include "comp/StaticWorldLight.h"
 #include "comp/StaticClippingPlanes.h"
 #include "comp/LightingUniforms.h"
@@ -64,6 +65,7 @@ void rendererRegisterAll(spire::Acorn& core)
   core.registerComponent<RenderBasicGeom>();
   core.registerComponent<SRRenderState>();
   core.registerComponent<RenderList>();
+  core.registerComponent<RenderLevelOfDetail>();
   core.registerComponent<Graphics::Datatypes::SpireSubPass>();
 }
 
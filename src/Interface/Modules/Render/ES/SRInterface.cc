@@ -60,6 +60,7 @@
 #include "comp/RenderBasicGeom.h"
 #include "comp/SRRenderState.h"
 #include "comp/RenderList.h"
+#include "comp/RenderLevelOfDetail.h"
 #include "comp/StaticWorldLight.h"
 #include "comp/LightingUniforms.h"
 #include "comp/ClippingPlaneUniforms.h"
@@ -86,6 +87,9 @@ namespace SCIRun {
       mScreenHeight(480),
       axesFailCount_(0),
       mContext(context),
+      mUploadBytesPerFrame(32 * 1024 * 1024),
+      mUploadBudget(32 * 1024 * 1024),
+      mGeometryGeneration(0),
       clippingPlaneIndex_(0),
       mMatAmbient(0.2),
       mMatDiffuse(1.0),
@@ -774,383 +778,471 @@ namespace SCIRun {
       mContext->makeCurrent();
 
       std::string objectName = obj->uniqueID();
-      BBox bbox; // Bounding box containing all vertex buffer objects.
 
-      RENDERER_LOG("Check to see if the object already exists in our list. "
-        "If so, then remove the object. We will re-add it.");
-      auto foundObject = std::find_if(
-        mSRObjects.begin(), mSRObjects.end(),
-        [&objectName](const SRObject& sro)
+      RENDERER_LOG("A newer version of the object replaces an upload that is still in progress.");
+      cancelPendingObject(objectName);
+
+      std::weak_ptr<ren::VBOMan> vm = mCore.getStaticComponent<ren::StaticVBOMan>()->instance_;
+      std::weak_ptr<ren::IBOMan> im = mCore.getStaticComponent<ren::StaticIBOMan>()->instance_;
+      std::shared_ptr<ren::VBOMan> vboMan = vm.lock();
+      std::shared_ptr<ren::IBOMan> iboMan = im.lock();
+      if (!vboMan || !iboMan)
+        return;
+
+      RENDERER_LOG("An earlier version of the object has another ID, only the stable part "
+        "of the ID matches.");
+      SRObject* current = findObject(objectName);
+
+      RENDERER_LOG("Find the buffers that are handed in again unchanged, modules pass the "
+        "same buffer when only other attributes of the object changed. All others are "
+        "queued for upload in the order of the passes that draw them.");
+      auto isOnGPU = [&vboMan, &iboMan](bool isVBO, const std::string& assetName)
+      {
+        return isVBO ? vboMan->hasVBO(assetName) != 0 : iboMan->hasIBO(assetName) != 0;
+      };
+      PendingObject pending(obj, port, current ? &current->mVBOs : nullptr,
+        current ? &current->mIBOs : nullptr, "#" + std::to_string(++mGeometryGeneration), isOnGPU);
+
+      if (pending.progressive)
       {
-        return (sro.mName == objectName);
-      });
+        RENDERER_LOG("A new object is shown pass by pass while its buffers arrive.");
+        mSRObjects.push_back(SRObject(objectName, glm::mat4(), objectBBox(*obj), obj->colorMap(), port));
+        updateSceneBBox();
+      }
 
+      RENDERER_LOG("Upload as much as the budget of this frame allows, the rest follows "
+        "in the next frames.");
+      if (uploadPendingBuffers(pending))
+        finishPendingObject(pending);
+      else
+      {
+        if (pending.progressive)
+          addReadyPasses(pending);
+        mPendingObjects.push_back(pending);
+      }
       DEBUG_LOG_LINE_INFO
+    }
+
+    //------------------------------------------------------------------------------
+    void SRInterface::uploadPendingObjects()
+    {
+      mUploadBudget = mUploadBytesPerFrame;
+      if (mPendingObjects.empty())
+        return;
 
+      mContext->makeCurrent();
+      while (!mPendingObjects.empty() && mUploadBudget > 0)
+      {
+        PendingObject& pending = mPendingObjects.front();
+        if (!uploadPendingBuffers(pending))
+        {
+          if (pending.progressive)
+            addReadyPasses(pending);
+          break;
+        }
+        finishPendingObject(pending);
+        mPendingObjects.pop_front();
+      }
+    }
+
+    //------------------------------------------------------------------------------
+    bool SRInterface::uploadPendingBuffers(PendingObject& pending)
+    {
       std::weak_ptr<ren::VBOMan> vm = mCore.getStaticComponent<ren::StaticVBOMan>()->instance_;
       std::weak_ptr<ren::IBOMan> im = mCore.getStaticComponent<ren::StaticIBOMan>()->instance_;
-      if (std::shared_ptr<ren::VBOMan> vboMan = vm.lock())
+      std::shared_ptr<ren::VBOMan> vboMan = vm.lock();
+      std::shared_ptr<ren::IBOMan> iboMan = im.lock();
+      if (!vboMan || !iboMan)
+        return true;
+
+      SRObject* progressive = nullptr;
+      if (pending.progressive)
+        progressive = findObject(pending.object->uniqueID());
+
+      for (const auto& upload : pending.takeUploads(mUploadBudget))
       {
-        DEBUG_LOG_LINE_INFO
-        if (std::shared_ptr<ren::IBOMan> iboMan = im.lock())
+        if (upload.first)
         {
-          DEBUG_LOG_LINE_INFO
-          if (foundObject != mSRObjects.end())
+          for (const auto& vbo : pending.object->vbos())
           {
-            DEBUG_LOG_LINE_INFO
-
-            RENDERER_LOG("Iterate through each of the passes and remove their associated entity ID.");
-            for (const auto& pass : foundObject->mPasses)
+            if (vbo.name != upload.second) continue;
+            RENDERER_LOG("Generate vector of attributes to pass into the entity system: {}", vbo.name);
+            std::vector<std::tuple<std::string, size_t, bool>> attributeData;
+            for (const auto& attribData : vbo.attributes)
             {
-              uint64_t entityID = getEntityIDForName(pass.passName, port);
-              mCore.removeEntity(entityID);
+              attributeData.push_back(std::make_tuple(attribData.name, attribData.sizeInBytes, attribData.normalize));
             }
 
-            RENDERER_LOG("We need to renormalize the core after removing entities. We don't need"
-              "to run a new pass however. Renormalization is enough to remove"
-              "old entities from the system.");
-            mCore.renormalize(true);
+            const GeometryBuffer& buffer = pending.vbos[vbo.name];
+            vboMan->addInMemoryVBO(vbo.data->getBuffer(), vbo.data->getBufferSize(), attributeData, buffer.assetName);
+            if (progressive) progressive->mVBOs[vbo.name] = buffer;
+            break;
+          }
+        }
+        else
+        {
+          for (const auto& ibo : pending.object->ibos())
+          {
+            if (ibo.name != upload.second) continue;
+            const GeometryBuffer& buffer = pending.ibos[ibo.name];
+            uploadIBO(*iboMan, ibo, buffer.assetName);
+            if (progressive) progressive->mIBOs[ibo.name] = buffer;
+            break;
+          }
+        }
+      }
+      return pending.complete();
+    }
 
-            RENDERER_LOG("Run a garbage collection cycle for the VBOs and IBOs. We will likely"
-              " be using similar VBO and IBO names.");
-            vboMan->runGCCycle(mCore);
-            iboMan->runGCCycle(mCore);
+    //------------------------------------------------------------------------------
+    void SRInterface::uploadIBO(ren::IBOMan& iboMan, const SpireIBO& ibo, const std::string& assetName)
+    {
+      GLenum primType = GL_UNSIGNED_SHORT;
+      switch (ibo.indexSize)
+      {
+      case 1: // 8-bit
+        primType = GL_UNSIGNED_BYTE;
+        break;
 
-            RENDERER_LOG("Remove the object from the entity system.");
-            mSRObjects.erase(foundObject);
-          }
+      case 2: // 16-bit
+        primType = GL_UNSIGNED_SHORT;
+        break;
 
-          DEBUG_LOG_LINE_INFO
-          RENDERER_LOG("Add vertex buffer objects.");
-          std::vector<char*> vbo_buffer;
-          std::vector<size_t> stride_vbo;
+      case 4: // 32-bit
+        primType = GL_UNSIGNED_INT;
+        break;
 
-          int nameIndex = 0;
-          for (auto it = obj->vbos().cbegin(); it != obj->vbos().cend(); ++it, ++nameIndex)
-          {
-            const auto& vbo = *it;
+      default:
+        primType = GL_UNSIGNED_INT;
+        logRendererError("Unable to determine index buffer depth.");
+        throw std::invalid_argument("Unable to determine index buffer depth.");
+        break;
+      }
 
-            if (vbo.onGPU)
-            {
-              RENDERER_LOG("Generate vector of attributes to pass into the entity system: {}, {}", nameIndex, vbo.name);
-              std::vector<std::tuple<std::string, size_t, bool>> attributeData;
-              for (const auto& attribData : vbo.attributes)
-              {
-                attributeData.push_back(std::make_tuple(attribData.name, attribData.sizeInBytes, attribData.normalize));
-              }
+      GLenum primitive = GL_TRIANGLES;
+      switch (ibo.prim)
+      {
+      case SpireIBO::PRIMITIVE::POINTS:
+        primitive = GL_POINTS;
+        break;
 
-              vboMan->addInMemoryVBO(vbo.data->getBuffer(), vbo.data->getBufferSize(), attributeData, vbo.name);
-            }
+      case SpireIBO::PRIMITIVE::LINES:
+        primitive = GL_LINES;
+        break;
 
-            vbo_buffer.push_back(reinterpret_cast<char*>(vbo.data->getBuffer()));
-            size_t stride = 0;
-            for (auto a : vbo.attributes)
-              stride += a.sizeInBytes;
-            stride_vbo.push_back(stride);
+      case SpireIBO::PRIMITIVE::TRIANGLES:
+      default:
+        primitive = GL_TRIANGLES;
+        break;
+      }
 
-            bbox.extend(vbo.boundingBox);
-          }
+      int numPrimitives = ibo.data->getBufferSize() / ibo.indexSize;
+      iboMan.addInMemoryIBO(ibo.data->getBuffer(), ibo.data->getBufferSize(), primitive, primType, numPrimitives, assetName);
+    }
 
-          DEBUG_LOG_LINE_INFO
-          RENDERER_LOG("Add index buffer objects.");
-          nameIndex = 0;
-          for (auto it = obj->ibos().cbegin(); it != obj->ibos().cend(); ++it, ++nameIndex)
-          {
-            const auto& ibo = *it;
-            GLenum primType = GL_UNSIGNED_SHORT;
-            switch (ibo.indexSize)
-            {
-            case 1: // 8-bit
-              primType = GL_UNSIGNED_BYTE;
-              break;
-
-            case 2: // 16-bit
-              primType = GL_UNSIGNED_SHORT;
-              break;
-
-            case 4: // 32-bit
-              primType = GL_UNSIGNED_INT;
-              break;
-
-            default:
-              primType = GL_UNSIGNED_INT;
-              logRendererError("Unable to determine index buffer depth.");
-              throw std::invalid_argument("Unable to determine index buffer depth.");
-              break;
-            }
+    //------------------------------------------------------------------------------
+    void SRInterface::finishPendingObject(PendingObject& pending)
+    {
+      const std::string objectName = pending.object->uniqueID();
+      SRObject* elem = findObject(objectName);
 
-            GLenum primitive = GL_TRIANGLES;
-            switch (ibo.prim)
-            {
-            case SpireIBO::PRIMITIVE::POINTS:
-              primitive = GL_POINTS;
-              break;
-
-            case SpireIBO::PRIMITIVE::LINES:
-              primitive = GL_LINES;
-              break;
-
-            case SpireIBO::PRIMITIVE::TRIANGLES:
-            default:
-              primitive = GL_TRIANGLES;
-              break;
-            }
+      if (!pending.progressive)
+      {
+        RENDERER_LOG("All buffers of the new version are on the GPU, swap it with the "
+          "version on screen.");
+        if (elem)
+        {
+          removeObjectEntities(*elem);
+          RENDERER_LOG("We need to renormalize the core after removing entities. We don't need"
+            "to run a new pass however. Renormalization is enough to remove"
+            "old entities from the system.");
+          mCore.renormalize(true);
+          removeObjectBuffers(*elem, &pending);
+          mSRObjects.erase(mSRObjects.begin() + (elem - &mSRObjects[0]));
+        }
 
-            if (mRenderSortType == RenderState::TransparencySortType::LISTS_SORT)
-            {
-              RENDERER_LOG("Create sorted lists of Buffers for transparency in each direction of the axis.");
-              uint32_t* ibo_buffer = reinterpret_cast<uint32_t*>(ibo.data->getBuffer());
-              size_t num_triangles = ibo.data->getBufferSize() / (sizeof(uint32_t) * 3);
-              Vector dir(0.0, 0.0, 0.0);
+        RENDERER_LOG("Add default identity transform to the object globally (instead of per-pass)");
+        mSRObjects.push_back(SRObject(objectName, glm::mat4(), objectBBox(*pending.object),
+          pending.object->colorMap(), pending.port));
+        elem = &mSRObjects.back();
+        elem->mVBOs = pending.vbos;
+        elem->mIBOs = pending.ibos;
+      }
 
-              std::vector<DepthIndex> rel_depth(num_triangles);
-              for (int i = 0; i <= 6; ++i)
-              {
-                std::string name = ibo.name;
-                if (i == 0)
-                {
-                  int numPrimitives = ibo.data->getBufferSize() / ibo.indexSize;
-                  iboMan->addInMemoryIBO(ibo.data->getBuffer(),
-                    ibo.data->getBufferSize(), primitive, primType,
-                    numPrimitives, ibo.name);
-                }
-                if (i == 1)
-                {
-                  dir = Vector(1.0, 0.0, 0.0);
-                  name += "X";
-                }
-                if (i == 2)
-                {
-                  dir = Vector(0.0, 1.0, 0.0);
-                  name += "Y";
-                }
-                if (i == 3)
-                {
-                  dir = Vector(0.0, 0.0, 1.0);
-                  name += "Z";
-                }
-                if (i == 4)
-                {
-                  dir = Vector(-1.0, 0.0, 0.0);
-                  name += "NegX";
-                }
-                if (i == 5)
-                {
-                  dir = Vector(0.0, -1.0, 0.0);
-                  name += "NegY";
-                }
-                if (i == 6)
-                {
-                  dir = Vector(0.0, 0.0, -1.0);
-                  name += "NegZ";
-                }
-                if (i > 0)
-                {
-                  for (size_t j = 0; j < num_triangles; j++)
-                  {
-                    float* vertex1 = reinterpret_cast<float*>(vbo_buffer[nameIndex] + stride_vbo[nameIndex] * (ibo_buffer[j * 3]));
-                    Point node1(vertex1[0], vertex1[1], vertex1[2]);
-
-                    float* vertex2 = reinterpret_cast<float*>(vbo_buffer[nameIndex] + stride_vbo[nameIndex] * (ibo_buffer[j * 3 + 1]));
-                    Point node2(vertex2[0], vertex2[1], vertex2[2]);
-
-                    float* vertex3 = reinterpret_cast<float*>(vbo_buffer[nameIndex] + stride_vbo[nameIndex] * (ibo_buffer[j * 3 + 2]));
-                    Point node3(vertex3[0], vertex3[1], vertex3[2]);
-
-                    rel_depth[j].mDepth = Dot(dir, node1) + Dot(dir, node2) + Dot(dir, node3);
-                    rel_depth[j].mIndex = j;
-                  }
-
-                  std::sort(rel_depth.begin(), rel_depth.end());
-
-                  int numPrimitives = ibo.data->getBufferSize() / ibo.indexSize;
-
-                  std::vector<char> sorted_buffer(ibo.data->getBufferSize());
-                  char* ibuffer = reinterpret_cast<char*>(ibo.data->getBuffer());
-                  char* sbuffer = !sorted_buffer.empty() ? reinterpret_cast<char*>(&sorted_buffer[0]) : 0;
-
-                  if (sbuffer && num_triangles > 0)
-                  {
-                    size_t tri_size = ibo.data->getBufferSize() / num_triangles;
-                    for (size_t j = 0; j < num_triangles; j++)
-                    {
-                      memcpy(sbuffer + j * tri_size, ibuffer + rel_depth[j].mIndex * tri_size, tri_size);
-                    }
-                    iboMan->addInMemoryIBO(sbuffer, ibo.data->getBufferSize(), primitive, primType, numPrimitives, name);
-                  }
-                }
-              }
-            }
-            else
-            {
-              int numPrimitives = ibo.data->getBufferSize() / ibo.indexSize;
-              iboMan->addInMemoryIBO(ibo.data->getBuffer(), ibo.data->getBufferSize(), primitive, primType, numPrimitives, ibo.name);
-            }
-          }
+      if (elem)
+        addReadyPasses(pending);
 
-          RENDERER_LOG("Add default identity transform to the object globally (instead of per-pass)");
-          glm::mat4 xform;
-          mSRObjects.push_back(SRObject(objectName, xform, bbox, obj->colorMap(), port));
-          SRObject& elem = mSRObjects.back();
+      RENDERER_LOG("Recalculate scene bounding box. Should only be done when an object is added.");
+      updateSceneBBox();
+    }
+
+    //------------------------------------------------------------------------------
+    void SRInterface::addReadyPasses(PendingObject& pending)
+    {
+      SRObject* elem = findObject(pending.object->uniqueID());
+      if (!elem)
+        return;
+
+      std::weak_ptr<ren::ShaderMan> sm = mCore.getStaticComponent<ren::StaticShaderMan>()->instance_;
+      auto shaderMan = sm.lock();
+      if (!shaderMan)
+        return;
+
+      RENDERER_LOG("Add the passes whose buffers are on the GPU, in order.");
+      auto& passes = pending.object->passes();
+      const size_t ready = pending.readyPasses();
+      auto it = passes.begin();
+      std::advance(it, std::min(pending.numPassesAdded, passes.size()));
+      for (; pending.numPassesAdded < ready; ++it, ++pending.numPassesAdded)
+        addPassToObject(*elem, pending, *it, *shaderMan);
+    }
+
+    //------------------------------------------------------------------------------
+    void SRInterface::addPassToObject(SRObject& elem, const PendingObject& pending,
+      SpireSubPass& pass, ren::ShaderMan& shaderMan)
+    {
+      uint64_t entityID = getEntityIDForName(pass.passName, elem.mPort);
+
+      if (pass.renderType == RenderType::RENDER_VBO_IBO)
+      {
+        addVBOToEntity(entityID, gpuAssetName(pending.vbos, pass.vboName));
+        addIBOToEntity(entityID, gpuAssetName(pending.ibos, pass.iboName));
+        RENDERER_LOG("add texture");
+        addTextToEntity(entityID, pass.text);
+      }
+      else if (pass.renderType == RenderType::RENDER_INSTANCED)
+      {
+        RENDERER_LOG("Instanced pass: the VBO and IBO are the template, drawn once per instance.");
+        RenderList list;
+        list.data = pass.instances.data;
+        list.renderType = pass.renderType;
+        list.numElements = pass.instances.numInstances;
+        mCore.addComponent(entityID, list);
+
+        addVBOToEntity(entityID, gpuAssetName(pending.vbos, pass.vboName));
+        addIBOToEntity(entityID, gpuAssetName(pending.ibos, pass.iboName));
+      }
+      else
+      {
+        RENDERER_LOG("We will be constructing a render list from the VBO and IBO.");
+        RenderList list;
 
-          std::weak_ptr<ren::ShaderMan> sm = mCore.getStaticComponent<ren::StaticShaderMan>()->instance_;
-          if (auto shaderMan = sm.lock())
+        for (const auto& vbo : pending.object->vbos())
+        {
+          if (vbo.name == pass.vboName)
           {
-            RENDERER_LOG("Add passes");
-            for (auto& pass : obj->passes())
-            {
-              uint64_t entityID = getEntityIDForName(pass.passName, port);
+            list.data = vbo.data;
+            list.attributes = vbo.attributes;
+            list.renderType = pass.renderType;
+            list.numElements = vbo.numElements;
+            mCore.addComponent(entityID, list);
+            break;
+          }
+        }
 
-              if (pass.renderType == RenderType::RENDER_VBO_IBO)
-              {
-                addVBOToEntity(entityID, pass.vboName);
-                if (mRenderSortType == RenderState::TransparencySortType::LISTS_SORT)
-                {
-                  for (int i = 0; i <= 6; ++i)
-                  {
-                    std::string name = pass.iboName;
-                    if (i == 1)
-                      name += "X";
-                    if (i == 2)
-                      name += "Y";
-                    if (i == 3)
-                      name += "Z";
-                    if (i == 4)
-                      name += "NegX";
-                    if (i == 5)
-                      name += "NegY";
-                    if (i == 6)
-                      name += "NegZ";
-
-                    addIBOToEntity(entityID, name);
-                  }
-                }
-                else
-                {
-                  addIBOToEntity(entityID, pass.iboName);
-                }
-                RENDERER_LOG("add texture");
-                addTextToEntity(entityID, pass.text);
-              }
-              else
-              {
-                RENDERER_LOG("We will be constructing a render list from the VBO and IBO.");
-                RenderList list;
+        RENDERER_LOG("Lookup the VBOs and IBOs associated with this particular draw list "
+          "and add them to our entity in question.");
+        std::string assetName = "Assets/sphere.geom";
 
-                for (const auto& vbo : obj->vbos())
-                {
-                  if (vbo.name == pass.vboName)
-                  {
-                    list.data = vbo.data;
-                    list.attributes = vbo.attributes;
-                    list.renderType = pass.renderType;
-                    list.numElements = vbo.numElements;
-                    mCore.addComponent(entityID, list);
-                    break;
-                  }
-                }
+        if (pass.renderType == RenderType::RENDER_RLIST_SPHERE)
+        {
+          assetName = "Assets/sphere.geom";
+        }
 
-                RENDERER_LOG("Lookup the VBOs and IBOs associated with this particular draw list "
-                  "and add them to our entity in question.");
-                std::string assetName = "Assets/sphere.geom";
+        if (pass.renderType == RenderType::RENDER_RLIST_CYLINDER)
+        {
+          assetName = "Assests/arrow.geom";
+        }
 
-                if (pass.renderType == RenderType::RENDER_RLIST_SPHERE)
-                {
-                  assetName = "Assets/sphere.geom";
-                }
+        addVBOToEntity(entityID, assetName);
+        addIBOToEntity(entityID, assetName);
+      }
 
-                if (pass.renderType == RenderType::RENDER_RLIST_CYLINDER)
-                {
-                  assetName = "Assests/arrow.geom";
-                }
+      RENDERER_LOG("Load vertex and fragment shader will use an already loaded program.");
+      shaderMan.loadVertexAndFragmentShader(mCore, entityID, pass.programName);
 
-                addVBOToEntity(entityID, assetName);
-                addIBOToEntity(entityID, assetName);
-              }
+      RENDERER_LOG("Add transformation");
+      gen::Transform trafo;
+
+      if (pass.renderState.get(RenderState::IS_WIDGET))
+      {
+        widgetExists_ = true;
+      }
 
-              RENDERER_LOG("Load vertex and fragment shader will use an already loaded program.");
-              shaderMan->loadVertexAndFragmentShader(mCore, entityID, pass.programName);
+      if (pass.renderType == RenderType::RENDER_RLIST_SPHERE)
+      {
+        double scale = pass.scalar;
+        trafo.transform[0].x = scale;
+        trafo.transform[1].y = scale;
+        trafo.transform[2].z = scale;
+      }
+      if (widgetSelected_ && elem.mName == mSelected)
+      {
+        mSelectedID = entityID;
+      }
+      mCore.addComponent(entityID, trafo);
+
+      RENDERER_LOG("Add lighting uniform checks");
+      LightingUniforms lightUniforms;
+      mCore.addComponent(entityID, lightUniforms);
+      RENDERER_LOG("plane uniforms");
+      ClippingPlaneUniforms clipplingPlaneUniforms;
+      mCore.addComponent(entityID, clipplingPlaneUniforms);
+
+      RENDERER_LOG("Add SCIRun render state.");
+      SRRenderState state;
+      state.state = pass.renderState;
+      mCore.addComponent(entityID, state);
+      RenderBasicGeom geom;
+      mCore.addComponent(entityID, geom);
+
+      if (pass.lod.radius > 0.0f)
+      {
+        RENDERER_LOG("One level of detail, drawn in a screen size range.");
+        RenderLevelOfDetail lod;
+        lod.lod = pass.lod;
+        mCore.addComponent(entityID, lod);
+      }
+      RENDERER_LOG("Ensure common uniforms are covered.");
+      ren::CommonUniforms commonUniforms;
+      mCore.addComponent(entityID, commonUniforms);
 
-              RENDERER_LOG("Add transformation");
-              gen::Transform trafo;
+      for (auto& uniform : pass.mUniforms)
+      {
+        applyMatFactors(uniform);
+        applyUniform(entityID, uniform);
+      }
 
-              if (pass.renderState.get(RenderState::IS_WIDGET))
-              {
-                widgetExists_ = true;
-              }
+      {
+        Graphics::Datatypes::SpireSubPass::Uniform uniform;
+        uniform.name = "uFogSettings";
+        applyFog(uniform);
+        applyUniform(entityID, uniform);
+        uniform.name = "uFogColor";
+        applyFog(uniform);
+        applyUniform(entityID, uniform);
+      }
 
-              if (pass.renderType == RenderType::RENDER_RLIST_SPHERE)
-              {
-                double scale = pass.scalar;
-                trafo.transform[0].x = scale;
-                trafo.transform[1].y = scale;
-                trafo.transform[2].z = scale;
-              }
-              if (widgetSelected_ && objectName == mSelected)
-              {
-                mSelectedID = entityID;
-              }
-              mCore.addComponent(entityID, trafo);
-
-              RENDERER_LOG("Add lighting uniform checks");
-              LightingUniforms lightUniforms;
-              mCore.addComponent(entityID, lightUniforms);
-              RENDERER_LOG("plane uniforms");
-              ClippingPlaneUniforms clipplingPlaneUniforms;
-              mCore.addComponent(entityID, clipplingPlaneUniforms);
-
-              RENDERER_LOG("Add SCIRun render state.");
-              SRRenderState state;
-              state.state = pass.renderState;
-              mCore.addComponent(entityID, state);
-              RenderBasicGeom geom;
-              mCore.addComponent(entityID, geom);
-              RENDERER_LOG("Ensure common uniforms are covered.");
-              ren::CommonUniforms commonUniforms;
-              mCore.addComponent(entityID, commonUniforms);
-
-              for (auto& uniform : pass.mUniforms)
-              {
-                applyMatFactors(uniform);
-                applyUniform(entityID, uniform);
-              }
+      // Add components associated with entity. We just need a base class which
+      // we can pass in an entity ID, then a derived class which bundles
+      // all associated components (including types) together. We can use
+      // a variadic template for this. This will allow us to place any components
+      // we want on the objects in question in show field. This could lead to
+      // much simpler customization.
 
-              {
-                Graphics::Datatypes::SpireSubPass::Uniform uniform;
-                uniform.name = "uFogSettings";
-                applyFog(uniform);
-                applyUniform(entityID, uniform);
-                uniform.name = "uFogColor";
-                applyFog(uniform);
-                applyUniform(entityID, uniform);
-              }
+      RENDERER_LOG("Add a pass to our local object.");
+      elem.mPasses.emplace_back(pass.passName, pass.renderType);
+      pass.renderState.mSortType = mRenderSortType;
+      mCore.addComponent(entityID, pass);
+    }
 
-              // Add components associated with entity. We just need a base class which
-              // we can pass in an entity ID, then a derived class which bundles
-              // all associated components (including types) together. We can use
-              // a variadic template for this. This will allow us to place any components
-              // we want on the objects in question in show field. This could lead to
-              // much simpler customization.
-
-              RENDERER_LOG("Add a pass to our local object.");
-              elem.mPasses.emplace_back(pass.passName, pass.renderType);
-              pass.renderState.mSortType = mRenderSortType;
-              mCore.addComponent(entityID, pass);
-            }
+    //------------------------------------------------------------------------------
+    void SRInterface::cancelPendingObject(const std::string& objectName)
+    {
+      for (auto it = mPendingObjects.begin(); it != mPendingObjects.end(); ++it)
+      {
+        if (!isSameObject(it->object->uniqueID(), objectName))
+          continue;
 
-            RENDERER_LOG("Recalculate scene bounding box. Should only be done when an object is added.");
-            mSceneBBox.reset();
-            for (auto it = mSRObjects.begin(); it != mSRObjects.end(); ++it)
+        // Buffers of an object that is shown while it arrives belong to its
+        // SRObject already, the others are only known here.
+        if (!it->progressive)
+        {
+          std::weak_ptr<ren::VBOMan> vm = mCore.getStaticComponent<ren::StaticVBOMan>()->instance_;
+          std::weak_ptr<ren::IBOMan> im = mCore.getStaticComponent<ren::StaticIBOMan>()->instance_;
+          std::shared_ptr<ren::VBOMan> vboMan = vm.lock();
+          std::shared_ptr<ren::IBOMan> iboMan = im.lock();
+          for (const auto& upload : it->uploaded)
+          {
+            if (upload.first && vboMan)
             {
-              if (it->mBBox.valid())
-              {
-                mSceneBBox.extend(it->mBBox);
-              }
+              GLuint glid = vboMan->hasVBO(it->vbos[upload.second].assetName);
+              if (glid) vboMan->removeInMemoryVBO(glid);
+            }
+            else if (!upload.first && iboMan)
+            {
+              GLuint glid = iboMan->hasIBO(it->ibos[upload.second].assetName);
+              if (glid) iboMan->removeInMemoryIBO(glid);
             }
           }
         }
+        mPendingObjects.erase(it);
+        return;
+      }
+    }
+
+    //------------------------------------------------------------------------------
+    void SRInterface::removeObjectEntities(const SRObject& object)
+    {
+      for (const auto& pass : object.mPasses)
+      {
+        uint64_t entityID = getEntityIDForName(pass.passName, object.mPort);
+        mCore.removeEntity(entityID);
+      }
+    }
+
+    //------------------------------------------------------------------------------
+    void SRInterface::removeObjectBuffers(const SRObject& object, const PendingObject* next)
+    {
+      std::weak_ptr<ren::VBOMan> vm = mCore.getStaticComponent<ren::StaticVBOMan>()->instance_;
+      std::weak_ptr<ren::IBOMan> im = mCore.getStaticComponent<ren::StaticIBOMan>()->instance_;
+      std::shared_ptr<ren::VBOMan> vboMan = vm.lock();
+      std::shared_ptr<ren::IBOMan> iboMan = im.lock();
+
+      RENDERER_LOG("Delete the buffers of the object, except the ones its next version kept.");
+      const GeometryBuffers none;
+      for (const auto& assetName : PendingObject::replacedAssets(object.mVBOs, next ? next->vbos : none))
+      {
+        GLuint glid = vboMan ? vboMan->hasVBO(assetName) : 0;
+        if (glid) vboMan->removeInMemoryVBO(glid);
+      }
+      for (const auto& assetName : PendingObject::replacedAssets(object.mIBOs, next ? next->ibos : none))
+      {
+        GLuint glid = iboMan ? iboMan->hasIBO(assetName) : 0;
+        if (glid) iboMan->removeInMemoryIBO(glid);
+      }
+    }
+
+    //------------------------------------------------------------------------------
+    SRInterface::SRObject* SRInterface::findObject(const std::string& objectName)
+    {
+      for (auto& object : mSRObjects)
+      {
+        if (isSameObject(object.mName, objectName))
+          return &object;
+      }
+      return nullptr;
+    }
+
+    //------------------------------------------------------------------------------
+    std::string SRInterface::gpuAssetName(const GeometryBuffers& buffers, const std::string& name)
+    {
+      auto it = buffers.find(name);
+      return it != buffers.end() ? it->second.assetName : name;
+    }
+
+    //------------------------------------------------------------------------------
+    BBox SRInterface::objectBBox(const GeometryObjectSpire& object)
+    {
+      BBox bbox; // Bounding box containing all vertex buffer objects.
+      for (const auto& vbo : object.vbos())
+      {
+        bbox.extend(vbo.boundingBox);
+      }
+      return bbox;
+    }
+
+    //------------------------------------------------------------------------------
+    void SRInterface::updateSceneBBox()
+    {
+      mSceneBBox.reset();
+      for (auto it = mSRObjects.begin(); it != mSRObjects.end(); ++it)
+      {
+        if (it->mBBox.valid())
+        {
+          mSceneBBox.extend(it->mBBox);
+        }
       }
-      DEBUG_LOG_LINE_INFO
     }
 
     //------------------------------------------------------------------------------
@@ -1311,18 +1403,19 @@ namespace SCIRun {
     void SRInterface::removeAllGeomObjects()
     {
       mContext->makeCurrent();
+      while (!mPendingObjects.empty())
+        cancelPendingObject(mPendingObjects.front().object->uniqueID());
+
       for (auto it = mSRObjects.begin(); it != mSRObjects.end(); ++it)
       {
         // Iterate through each of the passes and remove their associated
         // entity ID.
-        for (const auto& pass : it->mPasses)
-        {
-          uint64_t entityID = getEntityIDForName(pass.passName, it->mPort);
-          mCore.removeEntity(entityID);
-        }
+        removeObjectEntities(*it);
       }
 
       mCore.renormalize(true);
+      for (auto it = mSRObjects.begin(); it != mSRObjects.end(); ++it)
+        removeObjectBuffers(*it, nullptr);
       widgetExists_ = false;
       mSRObjects.clear();
     }
@@ -1330,15 +1423,29 @@ namespace SCIRun {
     //------------------------------------------------------------------------------
     void SRInterface::gcInvalidObjects(const std::vector<std::string>& validObjects)
     {
+      mContext->makeCurrent();
+
+      // The previous version of a valid object stays until the new one is
+      // swapped in.
+      auto isValidObject = [&validObjects](const std::string& name)
+      {
+        return std::any_of(validObjects.begin(), validObjects.end(),
+          [&name](const std::string& valid) { return isSameObject(valid, name); });
+      };
+      for (auto it = mPendingObjects.begin(); it != mPendingObjects.end();)
+      {
+        const std::string name = (it++)->object->uniqueID();
+        if (!isValidObject(name))
+          cancelPendingObject(name);
+      }
+
+      std::vector<SRObject> removed;
       for (auto it = mSRObjects.begin(); it != mSRObjects.end();)
       {
-        if (std::find(validObjects.begin(), validObjects.end(), it->mName) == validObjects.end())
+        if (!isValidObject(it->mName))
         {
-          for (const auto& pass : it->mPasses)
-          {
-            uint64_t entityID = getEntityIDForName(pass.passName, it->mPort);
-            mCore.removeEntity(entityID);
-          }
+          removeObjectEntities(*it);
+          removed.push_back(*it);
           it = mSRObjects.erase(it);
         }
         else
@@ -1348,6 +1455,9 @@ namespace SCIRun {
       }
 
       mCore.renormalize(true);
+      for (const auto& object : removed)
+        removeObjectBuffers(object, nullptr);
+      updateSceneBBox();
     }
 
     //------------------------------------------------------------------------------
@@ -1361,6 +1471,9 @@ namespace SCIRun {
       updateCamera();
       updateWorldLight();
 
+      // Geometry that did not fit into the upload budget of earlier frames.
+      uploadPendingObjects();
+
       mCore.execute(currentTime, constantDeltaTime);
 
       if (showOrientation_)
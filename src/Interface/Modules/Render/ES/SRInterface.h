@@ -30,7 +30,10 @@
 #define INTERFACE_MODULES_RENDER_SPIRESCIRUN_SRINTERFACE_H
 
 #include <cstdint>
+#include <list>
+#include <map>
 #include <memory>
+#include <set>
 #include <Interface/Modules/Render/GLContext.h>
 #include <Interface/Modules/Render/ES/Core.h>
 #include <es-general/comp/Transform.hpp>
@@ -42,9 +45,15 @@
 #include <es-render/util/Shader.hpp>
 #include <es-render/comp/CommonUniforms.hpp>
 #include <Interface/Modules/Render/ES/comp/StaticClippingPlanes.h>
+#include <Interface/Modules/Render/ES/PendingGeometry.h>
 #include <Graphics/Datatypes/GeometryImpl.h>
 #include <Interface/Modules/Render/share.h>
 
+namespace ren {
+  class IBOMan;
+  class ShaderMan;
+}
+
 namespace SCIRun {
   namespace Render {
 
@@ -215,27 +224,6 @@ namespace SCIRun {
 
     private:
 
-      class DepthIndex {
-      public:
-        size_t mIndex;
-        double mDepth;
-
-        DepthIndex() :
-          mIndex(0),
-          mDepth(0.0)
-        {}
-
-        DepthIndex(size_t index, double depth) :
-          mIndex(index),
-          mDepth(depth)
-        {}
-
-        bool operator<(const DepthIndex& di) const
-        {
-          return this->mDepth < di.mDepth;
-        }
-      };
-
       class SRObject
       {
       public:
@@ -278,11 +266,40 @@ namespace SCIRun {
         boost::optional<std::string>    mColorMap;
 
         int										          mPort;
+
+        /// Buffers uploaded for this object, by name. When the object is
+        /// replaced, buffers that come back unchanged stay on the GPU.
+        GeometryBuffers                 mVBOs;
+        GeometryBuffers                 mIBOs;
       };
 
       // Sets up ESCore.
       void setupCore();
 
+      // Uploads the buffers of pending objects within the budget of the frame.
+      void uploadPendingObjects();
+      bool uploadPendingBuffers(PendingObject& pending);
+      void uploadIBO(ren::IBOMan& iboMan, const Graphics::Datatypes::SpireIBO& ibo,
+        const std::string& assetName);
+
+      // Adds the passes of a pending object whose buffers are uploaded.
+      void addReadyPasses(PendingObject& pending);
+      void addPassToObject(SRObject& elem, const PendingObject& pending,
+        Graphics::Datatypes::SpireSubPass& pass, ren::ShaderMan& shaderMan);
+
+      // Shows the complete object, replacing an older version of it.
+      void finishPendingObject(PendingObject& pending);
+      void cancelPendingObject(const std::string& objectName);
+
+      void removeObjectEntities(const SRObject& object);
+      // Deletes the GPU buffers of the object that next does not use.
+      void removeObjectBuffers(const SRObject& object, const PendingObject* next);
+
+      SRObject* findObject(const std::string& objectName);
+      static std::string gpuAssetName(const GeometryBuffers& buffers, const std::string& name);
+      static Core::Geometry::BBox objectBBox(const Graphics::Datatypes::GeometryObjectSpire& object);
+      void updateSceneBBox();
+
       // set initial configuration of the lights
       void setupLights();
 
@@ -365,6 +382,11 @@ namespace SCIRun {
       std::vector<SRObject>             mSRObjects;       ///< All SCIRun objects.
       Core::Geometry::BBox              mSceneBBox;       ///< Scene's AABB. Recomputed per-frame.
 
+      std::list<PendingObject>          mPendingObjects;  ///< Objects still being uploaded, in order of arrival.
+      size_t                            mUploadBytesPerFrame; ///< Buffer bytes uploaded per frame.
+      size_t                            mUploadBudget;    ///< Bytes left for the current frame.
+      uint64_t                          mGeometryGeneration; ///< Makes asset names of uploads unique.
+
 
       ESCore                            mCore;            ///< Entity system core.
 
@@ -0,0 +1,270 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Interface/Modules/Render/ES/TransparencySorter.h>
+#include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <Core/Thread/Parallel.h>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace SCIRun {
+namespace Render {
+
+namespace {
+
+const int RadixBits = 8;
+const size_t RadixBuckets = size_t(1) << RadixBits;
+const size_t MinTrianglesPerTask = 16384;
+
+int numSortTasks(size_t n)
+{
+  size_t tasks = std::min<size_t>(Parallel::NumCores(), n / MinTrianglesPerTask);
+  return static_cast<int>(std::max<size_t>(tasks, 1));
+}
+
+}
+
+const double TransparencySorter::DefaultResortAngle = 10.0 * M_PI / 180.0;
+
+std::vector<uint32_t> TransparencySorter::sortTriangles(const char* vbo, size_t stride,
+  const uint32_t* ibo, size_t numTriangles, const Vector& dir)
+{
+  const size_t n = numTriangles;
+  std::vector<uint32_t> sorted(3 * n);
+  if (n == 0) return sorted;
+
+  const int tasks = numSortTasks(n);
+  const size_t chunk = (n + tasks - 1) / tasks;
+  const float dx = static_cast<float>(dir.x());
+  const float dy = static_cast<float>(dir.y());
+  const float dz = static_cast<float>(dir.z());
+
+  // Depth of every triangle and the range per task
+  std::vector<float> depth(n);
+  std::vector<float> minDepth(tasks, std::numeric_limits<float>::max());
+  std::vector<float> maxDepth(tasks, -std::numeric_limits<float>::max());
+  Parallel::RunTasks([&](int t)
+  {
+    const size_t end = std::min(n, (t + 1) * chunk);
+    for (size_t j = t * chunk; j < end; j++)
+    {
+      float d = 0.0f;
+      for (int k = 0; k < 3; k++)
+      {
+        const float* p = reinterpret_cast<const float*>(vbo + stride * ibo[3 * j + k]);
+        d += dx * p[0] + dy * p[1] + dz * p[2];
+      }
+      depth[j] = d;
+      minDepth[t] = std::min(minDepth[t], d);
+      maxDepth[t] = std::max(maxDepth[t], d);
+    }
+  }, tasks);
+
+  const double lo = *std::min_element(minDepth.begin(), minDepth.end());
+  const double hi = *std::max_element(maxDepth.begin(), maxDepth.end());
+  const double scale = hi > lo ? 4294967295.0 / (hi - lo) : 0.0;
+
+  std::vector<uint32_t> keys(n), order(n), keysTmp(n), orderTmp(n);
+  Parallel::RunTasks([&](int t)
+  {
+    const size_t end = std::min(n, (t + 1) * chunk);
+    for (size_t j = t * chunk; j < end; j++)
+    {
+      keys[j] = static_cast<uint32_t>(std::min(4294967295.0, (depth[j] - lo) * scale));
+      order[j] = static_cast<uint32_t>(j);
+    }
+  }, tasks);
+  std::vector<float>().swap(depth);
+
+  // LSD radix sort, stable within every pass. Each task counts the digits of
+  // its chunk, the offsets are laid out digit major so that the tasks
+  // scatter into disjoint ranges.
+  std::vector<size_t> counts(tasks * RadixBuckets);
+  for (int shift = 0; shift < 32; shift += RadixBits)
+  {
+    std::fill(counts.begin(), counts.end(), 0);
+    Parallel::RunTasks([&](int t)
+    {
+      size_t* count = &counts[t * RadixBuckets];
+      const size_t end = std::min(n, (t + 1) * chunk);
+      for (size_t j = t * chunk; j < end; j++)
+        count[(keys[j] >> shift) & (RadixBuckets - 1)]++;
+    }, tasks);
+
+    // All keys share this digit, nothing moves
+    size_t largest = 0;
+    for (size_t b = 0; b < RadixBuckets; b++)
+    {
+      size_t total = 0;
+      for (int t = 0; t < tasks; t++) total += counts[t * RadixBuckets + b];
+      largest = std::max(largest, total);
+    }
+    if (largest == n) continue;
+
+    size_t pos = 0;
+    for (size_t b = 0; b < RadixBuckets; b++)
+    {
+      for (int t = 0; t < tasks; t++)
+      {
+        size_t c = counts[t * RadixBuckets + b];
+        counts[t * RadixBuckets + b] = pos;
+        pos += c;
+      }
+    }
+
+    Parallel::RunTasks([&](int t)
+    {
+      size_t* offset = &counts[t * RadixBuckets];
+      const size_t end = std::min(n, (t + 1) * chunk);
+      for (size_t j = t * chunk; j < end; j++)
+      {
+        size_t dest = offset[(keys[j] >> shift) & (RadixBuckets - 1)]++;
+        keysTmp[dest] = keys[j];
+        orderTmp[dest] = order[j];
+      }
+    }, tasks);
+    keys.swap(keysTmp);
+    order.swap(orderTmp);
+  }
+
+  Parallel::RunTasks([&](int t)
+  {
+    const size_t end = std::min(n, (t + 1) * chunk);
+    for (size_t j = t * chunk; j < end; j++)
+      std::memcpy(&sorted[3 * j], ibo + 3 * order[j], 3 * sizeof(uint32_t));
+  }, tasks);
+
+  return sorted;
+}
+
+struct TransparencySorter::State
+{
+  State() : stride(0), running(false), ready(false), cancelled(false), hasDirection(false) {}
+
+  std::shared_ptr<spire::VarBuffer> vbo;
+  std::shared_ptr<spire::VarBuffer> ibo;
+  size_t stride;
+
+  boost::mutex lock;
+  bool running;
+  bool ready;
+  bool cancelled;
+  bool hasDirection;
+  Vector direction;
+  std::vector<uint32_t> result;
+};
+
+TransparencySorter::TransparencySorter(std::shared_ptr<spire::VarBuffer> vbo, size_t stride,
+  std::shared_ptr<spire::VarBuffer> ibo) : state_(new State)
+{
+  state_->vbo = vbo;
+  state_->ibo = ibo;
+  state_->stride = stride;
+}
+
+TransparencySorter::~TransparencySorter()
+{
+  boost::lock_guard<boost::mutex> guard(state_->lock);
+  state_->cancelled = true;
+}
+
+bool TransparencySorter::update(const Vector& dir, double maxAngle)
+{
+  boost::lock_guard<boost::mutex> guard(state_->lock);
+  if (state_->running) return false;
+
+  if (state_->hasDirection)
+  {
+    double lengths = state_->direction.length() * dir.length();
+    double cosine = lengths > 0.0 ? Dot(state_->direction, dir) / lengths : 1.0;
+    if (std::acos(std::max(-1.0, std::min(1.0, cosine))) <= maxAngle) return false;
+  }
+
+  state_->direction = dir;
+  state_->hasDirection = true;
+  state_->running = true;
+
+  // The worker owns a reference to the state, the sorter may be destroyed
+  // while it runs.
+  std::shared_ptr<State> state = state_;
+  boost::thread worker([state, dir]()
+  {
+    const size_t numTriangles = state->ibo->getBufferSize() / (3 * sizeof(uint32_t));
+    std::vector<uint32_t> sorted = sortTriangles(state->vbo->getBuffer(), state->stride,
+      reinterpret_cast<const uint32_t*>(state->ibo->getBuffer()), numTriangles, dir);
+
+    boost::lock_guard<boost::mutex> guard(state->lock);
+    state->running = false;
+    if (!state->cancelled)
+    {
+      state->result.swap(sorted);
+      state->ready = true;
+    }
+  });
+  worker.detach();
+  return true;
+}
+
+void TransparencySorter::invalidate()
+{
+  boost::lock_guard<boost::mutex> guard(state_->lock);
+  state_->hasDirection = false;
+}
+
+bool TransparencySorter::takeSorted(std::vector<uint32_t>& indices)
+{
+  boost::lock_guard<boost::mutex> guard(state_->lock);
+  if (!state_->ready) return false;
+  indices.swap(state_->result);
+  std::vector<uint32_t>().swap(state_->result);
+  state_->ready = false;
+  return true;
+}
+
+bool TransparencySorter::busy() const
+{
+  boost::lock_guard<boost::mutex> guard(state_->lock);
+  return state_->running;
+}
+
+const std::shared_ptr<spire::VarBuffer>& TransparencySorter::ibo() const
+{
+  return state_->ibo;
+}
+
+} // namespace Render
+} // namespace SCIRun
@@ -0,0 +1,87 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef INTERFACE_MODULES_RENDER_ES_TRANSPARENCYSORTER_H
+#define INTERFACE_MODULES_RENDER_ES_TRANSPARENCYSORTER_H
+
+#include <Core/GeometryPrimitives/Vector.h>
+#include <var-buffer/VarBuffer.hpp>
+#include <boost/noncopyable.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <Interface/Modules/Render/share.h>
+
+namespace SCIRun {
+namespace Render {
+
+/// Orders the triangles of a transparent object along a view direction. The
+/// depth of a triangle, the sum of its corners along the direction, is
+/// quantized to a 32 bit key and the keys are radix sorted. Every pass is
+/// split over all cores.
+///
+/// An instance keeps the order of one index buffer up to date in the
+/// background: update() starts a sort on a worker thread once the view has
+/// turned far enough, the renderer keeps drawing the previous order until
+/// takeSorted() hands over the new one.
+class SCISHARE TransparencySorter : boost::noncopyable
+{
+public:
+  /// The triangles of ibo ordered by increasing depth along dir. The first
+  /// three floats of every vertex are its position.
+  static std::vector<uint32_t> sortTriangles(const char* vbo, size_t stride,
+    const uint32_t* ibo, size_t numTriangles, const Core::Geometry::Vector& dir);
+
+  /// Angle in radians the view has to turn before the order is rebuilt.
+  static const double DefaultResortAngle;
+
+  TransparencySorter(std::shared_ptr<spire::VarBuffer> vbo, size_t stride,
+    std::shared_ptr<spire::VarBuffer> ibo);
+  /// A running sort is abandoned, not waited for.
+  ~TransparencySorter();
+
+  /// Starts a background sort if dir is more than maxAngle away from the
+  /// direction of the last sort and no sort is running.
+  bool update(const Core::Geometry::Vector& dir, double maxAngle = DefaultResortAngle);
+  /// The next update sorts regardless of the direction.
+  void invalidate();
+  /// Moves the order of a finished sort into indices, false if there is none.
+  bool takeSorted(std::vector<uint32_t>& indices);
+  bool busy() const;
+
+  const std::shared_ptr<spire::VarBuffer>& ibo() const;
+
+private:
+  struct State;
+  std::shared_ptr<State> state_;
+};
+
+} // namespace Render
+} // namespace SCIRun
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef INTERFACE_MODULES_RENDER_ES_COMP_RENDER_LEVEL_OF_DETAIL_H
+#define INTERFACE_MODULES_RENDER_ES_COMP_RENDER_LEVEL_OF_DETAIL_H
+
+#include <es-cereal/ComponentSerialize.hpp>
+#include <glm/glm.hpp>
+#include <cmath>
+#include <limits>
+#include <Graphics/Datatypes/GeometryImpl.h>
+
+namespace SCIRun {
+namespace Render {
+
+/// Screen space size range of a pass, see
+/// Graphics::Datatypes::SpireLevelOfDetail. Only attached to passes that
+/// are one level of a set.
+struct RenderLevelOfDetail
+{
+  // -- Data --
+  Graphics::Datatypes::SpireLevelOfDetail lod;
+
+  // -- Functions --
+  RenderLevelOfDetail() {}
+
+  static const char* getName() {return "RenderLevelOfDetail";}
+
+  /// Diameter of the bounding sphere on screen as a fraction of the viewport
+  /// height. The projected diameter is 2 * radius * P[1][1] / w in normalized
+  /// device coordinates, which are 2 units high, so the fraction is
+  /// radius * P[1][1] / w. Uses the depth of the center, which is accurate
+  /// enough to pick a level.
+  float screenSize(const glm::mat4& trafo, const glm::mat4& projIV,
+                   const glm::mat4& projection) const
+  {
+    const glm::vec4 center = projIV * trafo * glm::vec4(lod.center, 1.0f);
+    const float scale = glm::length(glm::vec3(trafo[0]));
+
+    // Orthographic projections do not depend on depth
+    const float w = (projection[3][3] != 0.0f) ? 1.0f : std::abs(center.w);
+    if (w <= 0.0f) return std::numeric_limits<float>::max();
+    return lod.radius * scale * projection[1][1] / w;
+  }
+
+  bool isVisible(const glm::mat4& trafo, const glm::mat4& projIV,
+                 const glm::mat4& projection) const
+  {
+    const float size = screenSize(trafo, projIV, projection);
+    return size >= lod.minSize && size < lod.maxSize;
+  }
+
+  bool serialize(spire::ComponentSerialize& /* s */, uint64_t /* entityID */)
+  {
+    // Shouldn't need to serialize these values. They are context specific.
+    return true;
+  }
+};
+
+} // namespace Render
+} // namespace SCIRun
+
+#endif
@@ -2,6 +2,7 @@
 #define INTERFACE_MODULES_RENDER_ES_COMP_RENDER_LIST_H
 
 #include <es-cereal/ComponentSerialize.hpp>
+#include <cstring>
 #include <Graphics/Datatypes/GeometryImpl.h>
 
 namespace SCIRun {
@@ -20,6 +21,24 @@ struct RenderList
 
   static const char* getName() {return "RenderList";}
 
+  /// Frame and color of instance i of a RENDER_INSTANCED list, the layout is
+  /// described by Graphics::Datatypes::SpireInstances.
+  glm::mat4 instanceFrame(int64_t i, glm::vec4& color) const
+  {
+    const char* instance = static_cast<const char*>(data->getBuffer()) +
+      i * Graphics::Datatypes::SpireInstances::instanceSize();
+
+    float frame[12];
+    std::memcpy(frame, instance, sizeof(frame));
+    const uint8_t* rgba = reinterpret_cast<const uint8_t*>(instance + sizeof(frame));
+    color = glm::vec4(rgba[0], rgba[1], rgba[2], rgba[3]) / 255.0f;
+
+    return glm::mat4(frame[0], frame[1], frame[2], 0.0f,
+                     frame[3], frame[4], frame[5], 0.0f,
+                     frame[6], frame[7], frame[8], 0.0f,
+                     frame[9], frame[10], frame[11], 1.0f);
+  }
+
   bool serialize(spire::ComponentSerialize& /* s */, uint64_t /* entityID */)
   {
     // Shouldn't need to serialize these values. They are context specific.
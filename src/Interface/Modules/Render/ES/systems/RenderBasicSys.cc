@@ -53,6 +53,7 @@
 #include "../comp/RenderBasicGeom.h"
 #include "../comp/SRRenderState.h"
 #include "../comp/RenderList.h"
+#include "../comp/RenderLevelOfDetail.h"
 #include "../comp/StaticWorldLight.h"
 #include "../comp/StaticClippingPlanes.h"
 #include "../comp/LightingUniforms.h"
@@ -69,6 +70,7 @@ class RenderBasicSys :
                              RenderBasicGeom,   // TAG class
                              SRRenderState,
                              RenderList,
+                             RenderLevelOfDetail,
                              LightingUniforms,
                              ClippingPlaneUniforms,
                              gen::Transform,
@@ -95,6 +97,7 @@ public:
   bool isComponentOptional(uint64_t type) override
   {
     return spire::OptionalComponents<RenderList,
+                                  RenderLevelOfDetail,
                                   ren::GLState,
                                   ren::StaticGLState,
                                   ren::CommonUniforms,
@@ -111,6 +114,7 @@ public:
       const spire::ComponentGroup<RenderBasicGeom>& geom,
       const spire::ComponentGroup<SRRenderState>& srstate,
       const spire::ComponentGroup<RenderList>& rlist,
+      const spire::ComponentGroup<RenderLevelOfDetail>& lod,
       const spire::ComponentGroup<LightingUniforms>& lightUniforms,
       const spire::ComponentGroup<ClippingPlaneUniforms>& clippingPlaneUniforms,
       const spire::ComponentGroup<gen::Transform>& trafo,
@@ -144,6 +148,13 @@ public:
       return;
     }
 
+    // Another level of detail covers the current screen size
+    if (lod.size() > 0 && !lod.front().isVisible(trafo.front().transform,
+        camera.front().data.projIV, camera.front().data.projection))
+    {
+      return;
+    }
+
     GLuint iboID = ibo.front().glid;
 
     // Setup *everything*. We don't want to enter multiple conditional
@@ -251,7 +262,34 @@ public:
 
     geom.front().attribs.bind();
 
-    if (rlist.size() > 0)
+    if (rlist.size() > 0 && rlist.front().renderType == Graphics::Datatypes::RenderType::RENDER_INSTANCED)
+    {
+      GLint diffuseColorLoc = -1;
+      for (const ren::VecUniform& unif : vecUniforms)
+      {
+        if (std::string(unif.uniformName) == "uDiffuseColor")
+        {
+          diffuseColorLoc = unif.uniformLocation;
+        }
+      }
+
+      // Draw the template mesh once per instance, placed by its frame.
+      glm::vec4 color;
+      for (int64_t i = 0; i < rlist.front().numElements; ++i)
+      {
+        glm::mat4 instanceTrafo = trafo.front().transform * rlist.front().instanceFrame(i, color);
+        if (diffuseColorLoc >= 0)
+        {
+          GL(glUniform4f(diffuseColorLoc, color.r, color.g, color.b, color.a));
+        }
+        commonUniforms.front().applyCommonUniforms(
+            instanceTrafo, camera.front().data, time.front().globalTime);
+
+        GL(glDrawElements(ibo.front().primMode, ibo.front().numPrims,
+                          ibo.front().primType, 0));
+      }
+    }
+    else if (rlist.size() > 0)
     {
       glm::mat4 rlistTrafo = trafo.front().transform;
 
@@ -54,10 +54,12 @@
 #include "../comp/RenderBasicGeom.h"
 #include "../comp/SRRenderState.h"
 #include "../comp/RenderList.h"
+#include "../comp/RenderLevelOfDetail.h"
 #include "../comp/StaticWorldLight.h"
 #include "../comp/StaticClippingPlanes.h"
 #include "../comp/LightingUniforms.h"
 #include "../comp/ClippingPlaneUniforms.h"
+#include "../TransparencySorter.h"
 
 namespace es = spire;
 namespace shaders = spire;
@@ -74,6 +76,7 @@ class RenderBasicSysTrans :
                              RenderBasicGeom,   // TAG class
                              SRRenderState,
                              RenderList,
+                             RenderLevelOfDetail,
                              LightingUniforms,
                              ClippingPlaneUniforms,
                              gen::Transform,
@@ -102,6 +105,7 @@ public:
   bool isComponentOptional(uint64_t type) override
   {
     return spire::OptionalComponents<RenderList,
+                                  RenderLevelOfDetail,
                                   ren::GLState,
                                   ren::StaticGLState,
                                   ren::CommonUniforms,
@@ -134,82 +138,125 @@ private:
 
   std::vector<SortedObject> sortedObjects;
 
-  class DepthIndex {
+  // View dependent order that is sorted on a worker thread, the sorted
+  // index buffer replaces the previous one once it is ready.
+  class BackgroundSort
+  {
   public:
-    size_t mIndex;
-    double mDepth;
+    std::shared_ptr<TransparencySorter> mSorter;
+    GLuint mSortedID;
+    bool mVisited;
 
-    DepthIndex() :
-      mIndex(0),
-      mDepth(0.0)
+    BackgroundSort() :
+      mSortedID(0),
+      mVisited(false)
     {}
+  };
 
-    DepthIndex(size_t index, double depth) :
-      mIndex(index),
-      mDepth(depth)
-    {}
+  std::map<std::string, BackgroundSort> backgroundSorts;
+  std::weak_ptr<ren::IBOMan> backgroundIBOMan;
 
-    bool operator<(const DepthIndex& di) const
-    {
-      return this->mDepth < di.mDepth;
-    }
-  };
+  static size_t vertexStride(const spire::ComponentGroup<SpireSubPass>& pass)
+  {
+    size_t stride_vbo = 0;
+    for (auto a : pass.front().vbo.attributes)
+      stride_vbo += a.sizeInBytes;
+    return stride_vbo;
+  }
 
   GLuint sortObjects(const Core::Geometry::Vector& dir,
     const spire::ComponentGroup<ren::IBO>& ibo,
     const spire::ComponentGroup<SpireSubPass>& pass,
     const spire::ComponentGroup<ren::StaticIBOMan>& iboMan)
   {
-    char* vbo_buffer = reinterpret_cast<char*>(pass.front().vbo.data->getBuffer());
-    uint32_t* ibo_buffer = reinterpret_cast<uint32_t*>(pass.front().ibo.data->getBuffer());
+    const char* vbo_buffer = reinterpret_cast<const char*>(pass.front().vbo.data->getBuffer());
+    const uint32_t* ibo_buffer = reinterpret_cast<const uint32_t*>(pass.front().ibo.data->getBuffer());
     size_t num_triangles = pass.front().ibo.data->getBufferSize() / (sizeof(uint32_t) * 3);
 
-    size_t stride_vbo = 0;
-    for (auto a : pass.front().vbo.attributes)
-      stride_vbo += a.sizeInBytes;
+    // setup index buffers
+    int numPrimitives = pass.front().ibo.data->getBufferSize() / pass.front().ibo.indexSize;
+
+    GLuint result = ibo.front().glid;
+    if (num_triangles > 0)
+    {
+      std::vector<uint32_t> sorted = TransparencySorter::sortTriangles(vbo_buffer,
+        vertexStride(pass), ibo_buffer, num_triangles, dir);
 
-    std::vector<DepthIndex> rel_depth(num_triangles);
+      std::string transIBOName = pass.front().ibo.name + "trans";
+      result = iboMan.front().instance_->addInMemoryIBO(&sorted[0], sorted.size() * sizeof(uint32_t),
+        ibo.front().primMode, ibo.front().primType, numPrimitives, transIBOName);
+    }
 
+    return result;
+  }
 
-    for (size_t j = 0; j < num_triangles; j++)
-    {
-      float* vertex1 = reinterpret_cast<float*>(vbo_buffer + stride_vbo * (ibo_buffer[j * 3]));
-      Core::Geometry::Point node1(vertex1[0], vertex1[1], vertex1[2]);
+  GLuint backgroundSortObjects(const Core::Geometry::Vector& dir,
+    const spire::ComponentGroup<ren::IBO>& ibo,
+    const spire::ComponentGroup<SpireSubPass>& pass,
+    const spire::ComponentGroup<ren::StaticIBOMan>& iboMan)
+  {
+    const SpireIBO& spireIBO = pass.front().ibo;
+    if (spireIBO.indexSize != sizeof(uint32_t) || spireIBO.data->getBufferSize() < 3 * sizeof(uint32_t))
+      return ibo.front().glid;
+
+    std::shared_ptr<ren::IBOMan> man = iboMan.front().instance_;
+    backgroundIBOMan = man;
+    const std::string sortedName = spireIBO.name + "sorted";
 
-      float* vertex2 = reinterpret_cast<float*>(vbo_buffer + stride_vbo * (ibo_buffer[j * 3 + 1]));
-      Core::Geometry::Point node2(vertex2[0], vertex2[1], vertex2[2]);
+    BackgroundSort& entry = backgroundSorts[spireIBO.name];
+    entry.mVisited = true;
 
-      float* vertex3 = reinterpret_cast<float*>(vbo_buffer + stride_vbo * (ibo_buffer[j * 3 + 2]));
-      Core::Geometry::Point node3(vertex3[0], vertex3[1], vertex3[2]);
+    // The geometry was replaced, the old order does not apply anymore
+    if (!entry.mSorter || entry.mSorter->ibo() != spireIBO.data)
+    {
+      if (entry.mSortedID != 0 && man->hasIBO(sortedName) == entry.mSortedID)
+        man->removeInMemoryIBO(entry.mSortedID);
+      entry.mSortedID = 0;
+      entry.mSorter.reset(new TransparencySorter(pass.front().vbo.data, vertexStride(pass), spireIBO.data));
+    }
 
-      rel_depth[j].mDepth = Core::Geometry::Dot(dir, node1) + Core::Geometry::Dot(dir, node2) + Core::Geometry::Dot(dir, node3);
-      rel_depth[j].mIndex = j;
+    // The buffer manager collected the sorted buffer, sort again
+    if (entry.mSortedID != 0 && man->hasIBO(sortedName) != entry.mSortedID)
+    {
+      entry.mSortedID = 0;
+      entry.mSorter->invalidate();
     }
 
-    std::sort(rel_depth.begin(), rel_depth.end());
+    std::vector<uint32_t> sorted;
+    if (entry.mSorter->takeSorted(sorted))
+    {
+      if (entry.mSortedID != 0)
+        man->removeInMemoryIBO(entry.mSortedID);
+      entry.mSortedID = man->addInMemoryIBO(&sorted[0], sorted.size() * sizeof(uint32_t),
+        ibo.front().primMode, ibo.front().primType, ibo.front().numPrims, sortedName);
+    }
 
-    // setup index buffers
-    int numPrimitives = pass.front().ibo.data->getBufferSize() / pass.front().ibo.indexSize;
+    entry.mSorter->update(dir);
 
-    std::vector<char> sorted_buffer(pass.front().ibo.data->getBufferSize());
-    char* ibuffer = reinterpret_cast<char*>(pass.front().ibo.data->getBuffer());
-    char* sbuffer = !sorted_buffer.empty() ? reinterpret_cast<char*>(&sorted_buffer[0]) : 0;
-    GLuint result = ibo.front().glid;
-    if (sbuffer && num_triangles > 0)
-    {
-      size_t tri_size = pass.front().ibo.data->getBufferSize() / num_triangles;
+    return entry.mSortedID != 0 ? entry.mSortedID : ibo.front().glid;
+  }
 
-      for (size_t j = 0; j < num_triangles; j++)
+  void preWalkComponents(spire::ESCoreBase&) override
+  {
+    for (auto& entry : backgroundSorts)
+      entry.second.mVisited = false;
+  }
+
+  // Release the sorted buffers of objects that were not drawn this frame
+  void postWalkComponents(spire::ESCoreBase&) override
+  {
+    std::shared_ptr<ren::IBOMan> man = backgroundIBOMan.lock();
+    for (auto it = backgroundSorts.begin(); it != backgroundSorts.end();)
+    {
+      if (it->second.mVisited)
       {
-        memcpy(sbuffer + j * tri_size, ibuffer + rel_depth[j].mIndex * tri_size, tri_size);
+        ++it;
+        continue;
       }
-
-      std::string transIBOName = pass.front().ibo.name + "trans";
-      result = iboMan.front().instance_->addInMemoryIBO(sbuffer, pass.front().ibo.data->getBufferSize(), ibo.front().primMode, ibo.front().primType,
-        numPrimitives, transIBOName);
+      if (man && it->second.mSortedID != 0 && man->hasIBO(it->first + "sorted") == it->second.mSortedID)
+        man->removeInMemoryIBO(it->second.mSortedID);
+      it = backgroundSorts.erase(it);
     }
-
-    return result;
   }
 
   void groupExecute(
@@ -217,6 +264,7 @@ private:
       const spire::ComponentGroup<RenderBasicGeom>& geom,
       const spire::ComponentGroup<SRRenderState>& srstate,
       const spire::ComponentGroup<RenderList>& rlist,
+      const spire::ComponentGroup<RenderLevelOfDetail>& lod,
       const spire::ComponentGroup<LightingUniforms>& lightUniforms,
       const spire::ComponentGroup<ClippingPlaneUniforms>& clippingPlaneUniforms,
       const spire::ComponentGroup<gen::Transform>& trafo,
@@ -258,6 +306,13 @@ private:
       return;
     }
 
+    // Another level of detail covers the current screen size
+    if (lod.size() > 0 && !lod.front().isVisible(trafo.front().transform,
+        camera.front().data.projIV, camera.front().data.projection))
+    {
+      return;
+    }
+
     bool drawLines = (ibo.front().primMode == static_cast<int>(SpireIBO::PRIMITIVE::LINES));
     GLuint iboID = ibo.front().glid;
 
@@ -308,49 +363,7 @@ private:
         }
         case RenderState::TransparencySortType::LISTS_SORT:
         {
-          GLuint iboXID = ibo.front().glid;
-          GLuint iboYID = ibo.front().glid;
-          GLuint iboZID = ibo.front().glid;
-          GLuint iboNegXID = ibo.front().glid;
-          GLuint iboNegYID = ibo.front().glid;
-          GLuint iboNegZID = ibo.front().glid;
-
-          int index = 0;
-          for (auto it = ibo.begin(); it != ibo.end(); ++it, ++index)
-          {
-            if (index == 1)
-              iboXID = it->glid;
-            if (index == 2)
-              iboYID = it->glid;
-            if (index == 3)
-              iboZID = it->glid;
-            if (index == 4)
-              iboNegXID = it->glid;
-            if (index == 5)
-              iboNegYID = it->glid;
-            if (index == 6)
-              iboNegZID = it->glid;
-          }
-
-          Core::Geometry::Vector absDir(fabs(camera.front().data.worldToView[0][2]),
-                                        fabs(camera.front().data.worldToView[1][2]),
-                                        fabs(camera.front().data.worldToView[2][2]));
-
-          double xORy = absDir.x() > absDir.y() ? absDir.x() : absDir.y();
-          double orZ = absDir.z() > xORy ? absDir.z() : xORy;
-
-          if (orZ == absDir.x())
-          {
-            iboID = dir.x() < orZ ? iboNegXID : iboXID;
-          }
-          if (orZ == absDir.y())
-          {
-            iboID = dir.y() < orZ ? iboNegYID : iboYID;
-          }
-          if (orZ == absDir.z())
-          {
-            iboID = dir.z() < orZ ? iboNegZID : iboZID;
-          }
+          iboID = backgroundSortObjects(dir, ibo, pass, iboMan);
           break;
         }
       }
@@ -465,7 +478,34 @@ private:
     GL(glEnable(GL_BLEND));
     GL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
-    if (rlist.size() > 0)
+    if (rlist.size() > 0 && rlist.front().renderType == RenderType::RENDER_INSTANCED)
+    {
+      GLint diffuseColorLoc = -1;
+      for (const ren::VecUniform& unif : vecUniforms)
+      {
+        if (std::string(unif.uniformName) == "uDiffuseColor")
+        {
+          diffuseColorLoc = unif.uniformLocation;
+        }
+      }
+
+      // Draw the template mesh once per instance, placed by its frame.
+      glm::vec4 color;
+      for (int64_t i = 0; i < rlist.front().numElements; ++i)
+      {
+        glm::mat4 instanceTrafo = trafo.front().transform * rlist.front().instanceFrame(i, color);
+        if (diffuseColorLoc >= 0)
+        {
+          GL(glUniform4f(diffuseColorLoc, color.r, color.g, color.b, color.a));
+        }
+        commonUniforms.front().applyCommonUniforms(
+            instanceTrafo, camera.front().data, time.front().globalTime);
+
+        GL(glDrawElements(ibo.front().primMode, ibo.front().numPrims,
+                          ibo.front().primType, 0));
+      }
+    }
+    else if (rlist.size() > 0)
     {
       glm::mat4 rlistTrafo = trafo.front().transform;
 
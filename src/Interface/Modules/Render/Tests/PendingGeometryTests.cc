@@ -0,0 +1,212 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Interface/Modules/Render/ES/PendingGeometry.h>
+#include <limits>
+
+using namespace SCIRun::Render;
+using namespace SCIRun::Graphics::Datatypes;
+using namespace SCIRun::Core;
+
+namespace
+{
+  // Module level IDs: tag, module and a hash of the inputs and state
+  class VersionedIDGenerator : public GeometryIDGenerator
+  {
+  public:
+    explicit VersionedIDGenerator(int version) : version_(version) {}
+    std::string generateGeometryID(const std::string& tag) const override
+    {
+      return tag + '\t' + "ShowField:0" + '\t' + "_" + std::to_string(version_);
+    }
+  private:
+    int version_;
+  };
+
+  std::shared_ptr<spire::VarBuffer> buffer(size_t numFloats)
+  {
+    std::shared_ptr<spire::VarBuffer> data(new spire::VarBuffer(numFloats * sizeof(float)));
+    for (size_t i = 0; i < numFloats; i++)
+      data->write(0.0f);
+    return data;
+  }
+
+  // Two chunks of faces, like ShowField sends for large surfaces
+  struct Chunks
+  {
+    std::shared_ptr<spire::VarBuffer> vbo[2];
+    std::shared_ptr<spire::VarBuffer> ibo[2];
+  };
+
+  Chunks newChunks()
+  {
+    Chunks chunks;
+    for (int c = 0; c < 2; c++)
+    {
+      chunks.vbo[c] = buffer(16);
+      chunks.ibo[c] = buffer(16);
+    }
+    return chunks;
+  }
+
+  GeometryHandle faces(int version, const Chunks& chunks)
+  {
+    GeometryHandle geom(new GeometryObjectSpire(VersionedIDGenerator(version), "Faces", true));
+    for (int c = 0; c < 2; c++)
+    {
+      const std::string suffix = "Chunk" + std::to_string(c);
+      geom->vbos().push_back(SpireVBO("facesVBO" + suffix, std::vector<SpireVBO::AttributeData>(),
+        chunks.vbo[c], 4, SCIRun::Core::Geometry::BBox(), true));
+      geom->ibos().push_back(SpireIBO("facesIBO" + suffix, SpireIBO::PRIMITIVE::TRIANGLES,
+        sizeof(uint32_t), chunks.ibo[c]));
+      SpireSubPass pass;
+      pass.passName = "facesPass" + suffix;
+      pass.vboName = "facesVBO" + suffix;
+      pass.iboName = "facesIBO" + suffix;
+      geom->passes().push_back(pass);
+    }
+    return geom;
+  }
+
+  // Stands in for the VBO and IBO managers of the renderer
+  struct GPU
+  {
+    std::set<std::string> assets;
+
+    PendingObject::IsOnGPU isOnGPU() const
+    {
+      return [this](bool, const std::string& assetName) { return assets.count(assetName) > 0; };
+    }
+
+    void upload(PendingObject& pending)
+    {
+      size_t budget = std::numeric_limits<size_t>::max();
+      for (const auto& upload : pending.takeUploads(budget))
+        assets.insert((upload.first ? pending.vbos : pending.ibos)[upload.second].assetName);
+    }
+  };
+}
+
+TEST(PendingGeometryTests, VersionsAreMatchedWithoutTheHash)
+{
+  const std::string first = VersionedIDGenerator(1).generateGeometryID("Faces");
+  const std::string second = VersionedIDGenerator(2).generateGeometryID("Faces");
+  ASSERT_NE(first, second);
+  EXPECT_TRUE(isSameObject(first, second));
+  EXPECT_FALSE(isSameObject(first, VersionedIDGenerator(1).generateGeometryID("Edges")));
+  EXPECT_FALSE(isSameObject(first, "Faces\tShowField:1\t_1"));
+
+  // IDs without a hash only match themselves
+  EXPECT_TRUE(isSameObject("ViewScene::plane", "ViewScene::plane"));
+  EXPECT_FALSE(isSameObject("ViewScene::plane", "ViewScene::scaleBar"));
+}
+
+TEST(PendingGeometryTests, NewObjectArrivesPassByPass)
+{
+  GPU gpu;
+  PendingObject pending(faces(1, newChunks()), 0, nullptr, nullptr, "#1", gpu.isOnGPU());
+
+  EXPECT_TRUE(pending.progressive);
+  ASSERT_EQ(4u, pending.uploads.size());
+  EXPECT_EQ(PendingObject::Upload(true, "facesVBOChunk0"), pending.uploads.front());
+  EXPECT_EQ(PendingObject::Upload(false, "facesIBOChunk1"), pending.uploads.back());
+  EXPECT_EQ(0u, pending.readyPasses());
+
+  // A buffer is 64 bytes, a budget of one byte still uploads one per frame
+  size_t budget = 1;
+  EXPECT_EQ(1u, pending.takeUploads(budget).size());
+  EXPECT_EQ(0u, budget);
+  EXPECT_EQ(0u, pending.readyPasses());
+
+  budget = 64;
+  EXPECT_EQ(1u, pending.takeUploads(budget).size());
+  EXPECT_EQ(1u, pending.readyPasses());
+  EXPECT_FALSE(pending.complete());
+
+  budget = 65;
+  EXPECT_EQ(2u, pending.takeUploads(budget).size());
+  EXPECT_EQ(2u, pending.readyPasses());
+  EXPECT_TRUE(pending.complete());
+  EXPECT_EQ("facesVBOChunk0#1", pending.vbos["facesVBOChunk0"].assetName);
+}
+
+TEST(PendingGeometryTests, RecoloredVersionKeepsItsIBOs)
+{
+  GPU gpu;
+  Chunks chunks = newChunks();
+  PendingObject first(faces(1, chunks), 0, nullptr, nullptr, "#1", gpu.isOnGPU());
+  gpu.upload(first);
+  ASSERT_TRUE(first.complete());
+
+  // New colors, the same indices, and a new ID
+  Chunks recolored = chunks;
+  recolored.vbo[0] = buffer(16);
+  recolored.vbo[1] = buffer(16);
+  auto next = faces(2, recolored);
+  ASSERT_TRUE(isSameObject(first.object->uniqueID(), next->uniqueID()));
+
+  PendingObject second(next, 0, &first.vbos, &first.ibos, "#2", gpu.isOnGPU());
+
+  // The version on screen is drawn until the new one is swapped in
+  EXPECT_FALSE(second.progressive);
+  ASSERT_EQ(2u, second.uploads.size());
+  for (const auto& upload : second.uploads)
+    EXPECT_TRUE(upload.first);
+  EXPECT_EQ(first.ibos["facesIBOChunk0"].assetName, second.ibos["facesIBOChunk0"].assetName);
+  EXPECT_EQ(first.ibos["facesIBOChunk1"].assetName, second.ibos["facesIBOChunk1"].assetName);
+  EXPECT_EQ("facesVBOChunk0#2", second.vbos["facesVBOChunk0"].assetName);
+
+  // The IBOs stay on the GPU when the versions are swapped
+  gpu.upload(second);
+  EXPECT_TRUE(second.complete());
+  EXPECT_TRUE(PendingObject::replacedAssets(first.ibos, second.ibos).empty());
+  const auto replaced = PendingObject::replacedAssets(first.vbos, second.vbos);
+  ASSERT_EQ(2u, replaced.size());
+  EXPECT_EQ("facesVBOChunk0#1", replaced[0]);
+  EXPECT_EQ("facesVBOChunk1#1", replaced[1]);
+}
+
+TEST(PendingGeometryTests, BuffersNoLongerOnTheGPUAreUploadedAgain)
+{
+  GPU gpu;
+  Chunks chunks = newChunks();
+  PendingObject first(faces(1, chunks), 0, nullptr, nullptr, "#1", gpu.isOnGPU());
+  gpu.upload(first);
+
+  gpu.assets.erase("facesIBOChunk1#1");
+  PendingObject second(faces(2, chunks), 0, &first.vbos, &first.ibos, "#2", gpu.isOnGPU());
+
+  ASSERT_EQ(1u, second.uploads.size());
+  EXPECT_EQ(PendingObject::Upload(false, "facesIBOChunk1"), second.uploads.front());
+  EXPECT_EQ(1u, second.readyPasses());
+
+  const auto replaced = PendingObject::replacedAssets(first.ibos, second.ibos);
+  ASSERT_EQ(1u, replaced.size());
+  EXPECT_EQ("facesIBOChunk1#1", replaced[0]);
+}
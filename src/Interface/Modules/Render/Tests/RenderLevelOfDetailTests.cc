@@ -0,0 +1,73 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Interface/Modules/Render/ES/comp/RenderLevelOfDetail.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+
+using namespace SCIRun::Render;
+
+TEST(RenderLevelOfDetailTests, SizeIsDiameterOverViewportHeight)
+{
+  RenderLevelOfDetail lod;
+  lod.lod.center = glm::vec3(0.0f, 0.0f, -2.0f);
+  lod.lod.radius = 1.0f;
+  const glm::mat4 trafo(1.0f);
+
+  // With a 90 degree field of view the view is 4 units high at a distance
+  // of 2, a sphere with a radius of 1 covers half of it.
+  const glm::mat4 perspective = glm::perspective(glm::half_pi<float>(), 1.0f, 0.1f, 100.0f);
+  EXPECT_NEAR(0.5f, lod.screenSize(trafo, perspective, perspective), 1e-5f);
+
+  // A view 8 units high
+  const glm::mat4 ortho = glm::ortho(-4.0f, 4.0f, -4.0f, 4.0f, 0.1f, 100.0f);
+  EXPECT_NEAR(0.25f, lod.screenSize(trafo, ortho, ortho), 1e-5f);
+
+  // Scaling the object scales the sphere
+  const glm::mat4 scaled = glm::scale(trafo, glm::vec3(2.0f));
+  lod.lod.center = glm::vec3(0.0f, 0.0f, -1.0f);
+  EXPECT_NEAR(0.5f, lod.screenSize(scaled, ortho, ortho), 1e-5f);
+}
+
+TEST(RenderLevelOfDetailTests, PassIsVisibleInItsRange)
+{
+  RenderLevelOfDetail lod;
+  lod.lod.center = glm::vec3(0.0f, 0.0f, -2.0f);
+  lod.lod.radius = 1.0f;
+  lod.lod.minSize = 0.25f;
+  lod.lod.maxSize = 0.5f;
+  const glm::mat4 trafo(1.0f);
+
+  EXPECT_FALSE(lod.isVisible(trafo, glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, 0.1f, 100.0f),
+    glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, 0.1f, 100.0f)));
+  EXPECT_TRUE(lod.isVisible(trafo, glm::ortho(-3.0f, 3.0f, -3.0f, 3.0f, 0.1f, 100.0f),
+    glm::ortho(-3.0f, 3.0f, -3.0f, 3.0f, 0.1f, 100.0f)));
+  EXPECT_FALSE(lod.isVisible(trafo, glm::ortho(-8.0f, 8.0f, -8.0f, 8.0f, 0.1f, 100.0f),
+    glm::ortho(-8.0f, 8.0f, -8.0f, 8.0f, 0.1f, 100.0f)));
+}
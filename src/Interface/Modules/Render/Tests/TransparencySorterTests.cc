@@ -0,0 +1,143 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Interface/Modules/Render/ES/TransparencySorter.h>
+
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace SCIRun::Render;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  // Positions followed by a normal, like the buffers of ShowField
+  const size_t Stride = 6 * sizeof(float);
+
+  std::shared_ptr<spire::VarBuffer> randomTriangles(size_t numTriangles, std::vector<uint32_t>& indices)
+  {
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    std::uniform_int_distribution<uint32_t> node(0, static_cast<uint32_t>(numTriangles) - 1);
+
+    std::shared_ptr<spire::VarBuffer> vbo(new spire::VarBuffer(numTriangles * Stride));
+    for (size_t i = 0; i < 6 * numTriangles; i++)
+      vbo->write(i % 6 < 3 ? coord(rng) : 0.0f);
+
+    indices.resize(3 * numTriangles);
+    for (auto& i : indices) i = node(rng);
+    return vbo;
+  }
+
+  std::shared_ptr<spire::VarBuffer> toBuffer(const std::vector<uint32_t>& indices)
+  {
+    std::shared_ptr<spire::VarBuffer> ibo(new spire::VarBuffer(indices.size() * sizeof(uint32_t)));
+    for (auto i : indices) ibo->write(i);
+    return ibo;
+  }
+
+  double depth(const char* vbo, const uint32_t* tri, const Vector& dir)
+  {
+    double d = 0.0;
+    for (int k = 0; k < 3; k++)
+    {
+      const float* p = reinterpret_cast<const float*>(vbo + Stride * tri[k]);
+      d += dir.x() * p[0] + dir.y() * p[1] + dir.z() * p[2];
+    }
+    return d;
+  }
+
+  bool waitForSort(TransparencySorter& sorter, std::vector<uint32_t>& sorted)
+  {
+    for (int i = 0; i < 1000; i++)
+    {
+      if (sorter.takeSorted(sorted)) return true;
+      boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    }
+    return false;
+  }
+}
+
+TEST(TransparencySorterTests, SortsTrianglesBackToFront)
+{
+  const size_t n = 100000;
+  std::vector<uint32_t> indices;
+  auto vbo = randomTriangles(n, indices);
+  const char* vertices = vbo->getBuffer();
+  Vector dir(0.3, -0.5, 0.8);
+
+  std::vector<uint32_t> sorted = TransparencySorter::sortTriangles(vertices, Stride, &indices[0], n, dir);
+  ASSERT_EQ(indices.size(), sorted.size());
+
+  // Same triangles, in increasing depth up to the quantization of the keys
+  std::vector<uint32_t> a(indices), b(sorted);
+  std::sort(a.begin(), a.end());
+  std::sort(b.begin(), b.end());
+  EXPECT_EQ(a, b);
+
+  const double tolerance = 1e-6 * 3 * 2 * 10 * 1.5;
+  for (size_t j = 1; j < n; j++)
+    ASSERT_LE(depth(vertices, &sorted[3 * (j - 1)], dir), depth(vertices, &sorted[3 * j], dir) + tolerance);
+}
+
+TEST(TransparencySorterTests, KeepsOrderOfEqualDepths)
+{
+  std::vector<uint32_t> indices;
+  auto vbo = randomTriangles(100, indices);
+
+  std::vector<uint32_t> sorted = TransparencySorter::sortTriangles(vbo->getBuffer(), Stride,
+    &indices[0], 100, Vector(0.0, 0.0, 0.0));
+  EXPECT_EQ(indices, sorted);
+}
+
+TEST(TransparencySorterTests, ResortsOnlyWhenViewTurns)
+{
+  std::vector<uint32_t> indices;
+  auto vbo = randomTriangles(1000, indices);
+  TransparencySorter sorter(vbo, Stride, toBuffer(indices));
+
+  std::vector<uint32_t> sorted;
+  EXPECT_FALSE(sorter.takeSorted(sorted));
+
+  EXPECT_TRUE(sorter.update(Vector(0.0, 0.0, 1.0)));
+  ASSERT_TRUE(waitForSort(sorter, sorted));
+  EXPECT_EQ(TransparencySorter::sortTriangles(vbo->getBuffer(), Stride, &indices[0], 1000,
+    Vector(0.0, 0.0, 1.0)), sorted);
+  EXPECT_FALSE(sorter.takeSorted(sorted));
+
+  // A small turn keeps the current order
+  EXPECT_FALSE(sorter.update(Vector(0.05, 0.0, 1.0)));
+  EXPECT_TRUE(sorter.update(Vector(1.0, 0.0, 1.0)));
+  ASSERT_TRUE(waitForSort(sorter, sorted));
+
+  sorter.invalidate();
+  EXPECT_TRUE(sorter.update(Vector(1.0, 0.0, 1.0)));
+  ASSERT_TRUE(waitForSort(sorter, sorted));
+}
@@ -456,7 +456,6 @@ void ViewSceneDialog::newGeometryValue()
   auto spire = mSpire.lock();
   if (!spire)
     return;
-  spire->removeAllGeomObjects();
 
   std::vector<QString> displayNames;
   std::vector<std::string> validObjects;
@@ -487,6 +486,7 @@ void ViewSceneDialog::newGeometryValue()
 
   auto showFieldStates = transient_value_cast<ShowFieldStatesMap>(state_->getTransientValue(Parameters::ShowFieldStates));
   displayNames = mConfigurationDock->visibleItems().synchronize(allGeoms, showFieldStates);
+  std::vector<std::pair<GeometryHandle, int>> visibleGeoms;
   int port = 0;
   for (auto it = allGeoms.begin(); it != allGeoms.end(); ++it, ++port)
   {
@@ -497,14 +497,26 @@ void ViewSceneDialog::newGeometryValue()
       auto realObj = boost::dynamic_pointer_cast<GeometryObjectSpire>(obj);
       if (realObj)
       {
-        DEBUG_LOG_LINE_INFO
-        spire->handleGeomObject(realObj, port);
+        visibleGeoms.push_back(std::make_pair(realObj, port));
         validObjects.push_back(obj->uniqueID());
       }
     }
   }
+
+  // Objects are replaced in place, the renderer keeps showing the previous
+  // version of an object until the buffers of the new one are uploaded.
+  // Versions are matched by the stable part of their IDs, the rest changes
+  // with every execution of the module.
   if (!validObjects.empty())
     spire->gcInvalidObjects(validObjects);
+  else
+    spire->removeAllGeomObjects();
+
+  for (const auto& geom : visibleGeoms)
+  {
+    DEBUG_LOG_LINE_INFO
+    spire->handleGeomObject(geom.first, geom.second);
+  }
 
   sendScreenshotDownstreamForTesting();
 
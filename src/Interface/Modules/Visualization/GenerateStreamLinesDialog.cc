@@ -56,4 +56,5 @@ GenerateStreamLinesDialog::GenerateStreamLinesDialog(const std::string& name, Mo
   addCheckBoxManager(autoParameterCheckBox_, Parameters::AutoParameters);
   addCheckBoxManager(filterColinearCheckBox_, Parameters::RemoveColinearPoints);
   addCheckBoxManager(multithreadedCheckBox_, Parameters::UseMultithreading);
+  addCheckBoxManager(coarseToFineCheckBox_, Parameters::StreamlineCoarseToFine);
 }
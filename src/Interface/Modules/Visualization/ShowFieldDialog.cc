@@ -74,6 +74,7 @@ ShowFieldDialog::ShowFieldDialog(const std::string& name, ModuleStateHandle stat
   addSpinBoxManager(sphereResolutionSpinBox, ShowField::SphereResolution);
   addSpinBoxManager(textSizeSpinBox_, ShowField::TextSize);
   addSpinBoxManager(textPrecisionSpinBox_, ShowField::TextPrecision);
+  addSpinBoxManager(faceLevelsOfDetailSpinBox_, ShowField::FaceLevelsOfDetail);
   addRadioButtonGroupManager({ edgesAsLinesButton_, edgesAsCylindersButton_ }, ShowField::EdgesAsCylinders);
   addRadioButtonGroupManager({ nodesAsPointsButton_, nodesAsSpheresButton_ }, ShowField::NodeAsSpheres);
   addRadioButtonGroupManager({ defaultNodeColoringButton_, colormapLookupNodeColoringButton_/*, conversionRGBNodeColoringButton_*/ }, ShowField::NodesColoring);
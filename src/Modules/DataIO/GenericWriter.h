@@ -165,9 +165,9 @@ GenericWriter<HType, PortTag>::execute()
     else
     {
       PiostreamPtr stream;
-      if (filetype_ == "Binary")
+      if (filetype_ == "Binary" || filetype_ == "Compressed")
       {
-        stream = auto_ostream(filename_, "Binary", getLogger());
+        stream = auto_ostream(filename_, filetype_, getLogger());
       }
       else
       {
@@ -49,6 +49,7 @@
 
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Thread/Time.h>
+#include <Core/Algorithms/DataIO/HDF5DatasetReader.h>
 #include <Dataflow/Modules/DataIO/ReadHDF5File.h>
 
 #ifdef HAVE_HDF5
@@ -58,6 +59,11 @@
 
 namespace SCIRun {
 
+#ifdef HAVE_HDF5
+using Core::Algorithms::DataIO::HDF5DatasetReader;
+using Core::Algorithms::DataIO::HDF5Hyperslab;
+#endif
+
 DECLARE_MAKER(ReadHDF5File)
 
 ReadHDF5File::ReadHDF5File(GuiContext *context)
@@ -1497,84 +1503,36 @@ NrrdDataHandle ReadHDF5File::readDataset( string filename,
         }
       }
 
-      hsize_t *start  = new hsize_t[ndims];
-      hsize_t *stride = new hsize_t[ndims];
-      hsize_t *block  = new hsize_t[ndims];
+      HDF5DatasetReader reader(ds_id);
+      HDF5Hyperslab slab = HDF5Hyperslab::all(reader.dims());
 
       for( int ic=0; ic<gui_ndims_.get(); ic++ ) {
-        start[ic]  = gui_starts_[ic]->get();
-        stride[ic] = gui_strides_[ic]->get();
-        count[ic]  = gui_counts_[ic]->get();
-        block[ic]  = 1;
-      }
-
-      for( int ic=gui_ndims_.get(); ic<ndims; ic++ ) {
-        start[ic]  = 0;
-        stride[ic] = 1;
-        count[ic]  = dims[ic];
-        block[ic]  = 1;
+        slab.start[ic]  = gui_starts_[ic]->get();
+        slab.stride[ic] = gui_strides_[ic]->get();
+        slab.count[ic]  = gui_counts_[ic]->get();
       }
 
-      if( (status = H5Sselect_hyperslab(file_space_id, H5S_SELECT_SET,
-          start, stride, count, block)) < 0 ) {
+      if( !slab.fits(reader.dims()) ) {
         error( "Can not select data slab requested." );
-        delete[] start;
-        delete[] stride;
-        delete[] block;
         return NULL;
       }
 
-      hid_t mem_space_id = H5Screate_simple (ndims, count, NULL );
-
-      for( int d=0; d<ndims; d++ ) {
-        start[d] = 0;
-        stride[d] = 1;
-      }
-
-      if( (status = H5Sselect_hyperslab(mem_space_id, H5S_SELECT_SET,
-          start, stride, count, block)) < 0 ) {
-        error( "Can not select memory for the data slab requested." );
-        delete[] start;
-        delete[] stride;
-        delete[] block;
-        return NULL;
-      }
-
-      for( int ic=0; ic<ndims; ic++ )
+      for( int ic=0; ic<ndims; ic++ ) {
+        count[ic] = slab.count[ic];
         size *= count[ic];
+      }
 
       if( (data = new char[size]) == NULL ) {
         error( "Can not allocate enough memory for the data" );
-        delete[] start;
-        delete[] stride;
-        delete[] block;
         return NULL;
       }
 
-      if( (status = H5Dread(ds_id, mem_type_id,
-          mem_space_id, file_space_id, H5P_DEFAULT,
-          data)) < 0 ) {
+      // The slab is read straight into the buffer the nrrd wraps.
+      if( !reader.read(slab, mem_type_id, data) ) {
         error( "Can not read the data slab requested." );
-        delete[] start;
-        delete[] stride;
-        delete[] block;
         delete[] data;
         return NULL;
       }
-
-      /* Terminate access to the data space. */
-      if( (status = H5Sclose(mem_space_id)) < 0 ) {
-        error( "Can not cloase the memory data slab requested." );
-        delete[] start;
-        delete[] stride;
-        delete[] block;
-        delete[] data;
-        return NULL;
-      }
-
-      delete[] start;
-      delete[] stride;
-      delete[] block;
     }
   }
 
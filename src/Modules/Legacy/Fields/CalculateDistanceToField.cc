@@ -58,6 +58,7 @@ void CalculateDistanceToField::setStateDefaults()
   setStateDoubleFromAlgo(Parameters::TruncateDistance);
   setStateStringFromAlgoOption(Parameters::BasisType);
   setStateStringFromAlgoOption(Parameters::OutputFieldDatatype);
+  setStateStringFromAlgoOption(Parameters::DistanceMethod);
 }
 
 void
@@ -74,6 +75,7 @@ CalculateDistanceToField::execute()
     setAlgoDoubleFromState(Parameters::TruncateDistance);
     setAlgoOptionFromState(Parameters::BasisType);
     setAlgoOptionFromState(Parameters::OutputFieldDatatype);
+    setAlgoOptionFromState(Parameters::DistanceMethod);
 
     auto inputs = make_input((InputField, input)(ObjectField, object));
 
@@ -236,6 +236,7 @@ void CalculateFieldData::execute()
       error("Error in parser."); //todo: improve
       return;
     }
+    setMetadata("Parser timing (seconds)", engine.timing_report());
 
     // Get the result from the engine
     FieldHandle ofield;
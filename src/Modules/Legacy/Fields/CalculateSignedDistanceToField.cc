@@ -30,9 +30,11 @@
 #include <Core/Datatypes/Legacy/Field/Field.h>
 
 #include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateSignedDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Modules::Fields;
@@ -46,6 +48,13 @@ CalculateSignedDistanceToField::CalculateSignedDistanceToField()
   INITIALIZE_PORT(ValueField);
 }
 
+void CalculateSignedDistanceToField::setStateDefaults()
+{
+  setStateBoolFromAlgo(Parameters::Truncate);
+  setStateDoubleFromAlgo(Parameters::TruncateDistance);
+  setStateStringFromAlgoOption(Parameters::DistanceMethod);
+}
+
 void CalculateSignedDistanceToField::execute()
 {
   FieldHandle input = getRequiredInput(InputField);
@@ -55,6 +64,10 @@ void CalculateSignedDistanceToField::execute()
 
   if (needToExecute())
   {
+    setAlgoBoolFromState(Parameters::Truncate);
+    setAlgoDoubleFromState(Parameters::TruncateDistance);
+    setAlgoOptionFromState(Parameters::DistanceMethod);
+
     auto inputs = make_input((InputField, input)(ObjectField, object));
 
     algo().set(CalculateSignedDistanceFieldAlgo::OutputValueField, value_connected);
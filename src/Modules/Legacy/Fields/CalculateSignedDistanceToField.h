@@ -50,13 +50,13 @@ namespace SCIRun {
         CalculateSignedDistanceToField();
 
         virtual void execute() override;
-        virtual void setStateDefaults() override {}
+        virtual void setStateDefaults() override;
 
         INPUT_PORT(0, InputField, Field);
         INPUT_PORT(1, ObjectField, Field);
         OUTPUT_PORT(0, SignedDistanceField, Field);
         OUTPUT_PORT(1, ValueField, Field);
-        MODULE_TRAITS_AND_INFO(ModuleHasAlgorithm)
+        MODULE_TRAITS_AND_INFO(ModuleHasUIAndAlgorithm)
       };
 
     }
@@ -185,6 +185,7 @@ void ClipFieldByFunction::execute()
     // over every data point
 
     if (!engine.run()) return;
+    setMetadata("Parser timing (seconds)", engine.timing_report());
 
     // Get the result from the engine
     FieldHandle sfield;
@@ -55,6 +55,11 @@ ClipFieldByMesh::ClipFieldByMesh() : Module(staticInfo_, false)
   INITIALIZE_PORT(Mapping);
 }
 
+void ClipFieldByMesh::setStateDefaults()
+{
+  get_state()->setValue(Parameters::InsideTest, std::string("locate"));
+}
+
 void ClipFieldByMesh::execute()
 {
   auto input = getRequiredInput(InputField);
@@ -72,6 +77,7 @@ void ClipFieldByMesh::execute()
 
     insideAlgo.setOption(Parameters::FieldOutputType, "char");
     insideAlgo.setOption(Parameters::SamplingScheme, "regular2");
+    insideAlgo.setOption(Parameters::InsideTest, get_state()->getValue(Parameters::InsideTest).toString());
 
     if (!insideAlgo.runImpl(input,object,selection))
     {
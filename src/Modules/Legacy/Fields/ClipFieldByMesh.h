@@ -44,14 +44,14 @@ namespace SCIRun {
         ClipFieldByMesh();
 
         virtual void execute() override;
-        virtual void setStateDefaults() override {};
+        virtual void setStateDefaults() override;
 
         INPUT_PORT(0, InputField, Field);
         INPUT_PORT(1, ObjectField, Field);
         OUTPUT_PORT(0, OutputField, Field);
         OUTPUT_PORT(1, Mapping, Matrix);
 
-        MODULE_TRAITS_AND_INFO(NoAlgoOrUI)
+        MODULE_TRAITS_AND_INFO(ModuleHasUI)
       };
 
     }
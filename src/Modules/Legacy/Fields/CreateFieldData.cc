@@ -149,6 +149,7 @@ CreateFieldData::execute()
     // over every data point
 
     if (!(engine.run())) return;
+    setMetadata("Parser timing (seconds)", engine.timing_report());
 
     // Get the result from the engine
     FieldHandle ofield;
@@ -57,6 +57,8 @@ void ExtractSimpleIsosurface::setStateDefaults()
   setStateIntFromAlgo(Parameters::QuantityOfIsovalues);
   get_state()->setValue(Parameters::IsovalueListString, std::string());
   get_state()->setValue(Parameters::IsovalueChoice, std::string("Single"));
+  setStateBoolFromAlgo(Parameters::IsosurfaceCoarseToFine);
+  setStateIntFromAlgo(Parameters::IsosurfaceCoarseResolution);
 }
 
 void ExtractSimpleIsosurface::execute()
@@ -121,7 +123,37 @@ void ExtractSimpleIsosurface::execute()
     std::transform(isoDoubles.begin(), isoDoubles.end(), std::back_inserter(isos), [](double x) { return makeVariable("iso", x); });
     algo().set(Parameters::Isovalues, isos);
 
+    // Large volumes are first sent as a surface of a subsampled grid, the
+    // full resolution surface follows from a background thread. A new
+    // isovalue interrupts a refinement that is still running.
+    int stride = 1;
+    if (state->getValue(Parameters::IsosurfaceCoarseToFine).toBool())
+    {
+      stride = ExtractSimpleIsosurfaceAlgo::coarseSampleStride(field,
+        state->getValue(Parameters::IsosurfaceCoarseResolution).toInt());
+    }
+
+    refinement_.cancel();
+    algo().set(Parameters::IsosurfaceSampleStride, stride);
     auto output = algo().run(withInputData((InputField, field)));
     sendOutputFromAlgorithm(OutputField, output);
+
+    if (stride > 1)
+    {
+      refinement_.start([field, isoDoubles]()
+      {
+        ExtractSimpleIsosurfaceAlgo fine;
+        FieldHandle surface;
+        fine.run(field, isoDoubles, surface);
+        return surface;
+      },
+      [this]() { enqueueExecuteAgain(false); });
+    }
+  }
+  else if (refinement_.ready())
+  {
+    auto surface = refinement_.wait();
+    if (surface)
+      sendOutput(OutputField, surface);
   }
 }
@@ -30,6 +30,7 @@
 #define MODULES_LEGACY_FIELDS_ExtractSimpleIsosurface_H__
 
 #include <Dataflow/Network/Module.h>
+#include <Core/Thread/BackgroundTask.h>
 #include <Modules/Legacy/Fields/share.h>
 
 namespace SCIRun {
@@ -52,6 +53,10 @@ namespace SCIRun {
         OUTPUT_PORT(0, OutputField, Field);
 
         MODULE_TRAITS_AND_INFO(ModuleHasUIAndAlgorithm)
+
+      private:
+        /// Full resolution surface, computed after a coarse preview was sent
+        Core::Thread::BackgroundTask<FieldHandle> refinement_;
       };
     }
   }
@@ -30,11 +30,13 @@
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Modules/Legacy/FiniteElements/BuildFEMatrix.h>
+#include <Core/Algorithms/Legacy/FiniteElements/BuildMatrix/BuildFEMatrix.h>
 
 using namespace SCIRun::Modules::FiniteElements;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::FiniteElements;
 using namespace SCIRun;
 
 BuildFEMatrix::BuildFEMatrix()
@@ -50,6 +52,11 @@ BuildFEMatrix::BuildFEMatrix()
   INITIALIZE_PORT(Stiffness_Matrix_Complex);
 }
 
+void BuildFEMatrix::setStateDefaults()
+{
+  setStateBoolFromAlgo(BuildFEMatrixAlgo::ReorderForLocality);
+}
+
 void BuildFEMatrix::execute()
 {
   auto field = getRequiredInput(InputField);
@@ -64,6 +71,7 @@ void BuildFEMatrix::execute()
 //    algo().set(GenerateBasis, true);
 //    algo().set(ForceSymmetry, true);
 #endif
+    setAlgoBoolFromState(BuildFEMatrixAlgo::ReorderForLocality);
 
     auto output = algo().run(withInputData((InputField, field)(Conductivity_Table, optionalAlgoInput(conductivity))));
 
@@ -44,8 +44,7 @@ namespace SCIRun {
       public:
         BuildFEMatrix();
 
-        void setStateDefaults() override
-        {}
+        void setStateDefaults() override;
 
         void execute() override;
 
@@ -68,6 +68,8 @@ void BuildBEMatrix::setStateDefaults()
   get_state()->setValue(Parameters::BoundaryConditionList, VariableList());
   get_state()->setValue(Parameters::OutsideConductivityList, VariableList());
   get_state()->setValue(Parameters::InsideConductivityList, VariableList());
+  get_state()->setValue(Parameters::UseHierarchicalMatrices, false);
+  get_state()->setValue(Parameters::HierarchicalMatrixTolerance, 1e-5);
 }
 
 void BuildBEMatrix::execute()
@@ -82,7 +84,10 @@ void BuildBEMatrix::execute()
     auto outsideConds = state->getValue(Parameters::OutsideConductivityList).toVector();
     auto insideConds = state->getValue(Parameters::InsideConductivityList).toVector();
 
-    BuildBEMatrixImpl impl(fieldNames, boundaryConditions, outsideConds, insideConds, this);
+    auto compress = state->getValue(Parameters::UseHierarchicalMatrices).toBool();
+    auto tolerance = state->getValue(Parameters::HierarchicalMatrixTolerance).toDouble();
+
+    BuildBEMatrixImpl impl(fieldNames, boundaryConditions, outsideConds, insideConds, compress, tolerance, this);
     MatrixHandle transferMatrix = impl.executeImpl(inputs);
     auto fieldTypes = impl.getInputTypes();
     state->setTransientValue(Parameters::FieldTypeList, fieldTypes);
@@ -58,11 +58,15 @@ BuildBEMatrixImpl::BuildBEMatrixImpl(const VariableList& names,
   const VariableList& bdyConds,
   const VariableList& outside,
   const VariableList& inside,
+  bool compress,
+  double tolerance,
   LegacyLoggerInterface* log) : 
   names_(names),
   bdyConds_(bdyConds),
   outside_(outside),
   inside_(inside),
+  compress_(compress),
+  tolerance_(tolerance),
   log_(log)
 {
 
@@ -129,7 +133,9 @@ MatrixHandle BuildBEMatrixImpl::executeImpl(const FieldList& inputs)
 
   // The specific BEM routine (2 so far) to be called is dependent on the inputs in the fields vector,
   // so we check for the conditions and call the appropriate routine:
-  auto BEMalgo = BEMAlgoImplFactory::create(fields);
+  HierarchicalMatrixOptions options;
+  options.tolerance = tolerance_;
+  auto BEMalgo = BEMAlgoImplFactory::create(fields, compress_, options);
 
   if (!BEMalgo)
   {
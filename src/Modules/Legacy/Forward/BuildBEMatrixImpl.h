@@ -47,6 +47,8 @@ namespace SCIRun {
           const Core::Algorithms::VariableList& bdyConds,
           const Core::Algorithms::VariableList& outside,
           const Core::Algorithms::VariableList& inside,
+          bool compress,
+          double tolerance,
           Core::Logging::LegacyLoggerInterface* log);
 
         Core::Datatypes::MatrixHandle executeImpl(const FieldList& inputs);
@@ -56,6 +58,8 @@ namespace SCIRun {
         const Core::Algorithms::VariableList& bdyConds_;
         const Core::Algorithms::VariableList& outside_;
         const Core::Algorithms::VariableList& inside_;
+        bool compress_;
+        double tolerance_;
         const Core::Logging::LegacyLoggerInterface* log_;
         std::vector<std::string> inputTypes_;
       };
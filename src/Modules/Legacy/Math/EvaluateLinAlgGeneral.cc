@@ -137,6 +137,8 @@ EvaluateLinearAlgebraGeneral::execute()
       return;
     }
 
+    setMetadata("Parser timing (seconds)", engine.timing_report());
+
     for (size_t p = 0; p < NUM_PORTS; p++)
     {
       engine.get_matrix(outputName(p), omatrix[p]);
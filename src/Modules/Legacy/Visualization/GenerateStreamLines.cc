@@ -33,6 +33,7 @@
 #include <Modules/Legacy/Visualization/GenerateStreamLines.h>
 #include <Core/Algorithms/Legacy/Fields/StreamLines/GenerateStreamLines.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
 
 using namespace SCIRun::Modules::Visualization;
 using namespace SCIRun::Core::Datatypes;
@@ -62,6 +63,8 @@ void GenerateStreamLines::setStateDefaults()
   setStateBoolFromAlgo(Parameters::AutoParameters);
   setStateBoolFromAlgo(Parameters::RemoveColinearPoints);
   setStateBoolFromAlgo(Parameters::UseMultithreading);
+  setStateBoolFromAlgo(Parameters::StreamlineCoarseToFine);
+  setStateIntFromAlgo(Parameters::StreamlineCoarseSeeds);
 }
 
 void GenerateStreamLines::execute()
@@ -81,6 +84,46 @@ void GenerateStreamLines::execute()
     setAlgoOptionFromState(Parameters::StreamlineMethod);
     setAlgoBoolFromState(Parameters::UseMultithreading);
 
+    // With many seeds a preview that traces a subset of them with larger
+    // steps is sent first, all streamlines follow from a background thread.
+    // New input interrupts a refinement that is still running.
+    int stride = 1;
+    auto state = get_state();
+    if (state->getValue(Parameters::StreamlineCoarseToFine).toBool())
+    {
+      const int coarseSeeds = std::max(1, state->getValue(Parameters::StreamlineCoarseSeeds).toInt());
+      stride = static_cast<int>((seeds->vmesh()->num_nodes() + coarseSeeds - 1) / coarseSeeds);
+    }
+
+    refinement_.cancel();
+    if (stride > 1)
+    {
+      boost::shared_ptr<GenerateStreamLinesAlgo> fine(new GenerateStreamLinesAlgo);
+      for (const auto& name : { Parameters::StreamlineStepSize, Parameters::StreamlineTolerance,
+        Parameters::StreamlineMaxSteps, Parameters::StreamlineDirection, Parameters::StreamlineValue,
+        Parameters::RemoveColinearPoints, Parameters::AutoParameters, Parameters::StreamlineMethod,
+        Parameters::UseMultithreading })
+      {
+        fine->set(name, algo().get(name).value());
+      }
+
+      algo().set(Parameters::StreamlineSeedStride, stride);
+      algo().set(Parameters::StreamlineStepScale, 4.0);
+      auto preview = algo().run(withInputData((Vector_Field, input)(Seed_Points, seeds)));
+      sendOutputFromAlgorithm(Streamlines, preview);
+
+      refinement_.start([fine, input, seeds]()
+      {
+        FieldHandle streamlines;
+        fine->runImpl(input, seeds, streamlines);
+        return streamlines;
+      },
+      [this]() { enqueueExecuteAgain(false); });
+      return;
+    }
+
+    algo().set(Parameters::StreamlineSeedStride, 1);
+    algo().set(Parameters::StreamlineStepScale, 1.0);
     auto output = algo().run(withInputData((Vector_Field, input)(Seed_Points, seeds)));
 
     #ifdef NEED_ALGO_OUTPUT
@@ -90,4 +133,10 @@ void GenerateStreamLines::execute()
 
     sendOutputFromAlgorithm(Streamlines, output);
   }
+  else if (refinement_.ready())
+  {
+    auto streamlines = refinement_.wait();
+    if (streamlines)
+      sendOutput(Streamlines, streamlines);
+  }
 }
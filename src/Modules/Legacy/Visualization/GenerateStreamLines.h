@@ -31,6 +31,7 @@
 
 #include <Dataflow/Network/Module.h>
 #include <Core/Thread/Interruptible.h>
+#include <Core/Thread/BackgroundTask.h>
 #include <Modules/Legacy/Visualization/share.h>
 
 namespace SCIRun {
@@ -52,6 +53,10 @@ namespace SCIRun {
         OUTPUT_PORT(0, Streamlines, Field);
 
         MODULE_TRAITS_AND_INFO(ModuleHasUIAndAlgorithm)
+
+      private:
+        /// Streamlines of all seeds, computed after a preview was sent
+        Core::Thread::BackgroundTask<FieldHandle> refinement_;
       };
     }
   }
@@ -37,6 +37,10 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Tensor.h>
 #include <Graphics/Glyphs/GlyphGeom.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Algorithms/Legacy/Fields/DecimateMesh/DecimateMesh.h>
+
+#include <unordered_map>
 
 using namespace SCIRun;
 using namespace Modules::Visualization;
@@ -59,6 +63,91 @@ namespace SCIRun {
     namespace Visualization {
 namespace detail
 {
+/// Face buffers of the last execution, split into streams by what they
+/// depend on. Positions, normals and indices only depend on the mesh and the
+/// normal options, colors on the field data and the colormap. Buffers that
+/// did not change are passed on as the same objects, so the renderer does
+/// not upload them again.
+struct FaceBufferCache
+{
+  struct GeometryKey
+  {
+    MeshHandle mesh;
+    bool withNormals = false;
+    bool nodeNormals = false;
+    bool invertNormals = false;
+    bool shareVertices = false;
+
+    bool operator==(const GeometryKey& k) const
+    {
+      return mesh == k.mesh && withNormals == k.withNormals && nodeNormals == k.nodeNormals &&
+        invertNormals == k.invertNormals && shareVertices == k.shareVertices;
+    }
+  };
+
+  struct ColorKey
+  {
+    FieldHandle field;
+    ColorMapHandle map;
+    bool nodeColors = false;
+    bool faceColors = false;
+    bool cellColors = false;
+    bool doubleSided = false;
+
+    bool operator==(const ColorKey& k) const
+    {
+      return field == k.field && map == k.map && nodeColors == k.nodeColors &&
+        faceColors == k.faceColors && cellColors == k.cellColors && doubleSided == k.doubleSided;
+    }
+  };
+
+  GeometryKey geometryKey;
+  bool geometryValid = false;
+  MeshBoundaryFacesHandle boundary;
+  size_t numFaces = 0;
+  size_t numCorners = 0;
+  BBox bbox;
+  std::vector<float> positions;
+  std::vector<float> normals;
+  std::vector<VMesh::index_type> vertexNodes;
+  std::shared_ptr<spire::VarBuffer> ibo;
+
+  ColorKey colorKey;
+  bool colorsValid = false;
+  std::vector<float> colors;
+
+  /// Interleaved streams, reset whenever one of them changes
+  std::shared_ptr<spire::VarBuffer> vbo;
+
+  /// Large meshes are sent to the renderer in chunks of at most
+  /// FaceChunkIndices indices, which are uploaded over several frames and
+  /// show up one after the other. The indices of a chunk refer to its own
+  /// vertices, a copy of the interleaved streams at the listed positions.
+  struct Chunk
+  {
+    std::vector<uint32_t> vertices;
+    BBox bbox;
+    std::shared_ptr<spire::VarBuffer> ibo;
+    std::shared_ptr<spire::VarBuffer> vbo;
+  };
+  std::vector<Chunk> chunks;
+  /// The buffers the chunks were made from
+  std::shared_ptr<spire::VarBuffer> chunkedIBO;
+  std::shared_ptr<spire::VarBuffer> chunkedVBO;
+};
+
+/// 64k triangles, a few MB of vertex data per chunk
+const size_t FaceChunkIndices = 3 * 65536;
+
+/// Decimated copies of a surface field, levels[0] is the field itself.
+/// They are only computed again for a new field or number of levels.
+struct FaceLevelCache
+{
+  FieldHandle field;
+  int numLevels = 0;
+  std::vector<FieldHandle> levels;
+};
+
 class GeometryBuilder
 {
 public:
@@ -94,18 +183,9 @@ public:
     Interruptible* interruptible,
     RenderState state, GeometryHandle geom,
     unsigned int approxDiv,
-    const std::string& id);
-
-  void addFaceGeom(
-    const std::vector<Point>  &points,
-    const std::vector<Vector> &normals,
-    bool withNormals,
-    uint32_t& iboBufferIndex,
-    spire::VarBuffer* iboBuffer,
-    spire::VarBuffer* vboBuffer,
-    ColorScheme colorScheme,
-    const std::vector<ColorRGB> &face_colors,
-    const RenderState& state);
+    const std::string& id,
+    size_t level = 0,
+    const SpireLevelOfDetail& lod = SpireLevelOfDetail());
 
   void renderEdges(
     FieldHandle field,
@@ -119,6 +199,17 @@ public:
   RenderState getEdgeRenderState(boost::optional<ColorMapHandle> colorMap);
   RenderState getFaceRenderState(boost::optional<ColorMapHandle> colorMap);
 private:
+  void buildFaceGeometry(FaceBufferCache& cache, VMesh* mesh,
+    const FaceBufferCache::GeometryKey& key, Interruptible* interruptible);
+  void buildFaceColors(FaceBufferCache& cache, VField* fld, VMesh* mesh,
+    const FaceBufferCache::ColorKey& key, Interruptible* interruptible);
+  void buildFaceChunks(FaceBufferCache& cache, size_t floatsPerVertex,
+    Interruptible* interruptible);
+  const std::vector<FieldHandle>& faceLevels(FieldHandle field, int numLevels);
+
+  /// One cache per level of detail
+  std::vector<FaceBufferCache> faceBuffers_;
+  FaceLevelCache faceLevels_;
   float faceTransparencyValue_ = 0.65f;
   float edgeTransparencyValue_ = 0.65f;
   float nodeTransparencyValue_ = 0.65f;
@@ -184,6 +275,7 @@ void ShowField::setStateDefaults()
 
   state->setValue(UseFaceNormals, false);
   state->setValue(FaceInvertNormals, false);
+  state->setValue(FaceLevelsOfDetail, 1);
 
   state->setValue(FieldName, std::string());
 
@@ -374,6 +466,10 @@ GeometryHandle GeometryBuilder::buildGeometryObject(
 
   /// \todo render_state_ DIRTY flag? See old scirun ShowField.cc:446.
 
+  // Buffers are named from the stable part of the ID, the hash changes with
+  // every input or state change. A buffer that is sent again unchanged keeps
+  // its name, and the renderer keeps it on the GPU.
+
   const int dim = field->vmesh()->dimensionality();
   if (showEdges && dim < 1) { showEdges = false; }
   if (showFaces && dim < 2) { showFaces = false; }
@@ -381,18 +477,18 @@ GeometryHandle GeometryBuilder::buildGeometryObject(
   if (showNodes)
   {
     // Construct node geometry.
-    renderNodes(field, colorMap, interruptible, getNodeRenderState(colorMap), geom, geom->uniqueID());
+    renderNodes(field, colorMap, interruptible, getNodeRenderState(colorMap), geom, geom->stableID());
   }
 
   if (showFaces)
   {
     int approxDiv = 1;
-    renderFaces(field, colorMap, interruptible, getFaceRenderState(colorMap), geom, approxDiv, geom->uniqueID());
+    renderFaces(field, colorMap, interruptible, getFaceRenderState(colorMap), geom, approxDiv, geom->stableID());
   }
 
   if (showEdges)
   {
-    renderEdges(field, colorMap, interruptible, getEdgeRenderState(colorMap), geom, geom->uniqueID());
+    renderEdges(field, colorMap, interruptible, getEdgeRenderState(colorMap), geom, geom->stableID());
   }
 
   return geom;
@@ -419,8 +515,39 @@ void GeometryBuilder::renderFaces(
   // if(mesh->is_regularmesh() && mesh->is_surface() &&
   //    get_flag(render_state, USE_TEXTURE))
 
+  // Surfaces can be drawn as a set of decimated meshes, the renderer picks
+  // the one that matches the size of the object on screen.
+  const int numLevels = state_->getValue(ShowField::FaceLevelsOfDetail).toInt();
+  if (doLinear && numLevels > 1 && mesh->is_surface() &&
+      (mesh->is_trisurfmesh() || mesh->is_quadsurfmesh()))
+  {
+    const std::vector<FieldHandle>& levels = faceLevels(field, numLevels);
+    if (levels.size() > 1)
+    {
+      const BBox bbox = mesh->get_bounding_box();
+      const Point center = bbox.center();
+
+      // Level k is drawn while the bounding sphere is between 0.5/2^k and
+      // 0.5/2^(k-1) of the viewport height across, the finest and coarsest
+      // levels are open ended.
+      SpireLevelOfDetail lod;
+      lod.center = glm::vec3(static_cast<float>(center.x()), static_cast<float>(center.y()),
+        static_cast<float>(center.z()));
+      lod.radius = static_cast<float>(0.5 * bbox.diagonal().length());
+      faceBuffers_.resize(levels.size());
+      for (size_t k = 0; k < levels.size(); k++)
+      {
+        lod.maxSize = (k == 0) ? std::numeric_limits<float>::max() : 0.5f / (1 << (k - 1));
+        lod.minSize = (k + 1 == levels.size()) ? 0.0f : 0.5f / (1 << k);
+        renderFacesLinear(levels[k], colorMap, interruptible, state, geom, approxDiv, id, k, lod);
+      }
+      return;
+    }
+  }
+
   if (doLinear)
   {
+    faceBuffers_.resize(1);
     return renderFacesLinear(field, colorMap, interruptible, state, geom, approxDiv, id);
   }
   else
@@ -430,306 +557,552 @@ void GeometryBuilder::renderFaces(
 }
 
 
-void GeometryBuilder::renderFacesLinear(
-  FieldHandle field,
-  boost::optional<boost::shared_ptr<ColorMap>> colorMap,
-  Interruptible* interruptible,
-  RenderState state,
-  GeometryHandle geom,
-  unsigned int approxDiv,
-  const std::string& id)
+const std::vector<FieldHandle>& GeometryBuilder::faceLevels(FieldHandle field, int numLevels)
 {
-  VField* fld = field->vfield();
-  VMesh*  mesh = field->vmesh();
+  FaceLevelCache& cache = faceLevels_;
+  if (cache.field != field || cache.numLevels != numLevels)
+  {
+    cache.levels.clear();
+    cache.field = field;
+    cache.numLevels = numLevels;
+    Core::Algorithms::Fields::DecimateMeshAlgo algo;
+    if (!algo.runLevels(field, static_cast<size_t>(numLevels), cache.levels))
+      cache.levels.assign(1, field);
+  }
+  return cache.levels;
+}
 
-  mesh->synchronize(Mesh::FACES_E);
+namespace
+{
+  float* writePoint(float* vertex, const Point& point)
+  {
+    vertex[0] = static_cast<float>(point.x());
+    vertex[1] = static_cast<float>(point.y());
+    vertex[2] = static_cast<float>(point.z());
+    return vertex + 3;
+  }
 
-  VMesh::Face::size_type numFaces;
+  float* writePoint(float* vertex, const Vector& normal)
+  {
+    vertex[0] = static_cast<float>(normal.x());
+    vertex[1] = static_cast<float>(normal.y());
+    vertex[2] = static_cast<float>(normal.z());
+    return vertex + 3;
+  }
 
-  mesh->size(numFaces);
+  float* writeColor(float* vertex, const ColorRGB& color)
+  {
+    vertex[0] = static_cast<float>(color.r());
+    vertex[1] = static_cast<float>(color.g());
+    vertex[2] = static_cast<float>(color.b());
+    vertex[3] = 1.0f;
+    return vertex + 4;
+  }
 
-  if (numFaces == 0)
-    return;
+  template <class Index>
+  ColorRGB valueToColor(VField* fld, const ColorMap& map, Index idx)
+  {
+    if (fld->is_scalar())
+    {
+      double value;
+      fld->get_value(value, idx);
+      return map.valueToColor(value);
+    }
+    else if (fld->is_vector())
+    {
+      Vector value;
+      fld->get_value(value, idx);
+      return map.valueToColor(value);
+    }
+    else if (fld->is_tensor())
+    {
+      Tensor value;
+      fld->get_value(value, idx);
+      return map.valueToColor(value);
+    }
+    return ColorRGB(1.0, 1.0, 1.0);
+  }
+}
 
-  bool withNormals = (state.get(RenderState::USE_NORMALS));
-  if (withNormals) { mesh->synchronize(Mesh::NORMALS_E); }
+void GeometryBuilder::buildFaceGeometry(FaceBufferCache& cache, VMesh* mesh,
+  const FaceBufferCache::GeometryKey& key, Interruptible* interruptible)
+{
+  cache.geometryValid = false;
+  cache.colorsValid = false;
+  cache.vbo.reset();
 
-  bool invertNormals = state_->getValue(ShowField::FaceInvertNormals).toBool();
-  ColorScheme colorScheme = ColorScheme::COLOR_UNIFORM;
-  std::vector<double> svals;
-  std::vector<Vector> vvals;
-  std::vector<Tensor> tvals;
-  std::vector<ColorRGB> face_colors;
+  // Only the boundary of a volume mesh is visible. It is found without
+  // building the face topology and kept with the buffers of this mesh.
+  cache.boundary.reset();
+  if (mesh->is_volume()) cache.boundary = mesh->get_boundary_faces();
+  const MeshBoundaryFaces* boundary = cache.boundary.get();
 
-  if (fld->basis_order() < 0 || state.get(RenderState::USE_DEFAULT_COLOR))
+  if (boundary)
   {
-    colorScheme = ColorScheme::COLOR_UNIFORM;
-  }
-  else if (state.get(RenderState::USE_COLORMAP))
-  {
-    colorScheme = ColorScheme::COLOR_MAP;
+    cache.numFaces = boundary->size();
   }
-  else // if (fld->basis_order() >= 0)
+  else
   {
-    colorScheme = ColorScheme::COLOR_IN_SITU;
+    mesh->synchronize(Mesh::FACES_E);
+    VMesh::Face::size_type size;
+    mesh->size(size);
+    cache.numFaces = static_cast<size_t>(size);
   }
 
-  // Three 32 bit ints to index into the VBO
-  uint32_t iboSize = static_cast<uint32_t>(mesh->num_faces() * sizeof(uint32_t) * 3);
-  //Seven floats per VBO: Pos (3) XYZ, and Color (4) RGBA
-  uint32_t vboSize = static_cast<uint32_t>(mesh->num_faces() * sizeof(float) * 7);
+  if (key.withNormals) { mesh->synchronize(Mesh::NORMALS_E); }
 
-  // Construct VBO and IBO that will be used to render the faces. Once again,
-  // IBOs are not strictly needed. But, we may be able to optimize this code
-  // somewhat.
-  /// \todo Switch to unique_ptrs and move semantics.
-  std::shared_ptr<spire::VarBuffer> iboBufferSPtr(
-    new spire::VarBuffer(vboSize));
-  std::shared_ptr<spire::VarBuffer> vboBufferSPtr(
-    new spire::VarBuffer(iboSize));
+  // Prisms mix triangles and quads, both are stored as quads.
+  const size_t numFaces = cache.numFaces;
+  const size_t numCorners = boundary ? boundary->nodes_per_face :
+    (mesh->is_prismvolmesh() ? 4 : mesh->num_nodes_per_face());
+  const size_t numTriangles = numCorners - 2;
+  cache.numCorners = numCorners;
 
-  // Accessing the pointers like this is contrived. We only do this for
-  // speed since we will be using the pointers in a tight inner loop.
-  auto iboBuffer = iboBufferSPtr.get();
-  auto vboBuffer = vboBufferSPtr.get();
+  // Shared vertices of a boundary are limited to the nodes it uses
+  std::vector<VMesh::index_type> nodeVertex;
+  std::vector<VMesh::index_type> vertexNode;
+  if (key.shareVertices && boundary)
+  {
+    nodeVertex.assign(static_cast<size_t>(mesh->num_nodes()), -1);
+    for (size_t i = 0; i < boundary->nodes.size(); i++)
+    {
+      VMesh::index_type& vertex = nodeVertex[boundary->nodes[i]];
+      if (vertex < 0)
+      {
+        vertex = static_cast<VMesh::index_type>(vertexNode.size());
+        vertexNode.push_back(boundary->nodes[i]);
+      }
+    }
+  }
 
-  uint32_t iboIndex = 0;
-  int64_t numVBOElements = 0;
+  const size_t numVertices = !key.shareVertices ? numFaces * numCorners :
+    (boundary ? vertexNode.size() : static_cast<size_t>(mesh->num_nodes()));
+  const size_t numIndices = numFaces * numTriangles * 3;
 
-  VMesh::Face::iterator fiter, fiterEnd;
-  VMesh::Node::array_type nodes;
+  // Every face and node has a fixed position in the streams, they are
+  // written in parallel.
+  cache.positions.resize(numVertices * 3);
+  cache.normals.resize(key.withNormals ? numVertices * 3 : 0);
+  cache.vertexNodes.resize(numVertices);
 
-  mesh->begin(fiter);
-  mesh->end(fiterEnd);
+  cache.ibo.reset(new spire::VarBuffer(static_cast<uint32_t>(numIndices * sizeof(uint32_t))));
+  uint32_t* ibo = reinterpret_cast<uint32_t*>(cache.ibo->allocate(numIndices * sizeof(uint32_t)));
 
-  Point idpt;
-  mesh->get_nodes(nodes, *fiter);
-  mesh->get_point(idpt, nodes[0]);
+  const int numProcs = Parallel::NumCores();
 
-  while (fiter != fiterEnd)
+  if (key.shareVertices)
   {
-    interruptible->checkForInterruption();
+    auto nodeTask = [&](int proc)
+    {
+      const size_t start = (numVertices*proc)/numProcs;
+      const size_t end = (numVertices*(proc+1))/numProcs;
+      for (size_t n = start; n < end; n++)
+      {
+        const VMesh::Node::index_type node(boundary ? vertexNode[n] :
+          static_cast<VMesh::index_type>(n));
+        cache.vertexNodes[n] = node;
 
-    mesh->get_nodes(nodes, *fiter);
+        Point point;
+        mesh->get_point(point, node);
+        writePoint(&cache.positions[n * 3], point);
 
-    std::vector<Point> points(nodes.size());
-    std::vector<Vector> normals(nodes.size());
+        if (key.withNormals)
+        {
+          Vector normal;
+          mesh->get_normal(normal, node);
+          writePoint(&cache.normals[n * 3], key.invertNormals ? -normal : normal);
+        }
+      }
+    };
+    Parallel::RunTasks(nodeTask, numProcs);
+    interruptible->checkForInterruption();
+  }
 
-    for (size_t i = 0; i < nodes.size(); i++)
-    {
-      mesh->get_point(points[i], nodes[i]);
-    }
+  auto faceTask = [&](int proc)
+  {
+    const size_t start = (numFaces*proc)/numProcs;
+    const size_t end = (numFaces*(proc+1))/numProcs;
 
-    //TODO fix so the withNormals tp be woth lighting is called correctly, and the meshes are fixed.
-    if (withNormals)
+    VMesh::Node::array_type nodes;
+    std::vector<Point> points(numCorners);
+
+    for (size_t f = start; f < end; f++)
     {
-      bool useFaceNormals = state.get(RenderState::USE_FACE_NORMALS) && mesh->has_normals();
-      if (useFaceNormals)
+      if (boundary)
       {
-        for (size_t i = 0; i < nodes.size(); i++)
-        {
-          auto norm = normals[i];
-          normals[i] = invertNormals ? -norm : norm;
-          mesh->get_normal(normals[i], nodes[i]);
-        }
+        const VMesh::index_type* first = &boundary->nodes[f * numCorners];
+        nodes.assign(first, first + numCorners);
       }
       else
       {
-        /// Fix normal of Quads
-        if (points.size() == 4)
-        {
-          Vector edge1 = points[1] - points[0];
-          Vector edge2 = points[2] - points[1];
-          Vector edge3 = points[3] - points[2];
-          Vector edge4 = points[0] - points[3];
-
-          Vector norm = Cross(edge1, edge2) + Cross(edge2, edge3) + Cross(edge3, edge4) + Cross(edge4, edge1);
+        mesh->get_nodes(nodes, VMesh::Face::index_type(static_cast<VMesh::index_type>(f)));
+      }
 
-          norm.normalize();
+      // The triangular faces of prisms are padded with their last node, the
+      // extra triangle is degenerate.
+      nodes.resize(numCorners, nodes.back());
 
-          for (size_t i = 0; i < nodes.size(); i++)
-          {
-            normals[i] = invertNormals ? -norm : norm;
-          }
+      // Triangle fan around the first corner
+      uint32_t* index = ibo + f * numTriangles * 3;
+      const uint32_t base = static_cast<uint32_t>(f * numCorners);
+      for (size_t t = 0; t < numTriangles; t++)
+      {
+        if (key.shareVertices && boundary)
+        {
+          index[0] = static_cast<uint32_t>(nodeVertex[nodes[0]]);
+          index[1] = static_cast<uint32_t>(nodeVertex[nodes[t + 1]]);
+          index[2] = static_cast<uint32_t>(nodeVertex[nodes[t + 2]]);
+        }
+        else if (key.shareVertices)
+        {
+          index[0] = static_cast<uint32_t>(nodes[0]);
+          index[1] = static_cast<uint32_t>(nodes[t + 1]);
+          index[2] = static_cast<uint32_t>(nodes[t + 2]);
         }
-        /// Fix Normals of Tris
         else
         {
-          Vector edge1 = points[1] - points[0];
-          Vector edge2 = points[2] - points[1];
-          Vector norm = Cross(edge1, edge2);
-
-          norm.normalize();
-
-          for (size_t i = 0; i < nodes.size(); i++)
-          {
-            normals[i] = invertNormals ? -norm : norm;
-          }
-          //For future reference for a try at smoother rendering
-          /*
-          for (size_t i = 0; i < nodes.size(); i++)
-          {
-          mesh->get_normal(normals[i], nodes[i]);
-          }
-          */
+          index[0] = base;
+          index[1] = base + static_cast<uint32_t>(t + 1);
+          index[2] = base + static_cast<uint32_t>(t + 2);
         }
+        index += 3;
       }
-    }
-    // Default color single face no matter the element data.
-    if (colorScheme == ColorScheme::COLOR_UNIFORM)
-    {
-      addFaceGeom(points, normals, withNormals, iboIndex, iboBuffer, vboBuffer,
-        colorScheme, face_colors, state);
-    }
-    // Element data (Cells) so two sided faces.
-    else if (fld->basis_order() == 0 && mesh->dimensionality() == 3)
-    {
-      auto map = colorMap.get();
-      //two possible colors.
-      svals.resize(2);
-      vvals.resize(2);
-      tvals.resize(2);
-      face_colors = {{ColorRGB(1.,1.,1.),ColorRGB(1.,1.,1.)}};
+      if (key.shareVertices) continue;
 
-      VMesh::Elem::array_type cells;
-      mesh->get_elems(cells, *fiter);
+      for (size_t i = 0; i < numCorners; i++)
+        mesh->get_point(points[i], nodes[i]);
 
-      if (fld->is_scalar())
+      Vector normal;
+      if (key.withNormals && !key.nodeNormals)
       {
-        fld->get_value(svals[0], cells[0]);
-
-        if (cells.size() > 1)
+        if (numCorners == 4)
         {
-          fld->get_value(svals[1], cells[1]);
+          /// Fix normal of Quads
+          Vector edge1 = points[1] - points[0];
+          Vector edge2 = points[2] - points[1];
+          Vector edge3 = points[3] - points[2];
+          Vector edge4 = points[0] - points[3];
+          normal = Cross(edge1, edge2) + Cross(edge2, edge3) + Cross(edge3, edge4) + Cross(edge4, edge1);
         }
         else
         {
-          svals[1] = svals[0];
+          /// Fix Normals of Tris
+          normal = Cross(points[1] - points[0], points[2] - points[1]);
         }
-        face_colors[0] = map->valueToColor(svals[0]);
-        face_colors[1] = map->valueToColor(svals[1]);
+        normal.normalize();
+        if (key.invertNormals) normal = -normal;
       }
-      else if (fld->is_vector())
+
+      for (size_t i = 0; i < numCorners; i++)
       {
-        fld->get_value(vvals[0], cells[0]);
+        const size_t v = base + i;
+        cache.vertexNodes[v] = nodes[i];
+        writePoint(&cache.positions[v * 3], points[i]);
 
-        if (cells.size() > 1)
+        if (key.nodeNormals)
         {
-          fld->get_value(vvals[1], cells[1]);
+          Vector n;
+          mesh->get_normal(n, nodes[i]);
+          writePoint(&cache.normals[v * 3], key.invertNormals ? -n : n);
         }
-        else
+        else if (key.withNormals)
         {
-          svals[1] = svals[0];
+          writePoint(&cache.normals[v * 3], normal);
         }
+      }
+    }
+  };
+  Parallel::RunTasks(faceTask, numProcs);
+  interruptible->checkForInterruption();
 
-        face_colors[0] = map->valueToColor(vvals[0]);
-        face_colors[1] = map->valueToColor(vvals[1]);
+  cache.bbox = mesh->get_bounding_box();
+  cache.geometryKey = key;
+  cache.geometryValid = true;
+}
+
+void GeometryBuilder::buildFaceColors(FaceBufferCache& cache, VField* fld, VMesh* mesh,
+  const FaceBufferCache::ColorKey& key, Interruptible* interruptible)
+{
+  cache.colorsValid = false;
+  cache.vbo.reset();
+
+  const size_t numVertices = cache.vertexNodes.size();
+  const size_t floatsPerColor = key.doubleSided ? 8 : 4;
+  cache.colors.resize(key.map ? numVertices * floatsPerColor : 0);
+
+  const int numProcs = Parallel::NumCores();
+  const MeshBoundaryFaces* boundary = cache.boundary.get();
+
+  if (key.map && key.nodeColors)
+  {
+    auto nodeTask = [&](int proc)
+    {
+      const size_t start = (numVertices*proc)/numProcs;
+      const size_t end = (numVertices*(proc+1))/numProcs;
+      for (size_t v = start; v < end; v++)
+      {
+        const ColorRGB color = valueToColor(fld, *key.map,
+          VMesh::Node::index_type(cache.vertexNodes[v]));
+        float* out = writeColor(&cache.colors[v * floatsPerColor], color);
+        if (key.doubleSided) writeColor(out, color);
       }
-      else if (fld->is_tensor())
+    };
+    Parallel::RunTasks(nodeTask, numProcs);
+  }
+  else if (key.map && (key.faceColors || key.cellColors))
+  {
+    const size_t numFaces = cache.numFaces;
+    auto faceTask = [&](int proc)
+    {
+      const size_t start = (numFaces*proc)/numProcs;
+      const size_t end = (numFaces*(proc+1))/numProcs;
+      VMesh::Elem::array_type cells;
+
+      for (size_t f = start; f < end; f++)
       {
-        fld->get_value(tvals[0], cells[0]);
+        const VMesh::Face::index_type face(static_cast<VMesh::index_type>(f));
 
-        if (cells.size() > 1)
+        // Per face colors, the second one is used by the back side.
+        ColorRGB colors[2];
+        if (key.faceColors)
         {
-          fld->get_value(tvals[1], cells[1]);
+          colors[0] = colors[1] = valueToColor(fld, *key.map, face);
+        }
+        else if (boundary)
+        {
+          colors[0] = colors[1] = valueToColor(fld, *key.map,
+            VMesh::Elem::index_type(boundary->elems[f]));
         }
         else
         {
-          svals[1] = svals[0];
+          mesh->get_elems(cells, face);
+          colors[0] = colors[1] = valueToColor(fld, *key.map, cells[0]);
+          if (cells.size() > 1) colors[1] = valueToColor(fld, *key.map, cells[1]);
         }
 
-        face_colors[0] = map->valueToColor(tvals[0]);
-        face_colors[1] = map->valueToColor(tvals[1]);
+        for (size_t i = 0; i < cache.numCorners; i++)
+        {
+          float* out = writeColor(&cache.colors[(f * cache.numCorners + i) * floatsPerColor], colors[0]);
+          if (key.doubleSided) writeColor(out, colors[1]);
+        }
       }
+    };
+    Parallel::RunTasks(faceTask, numProcs);
+  }
+  interruptible->checkForInterruption();
 
-      state.set(RenderState::IS_DOUBLE_SIDED, true);
-
-      addFaceGeom(points, normals, withNormals, iboIndex, iboBuffer, vboBuffer,
-        colorScheme, face_colors, state);
-    }
-    // Element data (faces)
-    else if (fld->basis_order() == 0 && mesh->dimensionality() == 2)
-    {
-      auto map = colorMap.get();
-      //one possible color, each node that color.
-      svals.resize(1);
-      vvals.resize(1);
-      tvals.resize(1);
-      face_colors.resize(nodes.size());
-      if (fld->is_scalar())
-      {
-        fld->get_value(svals[0], *fiter);
-        face_colors[0] = map->valueToColor(svals[0]);
-      }
-      else if (fld->is_vector())
-      {
-        fld->get_value(vvals[0], *fiter);
-        face_colors[0] = map->valueToColor(vvals[0]);
-      }
-      else if (fld->is_tensor())
-      {
-        fld->get_value(tvals[0], *fiter);
-        face_colors[0] = map->valueToColor(tvals[0]);
-      }
+  cache.colorKey = key;
+  cache.colorsValid = true;
+}
 
-      // Same color at all corners.
-      for (size_t i = 0; i<nodes.size(); ++i)
-      {
-        face_colors[i] = face_colors[0];
-      }
+void GeometryBuilder::buildFaceChunks(FaceBufferCache& cache, size_t floatsPerVertex,
+  Interruptible* interruptible)
+{
+  const size_t numIndices = cache.ibo->getBufferSize() / sizeof(uint32_t);
+  const uint32_t* ibo = reinterpret_cast<const uint32_t*>(cache.ibo->getBuffer());
+  const int numProcs = Parallel::NumCores();
 
-      addFaceGeom(points, normals, withNormals, iboIndex, iboBuffer, vboBuffer,
-        colorScheme, face_colors,  state);
-    }
+  // The split only depends on the indices, a new color keeps the index
+  // buffers of the chunks.
+  if (cache.chunkedIBO != cache.ibo)
+  {
+    cache.chunks.clear();
+    cache.chunks.resize((numIndices + FaceChunkIndices - 1) / FaceChunkIndices);
+    cache.chunkedVBO.reset();
 
-    // Data at nodes
-    else if (fld->basis_order() == 1)
+    const size_t numChunks = cache.chunks.size();
+    auto indexTask = [&](int proc)
     {
-      auto map = colorMap.get();
-      svals.resize(nodes.size());
-      vvals.resize(nodes.size());
-      tvals.resize(nodes.size());
-      face_colors.resize(nodes.size());
-      //node.size() possible colors.
-      if (fld->is_scalar())
+      std::unordered_map<uint32_t, uint32_t> local;
+      for (size_t c = proc; c < numChunks; c += numProcs)
       {
-        for (size_t i = 0; i<nodes.size(); i++)
-        {
-          fld->get_value(svals[i], nodes[i]);
-          face_colors[i] = map->valueToColor(svals[i]);
-        }
-      }
-      else if (fld->is_vector())
-      {
-        for (size_t i = 0; i<nodes.size(); i++)
+        FaceBufferCache::Chunk& chunk = cache.chunks[c];
+        const size_t start = c * FaceChunkIndices;
+        const size_t count = std::min(numIndices - start, FaceChunkIndices);
+
+        chunk.ibo.reset(new spire::VarBuffer(static_cast<uint32_t>(count * sizeof(uint32_t))));
+        uint32_t* out = reinterpret_cast<uint32_t*>(chunk.ibo->allocate(count * sizeof(uint32_t)));
+
+        local.clear();
+        for (size_t i = 0; i < count; i++)
         {
-          fld->get_value(vvals[i], nodes[i]);
-          face_colors[i] = map->valueToColor(vvals[i]);
+          const uint32_t vertex = ibo[start + i];
+          auto it = local.insert(std::make_pair(vertex, static_cast<uint32_t>(chunk.vertices.size())));
+          if (it.second)
+          {
+            chunk.vertices.push_back(vertex);
+            const float* p = &cache.positions[vertex * 3];
+            chunk.bbox.extend(Point(p[0], p[1], p[2]));
+          }
+          out[i] = it.first->second;
         }
       }
-      else if (fld->is_tensor())
+    };
+    Parallel::RunTasks(indexTask, numProcs);
+    interruptible->checkForInterruption();
+    cache.chunkedIBO = cache.ibo;
+  }
+
+  if (cache.chunkedVBO != cache.vbo)
+  {
+    const float* vbo = reinterpret_cast<const float*>(cache.vbo->getBuffer());
+    const size_t numChunks = cache.chunks.size();
+    auto vertexTask = [&](int proc)
+    {
+      for (size_t c = proc; c < numChunks; c += numProcs)
       {
-        for (size_t i = 0; i<nodes.size(); i++)
+        FaceBufferCache::Chunk& chunk = cache.chunks[c];
+        const size_t bytes = chunk.vertices.size() * floatsPerVertex * sizeof(float);
+        chunk.vbo.reset(new spire::VarBuffer(static_cast<uint32_t>(bytes)));
+        float* out = reinterpret_cast<float*>(chunk.vbo->allocate(bytes));
+        for (size_t v = 0; v < chunk.vertices.size(); v++)
         {
-          fld->get_value(tvals[i], nodes[i]);
-          face_colors[i] = map->valueToColor(tvals[i]);
+          const float* vertex = vbo + chunk.vertices[v] * floatsPerVertex;
+          out = std::copy(vertex, vertex + floatsPerVertex, out);
         }
       }
+    };
+    Parallel::RunTasks(vertexTask, numProcs);
+    interruptible->checkForInterruption();
+    cache.chunkedVBO = cache.vbo;
+  }
+}
 
-      addFaceGeom(points, normals, withNormals, iboIndex, iboBuffer, vboBuffer,
-        colorScheme, face_colors, state);
-    }
+void GeometryBuilder::renderFacesLinear(
+  FieldHandle field,
+  boost::optional<boost::shared_ptr<ColorMap>> colorMap,
+  Interruptible* interruptible,
+  RenderState state,
+  GeometryHandle geom,
+  unsigned int approxDiv,
+  const std::string& id,
+  size_t level,
+  const SpireLevelOfDetail& lod)
+{
+  VField* fld = field->vfield();
+  VMesh*  mesh = field->vmesh();
+
+  bool withNormals = (state.get(RenderState::USE_NORMALS));
 
-    ++fiter;
-    ++numVBOElements;
+  bool invertNormals = state_->getValue(ShowField::FaceInvertNormals).toBool();
+  ColorScheme colorScheme = ColorScheme::COLOR_UNIFORM;
+
+  if (fld->basis_order() < 0 || state.get(RenderState::USE_DEFAULT_COLOR))
+  {
+    colorScheme = ColorScheme::COLOR_UNIFORM;
   }
+  else if (state.get(RenderState::USE_COLORMAP))
+  {
+    colorScheme = ColorScheme::COLOR_MAP;
+  }
+  else // if (fld->basis_order() >= 0)
+  {
+    colorScheme = ColorScheme::COLOR_IN_SITU;
+  }
+
+  // Colors are always looked up in the color map
+  ColorMapHandle map;
+  if (colorScheme != ColorScheme::COLOR_UNIFORM)
+  {
+    if (colorMap) map = colorMap.get();
+    else colorScheme = ColorScheme::COLOR_UNIFORM;
+  }
+
+  const bool withColors = (colorScheme != ColorScheme::COLOR_UNIFORM);
+  const bool nodeColors = withColors && fld->basis_order() == 1;
+  const bool faceColors = withColors && fld->basis_order() == 0 && mesh->dimensionality() == 2;
+  // Element data (Cells) so two sided faces.
+  const bool cellColors = withColors && fld->basis_order() == 0 && mesh->dimensionality() == 3;
+  if (cellColors) { state.set(RenderState::IS_DOUBLE_SIDED, true); }
+  const bool doubleSided = state.get(RenderState::IS_DOUBLE_SIDED);
+
+  const bool nodeNormals = withNormals && state.get(RenderState::USE_FACE_NORMALS) && mesh->has_normals();
+
+  // When every attribute is defined at the nodes, the faces share one vertex
+  // per node and only the IBO is built per face. Otherwise every face gets
+  // its own corners.
+  const bool shareVertices = (!withNormals || nodeNormals) && !faceColors && !cellColors;
+
+  // The streams are rebuilt only when what they depend on changed. A new
+  // colormap or color option keeps positions, normals and indices, a change
+  // of transparency or of the default color, which are uniforms, keeps all
+  // buffers.
+  if (faceBuffers_.size() <= level) faceBuffers_.resize(level + 1);
+  FaceBufferCache& cache = faceBuffers_[level];
+
+  FaceBufferCache::GeometryKey geometryKey;
+  geometryKey.mesh = field->mesh();
+  geometryKey.withNormals = withNormals;
+  geometryKey.nodeNormals = nodeNormals;
+  geometryKey.invertNormals = invertNormals;
+  geometryKey.shareVertices = shareVertices;
+
+  if (!cache.geometryValid || !(cache.geometryKey == geometryKey))
+    buildFaceGeometry(cache, mesh, geometryKey, interruptible);
+
+  if (cache.numFaces == 0)
+    return;
+
+  FaceBufferCache::ColorKey colorKey;
+  if (withColors)
+  {
+    colorKey.field = field;
+    colorKey.map = map;
+    colorKey.nodeColors = nodeColors;
+    colorKey.faceColors = faceColors;
+    colorKey.cellColors = cellColors;
+    colorKey.doubleSided = doubleSided;
+  }
+
+  if (!cache.colorsValid || !(cache.colorKey == colorKey))
+    buildFaceColors(cache, fld, mesh, colorKey, interruptible);
+
+  // Pos (3) XYZ, Normal (3) and one or two colors (4) RGBA per vertex
+  const size_t numVertices = cache.vertexNodes.size();
+  const size_t floatsPerColor = withColors ? (doubleSided ? 8 : 4) : 0;
+  const size_t floatsPerVertex = 3 + (withNormals ? 3 : 0) + floatsPerColor;
+
+  if (!cache.vbo)
+  {
+    // Interleave the streams for the renderer
+    std::shared_ptr<spire::VarBuffer> interleaved(
+      new spire::VarBuffer(static_cast<uint32_t>(numVertices * floatsPerVertex * sizeof(float))));
+    float* vbo = reinterpret_cast<float*>(
+      interleaved->allocate(numVertices * floatsPerVertex * sizeof(float)));
+
+    const int numProcs = Parallel::NumCores();
+    auto vertexTask = [&](int proc)
+    {
+      const size_t start = (numVertices*proc)/numProcs;
+      const size_t end = (numVertices*(proc+1))/numProcs;
+      for (size_t v = start; v < end; v++)
+      {
+        float* vertex = std::copy(&cache.positions[v * 3], &cache.positions[v * 3] + 3,
+          vbo + v * floatsPerVertex);
+        if (withNormals)
+          vertex = std::copy(&cache.normals[v * 3], &cache.normals[v * 3] + 3, vertex);
+        if (floatsPerColor)
+          std::copy(&cache.colors[v * floatsPerColor], &cache.colors[v * floatsPerColor] + floatsPerColor, vertex);
+      }
+    };
+    Parallel::RunTasks(vertexTask, numProcs);
+    interruptible->checkForInterruption();
+    cache.vbo = interleaved;
+  }
+
+  std::shared_ptr<spire::VarBuffer> vboBufferSPtr = cache.vbo;
+  std::shared_ptr<spire::VarBuffer> iboBufferSPtr = cache.ibo;
+  int64_t numVBOElements = static_cast<int64_t>(numVertices);
 
   std::stringstream ss;
   ss << invertNormals << static_cast<int>(colorScheme) << faceTransparencyValue_;
 
-  std::string uniqueNodeID = id + "face" + ss.str();
-  std::string vboName = uniqueNodeID + "VBO";
-  std::string iboName = uniqueNodeID + "IBO";
+  // Buffer names do not depend on the options, the renderer keeps a buffer
+  // that is sent again under the same name.
+  const std::string levelName = level > 0 ? "Level" + std::to_string(level) : std::string();
+  std::string uniqueNodeID = id + "face" + levelName + ss.str();
+  std::string vboName = id + "faceVBO" + levelName;
+  std::string iboName = id + "faceIBO" + levelName;
   std::string passName = uniqueNodeID + "Pass";
 
   // NOTE: Attributes will depend on the color scheme. We will want to
@@ -855,351 +1228,50 @@ void GeometryBuilder::renderFacesLinear(
     }
   }
 
-  SpireVBO geomVBO(vboName, attribs, vboBufferSPtr,
-    numVBOElements, mesh->get_bounding_box(), true);
-
-  geom->vbos().push_back(geomVBO);
-
-  // Construct IBO.
+  auto addPass = [&](const std::string& suffix, std::shared_ptr<spire::VarBuffer> vboBuffer,
+    std::shared_ptr<spire::VarBuffer> iboBuffer, int64_t numElements, const BBox& bbox)
+  {
+    SpireVBO geomVBO(vboName + suffix, attribs, vboBuffer,
+      numElements, bbox, true);
 
-  SpireIBO geomIBO(iboName, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboBufferSPtr);
+    geom->vbos().push_back(geomVBO);
 
-  geom->ibos().push_back(geomIBO);
+    // Construct IBO.
 
-  SpireText text;
+    SpireIBO geomIBO(iboName + suffix, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboBuffer);
 
-  SpireSubPass pass(passName, vboName, iboName, shader,
-    colorScheme, state, RenderType::RENDER_VBO_IBO, geomVBO, geomIBO, text);
+    geom->ibos().push_back(geomIBO);
 
-  // Add all uniforms generated above to the pass.
-  for (const auto& uniform : uniforms) { pass.addUniform(uniform); }
+    SpireText text;
 
-  geom->passes().push_back(pass);
+    SpireSubPass pass(passName + suffix, vboName + suffix, iboName + suffix, shader,
+      colorScheme, state, RenderType::RENDER_VBO_IBO, geomVBO, geomIBO, text);
+    pass.lod = lod;
 
-  /// \todo Add spheres and other glyphs as display lists. Will want to
-  ///       build up to geometry / tessellation shaders if support is present.
-}
+    // Add all uniforms generated above to the pass.
+    for (const auto& uniform : uniforms) { pass.addUniform(uniform); }
 
-// This function needs to be reorganized.
-// The fact that we are only rendering triangles helps us dramatically and
-// we get rid of the quads renderer pointers. Additionally, we can re-order
-// the triangles in ES and perform different rendering based on the
-// transparency of the triangles.
-void GeometryBuilder::addFaceGeom(
-  const std::vector<Point>  &points,
-  const std::vector<Vector> &normals,
-  bool withNormals,
-  uint32_t& iboIndex,
-  spire::VarBuffer* iboBuffer,
-  spire::VarBuffer* vboBuffer,
-  ColorScheme colorScheme,
-  const std::vector<ColorRGB> &face_colors,
-  const RenderState& state)
-{
-  auto writeVBOPoint = [&vboBuffer](const Point& point)
-  {
-    vboBuffer->write(static_cast<float>(point.x()));
-    vboBuffer->write(static_cast<float>(point.y()));
-    vboBuffer->write(static_cast<float>(point.z()));
+    geom->passes().push_back(pass);
   };
 
-  auto writeVBONormal = [&vboBuffer](const Vector& normal)
+  if (cache.ibo->getBufferSize() / sizeof(uint32_t) <= FaceChunkIndices)
   {
-    vboBuffer->write(static_cast<float>(normal.x()));
-    vboBuffer->write(static_cast<float>(normal.y()));
-    vboBuffer->write(static_cast<float>(normal.z()));
-  };
-
-  auto writeVBOColorValue = [&vboBuffer](ColorRGB value)
-  {
-    vboBuffer->write(static_cast<float>(value.r()));
-    vboBuffer->write(static_cast<float>(value.g()));
-    vboBuffer->write(static_cast<float>(value.b()));
-    vboBuffer->write(static_cast<float>(1.f));
-  };
-
-  auto writeIBOIndex = [&iboBuffer](uint32_t index)
-  {
-    iboBuffer->write(index);
-  };
-
-  bool doubleSided = state.get(RenderState::IS_DOUBLE_SIDED);
-
-  if (colorScheme == ColorScheme::COLOR_UNIFORM)
-  {
-    if (points.size() == 4)
-    {
-      if (withNormals)
-      {
-        writeVBOPoint(points[0]);
-        writeVBONormal(normals[0]);
-
-        writeVBOPoint(points[1]);
-        writeVBONormal(normals[1]);
-
-        writeVBOPoint(points[2]);
-        writeVBONormal(normals[2]);
-
-        writeVBOPoint(points[3]);
-        writeVBONormal(normals[3]);
-      }
-      else
-      {
-        writeVBOPoint(points[0]);
-        writeVBOPoint(points[1]);
-        writeVBOPoint(points[2]);
-        writeVBOPoint(points[3]);
-      }
-      writeIBOIndex(iboIndex);
-      writeIBOIndex(iboIndex + 1);
-      writeIBOIndex(iboIndex + 2);
-
-      writeIBOIndex(iboIndex + 2);
-      writeIBOIndex(iboIndex + 3);
-      writeIBOIndex(iboIndex + 0);
-
-      iboIndex += 4;
-    }
-    else
-    {
-      for (size_t i = 2; i < points.size(); i++)
-      {
-        if (withNormals)
-        {
-          // Render points if we are not rendering spheres.
-          writeVBOPoint(points[0]);
-          writeVBONormal(normals[0]);
-          writeIBOIndex(iboIndex);
-
-          writeVBOPoint(points[i - 1]);
-          writeVBONormal(normals[i - 1]);
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-          writeVBONormal(normals[i]);
-          writeIBOIndex(iboIndex + i);
-        }
-        else
-        {
-          writeVBOPoint(points[0]);
-          writeIBOIndex(iboIndex);
-
-          writeVBOPoint(points[i - 1]);
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-          writeIBOIndex(iboIndex + i);
-        }
-      }
-      iboIndex += points.size();
-    }
+    addPass(std::string(), vboBufferSPtr, iboBufferSPtr, numVBOElements, cache.bbox);
   }
-  else if (colorScheme == ColorScheme::COLOR_MAP)
+  else
   {
-    if (points.size() == 4)
-    {
-      // Note:  For the double sided case, the 0 and 1 indices are not a typo.
-      //        It is a direct translation from old scirun.
-      if (withNormals)
-      {
-        writeVBOPoint(points[0]);
-        writeVBONormal(normals[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[1]);
-        writeVBONormal(normals[1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[2]);
-        writeVBONormal(normals[2]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[2]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[3]);
-        writeVBONormal(normals[3]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[3]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-      }
-      else
-      {
-        writeVBOPoint(points[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[2]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[2]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[3]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[3]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-      }
-      writeIBOIndex(iboIndex);
-      writeIBOIndex(iboIndex + 1);
-      writeIBOIndex(iboIndex + 2);
-
-      writeIBOIndex(iboIndex + 2);
-      writeIBOIndex(iboIndex + 3);
-      writeIBOIndex(iboIndex + 0);
-
-      iboIndex += 4;
-    }
-    else
+    // The renderer shows every chunk as soon as it is uploaded
+    buildFaceChunks(cache, floatsPerVertex, interruptible);
+    for (size_t c = 0; c < cache.chunks.size(); c++)
     {
-      for (size_t i = 2; i < points.size(); i++)
-      {
-        // Note:  For the double sided case, the 0 and 1 indices are not a typo.
-        //        It is a direct translation from old scirun.
-        if (withNormals)
-        {
-          // Render points if we are not rendering spheres.
-          writeVBOPoint(points[0]);
-          writeVBONormal(normals[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex);
-
-          // Apply misc user settings.
-          writeVBOPoint(points[i - 1]);
-          writeVBONormal(normals[i - 1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i-1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-          writeVBONormal(normals[i]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i);
-        }
-        else
-        {
-          // Render points if we are not rendering spheres.
-          writeVBOPoint(points[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex);
-
-          writeVBOPoint(points[i - 1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i-1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i);
-        }
-      }
-      iboIndex += points.size();
+      const FaceBufferCache::Chunk& chunk = cache.chunks[c];
+      addPass("Chunk" + std::to_string(c), chunk.vbo, chunk.ibo,
+        static_cast<int64_t>(chunk.vertices.size()), chunk.bbox);
     }
   }
-  else if (colorScheme == ColorScheme::COLOR_IN_SITU)
-  {
-    if (points.size() == 4)
-    {
-      if (withNormals)
-      {
-        writeVBOPoint(points[0]);
-        writeVBONormal(normals[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[1]);
-        writeVBONormal(normals[1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[2]);
-        writeVBONormal(normals[2]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[2]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[3]);
-        writeVBONormal(normals[3]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[3]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-      }
-      else
-      {
-        writeVBOPoint(points[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        // Add appropriate uniforms to the pass (in this case, uColor).
-        writeVBOPoint(points[1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[2]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[2]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[3]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[3]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-      }
-      writeIBOIndex(iboIndex);
-      writeIBOIndex(iboIndex + 1);
-      writeIBOIndex(iboIndex + 2);
-
-      writeIBOIndex(iboIndex + 2);
-      writeIBOIndex(iboIndex + 3);
-      writeIBOIndex(iboIndex + 0);
 
-      iboIndex += 4;
-    }
-    else
-    {
-      for (size_t i = 2; i < points.size(); i++)
-      {
-        if (withNormals)
-        {
-          writeVBOPoint(points[0]);
-          writeVBONormal(normals[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex);
-
-          writeVBOPoint(points[i - 1]);
-          writeVBONormal(normals[i - 1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i - 1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-          writeVBONormal(normals[i]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i);
-        }
-        else
-        {
-          writeVBOPoint(points[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          iboBuffer->write(iboIndex);
-
-          writeVBOPoint(points[i - 1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i - 1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i);
-        }
-      }
-      iboIndex += points.size();
-    }
-  }
+  /// \todo Add spheres and other glyphs as display lists. Will want to
+  ///       build up to geometry / tessellation shaders if support is present.
 }
 
 void GeometryBuilder::renderNodes(
@@ -1498,3 +1570,4 @@ const AlgorithmParameterName ShowField::TextSize("TextSize");
 const AlgorithmParameterName ShowField::TextPrecision("TextPrecision");
 const AlgorithmParameterName ShowField::TextColoring("TextColoring");
 const AlgorithmParameterName ShowField::UseFaceNormals("UseFaceNormals");
+const AlgorithmParameterName ShowField::FaceLevelsOfDetail("FaceLevelsOfDetail");
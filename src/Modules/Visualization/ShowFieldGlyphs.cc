@@ -54,6 +54,47 @@ using namespace Graphics::Datatypes;
 
 MODULE_INFO_DEF(ShowFieldGlyphs, Visualization, SCIRun)
 
+namespace
+{
+  // Glyph types drawn as instances of a template mesh, the others are
+  // tessellated one glyph at a time.
+  bool vectorTemplate(RenderState::GlyphType type, GlyphGeom::TemplateShape& shape)
+  {
+    switch (type)
+    {
+    case RenderState::GlyphType::LINE_GLYPH:
+    case RenderState::GlyphType::NEEDLE_GLYPH:
+    case RenderState::GlyphType::COMET_GLYPH:
+    case RenderState::GlyphType::RING_GLYPH:
+    case RenderState::GlyphType::SPRING_GLYPH:
+      return false;
+    case RenderState::GlyphType::CONE_GLYPH:
+      shape = GlyphGeom::TemplateShape::CONE;
+      return true;
+    case RenderState::GlyphType::DISK_GLYPH:
+      shape = GlyphGeom::TemplateShape::CYLINDER;
+      return true;
+    default:
+      shape = GlyphGeom::TemplateShape::ARROW;
+      return true;
+    }
+  }
+
+  bool scalarTemplate(RenderState::GlyphType type, GlyphGeom::TemplateShape& shape)
+  {
+    switch (type)
+    {
+    case RenderState::GlyphType::POINT_GLYPH:
+    case RenderState::GlyphType::BOX_GLYPH:
+    case RenderState::GlyphType::AXIS_GLYPH:
+      return false;
+    default:
+      shape = GlyphGeom::TemplateShape::SPHERE;
+      return true;
+    }
+  }
+}
+
 namespace SCIRun {
   namespace Modules {
     namespace Visualization {
@@ -170,6 +211,7 @@ void ShowFieldGlyphs::setStateDefaults()
 
 
   state->setValue(DefaultMeshColor, ColorRGB(0.5, 0.5, 0.5).toString());
+  state->setValue(InstancedGlyphs, false);
 }
 
 void ShowFieldGlyphs::execute()
@@ -340,6 +382,10 @@ void GlyphBuilder::renderVectors(
   if (scale < 0) scale = 1.0;
   if (resolution < 3) resolution = 5;
 
+  GlyphGeom::TemplateShape shape;
+  bool instanced = !useLines && vectorTemplate(renState.mGlyphType, shape) &&
+    state->getValue(ShowFieldGlyphs::InstancedGlyphs).toBool();
+
   GlyphGeom glyphs;
   auto facade(field->mesh()->getFacade());
 
@@ -372,6 +418,12 @@ void GlyphBuilder::renderVectors(
           node_color = ColorRGB(std::abs(colorVector.x()), std::abs(colorVector.y()), std::abs(colorVector.z()));
         }
       }
+      if (instanced)
+      {
+        glyphs.addInstance(p1, p2, radius, node_color);
+        done = true;
+        continue;
+      }
       switch (renState.mGlyphType)
       {
       case RenderState::GlyphType::LINE_GLYPH:
@@ -451,6 +503,11 @@ void GlyphBuilder::renderVectors(
       {
         node_color = renState.defaultColor;
       }
+      if (instanced)
+      {
+        glyphs.addInstance(p1, p2, radius, node_color);
+        continue;
+      }
       switch (renState.mGlyphType)
       {
       case RenderState::GlyphType::LINE_GLYPH:
@@ -502,8 +559,12 @@ void GlyphBuilder::renderVectors(
 
   std::string uniqueNodeID = id + "vector_glyphs" + ss.str();
 
-  glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENT_EDGES),
-    state->getValue(ShowFieldGlyphs::VectorsTransparencyValue).toDouble(), colorScheme, renState, primIn, mesh->get_bounding_box());
+  if (instanced)
+    glyphs.buildInstancedObject(*geom, uniqueNodeID, shape, resolution, renState.get(RenderState::USE_TRANSPARENT_EDGES),
+      state->getValue(ShowFieldGlyphs::VectorsTransparencyValue).toDouble(), colorScheme, renState, mesh->get_bounding_box());
+  else
+    glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENT_EDGES),
+      state->getValue(ShowFieldGlyphs::VectorsTransparencyValue).toDouble(), colorScheme, renState, primIn, mesh->get_bounding_box());
 }
 
 void GlyphBuilder::renderScalars(
@@ -552,6 +613,10 @@ void GlyphBuilder::renderScalars(
     primIn = SpireIBO::PRIMITIVE::POINTS;
   }
 
+  GlyphGeom::TemplateShape shape;
+  bool instanced = scalarTemplate(renState.mGlyphType, shape) &&
+    state->getValue(ShowFieldGlyphs::InstancedGlyphs).toBool();
+
   GlyphGeom glyphs;
   auto facade(field->mesh()->getFacade());
 
@@ -580,6 +645,12 @@ void GlyphBuilder::renderScalars(
           node_color = ColorRGB(std::abs(colorVector.x()), std::abs(colorVector.y()), std::abs(colorVector.z()));
         }
       }
+      if (instanced)
+      {
+        glyphs.addInstance(p, Vector(radius, 0, 0), Vector(0, radius, 0), Vector(0, 0, radius), node_color);
+        done = true;
+        continue;
+      }
       switch (renState.mGlyphType)
       {
       case RenderState::GlyphType::POINT_GLYPH:
@@ -634,6 +705,11 @@ void GlyphBuilder::renderScalars(
           node_color = ColorRGB(std::abs(colorVector.x()), std::abs(colorVector.y()), std::abs(colorVector.z()));
         }
       }
+      if (instanced)
+      {
+        glyphs.addInstance(p, Vector(radius, 0, 0), Vector(0, radius, 0), Vector(0, 0, radius), node_color);
+        continue;
+      }
       switch (renState.mGlyphType)
       {
       case RenderState::GlyphType::POINT_GLYPH:
@@ -664,8 +740,12 @@ void GlyphBuilder::renderScalars(
 
   std::string uniqueNodeID = id + "scalar_glyphs" + ss.str();
 
-  glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENT_NODES),
-    state->getValue(ShowFieldGlyphs::ScalarsTransparencyValue).toDouble(), colorScheme, renState, primIn, mesh->get_bounding_box());
+  if (instanced)
+    glyphs.buildInstancedObject(*geom, uniqueNodeID, shape, resolution, renState.get(RenderState::USE_TRANSPARENT_NODES),
+      state->getValue(ShowFieldGlyphs::ScalarsTransparencyValue).toDouble(), colorScheme, renState, mesh->get_bounding_box());
+  else
+    glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENT_NODES),
+      state->getValue(ShowFieldGlyphs::ScalarsTransparencyValue).toDouble(), colorScheme, renState, primIn, mesh->get_bounding_box());
 }
 
 void GlyphBuilder::renderTensors(
@@ -712,6 +792,10 @@ void GlyphBuilder::renderTensors(
 
   SpireIBO::PRIMITIVE primIn = SpireIBO::PRIMITIVE::TRIANGLES;;
 
+  GlyphGeom::TemplateShape shape = GlyphGeom::TemplateShape::SPHERE;
+  bool instanced = renState.mGlyphType == RenderState::GlyphType::SPHERE_GLYPH &&
+    state->getValue(ShowFieldGlyphs::InstancedGlyphs).toBool();
+
   GlyphGeom glyphs;
   auto facade(field->mesh()->getFacade());
   // Render linear data
@@ -739,6 +823,11 @@ void GlyphBuilder::renderTensors(
           node_color = ColorRGB(std::abs(colorVector.x()), std::abs(colorVector.y()), std::abs(colorVector.z()));
         }
       }
+      if (instanced)
+      {
+        glyphs.addInstance(p, Vector(radius, 0, 0), Vector(0, radius, 0), Vector(0, 0, radius), node_color);
+        continue;
+      }
       switch (renState.mGlyphType)
       {
       case RenderState::GlyphType::BOX_GLYPH:
@@ -778,6 +867,11 @@ void GlyphBuilder::renderTensors(
           node_color = ColorRGB(std::abs(colorVector.x()), std::abs(colorVector.y()), std::abs(colorVector.z()));
         }
       }
+      if (instanced)
+      {
+        glyphs.addInstance(p, Vector(radius, 0, 0), Vector(0, radius, 0), Vector(0, 0, radius), node_color);
+        continue;
+      }
       switch (renState.mGlyphType)
       {
       case RenderState::GlyphType::BOX_GLYPH:
@@ -793,8 +887,12 @@ void GlyphBuilder::renderTensors(
     }
   }
 
-  glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENCY),
-    state->getValue(ShowFieldGlyphs::TensorsTransparencyValue).toDouble(), colorScheme, renState, primIn, mesh->get_bounding_box());
+  if (instanced)
+    glyphs.buildInstancedObject(*geom, uniqueNodeID, shape, resolution, renState.get(RenderState::USE_TRANSPARENCY),
+      state->getValue(ShowFieldGlyphs::TensorsTransparencyValue).toDouble(), colorScheme, renState, mesh->get_bounding_box());
+  else
+    glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENCY),
+      state->getValue(ShowFieldGlyphs::TensorsTransparencyValue).toDouble(), colorScheme, renState, primIn, mesh->get_bounding_box());
 }
 
 RenderState GlyphBuilder::getVectorsRenderState(
@@ -1002,6 +1100,7 @@ const AlgorithmParameterName ShowFieldGlyphs::TensorsColoring("TensorsColoring")
 const AlgorithmParameterName ShowFieldGlyphs::TensorsDisplayType("TensorsDisplayType");
 // Mesh Color
 const AlgorithmParameterName ShowFieldGlyphs::DefaultMeshColor("DefaultMeshColor");
+const AlgorithmParameterName ShowFieldGlyphs::InstancedGlyphs("InstancedGlyphs");
 // Tab Controls
 const AlgorithmParameterName ShowFieldGlyphs::ShowVectorTab("ShowVectorTab");
 const AlgorithmParameterName ShowFieldGlyphs::ShowScalarTab("ShowScalarTab");
@@ -78,6 +78,11 @@ namespace SCIRun {
         // Mesh Color
         static const Core::Algorithms::AlgorithmParameterName DefaultMeshColor;
 
+        // Draw glyphs as instances of one template mesh. Off by default: the
+        // renderer issues one draw call per instance, which only pays off
+        // when the tessellated glyphs do not fit in GPU memory.
+        static const Core::Algorithms::AlgorithmParameterName InstancedGlyphs;
+
         // Tab Control
         static const Core::Algorithms::AlgorithmParameterName ShowVectorTab;
         static const Core::Algorithms::AlgorithmParameterName ShowScalarTab;
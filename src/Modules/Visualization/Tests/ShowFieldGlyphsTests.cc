@@ -0,0 +1,168 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Testing/ModuleTestBase/ModuleTestBase.h>
+#include <Modules/Visualization/ShowFieldGlyphs.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Logging/Log.h>
+#include <Graphics/Datatypes/GeometryImpl.h>
+#include <Graphics/Glyphs/GlyphGeom.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+using namespace SCIRun::Testing;
+using namespace SCIRun::TestUtils;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Modules::Visualization;
+using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Graphics;
+using namespace SCIRun::Graphics::Datatypes;
+using namespace SCIRun;
+
+namespace
+{
+  // The single glyph pass of the geometry sent by ShowFieldGlyphs
+  struct GlyphPass
+  {
+    SpireSubPass pass;
+    SpireVBO vbo;
+    SpireIBO ibo;
+  };
+
+  GlyphPass glyphPass(DatatypeHandle output)
+  {
+    GlyphPass glyphs;
+    auto geom = boost::dynamic_pointer_cast<GeometryObjectSpire>(output);
+    if (!geom || geom->passes().size() != 1) return glyphs;
+
+    glyphs.pass = geom->passes().front();
+    for (const auto& vbo : geom->vbos())
+      if (vbo.name == glyphs.pass.vboName) glyphs.vbo = vbo;
+    for (const auto& ibo : geom->ibos())
+      if (ibo.name == glyphs.pass.iboName) glyphs.ibo = ibo;
+    return glyphs;
+  }
+}
+
+class ShowFieldGlyphsInstancingTest : public ModuleTest
+{
+protected:
+  virtual void SetUp()
+  {
+    LogSettings::Instance().setVerbose(false);
+    showGlyphs = makeModule("ShowFieldGlyphs");
+    showGlyphs->setStateDefaults();
+    showGlyphs->get_state()->setValue(ShowFieldGlyphs::ShowVectors, true);
+    showGlyphs->get_state()->setValue(ShowFieldGlyphs::VectorsDisplayType, 4);
+    showGlyphs->get_state()->setValue(ShowFieldGlyphs::InstancedGlyphs, true);
+
+    // Vectors (1,2,3) on the nodes of a 3x3x3 lattice
+    field = CreateEmptyLatVol(3, 3, 3, VECTOR_E);
+    VMesh::Node::size_type numNodes;
+    field->vmesh()->size(numNodes);
+    for (VMesh::Node::index_type i = 0; i < numNodes; ++i)
+      field->vfield()->set_value(Vector(1, 2, 3), i);
+    stubPortNWithThisData(showGlyphs, 0, field);
+  }
+
+  UseRealModuleStateFactory f;
+  ModuleHandle showGlyphs;
+  FieldHandle field;
+};
+
+TEST_F(ShowFieldGlyphsInstancingTest, ArrowsAreInstancesOfOneTemplate)
+{
+  showGlyphs->execute();
+  auto glyphs = glyphPass(getDataOnThisOutputPort(showGlyphs, 0));
+
+  ASSERT_EQ(RenderType::RENDER_INSTANCED, glyphs.pass.renderType);
+  ASSERT_EQ(27, glyphs.pass.instances.numInstances);
+  ASSERT_EQ(27 * SpireInstances::instanceSize(), glyphs.pass.instances.data->getBufferSize());
+
+  // The VBO holds a single arrow
+  std::vector<Vector> points, normals;
+  std::vector<uint32_t> indices;
+  GlyphGeom::getTemplateMesh(GlyphGeom::TemplateShape::ARROW, 5, points, normals, indices);
+  EXPECT_EQ(static_cast<int64_t>(points.size()), glyphs.vbo.numElements);
+  EXPECT_EQ(indices.size() * sizeof(uint32_t), glyphs.ibo.data->getBufferSize());
+
+  // The frame of the first node: the vector along z, the origin at the node
+  VMesh::Node::index_type first(0);
+  Point p;
+  field->vmesh()->get_point(p, first);
+  const float* frame = reinterpret_cast<const float*>(glyphs.pass.instances.data->getBuffer());
+  EXPECT_FLOAT_EQ(1, frame[6]);
+  EXPECT_FLOAT_EQ(2, frame[7]);
+  EXPECT_FLOAT_EQ(3, frame[8]);
+  EXPECT_FLOAT_EQ(p.x(), frame[9]);
+  EXPECT_FLOAT_EQ(p.y(), frame[10]);
+  EXPECT_FLOAT_EQ(p.z(), frame[11]);
+
+  // The radius axes are perpendicular to the vector, a quarter of its length
+  Vector x(frame[0], frame[1], frame[2]);
+  Vector y(frame[3], frame[4], frame[5]);
+  Vector v(1, 2, 3);
+  EXPECT_NEAR(0, Dot(x, v), 1e-5);
+  EXPECT_NEAR(0, Dot(y, v), 1e-5);
+  EXPECT_NEAR(0.25 * v.length(), x.length(), 1e-5);
+  EXPECT_NEAR(0.25 * v.length(), y.length(), 1e-5);
+}
+
+TEST_F(ShowFieldGlyphsInstancingTest, TemplateIsSharedBetweenExecutions)
+{
+  showGlyphs->execute();
+  auto first = glyphPass(getDataOnThisOutputPort(showGlyphs, 0));
+
+  showGlyphs->get_state()->setValue(ShowFieldGlyphs::VectorsScale, 2.0);
+  showGlyphs->execute();
+  auto scaled = glyphPass(getDataOnThisOutputPort(showGlyphs, 0));
+
+  ASSERT_TRUE(first.vbo.data != nullptr);
+  EXPECT_EQ(first.vbo.data, scaled.vbo.data);
+  EXPECT_EQ(first.ibo.data, scaled.ibo.data);
+  EXPECT_NE(first.pass.instances.data, scaled.pass.instances.data);
+}
+
+TEST_F(ShowFieldGlyphsInstancingTest, ExpandedGlyphsAreStillAvailable)
+{
+  showGlyphs->get_state()->setValue(ShowFieldGlyphs::InstancedGlyphs, false);
+  showGlyphs->execute();
+  auto glyphs = glyphPass(getDataOnThisOutputPort(showGlyphs, 0));
+
+  EXPECT_EQ(RenderType::RENDER_VBO_IBO, glyphs.pass.renderType);
+  EXPECT_EQ(0, glyphs.pass.instances.numInstances);
+
+  std::vector<Vector> points, normals;
+  std::vector<uint32_t> indices;
+  GlyphGeom::getTemplateMesh(GlyphGeom::TemplateShape::ARROW, 5, points, normals, indices);
+  EXPECT_EQ(static_cast<int64_t>(27 * points.size()), glyphs.vbo.numElements);
+}
@@ -33,6 +33,10 @@
 #include <Core/Utils/Exception.h>
 #include <Core/Logging/Log.h>
 #include <Core/Datatypes/ColorMap.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Graphics/Datatypes/GeometryImpl.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
 
 using namespace SCIRun::Testing;
 using namespace SCIRun::TestUtils;
@@ -44,6 +48,7 @@ using namespace SCIRun::Modules::Visualization;
 using namespace SCIRun::Core;
 using namespace SCIRun;
 using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Graphics::Datatypes;
 using ::testing::Values;
 using ::testing::Combine;
 using ::testing::Range;
@@ -128,3 +133,241 @@ TEST_F(ShowFieldStateGeometryNameSynchronizationTest, GeometryNameSynchronizesWi
   EXPECT_NE(hash1, addInputShouldBeDifferent);
   EXPECT_NE(inputChangeShouldBeDifferent, hash1);
 }
+
+namespace
+{
+  // Face VBO and IBO of the geometry sent by ShowField
+  struct FaceBuffers
+  {
+    SpireVBO vbo;
+    SpireIBO ibo;
+    size_t vertexSize = 0;
+    std::vector<uint32_t> indices;
+  };
+
+  FaceBuffers faceBuffers(DatatypeHandle output)
+  {
+    FaceBuffers buffers;
+    auto geom = boost::dynamic_pointer_cast<GeometryObjectSpire>(output);
+    if (!geom) return buffers;
+
+    for (const auto& pass : geom->passes())
+    {
+      if (pass.passName.find("face") == std::string::npos) continue;
+      for (const auto& vbo : geom->vbos())
+        if (vbo.name == pass.vboName) buffers.vbo = vbo;
+      for (const auto& ibo : geom->ibos())
+        if (ibo.name == pass.iboName) buffers.ibo = ibo;
+    }
+
+    for (const auto& attrib : buffers.vbo.attributes)
+      buffers.vertexSize += attrib.sizeInBytes;
+    if (buffers.ibo.data)
+    {
+      const uint32_t* data = reinterpret_cast<const uint32_t*>(buffers.ibo.data->getBuffer());
+      buffers.indices.assign(data, data + buffers.ibo.data->getBufferSize()/sizeof(uint32_t));
+    }
+    return buffers;
+  }
+}
+
+class ShowFieldFaceGeometryTest : public ModuleTest
+{
+protected:
+  virtual void SetUp()
+  {
+    LogSettings::Instance().setVerbose(false);
+    showField = makeModule("ShowField");
+    showField->setStateDefaults();
+    showField->get_state()->setValue(ShowField::ShowEdges, false);
+  }
+
+  UseRealModuleStateFactory f;
+  ModuleHandle showField;
+};
+
+TEST_F(ShowFieldFaceGeometryTest, FacesShareVerticesAtNodes)
+{
+  FieldHandle latVol = CreateEmptyLatVol(3, 3, 3);
+  stubPortNWithThisData(showField, 0, latVol);
+  showField->execute();
+
+  auto buffers = faceBuffers(getDataOnThisOutputPort(showField, 0));
+  ASSERT_TRUE(buffers.vbo.data != nullptr);
+
+  // Only the boundary of the volume is shown: one vertex per boundary node
+  // (all but the center one) and two triangles per boundary quad
+  const size_t numNodes = 26;
+  const size_t numFaces = 24;
+  EXPECT_EQ(numNodes, static_cast<size_t>(buffers.vbo.numElements));
+  EXPECT_EQ(numNodes * buffers.vertexSize, buffers.vbo.data->getBufferSize());
+  ASSERT_EQ(numFaces * 6, buffers.indices.size());
+
+  // Every triangle lies in a grid plane
+  const float* vertices = reinterpret_cast<const float*>(buffers.vbo.data->getBuffer());
+  for (size_t t = 0; t < buffers.indices.size(); t += 3)
+  {
+    int shared = 0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+      float c = vertices[3*buffers.indices[t]+axis];
+      if (c == vertices[3*buffers.indices[t+1]+axis] && c == vertices[3*buffers.indices[t+2]+axis])
+        shared++;
+    }
+    ASSERT_LT(buffers.indices[t], numNodes);
+    EXPECT_EQ(1, shared);
+  }
+}
+
+TEST_F(ShowFieldFaceGeometryTest, CellDataGivesEveryFaceItsOwnCorners)
+{
+  FieldHandle latVol = CreateEmptyLatVol(3, 3, 3);
+  FieldInformation fi(latVol);
+  fi.make_constantdata();
+  latVol = CreateField(fi, latVol->mesh());
+  stubPortNWithThisData(showField, 0, latVol);
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create());
+  showField->execute();
+
+  auto buffers = faceBuffers(getDataOnThisOutputPort(showField, 0));
+  ASSERT_TRUE(buffers.vbo.data != nullptr);
+
+  // Position and a front and back color for every corner of every
+  // boundary face
+  const size_t numFaces = 24;
+  EXPECT_EQ((3 + 8) * sizeof(float), buffers.vertexSize);
+  EXPECT_EQ(numFaces * 4, static_cast<size_t>(buffers.vbo.numElements));
+  EXPECT_EQ(numFaces * 4 * buffers.vertexSize, buffers.vbo.data->getBufferSize());
+  ASSERT_EQ(numFaces * 6, buffers.indices.size());
+  for (size_t t = 0; t < buffers.indices.size(); t++)
+    EXPECT_EQ(t/6, buffers.indices[t]/4u);
+}
+
+TEST_F(ShowFieldFaceGeometryTest, ColorChangesKeepGeometryBuffers)
+{
+  FieldHandle latVol = CreateEmptyLatVol(3, 3, 3);
+  stubPortNWithThisData(showField, 0, latVol);
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create());
+  showField->execute();
+  auto first = faceBuffers(getDataOnThisOutputPort(showField, 0));
+  ASSERT_TRUE(first.vbo.data != nullptr);
+
+  // Transparency is a uniform, neither buffer is rebuilt
+  showField->get_state()->setValue(ShowField::FaceTransparencyValue, 0.3);
+  showField->execute();
+  auto transparent = faceBuffers(getDataOnThisOutputPort(showField, 0));
+  EXPECT_EQ(first.vbo.data, transparent.vbo.data);
+  EXPECT_EQ(first.ibo.data, transparent.ibo.data);
+
+  // A new colormap only changes the colors of the vertices
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create("Grayscale"));
+  showField->execute();
+  auto recolored = faceBuffers(getDataOnThisOutputPort(showField, 0));
+  EXPECT_NE(first.vbo.data, recolored.vbo.data);
+  EXPECT_EQ(first.ibo.data, recolored.ibo.data);
+  EXPECT_EQ(first.vbo.name, recolored.vbo.name);
+  EXPECT_EQ(first.vbo.numElements, recolored.vbo.numElements);
+
+  // Positions are unchanged
+  const float* a = reinterpret_cast<const float*>(first.vbo.data->getBuffer());
+  const float* b = reinterpret_cast<const float*>(recolored.vbo.data->getBuffer());
+  const size_t floats = first.vertexSize / sizeof(float);
+  for (int64_t v = 0; v < first.vbo.numElements; v++)
+    for (int k = 0; k < 3; k++)
+      EXPECT_EQ(a[v*floats+k], b[v*floats+k]);
+
+  // A new mesh rebuilds everything
+  stubPortNWithThisData(showField, 0, CreateEmptyLatVol(3, 3, 3));
+  showField->execute();
+  auto remeshed = faceBuffers(getDataOnThisOutputPort(showField, 0));
+  EXPECT_NE(recolored.ibo.data, remeshed.ibo.data);
+}
+
+TEST_F(ShowFieldFaceGeometryTest, RecoloredObjectKeepsBufferNames)
+{
+  FieldHandle latVol = CreateEmptyLatVol(3, 3, 3);
+  stubPortNWithThisData(showField, 0, latVol);
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create());
+  showField->execute();
+  auto firstGeom = boost::dynamic_pointer_cast<GeometryObjectSpire>(getDataOnThisOutputPort(showField, 0));
+  ASSERT_TRUE(firstGeom != nullptr);
+  auto first = faceBuffers(firstGeom);
+
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create("Grayscale"));
+  showField->execute();
+  auto recoloredGeom = boost::dynamic_pointer_cast<GeometryObjectSpire>(getDataOnThisOutputPort(showField, 0));
+  ASSERT_TRUE(recoloredGeom != nullptr);
+  auto recolored = faceBuffers(recoloredGeom);
+
+  // The object ID changes with the colormap, its stable part does not. The
+  // renderer keeps an IBO that comes back under the same name with the same
+  // data on the GPU.
+  EXPECT_NE(firstGeom->uniqueID(), recoloredGeom->uniqueID());
+  EXPECT_EQ(firstGeom->stableID(), recoloredGeom->stableID());
+  EXPECT_EQ(0u, first.ibo.name.find(firstGeom->stableID()));
+  EXPECT_EQ(first.ibo.name, recolored.ibo.name);
+  EXPECT_EQ(first.ibo.data, recolored.ibo.data);
+  EXPECT_EQ(first.vbo.name, recolored.vbo.name);
+  EXPECT_NE(first.vbo.data, recolored.vbo.data);
+}
+
+TEST_F(ShowFieldFaceGeometryTest, LargeSurfacesAreSplitIntoChunks)
+{
+  // 6*79*79 boundary quads, a bit more than 64k triangles
+  FieldHandle latVol = CreateEmptyLatVol(80, 80, 80);
+  stubPortNWithThisData(showField, 0, latVol);
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create());
+  showField->execute();
+
+  auto geom = boost::dynamic_pointer_cast<GeometryObjectSpire>(getDataOnThisOutputPort(showField, 0));
+  ASSERT_TRUE(geom != nullptr);
+
+  std::vector<std::shared_ptr<spire::VarBuffer>> chunkIBOs;
+  size_t numIndices = 0;
+  for (const auto& vbo : geom->vbos())
+  {
+    ASSERT_NE(std::string::npos, vbo.name.find("Chunk"));
+    EXPECT_TRUE(vbo.boundingBox.valid());
+  }
+  for (const auto& ibo : geom->ibos())
+  {
+    ASSERT_NE(std::string::npos, ibo.name.find("Chunk"));
+    const SpireVBO* vbo = nullptr;
+    for (const auto& v : geom->vbos())
+      if (v.name.substr(v.name.find("Chunk")) == ibo.name.substr(ibo.name.find("Chunk"))) vbo = &v;
+    ASSERT_TRUE(vbo != nullptr);
+
+    // Indices refer to the vertices of the chunk
+    const uint32_t* data = reinterpret_cast<const uint32_t*>(ibo.data->getBuffer());
+    const size_t n = ibo.data->getBufferSize()/sizeof(uint32_t);
+    for (size_t i = 0; i < n; i++)
+      ASSERT_LT(data[i], static_cast<uint32_t>(vbo->numElements));
+    numIndices += n;
+    chunkIBOs.push_back(ibo.data);
+  }
+  EXPECT_EQ(2u, geom->passes().size());
+  EXPECT_EQ(6u*79*79*6, numIndices);
+
+  // A new colormap keeps the indices of the chunks
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create("Grayscale"));
+  showField->execute();
+  geom = boost::dynamic_pointer_cast<GeometryObjectSpire>(getDataOnThisOutputPort(showField, 0));
+  ASSERT_EQ(chunkIBOs.size(), geom->ibos().size());
+  size_t c = 0;
+  for (const auto& ibo : geom->ibos())
+    EXPECT_EQ(chunkIBOs[c++], ibo.data);
+}
+
+TEST_F(ShowFieldFaceGeometryTest, DISABLED_LargeSurfaceBenchmark)
+{
+  // About 5M quads
+  FieldHandle latVol = CreateEmptyLatVol(120, 120, 120);
+  stubPortNWithThisData(showField, 0, latVol);
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create());
+  {
+    ScopedTimer t("ShowField faces with node colors");
+    showField->execute();
+  }
+  auto buffers = faceBuffers(getDataOnThisOutputPort(showField, 0));
+  std::cout << buffers.vbo.numElements << " vertices, " << buffers.indices.size()/3 << " triangles" << std::endl;
+}
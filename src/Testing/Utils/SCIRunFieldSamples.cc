@@ -34,6 +34,9 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 
 #include <boost/assign.hpp>
+#include <algorithm>
+#include <numeric>
+#include <random>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Geometry;
@@ -308,3 +311,68 @@ FieldHandle SCIRun::TestUtils::CreateEmptyLatVol(size_type sizex, size_type size
   return ofh;
 }
 
+
+FieldHandle SCIRun::TestUtils::CreateTetVolGrid(size_type cellsPerSide, bool shuffle, int basis_order, data_info_type type)
+{
+  FieldInformation fi(TETVOLMESH_E, basis_order == 0 ? CONSTANTDATA_E : LINEARDATA_E, type);
+  FieldHandle field = CreateField(fi);
+  auto vmesh = field->vmesh();
+
+  const size_type n = cellsPerSide;
+  const size_type np = n + 1;
+  const size_type num_nodes = np * np * np;
+  std::mt19937 rng(1234);
+
+  std::vector<index_type> nodeIndex(num_nodes);
+  std::iota(nodeIndex.begin(), nodeIndex.end(), 0);
+  if (shuffle)
+    std::shuffle(nodeIndex.begin(), nodeIndex.end(), rng);
+
+  std::vector<Point> points(num_nodes);
+  for (size_type k = 0; k < np; k++)
+    for (size_type j = 0; j < np; j++)
+      for (size_type i = 0; i < np; i++)
+        points[nodeIndex[i + np*(j + np*k)]] = Point(double(i)/n, double(j)/n, double(k)/n);
+
+  vmesh->node_reserve(num_nodes);
+  for (const auto& p : points)
+    vmesh->add_point(p);
+
+  // Kuhn subdivision: six positively oriented tets along the main diagonal of each hex
+  static const int kuhn[6][4] = { {0,1,3,7}, {0,1,7,5}, {0,2,7,3}, {0,2,6,7}, {0,4,5,7}, {0,4,7,6} };
+  std::vector<VMesh::Node::array_type> elems;
+  elems.reserve(6*n*n*n);
+  for (size_type k = 0; k < n; k++)
+    for (size_type j = 0; j < n; j++)
+      for (size_type i = 0; i < n; i++)
+      {
+        index_type corner[8];
+        for (int c = 0; c < 8; c++)
+          corner[c] = nodeIndex[(i + (c & 1)) + np*((j + ((c >> 1) & 1)) + np*(k + ((c >> 2) & 1)))];
+        for (int t = 0; t < 6; t++)
+        {
+          VMesh::Node::array_type tet(4);
+          for (int c = 0; c < 4; c++)
+            tet[c] = corner[kuhn[t][c]];
+          elems.push_back(tet);
+        }
+      }
+
+  if (shuffle)
+    std::shuffle(elems.begin(), elems.end(), rng);
+
+  vmesh->elem_reserve(elems.size());
+  for (const auto& tet : elems)
+    vmesh->add_elem(tet);
+
+  field->vfield()->resize_values();
+  return field;
+}
+
+std::vector<double> SCIRun::TestUtils::FieldValues(FieldHandle field)
+{
+  std::vector<double> v(field->vfield()->num_values());
+  for (VMesh::index_type i = 0; i < field->vfield()->num_values(); ++i)
+    field->vfield()->get_value(v[i], i);
+  return v;
+}
@@ -95,6 +95,14 @@ SCISHARE FieldHandle CreateEmptyLatVol(size_type sizex, size_type sizey, size_ty
   data_info_type type = DOUBLE_E,
   const Core::Geometry::Point& minb = { -1, -1, -1 }, const Core::Geometry::Point& maxb = {1,1,1});
 
+/// Unit cube split into cellsPerSide^3 hexes of six tets each. With shuffle set,
+/// nodes and elements are numbered in random order, like a typical mesher output.
+SCISHARE FieldHandle CreateTetVolGrid(size_type cellsPerSide, bool shuffle,
+  int basis_order = 0, data_info_type type = DOUBLE_E);
+
+/// The field values converted to double, in index order.
+SCISHARE std::vector<double> FieldValues(FieldHandle field);
+
 }}
 
 #endif